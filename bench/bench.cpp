@@ -0,0 +1,756 @@
+#include "../include/MapEngine.h"
+#include "../include/GraphGenerator.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 基准测试参数
+ */
+struct BenchOptions {
+    std::string generator = "grid";     // grid / geometric / scalefree
+    std::string mapFile;                // 非空时测试已有地图，不生成
+    long long nodes = 100000;
+    double degree = 6.0;                // geometric / scalefree 的期望平均度数
+    size_t queries = 1000;
+    std::vector<QueryWorkload> workloads = {QueryWorkload::RANDOM, QueryWorkload::LOCAL};
+    int walkLength = 32;
+    std::vector<SearchAlgorithm> algorithms = {SearchAlgorithm::DIJKSTRA,
+                                               SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                               SearchAlgorithm::ALT,
+                                               SearchAlgorithm::CONTRACTION_HIERARCHY};
+    std::vector<PathStrategy> strategies = {PathStrategy::SHORTEST_DISTANCE,
+                                            PathStrategy::LEAST_TIME};
+    std::vector<QueueType> queues = {QueueType::BINARY_HEAP, QueueType::DARY_HEAP,
+                                     QueueType::RADIX_HEAP};
+    int landmarks = 16;
+    std::vector<NodeOrder> orders = {NodeOrder::ORIGINAL, NodeOrder::RCM};  // 节点重排对比
+    int kPaths = 10;                    // 前 k 条最短路径测试的最大 k（0 表示不测）
+    size_t kQueries = 100;              // 前 k 条最短路径测试的查询数
+    size_t ssspSources = 3;             // 整图最短路径树测试的起点数（0 表示不测）
+    std::vector<double> deltas = {0.0}; // delta-stepping 的桶宽，0 表示自动选择
+    size_t threads = 0;
+    uint64_t seed = 1;
+    bool binary = true;
+    bool keepFiles = false;
+    std::string workDir = ".";
+    std::string output;
+};
+
+/**
+ * @brief 一组查询的延迟统计
+ */
+struct LatencyStats {
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+const char* algorithmName(SearchAlgorithm algorithm) {
+    switch (algorithm) {
+        case SearchAlgorithm::DIJKSTRA: return "dijkstra";
+        case SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA: return "bidirectional";
+        case SearchAlgorithm::ALT: return "alt";
+        case SearchAlgorithm::CONTRACTION_HIERARCHY: return "ch";
+    }
+    return "unknown";
+}
+
+const char* strategyName(PathStrategy strategy) {
+    return strategy == PathStrategy::LEAST_TIME ? "time" : "distance";
+}
+
+const char* queueName(QueueType queue) {
+    switch (queue) {
+        case QueueType::BINARY_HEAP: return "binary";
+        case QueueType::DARY_HEAP: return "dary4";
+        case QueueType::RADIX_HEAP: return "radix";
+    }
+    return "unknown";
+}
+
+const char* workloadName(QueryWorkload workload) {
+    return workload == QueryWorkload::LOCAL ? "local" : "random";
+}
+
+/**
+ * @brief 进程当前常驻内存（字节），不支持的平台返回 0
+ */
+size_t getCurrentRss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+#endif
+}
+
+/**
+ * @brief 进程峰值常驻内存（字节）
+ */
+size_t getPeakRss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief 计算延迟统计（最近秩百分位），单位微秒
+ */
+LatencyStats computeStats(std::vector<double> latencies) {
+    LatencyStats stats;
+    if (latencies.empty()) {
+        return stats;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * latencies.size()));
+        return latencies[std::max<size_t>(rank, 1) - 1];
+    };
+    double sum = 0.0;
+    for (double latency : latencies) {
+        sum += latency;
+    }
+    stats.mean = sum / latencies.size();
+    stats.p50 = percentile(0.50);
+    stats.p90 = percentile(0.90);
+    stats.p99 = percentile(0.99);
+    stats.max = latencies.back();
+    return stats;
+}
+
+/**
+ * @brief 按逗号拆分参数
+ */
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "用法: " << program << " [选项]\n"
+              << "  --generator grid|geometric|scalefree  合成图类型（默认 grid）\n"
+              << "  --map <文件>              测试已有地图（文本或二进制），不生成\n"
+              << "  --nodes N                 节点数（默认 100000，最多约 1000 万）\n"
+              << "  --degree D                geometric / scalefree 的期望平均度数（默认 6）\n"
+              << "  --queries Q               每组查询数（默认 1000）\n"
+              << "  --workload random,local   查询负载（默认两种都测）\n"
+              << "  --walk L                  local 负载的随机游走步数（默认 32）\n"
+              << "  --algorithms dijkstra,bidirectional,alt,ch\n"
+              << "  --strategies distance,time\n"
+              << "  --queues binary,dary4,radix 优先队列（默认三种都测；CH 只测第一种）\n"
+              << "  --landmarks N             ALT 地标数（默认 16）\n"
+              << "  --orders original,bfs,rcm 对比的节点重排方式（默认 original,rcm，第一种为基准）\n"
+              << "  --k-paths K               前 k 条最短路径测试 k = 1..K（默认 10，0 表示不测）\n"
+              << "  --k-queries Q             前 k 条最短路径测试的查询数（默认 100）\n"
+              << "  --sssp-sources S          整图最短路径树（delta-stepping）测试的起点数（默认 3，0 表示不测）\n"
+              << "  --deltas D1,D2            delta-stepping 桶宽（默认 0，即按边权自动选择）\n"
+              << "  --threads T               批量查询线程数（默认硬件线程数）\n"
+              << "  --seed S                  随机种子\n"
+              << "  --no-binary               不测试二进制地图的加载\n"
+              << "  --work-dir <目录>         临时地图文件目录（默认当前目录）\n"
+              << "  --keep-files              保留生成的地图文件\n"
+              << "  --output <文件>           JSON 结果写入文件（默认标准输出）" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= argc) {
+                std::cerr << "错误: 参数 " << arg << " 缺少取值" << std::endl;
+                return false;
+            }
+            out = argv[++i];
+            return true;
+        };
+        std::string text;
+        if (arg == "--no-binary") {
+            options.binary = false;
+        } else if (arg == "--keep-files") {
+            options.keepFiles = true;
+        } else if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (!value(text)) {
+            return false;
+        } else if (arg == "--generator") {
+            options.generator = text;
+        } else if (arg == "--map") {
+            options.mapFile = text;
+        } else if (arg == "--nodes") {
+            options.nodes = std::atoll(text.c_str());
+        } else if (arg == "--degree") {
+            options.degree = std::atof(text.c_str());
+        } else if (arg == "--queries") {
+            options.queries = static_cast<size_t>(std::atoll(text.c_str()));
+        } else if (arg == "--walk") {
+            options.walkLength = std::atoi(text.c_str());
+        } else if (arg == "--landmarks") {
+            options.landmarks = std::atoi(text.c_str());
+        } else if (arg == "--k-paths") {
+            options.kPaths = std::atoi(text.c_str());
+        } else if (arg == "--k-queries") {
+            options.kQueries = static_cast<size_t>(std::atoll(text.c_str()));
+        } else if (arg == "--sssp-sources") {
+            options.ssspSources = static_cast<size_t>(std::atoll(text.c_str()));
+        } else if (arg == "--deltas") {
+            options.deltas.clear();
+            for (const std::string& item : splitList(text)) {
+                options.deltas.push_back(std::atof(item.c_str()));
+            }
+        } else if (arg == "--threads") {
+            options.threads = static_cast<size_t>(std::atoll(text.c_str()));
+        } else if (arg == "--seed") {
+            options.seed = static_cast<uint64_t>(std::atoll(text.c_str()));
+        } else if (arg == "--work-dir") {
+            options.workDir = text;
+        } else if (arg == "--output") {
+            options.output = text;
+        } else if (arg == "--workload") {
+            options.workloads.clear();
+            for (const std::string& name : splitList(text)) {
+                if (name == "random") {
+                    options.workloads.push_back(QueryWorkload::RANDOM);
+                } else if (name == "local") {
+                    options.workloads.push_back(QueryWorkload::LOCAL);
+                } else {
+                    std::cerr << "错误: 未知查询负载 " << name << std::endl;
+                    return false;
+                }
+            }
+        } else if (arg == "--algorithms") {
+            options.algorithms.clear();
+            for (const std::string& name : splitList(text)) {
+                const SearchAlgorithm all[] = {SearchAlgorithm::DIJKSTRA,
+                                               SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                               SearchAlgorithm::ALT,
+                                               SearchAlgorithm::CONTRACTION_HIERARCHY};
+                bool known = false;
+                for (SearchAlgorithm algorithm : all) {
+                    if (name == algorithmName(algorithm)) {
+                        options.algorithms.push_back(algorithm);
+                        known = true;
+                    }
+                }
+                if (!known) {
+                    std::cerr << "错误: 未知搜索算法 " << name << std::endl;
+                    return false;
+                }
+            }
+        } else if (arg == "--queues") {
+            options.queues.clear();
+            for (const std::string& name : splitList(text)) {
+                const QueueType all[] = {QueueType::BINARY_HEAP, QueueType::DARY_HEAP,
+                                         QueueType::RADIX_HEAP};
+                bool known = false;
+                for (QueueType queue : all) {
+                    if (name == queueName(queue)) {
+                        options.queues.push_back(queue);
+                        known = true;
+                    }
+                }
+                if (!known) {
+                    std::cerr << "错误: 未知优先队列 " << name << std::endl;
+                    return false;
+                }
+            }
+        } else if (arg == "--orders") {
+            options.orders.clear();
+            for (const std::string& name : splitList(text)) {
+                NodeOrder order;
+                if (!NodeOrdering::parse(name, order)) {
+                    std::cerr << "错误: 未知重排方式 " << name << std::endl;
+                    return false;
+                }
+                options.orders.push_back(order);
+            }
+        } else if (arg == "--strategies") {
+            options.strategies.clear();
+            for (const std::string& name : splitList(text)) {
+                if (name == "distance") {
+                    options.strategies.push_back(PathStrategy::SHORTEST_DISTANCE);
+                } else if (name == "time") {
+                    options.strategies.push_back(PathStrategy::LEAST_TIME);
+                } else {
+                    std::cerr << "错误: 未知策略 " << name << std::endl;
+                    return false;
+                }
+            }
+        } else {
+            std::cerr << "错误: 未知参数 " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.generator != "grid" && options.generator != "geometric" &&
+        options.generator != "scalefree") {
+        std::cerr << "错误: 未知生成器 " << options.generator << std::endl;
+        return false;
+    }
+    if (options.nodes <= 0 || options.nodes > 100000000LL) {
+        std::cerr << "错误: 节点数超出范围" << std::endl;
+        return false;
+    }
+    return !options.algorithms.empty() && !options.strategies.empty() &&
+           !options.workloads.empty() && !options.queues.empty();
+}
+
+/**
+ * @brief 按参数生成合成图
+ */
+void generateGraph(const BenchOptions& options, Graph& graph) {
+    int nodes = static_cast<int>(options.nodes);
+    if (options.generator == "grid") {
+        // 接近正方形的网格，节点数向上取整到整行
+        int cols = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(nodes))));
+        int rows = (nodes + cols - 1) / cols;
+        GraphGenerator::generateGrid(graph, rows, cols, options.seed);
+    } else if (options.generator == "geometric") {
+        GraphGenerator::generateRandomGeometric(graph, nodes, options.degree, options.seed);
+    } else {
+        // 优先连接：每个新节点连 m 条边，平均度数约为 2m
+        GraphGenerator::generateScaleFree(graph, nodes,
+                                          std::max(1, static_cast<int>(options.degree / 2.0)),
+                                          options.seed);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 进度（包括加载器的输出）转到标准错误，标准输出只写 JSON
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+
+    // ---------- 生成并写出地图 ----------
+    std::string textFile = options.mapFile;
+    double generateSeconds = 0.0;
+    if (textFile.empty()) {
+        textFile = options.workDir + "/bench_map.txt";
+        std::cerr << "生成 " << options.generator << " 图，" << options.nodes << " 个节点..." << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        {
+            Graph generated;
+            generateGraph(options, generated);
+            generateSeconds = secondsSince(start);
+            if (!GraphGenerator::writeMap(generated, textFile)) {
+                return 1;
+            }
+        }
+        json << "  \"generator\": {\"type\": \"" << options.generator << "\", \"nodes\": "
+             << options.nodes << ", \"degree\": " << options.degree << ", \"seed\": "
+             << options.seed << ", \"seconds\": " << generateSeconds << "},\n";
+    } else {
+        json << "  \"map\": \"" << textFile << "\",\n";
+    }
+
+    // ---------- 加载 ----------
+    MapEngine engine;
+    engine.setThreadCount(options.threads);
+    size_t rssBefore = getCurrentRss();
+    auto loadStart = std::chrono::steady_clock::now();
+    if (!engine.loadMap(textFile)) {
+        std::cerr << "错误: 无法加载地图 " << textFile << std::endl;
+        return 1;
+    }
+    double loadSeconds = secondsSince(loadStart);
+    size_t rssAfterLoad = getCurrentRss();
+    std::cerr << "加载完成：" << engine.getNodeCount() << " 个节点，" << engine.getEdgeCount()
+              << " 条边，" << loadSeconds << " 秒" << std::endl;
+
+    // ---------- 预处理 ----------
+    bool needLandmarks = std::find(options.algorithms.begin(), options.algorithms.end(),
+                                   SearchAlgorithm::ALT) != options.algorithms.end();
+    bool needHierarchies = std::find(options.algorithms.begin(), options.algorithms.end(),
+                                     SearchAlgorithm::CONTRACTION_HIERARCHY) != options.algorithms.end();
+    double landmarkSeconds = 0.0;
+    double hierarchySeconds = 0.0;
+    if (needLandmarks && !engine.hasLandmarks()) {
+        std::cerr << "选择 " << options.landmarks << " 个地标..." << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        engine.buildLandmarks(options.landmarks);
+        landmarkSeconds = secondsSince(start);
+    }
+    if (needHierarchies && !engine.hasContractionHierarchy(PathStrategy::SHORTEST_DISTANCE)) {
+        std::cerr << "构建收缩层次..." << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        engine.buildContractionHierarchies();
+        hierarchySeconds = secondsSince(start);
+    }
+
+    // ---------- 二进制地图：保存后重新加载（不校验 / 校验负载） ----------
+    double binaryLoadSeconds = 0.0;
+    double binaryVerifiedLoadSeconds = 0.0;
+    std::string binaryFile = options.workDir + "/bench_map.pmap";
+    if (options.binary && !BinaryMap::isBinaryMap(textFile) && engine.saveBinaryMap(binaryFile)) {
+        MapEngine binaryEngine;
+        binaryEngine.setVerifyBinaryMap(false);
+        auto start = std::chrono::steady_clock::now();
+        binaryEngine.loadMap(binaryFile);
+        binaryLoadSeconds = secondsSince(start);
+        binaryEngine.setVerifyBinaryMap(true);
+        start = std::chrono::steady_clock::now();
+        binaryEngine.loadMap(binaryFile);
+        binaryVerifiedLoadSeconds = secondsSince(start);
+    }
+
+    std::shared_ptr<const MapSnapshot> snapshot = engine.getSnapshot();
+    const Graph& graph = snapshot->getGraph();
+    size_t landmarkBytes = snapshot->getLandmarks() ? snapshot->getLandmarks()->getMemoryUsage() : 0;
+    size_t hierarchyBytes = 0;
+    size_t shortcuts = 0;
+    for (PathStrategy strategy : {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME}) {
+        if (const ContractionHierarchy* hierarchy = snapshot->getContractionHierarchy(strategy)) {
+            hierarchyBytes += hierarchy->getMemoryUsage();
+            shortcuts += hierarchy->getShortcutCount();
+        }
+    }
+
+    json << "  \"graph\": {\"nodes\": " << graph.getNodeCount() << ", \"edges\": "
+         << graph.getEdgeCount() << "},\n";
+    json << "  \"load\": {\"text_seconds\": " << loadSeconds
+         << ", \"binary_seconds\": " << binaryLoadSeconds
+         << ", \"binary_verified_seconds\": " << binaryVerifiedLoadSeconds << "},\n";
+    json << "  \"preprocessing\": {\"landmarks\": " << (snapshot->getLandmarks() ?
+                                                         snapshot->getLandmarks()->getLandmarkCount() : 0)
+         << ", \"landmark_seconds\": " << landmarkSeconds
+         << ", \"ch_seconds\": " << hierarchySeconds
+         << ", \"ch_shortcuts\": " << shortcuts << "},\n";
+    json << "  \"memory\": {\"graph_bytes\": " << graph.getMemoryUsage()
+         << ", \"landmark_bytes\": " << landmarkBytes
+         << ", \"ch_bytes\": " << hierarchyBytes
+         << ", \"load_rss_delta_bytes\": " << (rssAfterLoad > rssBefore ? rssAfterLoad - rssBefore : 0)
+         << ", \"peak_rss_bytes\": " << getPeakRss() << "},\n";
+    json << "  \"threads\": " << engine.getThreadCount() << ",\n";
+    json << "  \"results\": [";
+
+    // ---------- 查询 ----------
+    bool first = true;
+    PathBatch pathBatch;    // 各组批量查询复用同一个结果缓冲区
+    for (QueryWorkload workload : options.workloads) {
+        std::vector<std::pair<int, int>> queries = GraphGenerator::generateQueries(
+            graph, options.queries, workload, options.seed + 1, options.walkLength);
+        for (PathStrategy strategy : options.strategies) {
+            // 第一组结果作为参照，其余队列和算法的总权重与之比较
+            std::vector<double> reference;
+            for (QueueType queue : options.queues) {
+                engine.setQueueType(queue);
+                std::shared_ptr<const MapSnapshot> querySnapshot = engine.getSnapshot();
+                for (SearchAlgorithm algorithm : options.algorithms) {
+                    // 收缩层次查询总是使用二叉堆，只测一次
+                    if (algorithm == SearchAlgorithm::CONTRACTION_HIERARCHY &&
+                        queue != options.queues.front()) {
+                        continue;
+                    }
+                    std::cerr << workloadName(workload) << " / " << strategyName(strategy) << " / "
+                              << queueName(queue) << " / " << algorithmName(algorithm) << "..."
+                              << std::endl;
+
+                    // 预热：初始化本线程的搜索工作区
+                    for (size_t i = 0; i < std::min<size_t>(queries.size(), 10); ++i) {
+                        querySnapshot->findPath(queries[i].first, queries[i].second, strategy,
+                                                algorithm);
+                    }
+
+                    std::vector<double> latencies;
+                    latencies.reserve(queries.size());
+                    size_t found = 0;
+                    size_t mismatches = 0;
+                    double queueSizeSum = 0.0;
+                    size_t queueSizeMax = 0;
+                    bool isReference = reference.empty();
+                    auto serialStart = std::chrono::steady_clock::now();
+                    for (size_t i = 0; i < queries.size(); ++i) {
+                        auto start = std::chrono::steady_clock::now();
+                        PathResult result = querySnapshot->findPath(queries[i].first,
+                                                                    queries[i].second,
+                                                                    strategy, algorithm);
+                        latencies.push_back(secondsSince(start) * 1e6);
+                        queueSizeSum += static_cast<double>(result.peakQueueSize);
+                        queueSizeMax = std::max(queueSizeMax, result.peakQueueSize);
+                        double weight = result.found ? result.totalWeight : -1.0;
+                        if (result.found) {
+                            found++;
+                        }
+                        if (isReference) {
+                            reference.push_back(weight);
+                        } else if (std::abs(weight - reference[i]) > 1e-6 * (1.0 + std::abs(weight))) {
+                            mismatches++;
+                        }
+                    }
+                    double serialSeconds = secondsSince(serialStart);
+
+                    engine.setAlgorithm(algorithm);
+                    engine.setStrategy(strategy);
+                    auto batchStart = std::chrono::steady_clock::now();
+                    engine.findPaths(queries);
+                    double batchSeconds = secondsSince(batchStart);
+                    auto arenaStart = std::chrono::steady_clock::now();
+                    engine.findPaths(queries.data(), queries.size(), pathBatch);
+                    double arenaSeconds = secondsSince(arenaStart);
+                    auto distanceStart = std::chrono::steady_clock::now();
+                    engine.findPaths(queries.data(), queries.size(), pathBatch, true);
+                    double distanceSeconds = secondsSince(distanceStart);
+
+                    LatencyStats stats = computeStats(latencies);
+                    json << (first ? "\n" : ",\n");
+                    first = false;
+                    json << "    {\"workload\": \"" << workloadName(workload)
+                         << "\", \"strategy\": \"" << strategyName(strategy)
+                         << "\", \"queue\": \"" << queueName(queue)
+                         << "\", \"algorithm\": \"" << algorithmName(algorithm)
+                         << "\", \"queries\": " << queries.size()
+                         << ", \"found\": " << found
+                         << ", \"mismatches\": " << mismatches
+                         << ", \"latency_us\": {\"mean\": " << stats.mean << ", \"p50\": " << stats.p50
+                         << ", \"p90\": " << stats.p90 << ", \"p99\": " << stats.p99
+                         << ", \"max\": " << stats.max << "}"
+                         << ", \"peak_queue\": {\"mean\": "
+                         << (queries.empty() ? 0.0 : queueSizeSum / queries.size())
+                         << ", \"max\": " << queueSizeMax << "}"
+                         << ", \"throughput_qps\": " << (serialSeconds > 0 ? queries.size() / serialSeconds : 0.0)
+                         << ", \"batch_throughput_qps\": " << (batchSeconds > 0 ? queries.size() / batchSeconds : 0.0)
+                         << ", \"batch_arena_qps\": " << (arenaSeconds > 0 ? queries.size() / arenaSeconds : 0.0)
+                         << ", \"batch_distance_qps\": " << (distanceSeconds > 0 ? queries.size() / distanceSeconds : 0.0)
+                         << "}";
+                }
+            }
+        }
+    }
+    json << "\n  ],\n";
+
+    // ---------- 前 k 条最短路径：每次查询求 K 条，第 k 条结果的累计时间即为求前 k 条的延迟 ----------
+    json << "  \"k_shortest\": [";
+    first = true;
+    if (options.kPaths > 0) {
+        std::shared_ptr<const MapSnapshot> querySnapshot = engine.getSnapshot();
+        PathStrategy strategy = options.strategies.front();
+        for (QueryWorkload workload : options.workloads) {
+            std::vector<std::pair<int, int>> queries = GraphGenerator::generateQueries(
+                graph, options.kQueries, workload, options.seed + 2, options.walkLength);
+            std::cerr << workloadName(workload) << " / " << strategyName(strategy)
+                      << " / k-shortest (k = 1.." << options.kPaths << ")..." << std::endl;
+            std::vector<std::vector<double>> latencies(static_cast<size_t>(options.kPaths));
+            for (const std::pair<int, int>& query : queries) {
+                std::vector<PathResult> paths = querySnapshot->findKShortestPaths(
+                    query.first, query.second, options.kPaths, strategy);
+                for (size_t k = 0; k < paths.size(); ++k) {
+                    latencies[k].push_back(static_cast<double>(paths[k].elapsedMicroseconds));
+                }
+            }
+            for (int k = 1; k <= options.kPaths; ++k) {
+                LatencyStats stats = computeStats(latencies[k - 1]);
+                json << (first ? "\n" : ",\n");
+                first = false;
+                json << "    {\"workload\": \"" << workloadName(workload)
+                     << "\", \"strategy\": \"" << strategyName(strategy)
+                     << "\", \"queue\": \"" << queueName(querySnapshot->getQueueType())
+                     << "\", \"k\": " << k
+                     << ", \"queries\": " << queries.size()
+                     << ", \"found\": " << latencies[k - 1].size()
+                     << ", \"latency_us\": {\"mean\": " << stats.mean << ", \"p50\": " << stats.p50
+                     << ", \"p90\": " << stats.p90 << ", \"p99\": " << stats.p99
+                     << ", \"max\": " << stats.max << "}}";
+            }
+        }
+    }
+    json << "\n  ],\n";
+
+    // ---------- 节点重排：按各重排方式重新加载文本地图，比较边跨度和 Dijkstra 延迟 ----------
+    json << "  \"node_order\": [";
+    first = true;
+    if (!BinaryMap::isBinaryMap(textFile)) {
+        std::vector<std::pair<int, int>> queries = GraphGenerator::generateQueries(
+            graph, options.queries, options.workloads.front(), options.seed + 3, options.walkLength);
+        PathStrategy strategy = options.strategies.front();
+        double baseline = 0.0;
+        for (NodeOrder order : options.orders) {
+            std::cerr << "节点重排 " << NodeOrdering::getName(order) << "..." << std::endl;
+            MapEngine orderedEngine;
+            orderedEngine.setQueueType(options.queues.front());
+            orderedEngine.setNodeOrder(order);
+            auto start = std::chrono::steady_clock::now();
+            if (!orderedEngine.loadMap(textFile)) {
+                continue;
+            }
+            double orderLoadSeconds = secondsSince(start);
+            std::shared_ptr<const MapSnapshot> orderedSnapshot = orderedEngine.getSnapshot();
+            for (size_t i = 0; i < std::min<size_t>(queries.size(), 10); ++i) {
+                orderedSnapshot->findPath(queries[i].first, queries[i].second, strategy,
+                                          SearchAlgorithm::DIJKSTRA);
+            }
+            std::vector<double> latencies;
+            latencies.reserve(queries.size());
+            for (const std::pair<int, int>& query : queries) {
+                auto queryStart = std::chrono::steady_clock::now();
+                orderedSnapshot->findPath(query.first, query.second, strategy,
+                                          SearchAlgorithm::DIJKSTRA);
+                latencies.push_back(secondsSince(queryStart) * 1e6);
+            }
+            LatencyStats stats = computeStats(latencies);
+            if (first) {
+                baseline = stats.mean;
+            }
+            json << (first ? "\n" : ",\n");
+            first = false;
+            json << "    {\"order\": \"" << NodeOrdering::getName(order)
+                 << "\", \"workload\": \"" << workloadName(options.workloads.front())
+                 << "\", \"strategy\": \"" << strategyName(strategy)
+                 << "\", \"queue\": \"" << queueName(options.queues.front())
+                 << "\", \"load_seconds\": " << orderLoadSeconds
+                 << ", \"mean_edge_span\": "
+                 << NodeOrdering::averageEdgeSpan(orderedSnapshot->getGraph())
+                 << ", \"latency_us\": {\"mean\": " << stats.mean << ", \"p50\": " << stats.p50
+                 << ", \"p90\": " << stats.p90 << ", \"p99\": " << stats.p99
+                 << ", \"max\": " << stats.max << "}"
+                 << ", \"speedup\": " << (stats.mean > 0 ? baseline / stats.mean : 0.0) << "}";
+        }
+    }
+    json << "\n  ],\n";
+
+    // ---------- 整图最短路径树：顺序 Dijkstra 与各线程数的 delta-stepping 对比 ----------
+    json << "  \"delta_stepping\": [";
+    first = true;
+    if (options.ssspSources > 0 && graph.getNodeCount() > 0) {
+        PathStrategy strategy = options.strategies.front();
+        std::vector<std::pair<int, int>> queries = GraphGenerator::generateQueries(
+            graph, options.ssspSources, QueryWorkload::RANDOM, options.seed + 4, options.walkLength);
+        std::vector<size_t> threadCounts;
+        for (size_t t = 1; t < engine.getThreadCount(); t *= 2) {
+            threadCounts.push_back(t);
+        }
+        threadCounts.push_back(engine.getThreadCount());
+
+        // 基准：无预算的一对多 Dijkstra，同时记录距离用于核对
+        std::cerr << "整图最短路径树 / dijkstra..." << std::endl;
+        std::vector<std::vector<double>> referenceDistances;
+        std::vector<ReachableNode> table;
+        double dijkstraSeconds = 0.0;
+        for (const std::pair<int, int>& query : queries) {
+            auto start = std::chrono::steady_clock::now();
+            snapshot->reachableWithin(query.first, std::numeric_limits<double>::infinity(),
+                                      strategy, table);
+            dijkstraSeconds += secondsSince(start);
+            std::vector<double> distances(graph.getNodeCount(), ShortestPathTree::UNREACHABLE);
+            for (const ReachableNode& item : table) {
+                distances[graph.getIndex(item.node)] = item.cost;
+            }
+            referenceDistances.push_back(std::move(distances));
+        }
+        double dijkstraMean = dijkstraSeconds / queries.size();
+
+        ShortestPathTree tree;
+        for (double delta : options.deltas) {
+            for (size_t threadCount : threadCounts) {
+                std::cerr << "整图最短路径树 / delta-stepping (delta = " << delta << ", "
+                          << threadCount << " 线程)..." << std::endl;
+                ThreadPool pool(threadCount);
+                double seconds = 0.0;
+                size_t phases = 0;
+                size_t mismatches = 0;
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    auto start = std::chrono::steady_clock::now();
+                    snapshot->shortestPathTree(queries[i].first, strategy, delta, tree, &pool);
+                    seconds += secondsSince(start);
+                    phases += tree.phases;
+                    mismatches += tree.distances == referenceDistances[i] ? 0 : 1;
+                }
+                double mean = seconds / queries.size();
+                json << (first ? "\n" : ",\n");
+                first = false;
+                json << "    {\"strategy\": \"" << strategyName(strategy)
+                     << "\", \"sources\": " << queries.size()
+                     << ", \"threads\": " << threadCount
+                     << ", \"delta\": " << tree.delta
+                     << ", \"phases\": " << phases / queries.size()
+                     << ", \"mismatches\": " << mismatches
+                     << ", \"mean_seconds\": " << mean
+                     << ", \"dijkstra_seconds\": " << dijkstraMean
+                     << ", \"speedup\": " << (mean > 0 ? dijkstraMean / mean : 0.0) << "}";
+            }
+        }
+    }
+    json << "\n  ]\n}\n";
+
+    if (!options.keepFiles) {
+        if (options.mapFile.empty()) {
+            std::remove(textFile.c_str());
+        }
+        std::remove(binaryFile.c_str());
+    }
+
+    std::cout.rdbuf(stdoutBuffer);
+    if (options.output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream out(options.output);
+        out << json.str();
+        if (!out) {
+            std::cerr << "错误: 无法写入结果文件 " << options.output << std::endl;
+            return 1;
+        }
+        std::cerr << "结果已写入 " << options.output << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef ARRAYVIEW_H
+#define ARRAYVIEW_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief 只读数组
+ * 数据或者由自身的 std::vector 持有，或者指向外部内存（例如映射的二进制地图文件）。
+ * 读取时只是一次指针访问，与 std::vector 相同；外部内存的生命周期由使用者保证。
+ */
+template <typename T>
+class ArrayView {
+public:
+    ArrayView() : data_(nullptr), size_(0) {}
+
+    // 禁止拷贝构造和赋值（视图指向自身存储时拷贝会悬空）
+    ArrayView(const ArrayView&) = delete;
+    ArrayView& operator=(const ArrayView&) = delete;
+
+    /**
+     * @brief 接管一个 vector 作为自有存储
+     * @param values 数据
+     */
+    void assign(std::vector<T>&& values) {
+        storage_ = std::move(values);
+        data_ = storage_.data();
+        size_ = storage_.size();
+    }
+
+    /**
+     * @brief 指向外部内存（释放自有存储）
+     * @param data 数据起始地址
+     * @param size 元素个数
+     */
+    void view(const T* data, size_t size) {
+        std::vector<T>().swap(storage_);
+        data_ = data;
+        size_ = size;
+    }
+
+    /**
+     * @brief 清空并释放自有存储
+     */
+    void clear() {
+        std::vector<T>().swap(storage_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    /**
+     * @brief 自有存储占用的内存（字节），外部内存不计入
+     */
+    size_t getMemoryUsage() const { return storage_.capacity() * sizeof(T); }
+
+private:
+    std::vector<T> storage_;
+    const T* data_;
+    size_t size_;
+};
+
+#endif // ARRAYVIEW_H
@@ -0,0 +1,65 @@
+#ifndef BINARYMAP_H
+#define BINARYMAP_H
+
+#include "MapSnapshot.h"
+#include "NodeOrdering.h"
+#include <string>
+#include <memory>
+#include <cstdint>
+
+/**
+ * @brief 二进制地图文件（图快照）
+ * 文件布局（本机字节序，段数据按 64 字节对齐）：
+ *   文件头：魔数 "PEMAPBIN"、版本、字节序标记、文件大小、节点数、边数、ID基址、段数、
+ *           负载校验和、头部校验和
+ *   段表：每段的类型、元素大小、偏移、元素个数和附加参数
+ *   段数据：CSR 数组、ID 映射、距离和时间两组权重，以及可选的地标表和每个策略的收缩层次
+ * 加载时映射整个文件，图和预处理数据的数组直接指向映射的页，不做复制也不重建；
+ * 多个进程（包括 fork 出的工作进程）映射同一文件时共享这些物理页。
+ */
+class BinaryMap {
+public:
+    // 文件格式版本
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    /**
+     * @brief 文件是否为二进制地图（只检查魔数）
+     * @param filename 文件名
+     * @return 是否为二进制地图
+     */
+    static bool isBinaryMap(const std::string& filename);
+
+    /**
+     * @brief 保存快照中的图及其预处理数据
+     * 先写入临时文件再改名，正在映射旧文件的进程不受影响
+     * @param filename 文件名
+     * @param snapshot 地图快照
+     * @return 是否成功
+     */
+    static bool save(const std::string& filename, const MapSnapshot& snapshot);
+
+    /**
+     * @brief 映射并加载二进制地图（零拷贝）
+     * 总是校验文件头、段表和数组尺寸；verifyChecksum 为 true 时再校验整个负载的校验和
+     * （需要读入所有页）
+     * @param filename 文件名
+     * @param verifyChecksum 是否校验负载
+     * @return 地图快照，失败时为空
+     */
+    static std::shared_ptr<const MapSnapshot> load(const std::string& filename, bool verifyChecksum);
+
+    /**
+     * @brief 把文本格式地图转换为二进制地图
+     * @param textFilename 文本地图文件
+     * @param binaryFilename 输出的二进制地图文件
+     * @param landmarkCount 预处理的地标数量，0 表示不生成地标表
+     * @param buildHierarchies 是否为两种策略生成收缩层次
+     * @param order 节点重排方式，重排后的顺序保存在二进制地图中
+     * @return 是否成功
+     */
+    static bool convertTextMap(const std::string& textFilename, const std::string& binaryFilename,
+                               int landmarkCount, bool buildHierarchies,
+                               NodeOrder order = NodeOrder::ORIGINAL);
+};
+
+#endif // BINARYMAP_H
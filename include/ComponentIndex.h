@@ -0,0 +1,82 @@
+#ifndef COMPONENTINDEX_H
+#define COMPONENTINDEX_H
+
+#include "Graph.h"
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief 连通分量统计
+ */
+struct ComponentStats {
+    size_t componentCount;          // 连通分量数（孤立点各算一个）
+    size_t largestComponentSize;    // 最大连通分量的节点数
+    size_t isolatedNodeCount;       // 孤立点数
+    
+    ComponentStats() : componentCount(0), largestComponentSize(0), isolatedNodeCount(0) {}
+};
+
+/**
+ * @brief 连通分量索引
+ * 对冻结的图做一次广度优先遍历，为每个节点标记所属连通分量（图是无向的）。
+ * 分量编号按大小降序排列，编号 0 是最大的连通分量。
+ * 起点和终点不在同一分量的查询无需搜索即可判定不可达。
+ */
+class ComponentIndex {
+public:
+    // 节点不存在时的分量编号
+    static constexpr int NO_COMPONENT = -1;
+    
+    ComponentIndex();
+    ~ComponentIndex();
+    
+    // 禁止拷贝构造和赋值
+    ComponentIndex(const ComponentIndex&) = delete;
+    ComponentIndex& operator=(const ComponentIndex&) = delete;
+    
+    /**
+     * @brief 计算连通分量标号
+     * @param graph 已冻结的图
+     */
+    void build(const Graph& graph);
+    
+    /**
+     * @brief 按稠密下标获取所属分量
+     * @param index 节点下标
+     * @return 分量编号
+     */
+    int getComponentAt(int index) const { return labels_[index]; }
+    
+    /**
+     * @brief 两个下标是否在同一连通分量
+     */
+    bool isConnectedAt(int a, int b) const { return labels_[a] == labels_[b]; }
+    
+    /**
+     * @brief 连通分量数
+     */
+    size_t getComponentCount() const { return sizes_.size(); }
+    
+    /**
+     * @brief 分量的节点数
+     * @param component 分量编号
+     * @return 节点数，编号无效时为 0
+     */
+    size_t getComponentSize(int component) const;
+    
+    /**
+     * @brief 分量统计
+     */
+    ComponentStats getStats() const;
+    
+    /**
+     * @brief 占用的内存（字节）
+     */
+    size_t getMemoryUsage() const;
+    
+private:
+    std::vector<int> labels_;   // 每个节点所属分量
+    std::vector<int> sizes_;    // 每个分量的节点数（降序）
+};
+
+#endif // COMPONENTINDEX_H
@@ -0,0 +1,190 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include "Graph.h"
+#include "Strategy.h"
+#include "ArrayView.h"
+#include "PriorityQueue.h"
+#include "SearchStats.h"
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+/**
+ * @brief 收缩层次（Contraction Hierarchies）
+ * 预处理按边差（添加的捷径数 - 删除的边数）为节点排序，依次收缩节点：
+ * 对收缩节点的每对邻居做见证搜索，不存在不经过该节点的更短路径时插入捷径。
+ * 收缩完成后每个节点只保留指向更高层次节点的"向上"边（原始边和捷径）。
+ * 查询在向上图上做双向Dijkstra（带 stall-on-demand），最后把捷径递归展开为原始路径。
+ * 每个层次只对应一组边权重（一个 PathStrategy）。
+ */
+class ContractionHierarchy {
+public:
+    static constexpr double INFINITE_DISTANCE = std::numeric_limits<double>::max();
+    // 原始边（非捷径）的中间节点标记
+    static constexpr int NO_MIDDLE = -1;
+
+    ContractionHierarchy();
+    ~ContractionHierarchy();
+
+    // 禁止拷贝构造和赋值
+    ContractionHierarchy(const ContractionHierarchy&) = delete;
+    ContractionHierarchy& operator=(const ContractionHierarchy&) = delete;
+
+    /**
+     * @brief 预处理：节点排序、收缩并构建向上图
+     * @param graph 已冻结的图
+     * @param metric 使用的边权重
+     * @return 是否成功
+     */
+    bool build(const Graph& graph, PathStrategy metric);
+
+    /**
+     * @brief 权重变化后重新定制（只重新计算权重，不做见证搜索）
+     * previous 是 build 得到的层次时，按图的嵌套剖分顺序做一次符号消去，得到只依赖拓扑的
+     * 向上图（任意权重下都包含所需的全部捷径；收缩得到的顺序消去时填充边过多，不沿用）；
+     * previous 已是定制得到的层次时直接共享其向上图和节点顺序。之后自底向上一遍计算每条向上边的权重：
+     * 每个节点的每对向上邻居之间的边用经过该节点的路径改进。
+     * 用于实时路况更新后刷新时间策略的层次
+     * @param graph 已冻结的图（拓扑与 previous 构建时相同，权重已更新）
+     * @param previous 已构建或已定制的层次
+     * @return 新层次，previous 无效或与图不匹配时为空
+     */
+    static std::shared_ptr<ContractionHierarchy> customize(
+        const Graph& graph, const std::shared_ptr<const ContractionHierarchy>& previous);
+
+    /**
+     * @brief 增量定制：只重新计算受变化边影响的向上边
+     * 从变化的原始边出发按较低端点的层次从低到高传播，权重不变的边不再向上传播；
+     * previous 不是定制得到的层次时退化为完整定制
+     * @param graph 已冻结的图（拓扑与 previous 相同）
+     * @param previous 按旧权重定制的层次
+     * @param changedEdges 权重变化的边（端点稠密下标，无向）
+     * @return 新层次，失败时为空
+     */
+    static std::shared_ptr<ContractionHierarchy> customize(
+        const Graph& graph, const std::shared_ptr<const ContractionHierarchy>& previous,
+        const std::vector<std::pair<int, int>>& changedEdges);
+
+    /**
+     * @brief 点对点查询
+     * 搜索状态使用当前线程的 SearchWorkspace（FORWARD / BACKWARD 两个槽位）
+     * @param source 起点下标
+     * @param target 终点下标
+     * @param path 可选，输出展开后的路径（稠密下标，含起点和终点）
+     * @param stats 可选，累加搜索计数器
+     * @return 最短距离，不可达时为 INFINITE_DISTANCE
+     */
+    double query(int source, int target, std::vector<int>* path,
+                 SearchStats* stats = nullptr) const;
+
+    /**
+     * @brief 从一个节点出发的完整向上搜索（带 stall-on-demand），用于多对多查询
+     * 任意两点的最短距离等于两者向上搜索空间中公共节点上距离之和的最小值。
+     * 搜索状态使用当前线程 SearchWorkspace 的 FORWARD 槽位
+     * @param origin 出发节点下标
+     * @param space 输出确定的节点及其距离（key 为距离，node 为下标），被 stall 的节点不输出
+     */
+    void upwardSearch(int origin, std::vector<HeapEntry>& space) const;
+
+    /**
+     * @brief 是否已构建
+     */
+    bool isBuilt() const { return !rank_.empty(); }
+
+    /**
+     * @brief 是否由 customize 得到（向上图只依赖拓扑，可以增量定制）
+     */
+    bool isCustomizable() const { return !downOffsets_.empty(); }
+
+    /**
+     * @brief 层次对应的权重
+     */
+    PathStrategy getMetric() const { return metric_; }
+
+    /**
+     * @brief 节点在收缩顺序中的层次（越大越晚收缩）
+     */
+    int getRank(int index) const { return rank_[index]; }
+
+    /**
+     * @brief 插入的捷径数量
+     */
+    size_t getShortcutCount() const { return shortcutCount_; }
+
+    /**
+     * @brief 向上图中的边数
+     */
+    size_t getUpwardEdgeCount() const { return upTargets_.size(); }
+
+    /**
+     * @brief 层次占用的堆内存（字节），映射的文件不计入
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    // 二进制地图读写直接访问层次数组
+    friend class BinaryMap;
+
+    /**
+     * @brief 与 previous 共享向上图、反向索引和节点顺序
+     */
+    void shareStructure(const std::shared_ptr<const ContractionHierarchy>& previous);
+
+    /**
+     * @brief 按给定的节点顺序做符号消去，构建向上图和反向索引
+     */
+    void buildStructure(const Graph& graph, const int* rank);
+
+    /**
+     * @brief 按图的权重自底向上计算全部向上边的权重
+     */
+    void computeWeights(const Graph& graph);
+
+    /**
+     * @brief 从 previous 的权重出发，只重新计算受变化边影响的向上边
+     */
+    void updateWeights(const Graph& graph, const ContractionHierarchy& previous,
+                       const std::vector<std::pair<int, int>>& changedEdges);
+
+    /**
+     * @brief 按中间节点统计捷径数量
+     */
+    void countShortcuts();
+
+    /**
+     * @brief 在较低层次端点的向上边中查找连接两个节点的边
+     * @return 边在向上图中的位置，不存在时为 -1
+     */
+    int findUpwardEdge(int a, int b) const;
+
+    /**
+     * @brief 把向上图中的一条边展开为原始路径，依次追加 a 之后直到 b 的节点
+     */
+    void unpackEdge(int a, int b, std::vector<int>& path) const;
+
+    PathStrategy metric_;
+    size_t shortcutCount_;
+    ArrayView<int> rank_;
+
+    // 向上图（CSR）：节点 v 的向上边位于 [upOffsets_[v], upOffsets_[v+1])
+    ArrayView<int> upOffsets_;
+    ArrayView<int> upTargets_;
+    ArrayView<double> upWeights_;
+    ArrayView<int> upMiddles_;     // 捷径的中间节点，原始边为 NO_MIDDLE
+
+    // 定制得到的层次的反向索引（CSR）：节点 v 作为较高端点的向上边，
+    // [downOffsets_[v], downOffsets_[v+1]) 中是较低端点和边在向上图中的位置；build 得到的层次为空
+    ArrayView<int> downOffsets_;
+    ArrayView<int> downSources_;
+    ArrayView<int> downEdges_;
+
+    // 数组指向映射文件时持有该文件
+    std::shared_ptr<const MappedFile> mapping_;
+    // 共享结构数组时持有其所属的层次
+    std::shared_ptr<const ContractionHierarchy> base_;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
@@ -11,7 +11,9 @@
 
 /**
  * @brief 数据加载器类
- * 负责从文件读取地图数据并构建图
+ * 负责从文件读取地图数据并构建图。
+ * loadFromFile 把文件映射到内存，在换行处把文件切成若干块并行解析（std::from_chars），
+ * 再按文件顺序把解析结果加入图，结果与逐行读取完全一致。
  */
 class DataLoader {
 public:
@@ -24,7 +26,11 @@ public:
     
     /**
      * @brief 从文件加载数据并构建图
-     * 文件格式：每行一条边，格式为 "from to distance time"
+     * 文件格式：每行一条边，格式为 "from to distance time"；
+     * 只有一个节点ID的行声明一个节点（用于表示孤立点）。
+     * 每条边同时保存距离和时间；距离或时间不为正的边会被跳过。
+     * 同一对节点（不分方向）出现在多行时以最后一行的距离和时间为准，只算一条边。
+     * 加载完成后图已冻结为CSR存储；格式错误的行会被跳过并给出行号警告
      * @param filename 文件名
      * @param graph 要填充的图对象
      * @return 是否加载成功
@@ -57,22 +63,53 @@ public:
      * @return 边数量
      */
     size_t getLoadedEdgeCount() const;
+    
+    /**
+     * @brief 设置 loadFromFile 解析使用的线程数
+     * @param threadCount 线程数，0 表示使用硬件线程数
+     */
+    void setThreadCount(size_t threadCount);
+    
+    /**
+     * @brief 最后一次 loadFromFile 的耗时
+     * @return 秒
+     */
+    double getLastLoadSeconds() const;
+    
+    /**
+     * @brief 最后一次 loadFromFile 的吞吐量
+     * @return MB/s（文件字节数 / 总耗时）
+     */
+    double getLastThroughput() const;
 
 private:
     size_t lastNodeCount_;
     size_t lastEdgeCount_;
+    size_t threadCount_;
+    double lastLoadSeconds_;
+    double lastThroughput_;
     
     /**
-     * @brief 解析一行数据
-     * @param line 输入行
+     * @brief 解析一行数据 "from to distance time"
+     * @param begin 行起始
+     * @param end 行结束（不含换行符）
      * @param from 输出的起始节点
      * @param to 输出的目标节点
      * @param distance 输出的距离
      * @param time 输出的时间
      * @return 是否解析成功
      */
-    bool parseLine(const std::string& line, int& from, int& to, 
-                   double& distance, double& time);
+    static bool parseLine(const char* begin, const char* end, int& from, int& to,
+                          double& distance, double& time);
+    
+    /**
+     * @brief 解析节点声明行（只包含一个节点ID）
+     * @param begin 行起始
+     * @param end 行结束（不含换行符）
+     * @param nodeId 输出的节点ID
+     * @return 是否解析成功
+     */
+    static bool parseNodeLine(const char* begin, const char* end, int& nodeId);
 };
 
 #endif // DATALOADER_H
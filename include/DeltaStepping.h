@@ -0,0 +1,62 @@
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include "Graph.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief 一对多最短路径树，按稠密下标存放（Graph::getNodeId 转换为外部ID）
+ */
+struct ShortestPathTree {
+    // 不可达节点的距离
+    static constexpr double UNREACHABLE = std::numeric_limits<double>::infinity();
+
+    int source;                     // 起点的稠密下标
+    std::vector<double> distances;  // distances[v]：起点到 v 的最短距离，不可达为 UNREACHABLE
+    std::vector<int> parents;       // parents[v]：树上的前驱下标，起点为自身，不可达为 -1
+    double delta;                   // 实际使用的桶宽
+    size_t phases;                  // 松弛轮数（每轮两次并行遍历：生成请求、应用请求）
+    int64_t elapsedMicroseconds;    // 执行时间（微秒）
+
+    ShortestPathTree() : source(-1), delta(0.0), phases(0), elapsedMicroseconds(0) {}
+};
+
+/**
+ * @brief 并行 delta-stepping 一对多最短路径
+ * 暂定距离按桶宽 delta 分桶，从小到大处理各桶：桶内节点反复松弛轻边（权重不超过 delta），
+ * 直到桶不再有新节点，再一次性松弛已确定节点的重边。每轮松弛分两步：各线程为自己负责的
+ * 节点生成松弛请求并按目标节点的归属分组，然后各线程只应用发给自己的请求。节点按 64 个
+ * 一组轮流分给各线程，每个节点的距离、前驱和桶只由一个线程写入，不需要原子操作；
+ * 同一轮中距离相同的请求取前驱下标最小者，固定线程数时结果是确定的。
+ * delta 越小轮数越多、重复松弛越少（趋近 Dijkstra），越大每轮并行的工作越多、
+ * 重复松弛越多（趋近 Bellman-Ford）。
+ */
+class DeltaStepping {
+public:
+    /**
+     * @brief 计算单源最短路径树
+     * @param graph 已冻结的图（无向图，每条边的两条弧权重相同）
+     * @param weights 与 graph.getTargets() 对齐的非负权重，非有限值的弧视为不存在
+     * @param source 起点的稠密下标
+     * @param delta 桶宽，不大于 0 时使用 suggestDelta；桶数超过上限时自动放大
+     * @param pool 可选的线程池，为空时在调用线程中串行执行
+     * @param tree 输出：距离和前驱数组（复用其容量）
+     * @return 图已冻结且起点有效时为 true
+     */
+    static bool run(const Graph& graph, const double* weights, int source, double delta,
+                    ThreadPool* pool, ShortestPathTree& tree);
+
+    /**
+     * @brief 默认桶宽：有限弧权重平均值的若干倍
+     * @param graph 已冻结的图
+     * @param weights 弧权重
+     * @return 桶宽，没有正权重的弧时为 1
+     */
+    static double suggestDelta(const Graph& graph, const double* weights);
+};
+
+#endif // DELTASTEPPING_H
@@ -1,95 +1,347 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "Strategy.h"
+#include "ArrayView.h"
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <cstdint>
+#include <cstddef>
+
+class MappedFile;
 
 /**
  * @brief 边结构体，表示图中的一条边
  */
 struct Edge {
-    int to;           // 目标节点ID
-    double weight;    // 边的权重（距离或时间）
-    
-    Edge(int t, double w) : to(t), weight(w) {}
+    int to;           // 目标节点：getAdjacentEdges 中为外部ID，getEdgesAt 中为稠密下标
+    double distance;  // 边的距离
+    double time;      // 通过该边所需的时间
+
+    Edge(int t, double d, double tm) : to(t), distance(d), time(tm) {}
+
+    /**
+     * @brief 按策略取边的权重
+     * @param strategy 策略类型
+     * @return 距离或时间
+     */
+    double getWeight(PathStrategy strategy) const {
+        return strategy == PathStrategy::LEAST_TIME ? time : distance;
+    }
+};
+
+/**
+ * @brief 邻接边区间
+ * CSR 存储中某个节点的一段连续邻接边的只读视图，不持有数据。
+ * 给出下标到外部ID的映射时，边的目标转换为外部ID，否则为稠密下标
+ */
+class EdgeRange {
+public:
+    class Iterator {
+    public:
+        Iterator(const int* target, const double* distance, const double* time, const int* ids)
+            : target_(target), distance_(distance), time_(time), ids_(ids) {}
+
+        Edge operator*() const {
+            return Edge(ids_ ? ids_[*target_] : *target_, *distance_, *time_);
+        }
+
+        Iterator& operator++() {
+            ++target_;
+            ++distance_;
+            ++time_;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const { return target_ != other.target_; }
+        bool operator==(const Iterator& other) const { return target_ == other.target_; }
+
+    private:
+        const int* target_;
+        const double* distance_;
+        const double* time_;
+        const int* ids_;
+    };
+
+    EdgeRange() : targets_(nullptr), distances_(nullptr), times_(nullptr), ids_(nullptr), size_(0) {}
+    EdgeRange(const int* targets, const double* distances, const double* times, size_t size,
+              const int* ids = nullptr)
+        : targets_(targets), distances_(distances), times_(times), ids_(ids), size_(size) {}
+
+    Iterator begin() const { return Iterator(targets_, distances_, times_, ids_); }
+    Iterator end() const {
+        return Iterator(targets_ + size_, distances_ + size_, times_ + size_, ids_);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    Edge operator[](size_t i) const {
+        return Edge(ids_ ? ids_[targets_[i]] : targets_[i], distances_[i], times_[i]);
+    }
+
+private:
+    const int* targets_;
+    const double* distances_;
+    const double* times_;
+    const int* ids_;        // 下标 -> 外部ID，为空时目标保持稠密下标
+    size_t size_;
 };
 
 /**
  * @brief 无向带权图类
- * 使用邻接表存储，优化大规模节点检索性能
+ * 构建阶段通过 addNode/addEdge 收集节点和边，finalize 后冻结为 CSR（压缩稀疏行）存储：
+ * 外部节点ID被一次性映射为 [0, n) 的稠密下标，邻接边的目标和权重按下标连续存放，
+ * 搜索时的邻接访问只是数组下标运算，不再有哈希查找和分散的堆内存块。
+ * 每条边同时保存距离和时间两组权重，搜索时按策略选择其中一组，切换策略无需重建图。
+ * 冻结后的数组可以直接指向映射的二进制地图文件（见 BinaryMap），此时不占用堆内存。
  */
 class Graph {
 public:
+    // 无效下标（节点不存在）
+    static constexpr int INVALID_INDEX = -1;
+
     Graph();
     ~Graph();
-    
+
     // 禁止拷贝构造和赋值
     Graph(const Graph&) = delete;
     Graph& operator=(const Graph&) = delete;
-    
+
     /**
      * @brief 添加节点
+     * 在 finalize 之后调用会使图回到构建状态，需要再次 finalize
      * @param nodeId 节点ID
      */
     void addNode(int nodeId);
-    
+
     /**
      * @brief 添加无向边
+     * 在 finalize 之后调用会使图回到构建状态，需要再次 finalize；
+     * 两个节点之间已有边时，finalize 后以最后添加的边为准
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param distance 边的距离
+     * @param time 通过该边所需的时间
+     */
+    void addEdge(int from, int to, double distance, double time);
+
+    /**
+     * @brief 添加无向边（距离和时间使用同一权重）
      * @param from 起始节点
      * @param to 目标节点
      * @param weight 边的权重
      */
     void addEdge(int from, int to, double weight);
-    
+
+    /**
+     * @brief 预留构建阶段的容量（批量加载时避免反复扩容和重新哈希）
+     * @param nodeCount 预计节点数
+     * @param edgeCount 预计边数
+     */
+    void reserve(size_t nodeCount, size_t edgeCount);
+
+    /**
+     * @brief 冻结图结构，生成CSR存储
+     * 同一节点的邻接边保持添加顺序；同一对节点之间（不分方向）重复添加的边只保留最后一条，
+     * 边数按保留的边计算。构建阶段的临时数据会被释放
+     */
+    void finalize();
+
     /**
-     * @brief 获取节点的邻接边列表
+     * @brief 图是否已冻结为CSR存储
+     * @return 是否已冻结
+     */
+    bool isFinalized() const;
+
+    /**
+     * @brief 获取节点的邻接边列表（需已 finalize）
      * @param nodeId 节点ID
-     * @return 邻接边列表的引用
+     * @return 邻接边区间，边的目标为外部节点ID；节点不存在时为空区间
      */
-    const std::vector<Edge>& getAdjacentEdges(int nodeId) const;
-    
+    EdgeRange getAdjacentEdges(int nodeId) const;
+
     /**
      * @brief 检查节点是否存在
      * @param nodeId 节点ID
      * @return 是否存在
      */
     bool hasNode(int nodeId) const;
-    
+
     /**
      * @brief 获取图中节点总数
      * @return 节点数量
      */
     size_t getNodeCount() const;
-    
+
     /**
      * @brief 获取图中边的总数
      * @return 边的数量
      */
     size_t getEdgeCount() const;
-    
+
     /**
      * @brief 检查节点是否为孤立点
      * @param nodeId 节点ID
      * @return 是否为孤立点
      */
     bool isIsolated(int nodeId) const;
-    
+
     /**
      * @brief 清空图
      */
     void clear();
 
+    // ---------- 稠密下标接口（供搜索算法使用） ----------
+
+    /**
+     * @brief 外部节点ID转换为稠密下标
+     * ID 紧凑时为一次数组访问，否则在按ID排序的数组中二分查找（构建阶段为哈希查找）
+     * @param nodeId 节点ID
+     * @return 稠密下标，不存在时返回 INVALID_INDEX
+     */
+    int getIndex(int nodeId) const;
+
+    /**
+     * @brief 稠密下标转换为外部节点ID
+     * @param index 稠密下标
+     * @return 节点ID
+     */
+    int getNodeId(int index) const {
+        return finalized_ ? denseToExternal_[index] : pendingIds_[index];
+    }
+
+    /**
+     * @brief 按稠密下标获取邻接边区间（需已 finalize）
+     * @param index 稠密下标
+     * @return 邻接边区间，边的目标为稠密下标
+     */
+    EdgeRange getEdgesAt(int index) const {
+        int begin = offsets_[index];
+        return EdgeRange(targets_.data() + begin, distances_.data() + begin,
+                         times_.data() + begin,
+                         static_cast<size_t>(offsets_[index + 1] - begin));
+    }
+
+    /**
+     * @brief 按稠密下标获取节点度数（需已 finalize）
+     * @param index 稠密下标
+     * @return 度数
+     */
+    int getDegreeAt(int index) const { return offsets_[index + 1] - offsets_[index]; }
+
+    /**
+     * @brief CSR 原始数组（需已 finalize）
+     * 节点 i 的邻接边位于 [offsets[i], offsets[i+1])
+     */
+    const int* getOffsets() const { return offsets_.data(); }
+    const int* getTargets() const { return targets_.data(); }
+    const double* getDistances() const { return distances_.data(); }
+    const double* getTimes() const { return times_.data(); }
+
+    /**
+     * @brief 按策略选择权重数组（需已 finalize），O(1)
+     * @param strategy 策略类型
+     * @return 与 getTargets() 对齐的权重数组
+     */
+    const double* getWeights(PathStrategy strategy) const {
+        return strategy == PathStrategy::LEAST_TIME ? times_.data() : distances_.data();
+    }
+
+    /**
+     * @brief 计算图内容的校验和（FNV-1a，覆盖ID映射、CSR结构和两组权重）
+     * 用于校验与图一起保存的预处理数据是否仍然匹配（需已 finalize）
+     * @return 64位校验和
+     */
+    uint64_t computeChecksum() const;
+
+    /**
+     * @brief 按给定顺序重新分配稠密下标（见 NodeOrdering），外部ID不变
+     * 每个节点的邻接边保持原有的相对顺序；数组原来指向映射文件或另一张图时改为自有数组
+     * @param order order[新下标] = 旧下标，必须是 [0, n) 的一个排列
+     * @return 是否成功（图未冻结或 order 不是排列时失败，图保持不变）
+     */
+    bool reorder(const std::vector<int>& order);
+
+    /**
+     * @brief 估算图占用的堆内存（字节），映射的文件不计入
+     * @return 字节数
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @brief 冻结的数组是否指向映射的二进制地图文件
+     * @return 是否为映射
+     */
+    bool isMapped() const { return mapping_ != nullptr; }
+
+    /**
+     * @brief 生成只替换时间权重的新图（用于实时路况更新）
+     * 新图的CSR结构、距离和ID索引直接指向原图的数组，只有时间数组是新的；
+     * 新图持有原图的引用，原图在新图销毁之前保持有效
+     * @param graph 已冻结的原图
+     * @param times 每条有向弧的新时间，长度必须与 getTargets() 的弧数相同
+     * @return 新图，参数无效时为空
+     */
+    static std::shared_ptr<Graph> withTimes(const std::shared_ptr<const Graph>& graph,
+                                            std::vector<double>&& times);
+
 private:
-    // 邻接表：nodeId -> 邻接边列表
-    std::unordered_map<int, std::vector<Edge>> adjacencyList_;
-    
-    // 节点集合，用于快速查找
-    std::unordered_map<int, bool> nodes_;
-    
+    // 二进制地图读写直接访问冻结的数组
+    friend class BinaryMap;
+
+    // 构建阶段的边（端点为稠密下标）
+    struct PendingEdge {
+        int from;
+        int to;
+        double distance;
+        double time;
+    };
+
+    /**
+     * @brief 将已冻结的CSR还原为构建状态
+     */
+    void thaw();
+
+    /**
+     * @brief 构建阶段取得节点下标，节点不存在时创建（一次哈希查找）
+     * @param nodeId 节点ID
+     * @return 稠密下标
+     */
+    int internNode(int nodeId);
+
+    /**
+     * @brief 为外部ID建立查找结构（ID紧凑时使用直接寻址数组，否则使用有序数组）
+     */
+    void buildIdIndex();
+
+    // ---------- CSR 存储 ----------
+    ArrayView<int> offsets_;         // 大小 n+1
+    ArrayView<int> targets_;         // 每条有向弧的目标下标
+    ArrayView<double> distances_;    // 每条有向弧的距离
+    ArrayView<double> times_;        // 每条有向弧的时间
+
+    // ---------- ID 映射 ----------
+    ArrayView<int> denseToExternal_;         // 下标 -> 外部ID
+    ArrayView<int> idTable_;                 // (外部ID - idBase_) -> 下标，ID紧凑时使用
+    int idBase_;
+    ArrayView<int> sortedIds_;               // 升序的外部ID，ID稀疏时使用
+    ArrayView<int> sortedIndices_;           // 与 sortedIds_ 对应的下标
+    std::unordered_map<int, int> idMap_;     // 外部ID -> 下标，仅构建阶段使用
+
+    // ---------- 构建阶段数据 ----------
+    std::vector<int> pendingIds_;            // 下标 -> 外部ID
+    std::vector<PendingEdge> pendingEdges_;
+    std::vector<int> pendingDegree_;
+
+    // 冻结的数组指向映射文件时持有该文件
+    std::shared_ptr<const MappedFile> mapping_;
+    // 冻结的数组指向另一张图时持有该图（见 withTimes）
+    std::shared_ptr<const Graph> base_;
+
     // 边的数量（无向边算一条）
     size_t edgeCount_;
+    bool finalized_;
 };
 
 #endif // GRAPH_H
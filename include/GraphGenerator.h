@@ -0,0 +1,78 @@
+#ifndef GRAPHGENERATOR_H
+#define GRAPHGENERATOR_H
+
+#include "Graph.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/**
+ * @brief 查询负载类型
+ */
+enum class QueryWorkload {
+    RANDOM,     // 起点和终点在所有节点中均匀随机选取
+    LOCAL       // 终点由起点出发随机游走若干步得到（近距离查询）
+};
+
+/**
+ * @brief 合成图生成器（用于基准测试）
+ * 生成的图已冻结为CSR存储，节点ID为 0..n-1；相同参数和种子总是生成相同的图。
+ * 每条边的时间等于距离除以随机选取的道路速度等级，两种策略的最短路径因此不同。
+ */
+class GraphGenerator {
+public:
+    /**
+     * @brief 网格路网：rows x cols 个节点，上下左右相邻节点之间连边，距离在 [1, 100] 之间
+     * @param graph 要填充的图（原有内容被清空）
+     * @param rows 行数
+     * @param cols 列数
+     * @param seed 随机种子
+     */
+    static void generateGrid(Graph& graph, int rows, int cols, uint64_t seed);
+
+    /**
+     * @brief 随机几何图：节点均匀分布在正方形区域内，距离不超过半径的节点之间连边，
+     * 半径按期望平均度数确定；边的距离为欧氏距离。图不保证连通
+     * @param graph 要填充的图（原有内容被清空）
+     * @param nodeCount 节点数
+     * @param averageDegree 期望平均度数
+     * @param seed 随机种子
+     */
+    static void generateRandomGeometric(Graph& graph, int nodeCount, double averageDegree,
+                                        uint64_t seed);
+
+    /**
+     * @brief 无标度图（Barabási–Albert 优先连接）：从 m+1 个节点的完全图开始，
+     * 每个新节点按度数成比例地连向 m 个已有节点
+     * @param graph 要填充的图（原有内容被清空）
+     * @param nodeCount 节点数（不少于 m+1）
+     * @param edgesPerNode 每个新节点的边数 m
+     * @param seed 随机种子
+     */
+    static void generateScaleFree(Graph& graph, int nodeCount, int edgesPerNode, uint64_t seed);
+
+    /**
+     * @brief 生成查询负载
+     * @param graph 已冻结的图
+     * @param count 查询数量
+     * @param workload 负载类型
+     * @param seed 随机种子
+     * @param walkLength LOCAL 负载随机游走的步数
+     * @return 查询列表（外部节点ID）
+     */
+    static std::vector<std::pair<int, int>> generateQueries(const Graph& graph, size_t count,
+                                                            QueryWorkload workload, uint64_t seed,
+                                                            int walkLength = 32);
+
+    /**
+     * @brief 把图写成文本地图文件：先逐行声明节点，再每条无向边一行（权重按最短往返表示写出），
+     * 重新加载后得到完全相同的图
+     * @param graph 已冻结的图
+     * @param filename 文件名
+     * @return 是否成功
+     */
+    static bool writeMap(const Graph& graph, const std::string& filename);
+};
+
+#endif // GRAPHGENERATOR_H
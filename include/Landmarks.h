@@ -0,0 +1,231 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "Graph.h"
+#include "Strategy.h"
+#include "ArrayView.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief 地标选择方法
+ */
+enum class LandmarkSelection {
+    FARTHEST,   // 最远点选择：每次选距离已选地标集合最远的节点
+    AVOID       // Avoid 选择：在最短路径树中选择当前下界最差的子树的叶子
+};
+
+/**
+ * @brief ALT 地标表（A*、地标、三角不等式）
+ * 预处理阶段选出 k 个地标，并按距离和时间两组权重分别保存每个节点到每个地标的最短距离。
+ * 图是无向的，节点到地标和地标到节点的距离相同，因此每组权重只需一张表。
+ * 查询时由三角不等式得到到终点的下界：h(v) = max_i |d(L_i, t) - d(L_i, v)|。
+ * 表按节点优先存放（节点 v 的 k 个距离连续），计算下界时只访问一条缓存行附近的数据。
+ */
+class Landmarks {
+public:
+    // 文件格式版本
+    static constexpr uint32_t FILE_VERSION = 1;
+    // 单次查询最多使用的地标数
+    static constexpr int MAX_ACTIVE = 64;
+
+    Landmarks();
+    ~Landmarks();
+
+    // 禁止拷贝构造和赋值
+    Landmarks(const Landmarks&) = delete;
+    Landmarks& operator=(const Landmarks&) = delete;
+
+    /**
+     * @brief 选择地标并计算距离表
+     * @param graph 已冻结的图
+     * @param count 地标数量（不超过节点数）
+     * @param selection 选择方法
+     * @return 是否成功
+     */
+    bool build(const Graph& graph, int count, LandmarkSelection selection);
+
+    /**
+     * @brief 时间权重变化后生成新地标表：沿用原表的地标和距离表，按新时间重新计算时间表
+     * 距离表直接指向原表的数组，新表持有原表的引用
+     * （只有时间增加时原时间表仍是有效的下界，调用方可以继续使用原表）
+     * @param landmarks 原地标表
+     * @param graph 只更新了时间的新图
+     * @return 新地标表，原表为空或与图不匹配时为空
+     */
+    static std::shared_ptr<Landmarks> withTimes(const std::shared_ptr<const Landmarks>& landmarks,
+                                                const Graph& graph);
+
+    /**
+     * @brief 时间减小后、新时间表算好之前使用的地标表：沿用原表的地标和距离表，没有时间表
+     * （原时间表可能高估新权重下的距离，不再是下界；时间策略的 ALT 搜索暂时退化）
+     * @param landmarks 原地标表
+     * @return 新地标表，原表为空时为空
+     */
+    static std::shared_ptr<Landmarks> withoutTimes(const std::shared_ptr<const Landmarks>& landmarks);
+
+    /**
+     * @brief 时间减小后立即可用的地标表：沿用原表的全部数组，时间表的下界整体乘以 factor
+     * 原表在权重 w 下一致（|h(u) - h(v)| <= w(u, v)），时间变为 w' 且每条边都有
+     * w' >= factor * w 时，缩放后的下界在 w' 下仍然一致（A* 势函数保持可行）。
+     * 缩放因子可以连乘；新时间表在后台算好之前，时间策略的 ALT 搜索继续使用较松的下界
+     * @param landmarks 原地标表（须有时间表）
+     * @param graph 更新时间后的新图（只用于计算校验和）
+     * @param factor 缩放因子，取 (0, 1]
+     * @return 新地标表，原表为空或没有时间表时为空
+     */
+    static std::shared_ptr<Landmarks> withTimeScale(const std::shared_ptr<const Landmarks>& landmarks,
+                                                    const Graph& graph, double factor);
+
+    /**
+     * @brief 保存地标表到二进制文件
+     * @param filename 文件名
+     * @return 是否成功
+     */
+    bool save(const std::string& filename) const;
+
+    /**
+     * @brief 从二进制文件加载地标表，并校验与图是否匹配
+     * @param filename 文件名
+     * @param graph 已冻结的图
+     * @return 是否成功（文件不存在、格式错误或与图不匹配时返回false）
+     */
+    bool load(const std::string& filename, const Graph& graph);
+
+    /**
+     * @brief 地标数量
+     */
+    int getLandmarkCount() const { return landmarkCount_; }
+
+    /**
+     * @brief 选出地标的方法（重建地标表时沿用）
+     * 文件和二进制地图不保存选择方法，从中加载的表视为 AVOID
+     */
+    LandmarkSelection getSelection() const { return selection_; }
+
+    /**
+     * @brief 是否有某组权重的距离表（见 withoutTimes）
+     */
+    bool hasTable(PathStrategy strategy) const {
+        return landmarkCount_ > 0 &&
+               !(strategy == PathStrategy::LEAST_TIME ? timeTable_ : distanceTable_).empty();
+    }
+
+    /**
+     * @brief 某组权重的下界缩放因子（见 withTimeScale），距离表和未缩放的时间表为 1
+     */
+    double getScale(PathStrategy strategy) const {
+        return strategy == PathStrategy::LEAST_TIME ? timeScale_ : 1.0;
+    }
+
+    /**
+     * @brief 两个地标表是否是同一组地标（共享同一张距离表，只有时间表不同）
+     */
+    bool sharesDistanceTable(const Landmarks& other) const {
+        return landmarkCount_ > 0 && distanceTable_.data() == other.distanceTable_.data();
+    }
+
+    /**
+     * @brief 地标的稠密下标
+     */
+    const std::vector<int>& getLandmarkIndices() const { return landmarkIndices_; }
+
+    /**
+     * @brief 获取节点到各地标的距离（需 getLandmarkCount() 个连续元素）
+     * @param strategy 选择距离表或时间表
+     * @param index 节点稠密下标
+     * @return 指向该节点距离行的指针，不可达的地标为无穷大
+     */
+    const double* getRow(PathStrategy strategy, int index) const {
+        const ArrayView<double>& table =
+            strategy == PathStrategy::LEAST_TIME ? timeTable_ : distanceTable_;
+        return table.data() + static_cast<size_t>(index) * landmarkCount_;
+    }
+
+    /**
+     * @brief 为一次查询挑选下界最大的若干个地标
+     * @param strategy 策略类型
+     * @param source 起点下标
+     * @param target 终点下标
+     * @param maxActive 最多使用的地标数（不超过 MAX_ACTIVE）
+     * @param active 输出的地标序号（在表行中的位置），容量至少为 maxActive
+     * @return 实际挑选的数量
+     */
+    int selectActive(PathStrategy strategy, int source, int target,
+                     int maxActive, int* active) const;
+
+    /**
+     * @brief 计算节点到终点的下界
+     * @param targetRow 终点的距离行
+     * @param row 节点的距离行
+     * @param active 使用的地标序号
+     * @param activeCount 地标数
+     * @return 下界（非负）
+     */
+    static double lowerBound(const double* targetRow, const double* row,
+                             const int* active, int activeCount) {
+        double bound = 0.0;
+        for (int i = 0; i < activeCount; ++i) {
+            double dt = targetRow[active[i]];
+            double dv = row[active[i]];
+            // 地标与某一端不连通时该地标不提供信息
+            if (dt == INFINITE_DISTANCE || dv == INFINITE_DISTANCE) {
+                continue;
+            }
+            double diff = dt > dv ? dt - dv : dv - dt;
+            if (diff > bound) {
+                bound = diff;
+            }
+        }
+        return bound;
+    }
+
+    /**
+     * @brief 地标表占用的堆内存（字节），映射的文件不计入
+     */
+    size_t getMemoryUsage() const;
+
+    static constexpr double INFINITE_DISTANCE = std::numeric_limits<double>::max();
+
+private:
+    // 二进制地图读写直接访问地标表
+    friend class BinaryMap;
+
+    /**
+     * @brief 最远点选择
+     * @param table 选择过程中逐列填充的距离表
+     */
+    void selectFarthest(const Graph& graph, int count, std::vector<double>& table);
+
+    /**
+     * @brief Avoid 选择
+     * @param table 选择过程中逐列填充的距离表
+     */
+    void selectAvoid(const Graph& graph, int count, std::vector<double>& table);
+
+    /**
+     * @brief 以已选地标为行，填充某组权重的距离表
+     */
+    void fillTable(const Graph& graph, const double* weights, std::vector<double>& table) const;
+
+    int landmarkCount_;
+    size_t nodeCount_;
+    uint64_t graphChecksum_;
+    LandmarkSelection selection_;
+    std::vector<int> landmarkIndices_;
+    ArrayView<double> distanceTable_;     // [节点][地标]，距离权重
+    ArrayView<double> timeTable_;         // [节点][地标]，时间权重
+    double timeScale_;                    // 时间表下界的缩放因子（见 withTimeScale）
+
+    // 距离表指向映射文件时持有该文件
+    std::shared_ptr<const MappedFile> mapping_;
+    // 距离表指向另一地标表时持有该表（见 withTimes）
+    std::shared_ptr<const Landmarks> base_;
+    // 时间表指向另一地标表时持有该表（见 withTimeScale）
+    std::shared_ptr<const Landmarks> timeBase_;
+};
+
+#endif // LANDMARKS_H
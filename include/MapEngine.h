@@ -5,16 +5,106 @@
 #include "PathFinder.h"
 #include "DataLoader.h"
 #include "Strategy.h"
-#include "PairHash.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "MapSnapshot.h"
+#include "ThreadPool.h"
+#include "BinaryMap.h"
+#include "PathCache.h"
+#include "NodeOrdering.h"
+#include "QueryMetrics.h"
+#include "RcuSlot.h"
+#include "SnapshotReaper.h"
 #include <string>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 #include <utility>
-#include <functional>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+/**
+ * @brief 一条边的时间更新（实时路况）
+ */
+struct EdgeTimeUpdate {
+    int from;       // 端点ID（无向边，两个方向同时更新）
+    int to;         // 端点ID
+    double time;    // 新的通行时间（正数）
+};
+
+/**
+ * @brief 带策略的查询（批量查询中每个查询可以使用不同的策略）
+ */
+struct PathQuery {
+    int from;               // 起始节点ID
+    int to;                 // 目标节点ID
+    PathStrategy strategy;  // 策略类型
+
+    PathQuery() : from(0), to(0), strategy(PathStrategy::SHORTEST_DISTANCE) {}
+    PathQuery(int f, int t, PathStrategy s) : from(f), to(t), strategy(s) {}
+};
+
+/**
+ * @brief 批量查询的结果缓冲区（见 MapEngine::findPaths 的 PathBatch 重载）
+ * 查询按分块分给线程，每块的路径写入该块自己的 PathArena，结果的 span 指向其中。
+ * 同一个 PathBatch 在多次批量查询之间复用时，结果数组和路径缓冲区都保留容量，
+ * 查询不再分配内存。结果和 span 在下一次用它查询或其销毁之前有效
+ */
+class PathBatch {
+public:
+    PathBatch() {}
+
+    // 禁止拷贝构造和赋值
+    PathBatch(const PathBatch&) = delete;
+    PathBatch& operator=(const PathBatch&) = delete;
+
+    size_t size() const { return results_.size(); }
+    const PathResult& operator[](size_t i) const { return results_[i]; }
+    const std::vector<PathResult>& getResults() const { return results_; }
+
+    /**
+     * @brief 路径缓冲区占用的内存（字节）
+     */
+    size_t getArenaMemoryUsage() const {
+        size_t bytes = 0;
+        for (const PathArena& arena : arenas_) {
+            bytes += arena.getMemoryUsage();
+        }
+        return bytes;
+    }
+
+private:
+    friend class MapEngine;
+
+    std::vector<PathResult> results_;
+    std::vector<PathArena> arenas_;     // 每个查询分块一个
+};
+
+/**
+ * @brief 后台重载地图的状态（见 MapEngine::startReload）
+ */
+struct ReloadStatus {
+    bool inProgress;            // 是否有重载正在进行
+    uint64_t succeeded;         // 成功发布的重载次数
+    uint64_t failed;            // 失败的重载次数（失败时继续使用原地图）
+    double buildSeconds;        // 最近一次重载加载和预处理的耗时（秒）
+    double drainSeconds;        // 最近一次发布到旧快照被释放的时间（秒），drained 为 true 时有效
+    bool drained;               // 最近一次发布替换的旧快照是否已释放（最后一个持有者放下后由回收线程释放）
+
+    ReloadStatus()
+        : inProgress(false), succeeded(0), failed(0), buildSeconds(0.0), drainSeconds(0.0),
+          drained(false) {}
+};
 
 /**
  * @brief 地图引擎核心类
- * 封装数据读取、图构建与路径搜索模块，支持多策略动态切换
+ * 封装数据读取、图构建与路径搜索模块，支持多策略动态切换。
+ * 已加载的地图以不可变快照（MapSnapshot）发布：查询方法是 const 的，可以在多个线程中同时调用；
+ * 加载地图和预处理等写操作相互串行，生成新快照后原子替换，不阻塞正在进行的查询。
+ * 读取当前快照不加锁（见 RcuSlot），快照替换对查询没有停顿；startReload 在后台线程中
+ * 完整构建新地图及其预处理数据后一次发布。
  */
 class MapEngine {
 public:
@@ -27,24 +117,429 @@ public:
     
     /**
      * @brief 从文件加载地图数据
+     * 自动识别文本格式和二进制地图（见 BinaryMap）：二进制地图直接映射到内存，
+     * 其中保存的地标表和收缩层次一并生效。
+     * 若地图中没有地标表而地图旁存在匹配的地标文件（见 getLandmarkFilename），会一并加载
      * @param filename 数据文件路径
      * @return 是否加载成功
      */
     bool loadMap(const std::string& filename);
     
     /**
-     * @brief 设置路径规划策略
+     * @brief 在后台线程中重新加载地图，构建完成后原子发布
+     * 新地图按 loadMap 的方式加载（使用当前的重排方式和优先队列），并为其重建当前地图已有
+     * 而新地图文件没有带来的预处理数据（按相同数量和选择方法选出的地标表、各策略的收缩层次），全部就绪后
+     * 才替换快照：期间查询和其他写操作照常进行，正在进行的查询在旧快照上完成，之后的查询
+     * 使用新地图。重载基于新的地图文件，发布时丢弃期间对旧地图的权重更新；结果缓存失效。
+     * 发布后重载即结束，不等待旧快照的持有者：最后一个持有者放下引用时旧地图交给回收线程
+     * 释放（见 SnapshotReaper），释放后 getReloadStatus 报告 drained。
+     * 加载或预处理失败时保留原地图，失败信息写到 std::cerr
+     * @param filename 数据文件路径（文本地图或二进制地图）
+     * @return 是否已开始重载（已有重载正在进行时返回 false）
+     */
+    bool startReload(const std::string& filename);
+    
+    /**
+     * @brief 等待正在进行的后台重载结束（到新快照发布为止，不等待旧快照释放）
+     * @return 最近一次重载是否成功，从未重载时为 false
+     */
+    bool waitForReload();
+    
+    /**
+     * @brief 获取后台重载的状态
+     * @return 状态
+     */
+    ReloadStatus getReloadStatus() const;
+    
+    /**
+     * @brief 把当前地图及其预处理数据保存为二进制地图
+     * @param filename 文件路径
+     * @return 是否成功
+     */
+    bool saveBinaryMap(const std::string& filename) const;
+    
+    /**
+     * @brief 设置加载二进制地图时是否校验整个文件的校验和（默认校验）
+     * 不校验时只检查文件头和段表，加载耗时与文件大小无关
+     * @param verify 是否校验
+     */
+    void setVerifyBinaryMap(bool verify);
+    
+    /**
+     * @brief 设置加载文本地图时的节点重排方式（默认 ORIGINAL，不重排）
+     * 重排在预处理之前完成，只改变内部稠密下标，查询接口和结果中的节点ID不变；
+     * 二进制地图保持保存时的顺序（转换时可指定重排方式）。下次 loadMap 时生效
+     * @param order 重排方式
+     */
+    void setNodeOrder(NodeOrder order);
+    
+    /**
+     * @brief 获取加载文本地图时的节点重排方式
+     */
+    NodeOrder getNodeOrder() const;
+    
+    /**
+     * @brief 预处理：选择地标并计算距离和时间两组地标表（ALT 搜索使用）
+     * @param count 地标数量
+     * @param selection 选择方法
+     * @return 是否成功
+     */
+    bool buildLandmarks(int count = 16, LandmarkSelection selection = LandmarkSelection::AVOID);
+    
+    /**
+     * @brief 保存地标表
+     * @param filename 文件路径，为空时保存在地图文件旁
+     * @return 是否成功
+     */
+    bool saveLandmarks(const std::string& filename = std::string()) const;
+    
+    /**
+     * @brief 加载地标表（与当前地图不匹配时拒绝加载）
+     * @param filename 文件路径，为空时从地图文件旁加载
+     * @return 是否成功
+     */
+    bool loadLandmarks(const std::string& filename = std::string());
+    
+    /**
+     * @brief 是否已有地标表
+     * @return 是否有地标表
+     */
+    bool hasLandmarks() const;
+    
+    /**
+     * @brief 丢弃地标表（ALT 搜索退化为单向Dijkstra）
+     */
+    void clearLandmarks();
+    
+    /**
+     * @brief 预处理：为每个策略各构建一个收缩层次（CONTRACTION_HIERARCHY 搜索使用）
+     * @return 是否成功
+     */
+    bool buildContractionHierarchies();
+    
+    /**
+     * @brief 是否已有某个策略的收缩层次
+     * @param strategy 策略类型
+     * @return 是否已构建
+     */
+    bool hasContractionHierarchy(PathStrategy strategy) const;
+    
+    /**
+     * @brief 丢弃所有收缩层次（CONTRACTION_HIERARCHY 搜索退化为 ALT 或双向Dijkstra）
+     */
+    void clearContractionHierarchies();
+    
+    /**
+     * @brief 更新一条边的通行时间（不重新加载地图）
+     * @param from 端点ID
+     * @param to 端点ID
+     * @param newTime 新的通行时间（正数）
+     * @return 边存在且时间有效时返回 true
+     */
+    bool updateEdgeTime(int from, int to, double newTime);
+    
+    /**
+     * @brief 批量更新边的通行时间（实时路况）
+     * 复制时间数组并修改，生成共享拓扑、距离和ID索引的新图，立即原子发布新快照：
+     * 正在进行的查询继续使用旧权重，之后的查询看到全部新权重。结果缓存整体失效。
+     * 时间策略的收缩层次按原节点顺序只重新计算权重（见 ContractionHierarchy::customize）：
+     * 定制得到的层次在写锁内增量定制受影响的向上边，与新图一起发布，查询一直有收缩层次；
+     * build 或二进制地图得到的层次第一次更新时撤下，在后台线程中转换为可定制的层次后发布，
+     * 其间该策略的 CONTRACTION_HIERARCHY 查询使用 ALT 或双向Dijkstra，期间到达的更新在发布前补齐。
+     * 某条边的时间减小时地标的时间表按新旧时间之比缩放后继续作为下界（时间只增加时原表仍然有效），
+     * 后台按新时间重新计算；计算期间到达的更新同样按缩放因子补齐，结果不会被丢弃。
+     * 距离策略的预处理数据和连通分量索引不变。需要等待后台刷新完成时调用 waitForCustomization
+     * @param updates 更新列表（同一条边出现多次时以最后一次为准）
+     * @return 生效的更新数（边不存在或时间无效的更新被忽略）
+     */
+    size_t applyWeightUpdates(const std::vector<EdgeTimeUpdate>& updates);
+    
+    /**
+     * @brief 等待权重更新后的后台定制完成（撤下的时间层次和缩放过的地标时间表已重新发布）
+     */
+    void waitForCustomization();
+    
+    /**
+     * @brief 地图文件对应的地标文件路径（地图路径加 ".landmarks" 后缀）
+     * @param mapFilename 地图文件路径
+     * @return 地标文件路径
+     */
+    static std::string getLandmarkFilename(const std::string& mapFilename);
+    
+    /**
+     * @brief 设置默认路径规划策略
+     * 每条边同时保存距离和时间，切换策略只改变查询时选用的权重，O(1)
      * @param strategy 策略类型
      */
     void setStrategy(PathStrategy strategy);
     
     /**
-     * @brief 查找路径
+     * @brief 设置搜索算法（单向Dijkstra、双向Dijkstra、ALT或收缩层次）
+     * @param algorithm 算法类型
+     */
+    void setAlgorithm(SearchAlgorithm algorithm);
+    
+    /**
+     * @brief 获取当前搜索算法
+     * @return 算法类型
+     */
+    SearchAlgorithm getAlgorithm() const;
+    
+    /**
+     * @brief 设置搜索使用的优先队列（二叉堆、带下标的4叉堆或基数堆）
+     * 生成只改变该设置的新快照，重新加载地图后仍然有效
+     * @param type 优先队列类型
+     */
+    void setQueueType(QueueType type);
+    
+    /**
+     * @brief 获取当前优先队列类型
+     * @return 优先队列类型
+     */
+    QueueType getQueueType() const;
+    
+    /**
+     * @brief 使用默认策略查找路径（线程安全）
+     * @param from 起始节点
+     * @param to 目标节点
+     * @return 路径结果
+     */
+    PathResult findPath(int from, int to) const;
+    
+    /**
+     * @brief 按指定策略查找路径（不改变默认策略，线程安全）
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param strategy 策略类型
+     * @return 路径结果
+     */
+    PathResult findPath(int from, int to, PathStrategy strategy) const;
+    
+    /**
+     * @brief 使用默认策略和算法只求最短距离（线程安全，不重建路径，不经过结果缓存）
+     * @param from 起始节点
+     * @param to 目标节点
+     * @return 路径结果（found、totalWeight 和统计信息，path 和 span 为空）
+     */
+    PathResult findDistance(int from, int to) const;
+    
+    /**
+     * @brief 按任意策略对象查找路径（线程安全，不经过结果缓存）
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param strategy 策略对象，边权重必须非负
+     * @return 路径结果，totalWeight 为该策略下的代价
+     */
+    PathResult findPath(int from, int to, const Strategy& strategy) const;
+    
+    /**
+     * @brief 按已注册的策略名称查找路径（线程安全）
      * @param from 起始节点
      * @param to 目标节点
+     * @param strategyName 注册时的策略名称
+     * @return 路径结果，策略未注册时 found 为 false
+     */
+    PathResult findPath(int from, int to, const std::string& strategyName) const;
+    
+    /**
+     * @brief 运行时注册自定义策略（按 getName() 命名，同名策略被替换）
+     * 之后的查询可以按名称使用，不需要重建图
+     * @param strategy 策略对象
+     * @return 是否成功（策略为空、名称为空或线性系数无效时失败）
+     */
+    bool registerStrategy(std::shared_ptr<const Strategy> strategy);
+    
+    /**
+     * @brief 注册线性组合策略：权重 = distanceWeight * 距离 + timeWeight * 时间
+     * @param name 策略名称
+     * @param distanceWeight 距离的系数（非负）
+     * @param timeWeight 时间的系数（非负，两个系数不能都为 0）
+     * @return 是否成功
+     */
+    bool registerLinearStrategy(const std::string& name, double distanceWeight, double timeWeight);
+    
+    /**
+     * @brief 注销自定义策略
+     * @param name 策略名称
+     * @return 策略是否存在
+     */
+    bool unregisterStrategy(const std::string& name);
+    
+    /**
+     * @brief 查找已注册的策略
+     * @param name 策略名称
+     * @return 策略对象，未注册时为空
+     */
+    std::shared_ptr<const Strategy> getRegisteredStrategy(const std::string& name) const;
+    
+    /**
+     * @brief 批量查找路径：把查询分散到线程池，结果顺序与输入一致
+     * 整批查询使用同一个快照和调用时的默认策略、算法
+     * @param queries 起点终点对数组
+     * @param count 查询数
      * @return 路径结果
      */
-    PathResult findPath(int from, int to);
+    std::vector<PathResult> findPaths(const std::pair<int, int>* queries, size_t count) const;
+    
+    /**
+     * @brief 批量查找路径
+     * @param queries 起点终点对
+     * @return 路径结果，顺序与输入一致
+     */
+    std::vector<PathResult> findPaths(const std::vector<std::pair<int, int>>& queries) const;
+    
+    /**
+     * @brief 批量查找路径，结果和路径写入调用方复用的 PathBatch（不经过结果缓存）
+     * 每个查询的路径写入所在分块的缓冲区，结果的 span 指向其中，path 为空；
+     * 复用 batch 时整批查询不为结果和路径分配内存
+     * @param queries 起点终点对数组
+     * @param count 查询数
+     * @param batch 输出：结果顺序与输入一致
+     * @param distancesOnly 是否只求距离（不重建路径，span 为空）
+     */
+    void findPaths(const std::pair<int, int>* queries, size_t count, PathBatch& batch,
+                   bool distancesOnly = false) const;
+    
+    /**
+     * @brief 批量查找路径，每个查询使用自己的策略（其余同上）
+     * @param queries 查询数组
+     * @param count 查询数
+     * @param batch 输出：结果顺序与输入一致
+     * @param distancesOnly 是否只求距离
+     */
+    void findPaths(const PathQuery* queries, size_t count, PathBatch& batch,
+                   bool distancesOnly = false) const;
+    
+    /**
+     * @brief 设置查询结果缓存的容量
+     * findPath 和 findPaths 先查缓存（A→B 的结果也用于 B→A），未命中时搜索并写入缓存。
+     * 加载地图和边权重变化时缓存整体失效
+     * @param capacity 最多缓存的结果数，0 表示关闭缓存（默认）
+     */
+    void setResultCacheCapacity(size_t capacity);
+    
+    /**
+     * @brief 查询结果缓存的统计（命中、未命中、淘汰次数等），未开启缓存时全为 0
+     * @return 统计信息
+     */
+    PathCacheStats getResultCacheStats() const;
+    
+    /**
+     * @brief 清空查询结果缓存
+     */
+    void clearResultCache();
+    
+    /**
+     * @brief 开启或关闭查询指标的聚合（默认开启）
+     * 每次 findPath / findPaths 查询把执行时间和搜索计数器记入直方图；
+     * 搜索计数器本身由编译选项 ENABLE_SEARCH_STATS 控制
+     * @param enabled 是否聚合
+     */
+    void setMetricsEnabled(bool enabled);
+    
+    /**
+     * @brief 聚合查询指标的快照：查询数、计数器累计值、延迟和确定节点数的直方图
+     * @return 指标快照
+     */
+    MetricsSnapshot getMetrics() const;
+    
+    /**
+     * @brief 以 Prometheus 文本格式输出聚合查询指标（可直接作为 /metrics 的响应体）
+     * @return 指标文本
+     */
+    std::string getMetricsText() const;
+    
+    /**
+     * @brief 清零聚合查询指标
+     */
+    void resetMetrics();
+    
+    /**
+     * @brief 预算范围内可达的节点（等时圈，线程安全）
+     * @param from 起点
+     * @param budget 代价预算（含边界），单位与策略一致
+     * @param strategy 策略类型
+     * @param table 输出：(节点, 代价, 前驱) 表，按代价非降序；复用缓冲区时不再分配内存
+     * @return 起点是否存在
+     */
+    bool reachableWithin(int from, double budget, PathStrategy strategy,
+                         std::vector<ReachableNode>& table) const;
+    
+    /**
+     * @brief 预算范围内可达的节点集合（线程安全）
+     * @param from 起点
+     * @param budget 代价预算（含边界）
+     * @param strategy 策略类型
+     * @param nodes 输出：可达节点ID（含起点）
+     * @return 起点是否存在
+     */
+    bool reachableWithin(int from, double budget, PathStrategy strategy,
+                         std::vector<int>& nodes) const;
+    
+    /**
+     * @brief 整图的单源最短路径树（线程安全）：并行 delta-stepping，使用批量查询的线程池
+     * 结果按稠密下标存放，下标属于调用时的快照；需要转换为外部ID时先用 getSnapshot()
+     * 取得快照，再调用快照的同名方法并用快照的图转换
+     * @param from 起点ID
+     * @param strategy 策略类型
+     * @param tree 输出：距离和前驱数组
+     * @param delta 桶宽，不大于 0 时按边权自动选择
+     * @return 起点是否存在
+     */
+    bool shortestPathTree(int from, PathStrategy strategy, ShortestPathTree& tree,
+                          double delta = 0.0) const;
+    
+    /**
+     * @brief (距离, 时间) 双目标路线搜索（线程安全）：返回全部 Pareto 最优路线，
+     * 在最短路线和最快路线之间给出所有折中方案
+     * @param from 起始节点ID
+     * @param to 目标节点ID
+     * @param maxLabels 标签数上限，达到上限时结果标记为不完整
+     * @return Pareto 前沿，距离递增、时间递减
+     */
+    ParetoResult findParetoPaths(int from, int to,
+                                 size_t maxLabels = ParetoResult::DEFAULT_LABEL_LIMIT) const;
+    
+    /**
+     * @brief 前 k 条最短简单路径（备选路线，线程安全）
+     * @param from 起始节点ID
+     * @param to 目标节点ID
+     * @param k 路径条数上限
+     * @param strategy 策略类型
+     * @return 按总权重非降序的路径
+     */
+    std::vector<PathResult> findKShortestPaths(int from, int to, int k,
+                                               PathStrategy strategy) const;
+    
+    /**
+     * @brief 多对多距离矩阵（线程安全）：起点和终点的搜索分散到线程池
+     * 只要距离且已构建收缩层次时使用桶式多对多搜索，远少于逐对查询的工作量
+     * @param sources 起点
+     * @param targets 终点
+     * @param strategy 策略类型
+     * @param distancesOnly 是否只计算距离；为 false 时 otherWeights 给出路径的另一指标
+     * @return 距离矩阵（行主序），不可达或节点不存在的单元为 DistanceMatrix::UNREACHABLE
+     */
+    DistanceMatrix distanceMatrix(const std::vector<int>& sources, const std::vector<int>& targets,
+                                  PathStrategy strategy, bool distancesOnly = true) const;
+    
+    /**
+     * @brief 设置批量查询使用的线程数
+     * @param threadCount 线程数，0 表示使用硬件线程数
+     */
+    void setThreadCount(size_t threadCount);
+    
+    /**
+     * @brief 批量查询使用的线程数
+     * @return 线程数
+     */
+    size_t getThreadCount() const;
+    
+    /**
+     * @brief 获取当前快照，可在其上执行一组看到同一份地图的查询
+     * @return 当前快照
+     */
+    std::shared_ptr<const MapSnapshot> getSnapshot() const;
     
     /**
      * @brief 获取当前策略名称
@@ -70,24 +565,139 @@ public:
      * @return 是否为孤立点
      */
     bool isIsolated(int nodeId) const;
+    
+    /**
+     * @brief 节点所属的连通分量（加载地图时计算，编号 0 是最大的分量）
+     * @param nodeId 节点ID
+     * @return 分量编号，节点不存在时为 ComponentIndex::NO_COMPONENT
+     */
+    int componentOf(int nodeId) const;
+    
+    /**
+     * @brief 连通分量的节点数
+     * @param component 分量编号
+     * @return 节点数，编号无效时为 0
+     */
+    size_t getComponentSize(int component) const;
+    
+    /**
+     * @brief 连通分量统计（分量数、最大分量的节点数、孤立点数）
+     * @return 统计信息
+     */
+    ComponentStats getComponentStats() const;
 
 private:
-    Graph graph_;
-    std::unique_ptr<PathFinder> pathFinder_;
-    DataLoader dataLoader_;
+    /**
+     * @brief 原子替换当前快照（调用方需持有 updateMutex_）
+     * @param snapshot 新快照
+     */
+    void publish(std::shared_ptr<const MapSnapshot> snapshot);
     
-    // 存储距离和时间信息（用于策略切换）
-    std::unordered_map<std::pair<int, int>, double, 
-                      std::hash<std::pair<int, int>>> distances_;
-    std::unordered_map<std::pair<int, int>, double,
-                      std::hash<std::pair<int, int>>> times_;
+    /**
+     * @brief 从文件加载新快照（不发布）：二进制地图映射后直接使用，文本地图解析后按需重排；
+     *        应用优先队列类型，并加载地图旁匹配的地标文件
+     * @return 新快照，失败时为空
+     */
+    static std::shared_ptr<const MapSnapshot> loadSnapshot(const std::string& filename,
+                                                           DataLoader& loader, bool verify,
+                                                           NodeOrder order, QueueType queueType);
+    
+    /**
+     * @brief 后台重载线程的主体
+     */
+    void runReload(const std::string& filename);
+    
+    /**
+     * @brief 请求后台定制，首次请求时启动定制线程（调用方持有 updateMutex_）
+     */
+    void requestCustomization();
+    
+    /**
+     * @brief 后台定制线程的主循环
+     */
+    void runCustomizer();
+    
+    /**
+     * @brief 把撤下的时间层次转换为可定制的层次、按新时间重新计算地标时间表，
+     *        按期间到达的更新补齐后发布
+     */
+    void customizePending();
+    
+    /**
+     * @brief 获取批量查询的线程池，首次使用时创建
+     * @return 线程池
+     */
+    std::shared_ptr<ThreadPool> getThreadPool() const;
+    
+    /**
+     * @brief 经过结果缓存的单次查询
+     * @param cache 结果缓存（可以为空）
+     * @param generation 获取快照之前读取的缓存代数
+     */
+    PathResult cachedFindPath(PathCache* cache, uint64_t generation, const MapSnapshot& snapshot,
+                              int from, int to, PathStrategy strategy,
+                              SearchAlgorithm algorithm) const;
     
-    PathStrategy currentStrategy_;
+    /**
+     * @brief PathBatch 批量查询：按块分给线程池，query(i) 给出第 i 个查询
+     */
+    template <typename Query>
+    void findPathsInto(size_t count, PathBatch& batch, bool distancesOnly, Query&& query) const;
     
     /**
-     * @brief 根据当前策略重建图的权重
+     * @brief 使结果缓存失效（在发布新快照之后调用）
      */
-    void rebuildGraphWeights();
+    void invalidateResultCache();
+    
+    // 在后台释放不再使用的快照，所有发布的快照都经它包装（先于 snapshot_ 构造）
+    std::shared_ptr<SnapshotReaper> reaper_;
+    // 当前快照，读取不加锁
+    RcuSlot<const MapSnapshot> snapshot_;
+    // 串行化写操作（加载地图、预处理），查询不需要此锁
+    mutable std::mutex updateMutex_;
+    DataLoader dataLoader_;
+    std::string mapFilename_;
+    
+    std::atomic<PathStrategy> currentStrategy_;
+    std::atomic<SearchAlgorithm> currentAlgorithm_;
+    bool verifyBinaryMap_;
+    NodeOrder nodeOrder_;      // 由 updateMutex_ 保护，加载文本地图时应用
+    QueueType queueType_;      // 由 updateMutex_ 保护，加载地图时应用到新快照
+    
+    mutable std::mutex poolMutex_;
+    mutable std::shared_ptr<ThreadPool> threadPool_;
+    size_t threadCount_;
+    
+    // 运行时注册的自定义策略（按名称）
+    mutable std::mutex strategyMutex_;
+    std::unordered_map<std::string, std::shared_ptr<const Strategy>> strategies_;
+    
+    // 查询结果缓存，读取不加锁，为空表示关闭
+    RcuSlot<PathCache> resultCache_;
+    
+    // 聚合查询指标（原子计数，查询线程并发记录）
+    mutable QueryMetrics metrics_;
+    std::atomic<bool> metricsEnabled_;
+    
+    // 后台重载：同一时间最多一个重载线程，状态由 reloadMutex_ 保护
+    mutable std::mutex reloadMutex_;
+    std::condition_variable reloadFinished_;
+    std::thread reloadThread_;
+    ReloadStatus reloadStatus_;
+    bool lastReloadSucceeded_;
+    
+    // 等待转换为可定制层次的时间层次（提供节点顺序），由 updateMutex_ 保护，为空表示没有待定制的层次
+    std::shared_ptr<const ContractionHierarchy> pendingTimeHierarchy_;
+    // 本轮后台定制开始后各批更新的新旧时间之比的最小值之积，由 updateMutex_ 保护
+    double landmarkTimeFactor_;
+    // 后台定制线程，状态由 customizeMutex_ 保护
+    std::mutex customizeMutex_;
+    std::condition_variable customizeWake_;
+    std::condition_variable customizeIdle_;
+    std::thread customizeThread_;
+    bool customizeRequested_;
+    bool customizeRunning_;
+    bool customizeStopping_;
 };
 
 #endif // MAPENGINE_H
@@ -0,0 +1,223 @@
+#ifndef MAPSNAPSHOT_H
+#define MAPSNAPSHOT_H
+
+#include "Graph.h"
+#include "PathFinder.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "ComponentIndex.h"
+#include "Strategy.h"
+#include <memory>
+
+/**
+ * @brief 已加载地图的不可变快照
+ * 包含冻结的图及其预处理数据（地标表、每个策略的收缩层次）。快照发布之后不再修改，
+ * 任意多个线程可以同时查询；更新预处理数据时生成共享未改变部分的新快照，
+ * 已经拿到旧快照的查询不受影响，旧快照在最后一个使用者释放后销毁。
+ * 连通分量索引随图一起生成，只替换预处理数据的新快照与旧快照共享同一份索引。
+ */
+class MapSnapshot {
+public:
+    /**
+     * @brief 构造函数
+     * @param graph 已冻结的图
+     * @param landmarks 地标表（可以为空）
+     * @param distanceHierarchy 距离策略的收缩层次（可以为空）
+     * @param timeHierarchy 时间策略的收缩层次（可以为空）
+     * @param queueType 搜索使用的优先队列
+     * @param components 图的连通分量索引，为空时由图计算
+     */
+    MapSnapshot(std::shared_ptr<const Graph> graph,
+                std::shared_ptr<const Landmarks> landmarks,
+                std::shared_ptr<const ContractionHierarchy> distanceHierarchy,
+                std::shared_ptr<const ContractionHierarchy> timeHierarchy,
+                QueueType queueType = QueueType::DARY_HEAP,
+                std::shared_ptr<const ComponentIndex> components = nullptr);
+
+    ~MapSnapshot();
+
+    // 禁止拷贝构造和赋值
+    MapSnapshot(const MapSnapshot&) = delete;
+    MapSnapshot& operator=(const MapSnapshot&) = delete;
+
+    /**
+     * @brief 创建只包含空图的快照
+     * @return 快照
+     */
+    static std::shared_ptr<const MapSnapshot> createEmpty();
+
+    /**
+     * @brief 生成替换地标表的新快照（图和收缩层次共享）
+     * @param landmarks 新地标表（可以为空）
+     * @return 新快照
+     */
+    std::shared_ptr<const MapSnapshot> withLandmarks(std::shared_ptr<const Landmarks> landmarks) const;
+
+    /**
+     * @brief 生成替换某个策略收缩层次的新快照（图和其余预处理数据共享）
+     * @param strategy 策略类型
+     * @param hierarchy 新收缩层次（可以为空）
+     * @return 新快照
+     */
+    std::shared_ptr<const MapSnapshot> withContractionHierarchy(
+        PathStrategy strategy, std::shared_ptr<const ContractionHierarchy> hierarchy) const;
+
+    /**
+     * @brief 生成使用另一种优先队列的新快照（图和预处理数据共享）
+     * @param queueType 优先队列类型
+     * @return 新快照
+     */
+    std::shared_ptr<const MapSnapshot> withQueueType(QueueType queueType) const;
+
+    /**
+     * @brief 边的时间更新后生成新快照
+     * 连通分量索引和距离策略的收缩层次与旧快照共享（结构和距离没有变化）
+     * @param graph 只更新了时间的新图
+     * @param landmarks 新图使用的地标表（可以为空）
+     * @param timeHierarchy 新图的时间策略收缩层次（可以为空）
+     * @return 新快照
+     */
+    std::shared_ptr<const MapSnapshot> withUpdatedTimes(
+        std::shared_ptr<const Graph> graph, std::shared_ptr<const Landmarks> landmarks,
+        std::shared_ptr<const ContractionHierarchy> timeHierarchy) const;
+
+    /**
+     * @brief 搜索使用的优先队列
+     */
+    QueueType getQueueType() const { return pathFinder_.getQueueType(); }
+
+    /**
+     * @brief 查找路径，可在多个线程中同时调用
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param strategy 策略类型
+     * @param algorithm 搜索算法
+     * @return 路径结果
+     */
+    PathResult findPath(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm) const {
+        return pathFinder_.findPath(from, to, strategy, algorithm);
+    }
+
+    /**
+     * @brief 查找路径，路径写入调用方的缓冲区（见 PathFinder::findPath 的 PathArena 重载）
+     */
+    PathResult findPath(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm,
+                        PathArena& arena) const {
+        return pathFinder_.findPath(from, to, strategy, algorithm, arena);
+    }
+
+    /**
+     * @brief 只求最短距离，不重建路径，可在多个线程中同时调用
+     */
+    PathResult findDistance(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm) const {
+        return pathFinder_.findDistance(from, to, strategy, algorithm);
+    }
+
+    /**
+     * @brief 按任意策略对象查找路径，可在多个线程中同时调用
+     */
+    PathResult findPath(int from, int to, const Strategy& strategy,
+                        SearchAlgorithm algorithm) const {
+        return pathFinder_.findPath(from, to, strategy, algorithm);
+    }
+
+    /**
+     * @brief 预算范围内可达的节点，可在多个线程中同时调用
+     */
+    bool reachableWithin(int from, double budget, PathStrategy strategy,
+                         std::vector<ReachableNode>& table) const {
+        return pathFinder_.reachableWithin(from, budget, strategy, table);
+    }
+
+    bool reachableWithin(int from, double budget, PathStrategy strategy,
+                         std::vector<int>& nodes) const {
+        return pathFinder_.reachableWithin(from, budget, strategy, nodes);
+    }
+
+    /**
+     * @brief 整图的单源最短路径树，可在多个线程中同时调用
+     */
+    bool shortestPathTree(int from, PathStrategy strategy, double delta, ShortestPathTree& tree,
+                          ThreadPool* pool = nullptr) const {
+        return pathFinder_.shortestPathTree(from, strategy, delta, tree, pool);
+    }
+
+    /**
+     * @brief (距离, 时间) 双目标 Pareto 路线，可在多个线程中同时调用
+     */
+    ParetoResult findParetoPaths(int from, int to, size_t maxLabels) const {
+        return pathFinder_.findParetoPaths(from, to, maxLabels);
+    }
+
+    /**
+     * @brief 前 k 条最短简单路径，可在多个线程中同时调用
+     */
+    std::vector<PathResult> findKShortestPaths(int from, int to, int k,
+                                               PathStrategy strategy) const {
+        return pathFinder_.findKShortestPaths(from, to, k, strategy);
+    }
+
+    /**
+     * @brief 多对多距离矩阵，可在多个线程中同时调用
+     * @param sources 起点
+     * @param targets 终点
+     * @param strategy 策略类型
+     * @param distancesOnly 是否只计算距离
+     * @param pool 可选的线程池
+     * @return 距离矩阵（行主序）
+     */
+    DistanceMatrix distanceMatrix(const std::vector<int>& sources, const std::vector<int>& targets,
+                                  PathStrategy strategy, bool distancesOnly,
+                                  ThreadPool* pool = nullptr) const {
+        return pathFinder_.distanceMatrix(sources, targets, strategy, distancesOnly, pool);
+    }
+
+    /**
+     * @brief 快照中的图
+     */
+    const Graph& getGraph() const { return *graph_; }
+
+    /**
+     * @brief 快照中图的共享引用（用于生成共享数组的新图）
+     */
+    const std::shared_ptr<const Graph>& getSharedGraph() const { return graph_; }
+
+    /**
+     * @brief 地标表的共享引用，没有时为空
+     */
+    const std::shared_ptr<const Landmarks>& getSharedLandmarks() const { return landmarks_; }
+
+    /**
+     * @brief 地标表，没有时为空
+     */
+    const Landmarks* getLandmarks() const { return landmarks_.get(); }
+
+    /**
+     * @brief 某个策略的收缩层次，没有时为空
+     */
+    const ContractionHierarchy* getContractionHierarchy(PathStrategy strategy) const {
+        return hierarchies_[static_cast<int>(strategy)].get();
+    }
+
+    /**
+     * @brief 某个策略收缩层次的共享引用，没有时为空
+     */
+    const std::shared_ptr<const ContractionHierarchy>& getSharedContractionHierarchy(
+        PathStrategy strategy) const {
+        return hierarchies_[static_cast<int>(strategy)];
+    }
+
+    /**
+     * @brief 图的连通分量索引
+     */
+    const ComponentIndex& getComponentIndex() const { return *components_; }
+
+private:
+    std::shared_ptr<const Graph> graph_;
+    std::shared_ptr<const Landmarks> landmarks_;
+    std::shared_ptr<const ContractionHierarchy> hierarchies_[2];  // 按 PathStrategy 下标
+    std::shared_ptr<const ComponentIndex> components_;
+    PathFinder pathFinder_;   // 指向上面的图和预处理数据，只用于 const 查询
+};
+
+#endif // MAPSNAPSHOT_H
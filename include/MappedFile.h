@@ -0,0 +1,59 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief 只读内存映射文件
+ * POSIX 上使用 mmap，Windows 上使用 CreateFileMapping / MapViewOfFile。
+ * 映射的页由操作系统按需读入，多个进程映射同一文件时共享物理页。
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // 禁止拷贝构造和赋值
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief 映射整个文件（已映射的文件会先解除映射）
+     * @param filename 文件名
+     * @param sequential 是否以顺序读取为主（提示操作系统积极预读）
+     * @return 是否成功（空文件也算成功，此时 getData() 为空）
+     */
+    bool open(const std::string& filename, bool sequential = true);
+
+    /**
+     * @brief 解除映射
+     */
+    void close();
+
+    /**
+     * @brief 是否已映射
+     */
+    bool isOpen() const { return open_; }
+
+    /**
+     * @brief 文件内容起始地址
+     */
+    const char* getData() const { return data_; }
+
+    /**
+     * @brief 文件大小（字节）
+     */
+    size_t getSize() const { return size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    bool open_;
+#ifdef _WIN32
+    void* fileHandle_;
+    void* mappingHandle_;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,63 @@
+#ifndef NODEORDERING_H
+#define NODEORDERING_H
+
+#include "Graph.h"
+#include <vector>
+#include <string>
+
+/**
+ * @brief 节点重排方式
+ */
+enum class NodeOrder {
+    ORIGINAL,   // 保持加载顺序（节点在数据文件中首次出现的顺序）
+    BFS,        // 从每个连通分量的伪外围节点出发的广度优先顺序
+    RCM         // 反向 Cuthill–McKee：广度优先、同层按度数升序展开，再整体反转
+};
+
+/**
+ * @brief 缓存局部性节点重排
+ * 数据文件中的节点ID往往是任意分配的，相邻路口的稠密下标相距很远，搜索前沿的每次
+ * 邻接访问和距离读写都落在随机的缓存行上。按图的遍历顺序重新分配稠密下标后，
+ * 相邻节点的下标相近，邻接数组和工作区的访问集中在少量缓存行中。
+ * 重排只改变稠密下标，外部节点ID保持不变，PathResult::path 等结果不受影响。
+ */
+class NodeOrdering {
+public:
+    /**
+     * @brief 计算重排顺序
+     * @param graph 已冻结的图
+     * @param order 重排方式
+     * @return order[新下标] = 旧下标
+     */
+    static std::vector<int> computeOrder(const Graph& graph, NodeOrder order);
+
+    /**
+     * @brief 按重排方式重排图的稠密下标（ORIGINAL 不做任何事）
+     * @param graph 已冻结的图
+     * @param order 重排方式
+     * @return 是否成功
+     */
+    static bool apply(Graph& graph, NodeOrder order);
+
+    /**
+     * @brief 平均边跨度：所有弧两端稠密下标之差的绝对值的平均，越小局部性越好
+     * @param graph 已冻结的图
+     * @return 平均边跨度
+     */
+    static double averageEdgeSpan(const Graph& graph);
+
+    /**
+     * @brief 重排方式的名称（original / bfs / rcm）
+     */
+    static const char* getName(NodeOrder order);
+
+    /**
+     * @brief 按名称解析重排方式
+     * @param name 名称
+     * @param order 输出的重排方式
+     * @return 名称是否有效
+     */
+    static bool parse(const std::string& name, NodeOrder& order);
+};
+
+#endif // NODEORDERING_H
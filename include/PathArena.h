@@ -0,0 +1,110 @@
+#ifndef PATHARENA_H
+#define PATHARENA_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief 查询结果中路径的输出方式
+ */
+enum class PathMode {
+    VECTOR,         // 写入 PathResult::path（每个找到的路径分配一个 vector）
+    ARENA,          // 写入调用方的 PathArena，PathResult::span 指向其中
+    DISTANCE_ONLY   // 不重建路径，只给出 found 和 totalWeight
+};
+
+/**
+ * @brief 不持有内存的路径视图（外部节点ID序列），可以随意拷贝
+ */
+struct PathSpan {
+    const int* data;
+    size_t size;
+
+    PathSpan() : data(nullptr), size(0) {}
+    PathSpan(const int* d, size_t s) : data(d), size(s) {}
+
+    bool empty() const { return size == 0; }
+    const int& operator[](size_t i) const { return data[i]; }
+    const int* begin() const { return data; }
+    const int* end() const { return data + size; }
+    std::vector<int> toVector() const { return std::vector<int>(data, data + size); }
+};
+
+/**
+ * @brief 路径缓冲区
+ * 按块分配：路径写在当前块的末尾，块满时换下一块（比块大的路径单独占一块）。
+ * 已分配的地址在 clear() 之前保持不变；clear() 只重置写入位置，保留所有块，
+ * 因此复用缓冲区的查询不再分配内存。不是线程安全的，每个线程使用自己的缓冲区。
+ */
+class PathArena {
+public:
+    // 默认块大小（节点数）
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 16;
+
+    /**
+     * @brief 构造函数
+     * @param blockSize 块大小（节点数）
+     */
+    explicit PathArena(size_t blockSize = DEFAULT_BLOCK_SIZE)
+        : blockSize_(blockSize == 0 ? 1 : blockSize), current_(0), used_(0), size_(0) {}
+
+    // 禁止拷贝构造和赋值（副本中的路径地址与已返回的 PathSpan 无关）；移动后块的地址不变
+    PathArena(const PathArena&) = delete;
+    PathArena& operator=(const PathArena&) = delete;
+    PathArena(PathArena&&) = default;
+    PathArena& operator=(PathArena&&) = default;
+
+    /**
+     * @brief 分配 length 个连续位置
+     * @param length 节点数
+     * @return 可写地址，在 clear() 或析构之前有效
+     */
+    int* allocate(size_t length) {
+        while (current_ < blocks_.size() && blocks_[current_].size() - used_ < length) {
+            current_++;
+            used_ = 0;
+        }
+        if (current_ == blocks_.size()) {
+            blocks_.emplace_back(length > blockSize_ ? length : blockSize_);
+            used_ = 0;
+        }
+        int* data = blocks_[current_].data() + used_;
+        used_ += length;
+        size_ += length;
+        return data;
+    }
+
+    /**
+     * @brief 丢弃已写入的路径（之前返回的地址和 PathSpan 失效），保留已分配的块
+     */
+    void clear() {
+        current_ = 0;
+        used_ = 0;
+        size_ = 0;
+    }
+
+    /**
+     * @brief 已写入的节点数
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief 已分配的块占用的内存（字节）
+     */
+    size_t getMemoryUsage() const {
+        size_t bytes = 0;
+        for (const std::vector<int>& block : blocks_) {
+            bytes += block.size() * sizeof(int);
+        }
+        return bytes;
+    }
+
+private:
+    std::vector<std::vector<int>> blocks_;  // 块在 blocks_ 扩容时移动，数据地址不变
+    size_t blockSize_;
+    size_t current_;    // 当前写入的块
+    size_t used_;       // 当前块已写入的节点数
+    size_t size_;       // 所有块已写入的节点数
+};
+
+#endif // PATHARENA_H
@@ -0,0 +1,138 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "PathFinder.h"
+#include "Strategy.h"
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 结果缓存的统计计数
+ */
+struct PathCacheStats {
+    uint64_t hits;          // 命中次数（含反向命中）
+    uint64_t misses;        // 未命中次数
+    uint64_t evictions;     // 因容量不足淘汰的条目数
+    uint64_t invalidations; // 整体失效次数（加载地图、边权重变化）
+    size_t size;            // 当前条目数
+    size_t capacity;        // 容量
+    
+    PathCacheStats() : hits(0), misses(0), evictions(0), invalidations(0), size(0), capacity(0) {}
+};
+
+/**
+ * @brief 分片的查询结果缓存
+ * 以 (起点, 终点, 策略) 为键保存路径结果。图是无向的，键按端点大小规范化，
+ * B→A 的查询由 A→B 的结果反转路径得到。
+ * 键按哈希分到若干分片，每个分片一把锁，并发查询只在落到同一分片时竞争。
+ * 分片内用 CLOCK 近似 LRU：命中只设置引用位，不移动条目；满时指针扫过的条目
+ * 引用位为 0 的被淘汰。
+ */
+class PathCache {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最多缓存的结果数（按分片平均分配）
+     * @param shardCount 分片数（不超过容量）
+     */
+    explicit PathCache(size_t capacity, size_t shardCount = 16);
+    ~PathCache();
+    
+    // 禁止拷贝构造和赋值
+    PathCache(const PathCache&) = delete;
+    PathCache& operator=(const PathCache&) = delete;
+    
+    /**
+     * @brief 查找缓存的结果
+     * @param from 起点ID
+     * @param to 终点ID
+     * @param strategy 策略类型
+     * @param result 输出：命中时的结果（路径方向与查询一致）
+     * @return 是否命中
+     */
+    bool lookup(int from, int to, PathStrategy strategy, PathResult& result);
+    
+    /**
+     * @brief 写入结果
+     * 计算期间缓存已失效（代数变化）时丢弃，避免旧地图的结果写入新缓存
+     * @param from 起点ID
+     * @param to 终点ID
+     * @param strategy 策略类型
+     * @param result 查询结果
+     * @param generation 查询开始前读取的缓存代数（getGeneration）
+     */
+    void insert(int from, int to, PathStrategy strategy, const PathResult& result,
+                uint64_t generation);
+    
+    /**
+     * @brief 当前代数，每次 invalidate 加一
+     */
+    uint64_t getGeneration() const { return generation_.load(std::memory_order_acquire); }
+    
+    /**
+     * @brief 清空所有分片
+     */
+    void invalidate();
+    
+    /**
+     * @brief 统计计数
+     */
+    PathCacheStats getStats() const;
+    
+    /**
+     * @brief 容量
+     */
+    size_t getCapacity() const { return capacity_; }
+    
+private:
+    /**
+     * @brief 规范化的键：first <= second
+     */
+    struct Key {
+        int first;
+        int second;
+        int strategy;
+        
+        bool operator==(const Key& other) const {
+            return first == other.first && second == other.second && strategy == other.strategy;
+        }
+    };
+    
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    
+    struct Entry {
+        Key key;
+        PathResult result;      // 路径方向为 key.first → key.second
+        bool referenced;        // CLOCK 引用位
+    };
+    
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        std::unordered_map<Key, size_t, KeyHash> index;
+        size_t hand;            // CLOCK 指针
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        
+        Shard() : hand(0), hits(0), misses(0), evictions(0) {}
+    };
+    
+    static Key makeKey(int from, int to, PathStrategy strategy);
+    Shard& shardOf(const Key& key);
+    
+    size_t capacity_;
+    size_t shardCapacity_;
+    std::unique_ptr<Shard[]> shards_;
+    size_t shardCount_;
+    std::atomic<uint64_t> generation_;
+};
+
+#endif // PATHCACHE_H
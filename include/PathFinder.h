@@ -3,26 +3,104 @@
 
 #include "Graph.h"
 #include "Strategy.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "ComponentIndex.h"
+#include "ThreadPool.h"
+#include "DeltaStepping.h"
+#include "PathArena.h"
 #include <vector>
-#include <unordered_map>
 #include <memory>
 #include <chrono>
+#include <limits>
 
 /**
  * @brief 路径结果结构体
  */
 struct PathResult {
     std::vector<int> path;      // 路径节点序列
+    PathSpan span;               // 路径写入 PathArena 时指向其中的节点序列（此时 path 为空）
     double totalWeight;          // 总权重（距离或时间）
     bool found;                  // 是否找到路径
     int64_t elapsedMicroseconds; // 执行时间（微秒）
+    size_t peakQueueSize;        // 搜索中优先队列的最大长度（双向搜索为两侧之和）
+    SearchStats stats;           // 搜索计数器（编译时关闭 ENABLE_SEARCH_STATS 时全为 0）
     
-    PathResult() : totalWeight(0.0), found(false), elapsedMicroseconds(0) {}
+    PathResult() : totalWeight(0.0), found(false), elapsedMicroseconds(0), peakQueueSize(0) {}
+};
+
+/**
+ * @brief 多对多距离矩阵，按行主序连续存放
+ */
+struct DistanceMatrix {
+    // 不可达（或节点不存在）的单元
+    static constexpr double UNREACHABLE = std::numeric_limits<double>::infinity();
+    
+    size_t rowCount;                  // 起点数
+    size_t columnCount;               // 终点数
+    std::vector<double> weights;      // weights[i * columnCount + j]：第 i 个起点到第 j 个终点的最短距离（按策略）
+    std::vector<double> otherWeights; // 同一路径的另一指标（距离策略时为时间，反之为距离），只要距离时为空
+    
+    DistanceMatrix() : rowCount(0), columnCount(0) {}
+    
+    double at(size_t row, size_t column) const { return weights[row * columnCount + column]; }
+};
+
+/**
+ * @brief 预算范围内可达的节点（等时圈/可达范围查询的结果项）
+ */
+struct ReachableNode {
+    int node;       // 节点ID
+    double cost;    // 从起点出发的最小代价（距离或时间）
+    int parent;     // 最短路径树上的前驱节点ID，起点的前驱为自身
+    
+    ReachableNode() : node(0), cost(0.0), parent(0) {}
+    ReachableNode(int n, double c, int p) : node(n), cost(c), parent(p) {}
+};
+
+/**
+ * @brief Pareto 最优路线（距离和时间都不能同时被其他路线改进）
+ */
+struct ParetoRoute {
+    std::vector<int> path;  // 路径节点序列
+    double distance;        // 总距离
+    double time;            // 总时间
+    
+    ParetoRoute() : distance(0.0), time(0.0) {}
+};
+
+/**
+ * @brief 双目标（距离，时间）搜索结果
+ */
+struct ParetoResult {
+    // 默认的标签数上限
+    static constexpr size_t DEFAULT_LABEL_LIMIT = 1000000;
+    
+    std::vector<ParetoRoute> routes;    // Pareto 前沿，距离递增、时间递减：首条最短，末条最快
+    bool complete;                      // 是否为完整的前沿（标签数达到上限时为 false）
+    size_t labelCount;                  // 本次搜索创建的标签数
+    int64_t elapsedMicroseconds;        // 执行时间（微秒）
+    
+    ParetoResult() : complete(true), labelCount(0), elapsedMicroseconds(0) {}
+};
+
+/**
+ * @brief 搜索算法枚举
+ */
+enum class SearchAlgorithm {
+    DIJKSTRA,                // 单向Dijkstra
+    BIDIRECTIONAL_DIJKSTRA,  // 双向Dijkstra（起点和终点同时搜索，在中间相遇）
+    ALT,                     // A* + 地标下界（需要对应策略的地标表，没有时退化为单向Dijkstra）
+    CONTRACTION_HIERARCHY    // 收缩层次（需要对应策略的层次，没有时退化为 ALT 或双向Dijkstra）
 };
 
 /**
  * @brief 路径规划引擎核心类
- * 使用堆优化的Dijkstra算法实现高性能路径搜索
+ * 使用堆优化的Dijkstra算法实现高性能路径搜索。
+ * 搜索状态存放在线程私有的 SearchWorkspace 中，首次查询之后搜索不再分配堆内存。
+ * 配置（set* 方法）完成后查询方法都是 const 且可重入的，多个线程可以同时查询同一个 PathFinder
  */
 class PathFinder {
 public:
@@ -45,12 +123,200 @@ public:
     void setStrategy(std::unique_ptr<Strategy> strategy);
     
     /**
-     * @brief 查找最短路径
+     * @brief 设置默认路径规划策略，O(1)，不需要重建图
+     * @param strategy 策略类型
+     */
+    void setStrategy(PathStrategy strategy);
+    
+    /**
+     * @brief 设置搜索算法
+     * @param algorithm 算法类型
+     */
+    void setAlgorithm(SearchAlgorithm algorithm);
+    
+    /**
+     * @brief 获取当前搜索算法
+     * @return 算法类型
+     */
+    SearchAlgorithm getAlgorithm() const;
+    
+    /**
+     * @brief 设置 Dijkstra、双向 Dijkstra 和 ALT 使用的优先队列
+     * 收缩层次查询的搜索空间很小，总是使用二叉堆
+     * @param type 优先队列类型
+     */
+    void setQueueType(QueueType type);
+    
+    /**
+     * @brief 获取当前优先队列类型
+     * @return 优先队列类型
+     */
+    QueueType getQueueType() const;
+    
+    /**
+     * @brief 设置 ALT 模式使用的地标表
+     * @param landmarks 地标表（由调用方管理生命周期，可以为空）
+     */
+    void setLandmarks(const Landmarks* landmarks);
+    
+    /**
+     * @brief 设置连通分量索引，起点和终点不在同一分量的查询不做搜索直接返回未找到
+     * @param components 分量索引（由调用方管理生命周期，可以为空）
+     */
+    void setComponentIndex(const ComponentIndex* components);
+    
+    /**
+     * @brief 设置某个策略使用的收缩层次
+     * @param strategy 策略类型
+     * @param hierarchy 收缩层次（由调用方管理生命周期，可以为空）
+     */
+    void setContractionHierarchy(PathStrategy strategy, const ContractionHierarchy* hierarchy);
+    
+    /**
+     * @brief 使用默认策略查找最短路径
+     * @param from 起始节点
+     * @param to 目标节点
+     * @return 路径结果
+     */
+    PathResult findPath(int from, int to) const;
+    
+    /**
+     * @brief 按指定策略查找最短路径（每次查询选择边的权重）
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param strategy 策略类型
+     * @return 路径结果
+     */
+    PathResult findPath(int from, int to, PathStrategy strategy) const;
+    
+    /**
+     * @brief 按指定策略和算法查找最短路径（不读取 PathFinder 的默认设置）
      * @param from 起始节点
      * @param to 目标节点
+     * @param strategy 策略类型
+     * @param algorithm 搜索算法
      * @return 路径结果
      */
-    PathResult findPath(int from, int to);
+    PathResult findPath(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm) const;
+    
+    /**
+     * @brief 路径写入调用方缓冲区的查询：结果的 path 为空，span 指向 arena 中的节点序列
+     * 路径先沿父节点链测出长度，再在缓冲区中一次分配并按顺序写入；复用缓冲区时查询不分配内存。
+     * span 在 arena.clear() 或销毁之前有效
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param strategy 策略类型
+     * @param algorithm 搜索算法
+     * @param arena 路径缓冲区
+     * @return 路径结果
+     */
+    PathResult findPath(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm,
+                        PathArena& arena) const;
+    
+    /**
+     * @brief 只求最短距离：不重建路径（收缩层次不展开捷径），found 和 totalWeight 与 findPath 相同
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param strategy 策略类型
+     * @param algorithm 搜索算法
+     * @return 路径结果（path 和 span 为空）
+     */
+    PathResult findDistance(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm) const;
+    
+    /**
+     * @brief 按任意策略查找最短路径（每次查询计算边的代价，不需要重建图）
+     * 与内置策略系数相同的线性组合使用内置策略的全部算法和预处理数据；
+     * 其他线性组合内联计算 alpha * distance + beta * time，其余策略逐条边调用 calculateWeight。
+     * 自定义代价只支持 Dijkstra 和双向 Dijkstra，其他算法退化为单向 Dijkstra。
+     * 策略给出的边权重必须非负
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param strategy 策略对象
+     * @param algorithm 搜索算法
+     * @return 路径结果（totalWeight 为该策略下的代价）
+     */
+    PathResult findPath(int from, int to, const Strategy& strategy, SearchAlgorithm algorithm) const;
+    
+    /**
+     * @brief 多对多距离矩阵
+     * 只要距离且该策略有收缩层次时，对每个终点和每个起点各做一次向上搜索，
+     * 通过终点搜索空间建立的桶合并结果（总共 N+M 次小范围搜索）；
+     * 否则每个起点做一次多目标 Dijkstra，所有终点确定后即停止（收缩层次的捷径只带一种指标）
+     * @param sources 起点（外部节点ID）
+     * @param targets 终点（外部节点ID）
+     * @param strategy 策略类型
+     * @param distancesOnly 是否只计算距离；为 false 时同时给出路径的另一指标
+     * @param pool 可选的线程池，起点（和终点）的搜索在其中并行执行
+     * @return 距离矩阵
+     */
+    DistanceMatrix distanceMatrix(const std::vector<int>& sources, const std::vector<int>& targets,
+                                  PathStrategy strategy, bool distancesOnly,
+                                  ThreadPool* pool = nullptr) const;
+    
+    /**
+     * @brief 预算受限的一对多搜索：找出从起点出发代价不超过预算的所有节点
+     * 搜索前沿超出预算即停止；结果按代价非降序写入调用方传入的缓冲区（先清空，保留容量），
+     * 缓冲区复用时每个确定的节点不再分配内存
+     * @param from 起点ID
+     * @param budget 代价预算（含边界）
+     * @param strategy 策略类型（决定代价是距离还是时间）
+     * @param table 输出：(节点, 代价, 前驱) 表
+     * @return 起点是否存在
+     */
+    bool reachableWithin(int from, double budget, PathStrategy strategy,
+                         std::vector<ReachableNode>& table) const;
+    
+    /**
+     * @brief 预算受限的一对多搜索，只返回可达节点集合
+     * @param from 起点ID
+     * @param budget 代价预算（含边界）
+     * @param strategy 策略类型
+     * @param nodes 输出：可达节点ID（含起点），按代价非降序
+     * @return 起点是否存在
+     */
+    bool reachableWithin(int from, double budget, PathStrategy strategy,
+                         std::vector<int>& nodes) const;
+    
+    /**
+     * @brief 整图的单源最短路径树（并行 delta-stepping，见 DeltaStepping）
+     * 适合离线分析等需要到所有节点距离的场景；只要少数终点时 reachableWithin 或 distanceMatrix 更快
+     * @param from 起点ID
+     * @param strategy 策略类型
+     * @param delta 桶宽，不大于 0 时按边权自动选择
+     * @param tree 输出：稠密下标上的距离和前驱数组
+     * @param pool 可选的线程池，每轮松弛在其中并行执行
+     * @return 起点是否存在
+     */
+    bool shortestPathTree(int from, PathStrategy strategy, double delta, ShortestPathTree& tree,
+                          ThreadPool* pool = nullptr) const;
+    
+    /**
+     * @brief 双目标标签设置搜索：求 (距离, 时间) 的全部 Pareto 最优路线
+     * 标签按 (距离, 时间) 字典序出队，节点上已确定的标签按距离递增，因此新标签只需与
+     * 该节点已确定标签的最小时间比较即可判定是否被支配；时间不小于终点已知最小时间的
+     * 标签也被剪掉。标签紧凑地存放在线程私有的标签池中，在查询之间复用
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param maxLabels 标签数上限，达到上限后不再创建标签（结果标记为不完整），内存因此有界
+     * @return Pareto 前沿（起点或终点不存在、不连通时为空）
+     */
+    ParetoResult findParetoPaths(int from, int to,
+                                 size_t maxLabels = ParetoResult::DEFAULT_LABEL_LIMIT) const;
+    
+    /**
+     * @brief 前 k 条最短简单路径（Yen 算法）
+     * 先从终点反向搜索到起点得到最短路径树，偏离搜索以树上的距离为 A* 启发函数，
+     * 偏离点沿树到终点的路径未被屏蔽时直接采用而不搜索；偏离只从上一条路径的偏离点之后
+     * 开始（Lawler 改进）。屏蔽的节点和边记录在线程私有的时间戳数组中，不复制图
+     * @param from 起始节点
+     * @param to 目标节点
+     * @param k 路径条数上限
+     * @param strategy 策略类型
+     * @return 按总权重非降序的路径，少于 k 条时为全部简单路径；每条结果的执行时间为
+     *         截至找到该路径的累计时间
+     */
+    std::vector<PathResult> findKShortestPaths(int from, int to, int k,
+                                               PathStrategy strategy) const;
     
     /**
      * @brief 获取当前使用的策略名称
@@ -60,38 +326,179 @@ public:
 
 private:
     /**
-     * @brief 堆优化的Dijkstra算法实现
+     * @brief 校验查询端点并处理平凡情况（节点不存在、起终点相同、孤立点）
      * @param from 起始节点
      * @param to 目标节点
+     * @param source 输出的起点下标
+     * @param target 输出的终点下标
+     * @param result 平凡情况下的结果
+     * @param mode 路径输出方式（起终点相同时的单节点路径）
+     * @param arena 路径缓冲区（mode 为 ARENA 时使用）
+     * @return 是否需要执行搜索
+     */
+    bool prepareQuery(int from, int to, int& source, int& target, PathResult& result,
+                      PathMode mode = PathMode::VECTOR, PathArena* arena = nullptr) const;
+    
+    /**
+     * @brief 按内置策略查询，路径按输出方式写入
+     */
+    PathResult query(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm,
+                     PathMode mode, PathArena* arena) const;
+    
+    /**
+     * @brief 按算法分派搜索（优先队列类型由模板参数决定）
+     * @param source 起点下标
+     * @param target 终点下标
+     * @param strategy 策略类型
+     * @param algorithm 搜索算法
+     * @param mode 路径输出方式
+     * @param arena 路径缓冲区（mode 为 ARENA 时使用）
      * @return 路径结果
      */
-    PathResult dijkstra(int from, int to);
+    template <typename Queue>
+    PathResult search(int source, int target, PathStrategy strategy, SearchAlgorithm algorithm,
+                      PathMode mode = PathMode::VECTOR, PathArena* arena = nullptr) const;
     
     /**
-     * @brief 重构路径
-     * @param from 起始节点
-     * @param to 目标节点
-     * @param parent 父节点数组
-     * @return 路径节点序列
+     * @brief 按任意策略分派搜索：选择代价函数对象并实例化对应的搜索内核
+     */
+    template <typename Queue>
+    PathResult customSearch(int source, int target, const Strategy& strategy,
+                            SearchAlgorithm algorithm) const;
+    
+    /**
+     * @brief 堆优化的Dijkstra算法实现
+     * @param source 起点下标
+     * @param target 终点下标
+     * @param cost 边代价函数对象（见 Strategy.h），内置策略为权重数组
+     * @param mode 路径输出方式
+     * @param arena 路径缓冲区
+     * @return 路径结果
      */
-    std::vector<int> reconstructPath(int from, int to, 
-                                     const std::unordered_map<int, int>& parent) const;
+    template <typename Queue, typename Cost>
+    PathResult dijkstra(int source, int target, const Cost& cost,
+                        PathMode mode = PathMode::VECTOR, PathArena* arena = nullptr) const;
+    
+    /**
+     * @brief 双向Dijkstra算法实现
+     * 交替扩展正向和反向搜索中堆顶较小的一侧，两侧堆顶之和不小于已知最短路径时停止
+     * @param source 起点下标
+     * @param target 终点下标
+     * @param cost 边代价函数对象（无向图，弧的两个方向代价相同）
+     * @param mode 路径输出方式
+     * @param arena 路径缓冲区
+     * @return 路径结果
+     */
+    template <typename Queue, typename Cost>
+    PathResult bidirectionalDijkstra(int source, int target, const Cost& cost,
+                                     PathMode mode = PathMode::VECTOR,
+                                     PathArena* arena = nullptr) const;
+    
+    /**
+     * @brief ALT 搜索：以地标下界为启发函数的 A*
+     * 地标下界满足一致性，节点出堆时即为最短距离，终点出堆即可停止
+     * @param source 起点下标
+     * @param target 终点下标
+     * @param strategy 策略类型（决定边权重和地标表）
+     * @param mode 路径输出方式
+     * @param arena 路径缓冲区
+     * @return 路径结果
+     */
+    template <typename Queue>
+    PathResult altSearch(int source, int target, PathStrategy strategy,
+                         PathMode mode = PathMode::VECTOR, PathArena* arena = nullptr) const;
+    
+    /**
+     * @brief 收缩层次查询，并把捷径展开为原始节点ID路径
+     * @param hierarchy 收缩层次
+     * @param source 起点下标
+     * @param target 终点下标
+     * @param mode 路径输出方式（只要距离时不展开捷径）
+     * @param arena 路径缓冲区
+     * @return 路径结果
+     */
+    PathResult hierarchySearch(const ContractionHierarchy& hierarchy, int source, int target,
+                               PathMode mode = PathMode::VECTOR, PathArena* arena = nullptr) const;
+    
+    /**
+     * @brief 预算受限搜索：按代价顺序对每个确定的节点调用 visit(下标, 代价, 工作区)
+     */
+    template <typename Visit>
+    bool boundedSearch(int from, double budget, PathStrategy strategy, Visit&& visit) const;
+    
+    template <typename Queue, typename Visit>
+    void boundedDijkstra(int source, double budget, const double* weights, Visit& visit) const;
+    
+    /**
+     * @brief Yen 算法主体（优先队列类型由模板参数决定）
+     */
+    template <typename Queue>
+    void kShortestPaths(int source, int target, int k, const double* weights,
+                        std::vector<PathResult>& results,
+                        std::chrono::steady_clock::time_point start) const;
+    
+    /**
+     * @brief 距离矩阵：收缩层次上的桶式多对多搜索
+     */
+    void hierarchyMatrix(const ContractionHierarchy& hierarchy, const std::vector<int>& sources,
+                         const std::vector<int>& targets, DistanceMatrix& matrix,
+                         ThreadPool* pool) const;
+    
+    /**
+     * @brief 距离矩阵：每个起点一次多目标 Dijkstra
+     */
+    template <typename Queue>
+    void multiTargetMatrix(const std::vector<int>& sources, const std::vector<int>& targets,
+                           PathStrategy strategy, DistanceMatrix& matrix, ThreadPool* pool) const;
+    
+    /**
+     * @brief 按输出方式分配路径存储：VECTOR 时为 result.path，ARENA 时在缓冲区中分配并设置 result.span
+     * @param length 路径节点数
+     * @param mode 路径输出方式（不能是 DISTANCE_ONLY）
+     * @param arena 路径缓冲区
+     * @param result 查询结果
+     * @return 长度为 length 的可写位置
+     */
+    int* allocatePath(size_t length, PathMode mode, PathArena* arena, PathResult& result) const;
+    
+    /**
+     * @brief 父节点链上从 from 到 to 的节点数（含两端）
+     * @param from 起始节点下标
+     * @param to 目标节点下标
+     * @param workspace 保存父节点的搜索工作区
+     * @return 节点数，链在到达 from 之前断开时为 0
+     */
+    size_t pathLength(int from, int to, const SearchWorkspace& workspace) const;
+    
+    /**
+     * @brief 沿父节点链从 to 回溯到 from，把外部节点ID按从起点到终点的顺序写入 out[0, length)
+     * @param to 目标节点下标
+     * @param workspace 保存父节点的搜索工作区
+     * @param out 输出位置
+     * @param length pathLength 给出的节点数
+     */
+    void writePath(int to, const SearchWorkspace& workspace, int* out, size_t length) const;
+    
+    /**
+     * @brief 重构路径并按输出方式写入结果
+     * @param from 起始节点下标
+     * @param to 目标节点下标
+     * @param workspace 保存父节点的搜索工作区
+     * @param mode 路径输出方式
+     * @param arena 路径缓冲区
+     * @param result 查询结果
+     */
+    void reconstructPath(int from, int to, const SearchWorkspace& workspace,
+                         PathMode mode, PathArena* arena, PathResult& result) const;
     
     const Graph& graph_;                    // 图的引用
     std::unique_ptr<Strategy> strategy_;   // 当前策略
-    
-    // 最小堆节点（用于优先队列）
-    struct HeapNode {
-        int nodeId;
-        double distance;
-        
-        HeapNode(int id, double dist) : nodeId(id), distance(dist) {}
-        
-        // 用于最小堆比较
-        bool operator>(const HeapNode& other) const {
-            return distance > other.distance;
-        }
-    };
+    PathStrategy strategyType_;            // 当前策略类型（决定使用哪组边权重）
+    SearchAlgorithm algorithm_;            // 当前搜索算法
+    QueueType queueType_;                  // 当前优先队列类型
+    const Landmarks* landmarks_;           // ALT 地标表（可选）
+    const ComponentIndex* components_;     // 连通分量索引（可选）
+    const ContractionHierarchy* hierarchies_[2];  // 每个策略的收缩层次（可选）
 };
 
 #endif // PATHFINDER_H
@@ -0,0 +1,311 @@
+#ifndef PRIORITYQUEUE_H
+#define PRIORITYQUEUE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @brief 堆元素（键值 + 稠密下标）
+ */
+struct HeapEntry {
+    double key;
+    int node;
+
+    HeapEntry() : key(0.0), node(0) {}
+    HeapEntry(double k, int n) : key(k), node(n) {}
+
+    // 用于最小堆比较（std::push_heap 默认构造最大堆，因此反向比较）
+    bool operator<(const HeapEntry& other) const {
+        return key > other.key;
+    }
+};
+
+/**
+ * @brief 优先队列类型
+ */
+enum class QueueType {
+    BINARY_HEAP,    // 二叉堆，惰性删除（改进距离时重复入队，出队时跳过已确定的节点）
+    DARY_HEAP,      // 带下标的4叉堆，真正的 decrease-key，每个节点最多一项
+    RADIX_HEAP      // 单调基数堆，要求出队键值单调不减（Dijkstra 类搜索满足）
+};
+
+/*
+ * 三种优先队列提供相同的接口，搜索算法以模板参数选择其中之一：
+ *   reset(nodeCount)   开始一次新的搜索
+ *   push(key, node)    插入；带下标的堆中节点已在队列里时为 decrease-key（键值不变大）
+ *   pop()              取出键值最小的元素
+ *   topKey()           最小键值（队列非空）
+ *   empty() / size()   状态；getPeakSize() 为本次搜索中队列的最大长度
+ * 缓冲区在搜索之间保留容量，首次搜索之后不再分配内存。
+ */
+
+/**
+ * @brief 二叉堆（惰性删除）
+ */
+class BinaryHeap {
+public:
+    BinaryHeap() : peakSize_(0) {}
+
+    void reset(size_t nodeCount) {
+        (void)nodeCount;
+        heap_.clear();
+        peakSize_ = 0;
+    }
+
+    void push(double key, int node) {
+        heap_.emplace_back(key, node);
+        std::push_heap(heap_.begin(), heap_.end());
+        if (heap_.size() > peakSize_) {
+            peakSize_ = heap_.size();
+        }
+    }
+
+    HeapEntry pop() {
+        std::pop_heap(heap_.begin(), heap_.end());
+        HeapEntry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+    const HeapEntry& top() const { return heap_.front(); }
+    double topKey() const { return heap_.front().key; }
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+    size_t getPeakSize() const { return peakSize_; }
+    size_t getMemoryUsage() const { return heap_.capacity() * sizeof(HeapEntry); }
+
+private:
+    std::vector<HeapEntry> heap_;
+    size_t peakSize_;
+};
+
+/**
+ * @brief 带下标的 d 叉最小堆
+ * 每个节点记录自己在堆中的位置，改进距离时原地减小键值并上浮，队列长度不超过前沿大小。
+ * d 取 4 时树高减半，下沉时比较的子节点位于同一缓存行。
+ */
+template <int ARITY>
+class IndexedDaryHeap {
+public:
+    static_assert(ARITY >= 2, "堆的叉数至少为2");
+
+    IndexedDaryHeap() : peakSize_(0) {}
+
+    void reset(size_t nodeCount) {
+        // 只清除上次搜索残留在堆中的节点，出队的节点已在 pop 时清除
+        for (const HeapEntry& entry : heap_) {
+            positions_[entry.node] = NOT_IN_HEAP;
+        }
+        heap_.clear();
+        if (positions_.size() < nodeCount) {
+            positions_.resize(nodeCount, NOT_IN_HEAP);
+        }
+        peakSize_ = 0;
+    }
+
+    void push(double key, int node) {
+        int position = positions_[node];
+        if (position == NOT_IN_HEAP) {
+            heap_.emplace_back(key, node);
+            if (heap_.size() > peakSize_) {
+                peakSize_ = heap_.size();
+            }
+            siftUp(heap_.size() - 1, HeapEntry(key, node));
+        } else if (key < heap_[position].key) {
+            siftUp(static_cast<size_t>(position), HeapEntry(key, node));
+        }
+    }
+
+    HeapEntry pop() {
+        HeapEntry top = heap_.front();
+        positions_[top.node] = NOT_IN_HEAP;
+        HeapEntry last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            siftDown(0, last);
+        }
+        return top;
+    }
+
+    bool contains(int node) const {
+        return static_cast<size_t>(node) < positions_.size() && positions_[node] != NOT_IN_HEAP;
+    }
+
+    const HeapEntry& top() const { return heap_.front(); }
+    double topKey() const { return heap_.front().key; }
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+    size_t getPeakSize() const { return peakSize_; }
+    size_t getMemoryUsage() const {
+        return heap_.capacity() * sizeof(HeapEntry) + positions_.capacity() * sizeof(int);
+    }
+
+private:
+    static constexpr int NOT_IN_HEAP = -1;
+
+    void place(size_t position, const HeapEntry& entry) {
+        heap_[position] = entry;
+        positions_[entry.node] = static_cast<int>(position);
+    }
+
+    void siftUp(size_t position, const HeapEntry& entry) {
+        while (position > 0) {
+            size_t parent = (position - 1) / ARITY;
+            if (heap_[parent].key <= entry.key) {
+                break;
+            }
+            place(position, heap_[parent]);
+            position = parent;
+        }
+        place(position, entry);
+    }
+
+    void siftDown(size_t position, const HeapEntry& entry) {
+        const size_t count = heap_.size();
+        while (true) {
+            size_t first = position * ARITY + 1;
+            if (first >= count) {
+                break;
+            }
+            size_t last = std::min(first + ARITY, count);
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (heap_[child].key < heap_[best].key) {
+                    best = child;
+                }
+            }
+            if (heap_[best].key >= entry.key) {
+                break;
+            }
+            place(position, heap_[best]);
+            position = best;
+        }
+        place(position, entry);
+    }
+
+    std::vector<HeapEntry> heap_;
+    std::vector<int> positions_;    // 节点在堆中的位置，不在堆中为 NOT_IN_HEAP
+    size_t peakSize_;
+};
+
+typedef IndexedDaryHeap<4> QuaternaryHeap;
+
+/**
+ * @brief 单调基数堆（惰性删除）
+ * 非负 double 的位模式按无符号整数比较时与数值顺序一致。元素按与最近出队键值
+ * 最高的不同位分桶，出队时只在最低的非空桶里找最小值并把该桶重新分配到更低的桶，
+ * 每个元素最多被移动 64 次，与堆的大小无关。
+ * 键值必须不小于最近出队的键值；浮点舍入造成的微小回退按最近出队的键值处理。
+ */
+class RadixHeap {
+public:
+    RadixHeap() : lastKey_(0.0), lastBits_(0), size_(0), peakSize_(0) {}
+
+    void reset(size_t nodeCount) {
+        (void)nodeCount;
+        for (std::vector<HeapEntry>& bucket : buckets_) {
+            bucket.clear();
+        }
+        lastKey_ = 0.0;
+        lastBits_ = 0;
+        size_ = 0;
+        peakSize_ = 0;
+    }
+
+    void push(double key, int node) {
+        if (key < lastKey_) {
+            key = lastKey_;
+        }
+        uint64_t bits = toBits(key);
+        buckets_[bucketOf(bits)].emplace_back(key, node);
+        if (++size_ > peakSize_) {
+            peakSize_ = size_;
+        }
+    }
+
+    HeapEntry pop() {
+        refill();
+        HeapEntry top = buckets_[0].back();
+        buckets_[0].pop_back();
+        size_--;
+        return top;
+    }
+
+    double topKey() {
+        refill();
+        return buckets_[0].back().key;
+    }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    size_t getPeakSize() const { return peakSize_; }
+    size_t getMemoryUsage() const {
+        size_t bytes = 0;
+        for (const std::vector<HeapEntry>& bucket : buckets_) {
+            bytes += bucket.capacity() * sizeof(HeapEntry);
+        }
+        return bytes;
+    }
+
+private:
+    static const int BUCKET_COUNT = 65;
+
+    static uint64_t toBits(double key) {
+        uint64_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    // 桶 0 存放等于最近出队键值的元素，桶 i 存放最高不同位为第 i-1 位的元素
+    size_t bucketOf(uint64_t bits) const {
+        uint64_t diff = bits ^ lastBits_;
+        if (diff == 0) {
+            return 0;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(64 - __builtin_clzll(diff));
+#else
+        size_t bucket = 0;
+        while (diff != 0) {
+            diff >>= 1;
+            bucket++;
+        }
+        return bucket;
+#endif
+    }
+
+    // 桶 0 为空时，以最低非空桶的最小键值为新基准，把该桶的元素分配到更低的桶
+    void refill() {
+        if (!buckets_[0].empty()) {
+            return;
+        }
+        size_t index = 1;
+        while (buckets_[index].empty()) {
+            index++;
+        }
+        std::vector<HeapEntry>& bucket = buckets_[index];
+        double minKey = bucket.front().key;
+        for (const HeapEntry& entry : bucket) {
+            if (entry.key < minKey) {
+                minKey = entry.key;
+            }
+        }
+        lastKey_ = minKey;
+        lastBits_ = toBits(minKey);
+        for (const HeapEntry& entry : bucket) {
+            buckets_[bucketOf(toBits(entry.key))].push_back(entry);
+        }
+        bucket.clear();
+    }
+
+    std::vector<HeapEntry> buckets_[BUCKET_COUNT];
+    double lastKey_;
+    uint64_t lastBits_;
+    size_t size_;
+    size_t peakSize_;
+};
+
+#endif // PRIORITYQUEUE_H
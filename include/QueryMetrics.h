@@ -0,0 +1,111 @@
+#ifndef QUERYMETRICS_H
+#define QUERYMETRICS_H
+
+#include "PathFinder.h"
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 直方图快照
+ * 桶按 2 的幂划分：第 0 个桶统计取值 0，第 i 个桶统计 (2^(i-2), 2^(i-1)]，最后一个桶为溢出（+Inf）
+ */
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;       // 各桶计数（不累积）
+    std::vector<double> upperBounds;    // 各桶上界（含），最后一个为 +Inf
+    uint64_t count;                     // 样本数
+    uint64_t sum;                       // 样本之和
+
+    HistogramSnapshot() : count(0), sum(0) {}
+
+    /**
+     * @brief 近似百分位：样本所在桶的上界
+     * @param p 百分位（0~1）
+     * @return 上界，没有样本时为 0
+     */
+    double percentile(double p) const;
+};
+
+/**
+ * @brief 聚合查询指标快照
+ */
+struct MetricsSnapshot {
+    uint64_t queries;                   // 查询数（含缓存命中）
+    uint64_t foundQueries;              // 找到路径的查询数
+    SearchStats totals;                 // 搜索计数器的累计值
+    HistogramSnapshot latency;          // 查询延迟（微秒）
+    HistogramSnapshot settledNodes;     // 每次查询确定的节点数
+
+    MetricsSnapshot() : queries(0), foundQueries(0) {}
+};
+
+/**
+ * @brief 查询指标聚合器
+ * 多个线程可以同时 record：每个计数器是一个原子变量，记录只做几次 relaxed 原子加法，
+ * 不加锁。快照逐个读取计数器，并发记录时各项之间可能相差正在进行的几次查询。
+ */
+class QueryMetrics {
+public:
+    // 直方图的桶数（最后一个为溢出桶）
+    static constexpr int BUCKET_COUNT = 32;
+
+    QueryMetrics();
+
+    // 禁止拷贝构造和赋值
+    QueryMetrics(const QueryMetrics&) = delete;
+    QueryMetrics& operator=(const QueryMetrics&) = delete;
+
+    /**
+     * @brief 记录一次查询
+     * @param result 查询结果（使用其执行时间和搜索计数器）
+     */
+    void record(const PathResult& result);
+
+    /**
+     * @brief 读取当前的聚合值
+     */
+    MetricsSnapshot snapshot() const;
+
+    /**
+     * @brief 清零所有计数器
+     */
+    void reset();
+
+    /**
+     * @brief 以 Prometheus 文本格式输出快照
+     * @param snapshot 指标快照
+     * @param prefix 指标名前缀
+     * @return 文本，每个指标带 HELP 和 TYPE 注释
+     */
+    static std::string toPrometheus(const MetricsSnapshot& snapshot,
+                                    const std::string& prefix = "path_planning");
+
+private:
+    /**
+     * @brief 原子计数的对数分桶直方图
+     */
+    class Histogram {
+    public:
+        Histogram();
+        void record(uint64_t value);
+        HistogramSnapshot snapshot() const;
+        void reset();
+
+    private:
+        std::atomic<uint64_t> buckets_[BUCKET_COUNT];  // 样本数为各桶之和
+        std::atomic<uint64_t> sum_;
+    };
+
+    std::atomic<uint64_t> queries_;
+    std::atomic<uint64_t> foundQueries_;
+    std::atomic<uint64_t> settledNodes_;
+    std::atomic<uint64_t> relaxedEdges_;
+    std::atomic<uint64_t> heapPushes_;
+    std::atomic<uint64_t> stalePops_;
+    Histogram latency_;
+    Histogram settled_;
+};
+
+#endif // QUERYMETRICS_H
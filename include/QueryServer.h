@@ -0,0 +1,107 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include "MapEngine.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 查询服务的输出格式
+ */
+enum class ServerFormat {
+    TEXT,   // 每个查询一行：from to weight [节点...]，不可达时 weight 为 -1
+    BINARY  // 每个查询一条记录（主机字节序）：int32 from, int32 to, uint8 found,
+            // float64 weight, uint32 节点数, int32 节点[节点数]
+};
+
+/**
+ * @brief 查询服务的运行统计
+ */
+struct ServerStats {
+    uint64_t queries;       // 执行的查询数
+    uint64_t found;         // 找到路径的查询数
+    uint64_t errors;        // 格式错误而跳过的行数
+    uint64_t batches;       // 批次数
+    double seconds;         // 从开始读取到输出完毕的时间（秒）
+    double searchSeconds;   // 搜索阶段的累计时间（秒）
+
+    ServerStats() : queries(0), found(0), errors(0), batches(0), seconds(0.0), searchSeconds(0.0) {}
+
+    /**
+     * @brief 持续吞吐量（查询数 / 总时间）
+     */
+    double getQps() const { return seconds > 0.0 ? static_cast<double>(queries) / seconds : 0.0; }
+};
+
+/**
+ * @brief 流式查询服务
+ * 地图只加载一次，之后从输入流逐行读取 "from to [distance|time]" 查询（空行和 # 开头的行忽略），
+ * 结果按输入顺序写到输出流。读取解析、搜索和格式化输出是三个流水线阶段：读取线程把查询
+ * 攒成批次，调用线程用引擎的线程池并行搜索整批（MapEngine::findPaths 的 PathBatch 重载），
+ * 输出线程把上一批结果格式化后整块写出，三个阶段同时处理相邻的批次。
+ * 读取不等待整块缓冲区填满：输入暂时没有更多数据时立即提交已读到的查询，交互使用时也能及时响应。
+ */
+class QueryServer {
+public:
+    // 默认每批最多的查询数
+    static constexpr size_t DEFAULT_BATCH_SIZE = 4096;
+
+    /**
+     * @brief 构造函数
+     * @param engine 已加载地图的引擎（使用其默认算法和线程池）
+     */
+    explicit QueryServer(const MapEngine& engine);
+
+    // 禁止拷贝构造和赋值
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * @brief 设置输出格式（默认 TEXT）
+     */
+    void setFormat(ServerFormat format) { format_ = format; }
+
+    /**
+     * @brief 设置每批最多的查询数
+     */
+    void setBatchSize(size_t batchSize) { batchSize_ = batchSize == 0 ? 1 : batchSize; }
+
+    /**
+     * @brief 设置是否只输出距离（不重建路径，输出中没有节点序列）
+     */
+    void setDistancesOnly(bool distancesOnly) { distancesOnly_ = distancesOnly; }
+
+    /**
+     * @brief 设置查询行没有给出策略时使用的策略（默认最短距离）
+     */
+    void setDefaultStrategy(PathStrategy strategy) { defaultStrategy_ = strategy; }
+
+    /**
+     * @brief 处理输入流中的全部查询，直到输入结束
+     * 格式错误的行写一条错误信息到 std::cerr 后跳过；输出流出错时停止
+     * @param in 查询输入
+     * @param out 结果输出
+     * @return 运行统计
+     */
+    ServerStats run(std::istream& in, std::ostream& out) const;
+
+    /**
+     * @brief 按名称解析输出格式（text / binary）
+     * @param name 名称
+     * @param format 输出的格式
+     * @return 名称是否有效
+     */
+    static bool parseFormat(const std::string& name, ServerFormat& format);
+
+private:
+    const MapEngine& engine_;
+    ServerFormat format_;
+    size_t batchSize_;
+    bool distancesOnly_;
+    PathStrategy defaultStrategy_;
+};
+
+#endif // QUERYSERVER_H
@@ -0,0 +1,93 @@
+#ifndef RCUSLOT_H
+#define RCUSLOT_H
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+
+/**
+ * @brief 读多写少的共享指针槽（RCU 风格发布）
+ * 读取不加锁：读者在两个计数器中按当前纪元的奇偶选一个加一，读出当前持有者并复制其中的
+ * shared_ptr（引用计数加一），再把计数器减一，全程只有原子加减。写者换上新的持有者后把
+ * 纪元翻转两次，每次等待翻转前的计数器归零（宽限期，只需等待读者完成一次指针复制），
+ * 之后不会再有读者访问旧的持有者，可以安全地删除它。新读者总是落在另一个计数器上，
+ * 写者不会被持续的读取饿死。
+ * libstdc++ 中 std::atomic_load(std::shared_ptr*) 通过全局互斥锁池实现，查询路径上用此类代替。
+ * 写操作相互串行（内部互斥锁），只有写者会等待。
+ */
+template <typename T>
+class RcuSlot {
+public:
+    /**
+     * @brief 构造函数
+     * @param value 初始值（可以为空）
+     */
+    explicit RcuSlot(std::shared_ptr<T> value = nullptr)
+        : current_(new Holder{std::move(value)}), epoch_(0) {}
+
+    ~RcuSlot() { delete current_.load(); }
+
+    // 禁止拷贝构造和赋值
+    RcuSlot(const RcuSlot&) = delete;
+    RcuSlot& operator=(const RcuSlot&) = delete;
+
+    /**
+     * @brief 读取当前值（无锁，可在任意线程并发调用）
+     * @return 当前值的引用，持有期间即使被替换也保持有效
+     */
+    std::shared_ptr<T> load() const {
+        ReaderCount& readers = readers_[epoch_.load() & 1u];
+        readers.count.fetch_add(1);
+        std::shared_ptr<T> value = current_.load()->value;
+        readers.count.fetch_sub(1);
+        return value;
+    }
+
+    /**
+     * @brief 替换当前值，等待宽限期结束后返回旧值
+     * 返回时之后的 load() 都看到新值；旧值的其他引用（正在进行的读取）释放后才销毁，
+     * 调用方可以据此决定在哪个线程中释放旧值
+     * @param value 新值
+     * @return 旧值
+     */
+    std::shared_ptr<T> exchange(std::shared_ptr<T> value) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        Holder* old = current_.exchange(new Holder{std::move(value)});
+        // 每个计数器都在替换之后归零过一次：在此之前加一的读者已经完成复制，
+        // 之后加一的读者读到的是新的持有者
+        for (int i = 0; i < 2; ++i) {
+            ReaderCount& readers = readers_[epoch_.fetch_add(1) & 1u];
+            while (readers.count.load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+        std::shared_ptr<T> previous = std::move(old->value);
+        delete old;
+        return previous;
+    }
+
+    /**
+     * @brief 替换当前值，丢弃旧值的引用
+     * @param value 新值
+     */
+    void store(std::shared_ptr<T> value) { exchange(std::move(value)); }
+
+private:
+    struct Holder {
+        std::shared_ptr<T> value;
+    };
+
+    // 两个计数器分处不同的缓存行，读者只写其中一个
+    struct alignas(64) ReaderCount {
+        std::atomic<uint64_t> count{0};
+    };
+
+    std::atomic<Holder*> current_;
+    mutable ReaderCount readers_[2];
+    std::atomic<unsigned> epoch_;
+    std::mutex writeMutex_;
+};
+
+#endif // RCUSLOT_H
@@ -0,0 +1,41 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <cstdint>
+
+/*
+ * 搜索计数器的编译开关：CMake 选项 ENABLE_SEARCH_STATS（默认开启）定义 PATH_PLANNING_SEARCH_STATS。
+ * 关闭时 SEARCH_STAT(...) 展开为空语句，计数代码不参与编译，搜索内核与没有计数器时完全相同。
+ */
+#ifdef PATH_PLANNING_SEARCH_STATS
+#define SEARCH_STAT(statement) statement
+#else
+#define SEARCH_STAT(statement) ((void)0)
+#endif
+
+/**
+ * @brief 单次查询的搜索计数器（见 PathResult::stats）
+ */
+struct SearchStats {
+#ifdef PATH_PLANNING_SEARCH_STATS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    uint64_t settledNodes;  // 出队并确定距离的节点数
+    uint64_t relaxedEdges;  // 检查过的边数
+    uint64_t heapPushes;    // 入队次数（带下标的堆中包括 decrease-key）
+    uint64_t stalePops;     // 出队时已确定而被跳过的过期项数（惰性删除的队列）
+
+    SearchStats() : settledNodes(0), relaxedEdges(0), heapPushes(0), stalePops(0) {}
+
+    void add(const SearchStats& other) {
+        settledNodes += other.settledNodes;
+        relaxedEdges += other.relaxedEdges;
+        heapPushes += other.heapPushes;
+        stalePops += other.stalePops;
+    }
+};
+
+#endif // SEARCHSTATS_H
@@ -0,0 +1,135 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include "PriorityQueue.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+/**
+ * @brief 可复用的搜索工作区
+ * 按稠密下标存放距离、父节点和状态戳的扁平数组，以及在查询之间保留容量的优先队列
+ * （每种 QueueType 一个，搜索算法按模板参数通过 getQueue 取用）。
+ * 每次搜索只递增代数（generation），状态戳不等于当前代数的节点视为未访问，
+ * 因此重置是 O(1) 的；数组只在图变大时扩容，首次查询之后搜索不再分配堆内存。
+ * 每个线程通过 forThread 取得自己的实例，互不共享。
+ */
+class SearchWorkspace {
+public:
+    // 同一线程内可同时使用的工作区槽位（例如双向搜索的两个方向）
+    enum Slot {
+        FORWARD = 0,
+        BACKWARD = 1,
+        SLOT_COUNT
+    };
+
+    static constexpr double INFINITE_DISTANCE = std::numeric_limits<double>::max();
+    static constexpr int NO_PARENT = -1;
+
+    SearchWorkspace();
+    ~SearchWorkspace();
+
+    // 禁止拷贝构造和赋值
+    SearchWorkspace(const SearchWorkspace&) = delete;
+    SearchWorkspace& operator=(const SearchWorkspace&) = delete;
+
+    /**
+     * @brief 获取当前线程的工作区
+     * @param slot 槽位
+     * @return 工作区引用
+     */
+    static SearchWorkspace& forThread(Slot slot = FORWARD);
+
+    /**
+     * @brief 开始一次新的搜索
+     * 数组容量不足时扩容，然后递增代数使所有节点回到未访问状态，并清空堆
+     * @param nodeCount 图中节点数
+     */
+    void beginSearch(size_t nodeCount);
+
+    /**
+     * @brief 节点在本次搜索中是否已被访问（已有暂定距离）
+     */
+    bool isReached(int node) const { return states_[node].stamp >= generation_; }
+
+    /**
+     * @brief 节点在本次搜索中是否已确定最短距离
+     */
+    bool isSettled(int node) const { return states_[node].stamp == generation_ + 1; }
+
+    /**
+     * @brief 获取暂定距离，未访问时为 INFINITE_DISTANCE
+     */
+    double getDistance(int node) const {
+        return isReached(node) ? states_[node].distance : INFINITE_DISTANCE;
+    }
+
+    /**
+     * @brief 获取父节点下标，未访问时为 NO_PARENT
+     */
+    int getParent(int node) const {
+        return isReached(node) ? states_[node].parent : NO_PARENT;
+    }
+
+    /**
+     * @brief 更新暂定距离和父节点（节点不能已确定）
+     */
+    void setDistance(int node, double distance, int parent) {
+        NodeState& state = states_[node];
+        state.distance = distance;
+        state.parent = parent;
+        state.stamp = generation_;
+    }
+
+    /**
+     * @brief 标记节点已确定最短距离
+     */
+    void markSettled(int node) { states_[node].stamp = generation_ + 1; }
+
+    /**
+     * @brief 默认最小堆（二叉堆）操作，beginSearch 时清空
+     */
+    void pushHeap(double key, int node) { binaryHeap_.push(key, node); }
+    HeapEntry popHeap() { return binaryHeap_.pop(); }
+    const HeapEntry& topHeap() const { return binaryHeap_.top(); }
+    bool isHeapEmpty() const { return binaryHeap_.empty(); }
+    size_t getHeapSize() const { return binaryHeap_.size(); }
+
+    /**
+     * @brief 取得指定类型的优先队列（BinaryHeap、QuaternaryHeap 或 RadixHeap）
+     * 除默认二叉堆外，使用前由搜索算法调用 reset
+     */
+    template <typename Queue>
+    Queue& getQueue();
+
+    /**
+     * @brief 工作区占用的内存（字节）
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    // 每个节点的搜索状态，stamp == generation_ 表示已访问，== generation_ + 1 表示已确定
+    struct NodeState {
+        double distance;
+        int parent;
+        uint32_t stamp;
+    };
+
+    std::vector<NodeState> states_;
+    BinaryHeap binaryHeap_;
+    QuaternaryHeap quaternaryHeap_;
+    RadixHeap radixHeap_;
+    uint32_t generation_;
+};
+
+template <>
+inline BinaryHeap& SearchWorkspace::getQueue<BinaryHeap>() { return binaryHeap_; }
+
+template <>
+inline QuaternaryHeap& SearchWorkspace::getQueue<QuaternaryHeap>() { return quaternaryHeap_; }
+
+template <>
+inline RadixHeap& SearchWorkspace::getQueue<RadixHeap>() { return radixHeap_; }
+
+#endif // SEARCHWORKSPACE_H
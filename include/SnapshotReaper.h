@@ -0,0 +1,84 @@
+#ifndef SNAPSHOTREAPER_H
+#define SNAPSHOTREAPER_H
+
+#include "MapSnapshot.h"
+#include <memory>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @brief 在后台线程中释放不再使用的快照
+ * 发布的快照经 adopt 包装：最后一个持有者（通常是查询线程）放下引用时，删除器只把快照
+ * 交给回收线程，图和预处理数据的大块内存在回收线程中释放，不占用查询的时间。
+ * 不需要轮询引用计数；watch 可以在某个快照被释放后得到通知。
+ * stop 之后（或回收器已销毁时）放下的快照在当前线程中直接释放。
+ */
+class SnapshotReaper : public std::enable_shared_from_this<SnapshotReaper> {
+public:
+    SnapshotReaper();
+
+    /**
+     * @brief 析构函数：释放已交来的快照后停止回收线程
+     */
+    ~SnapshotReaper();
+
+    // 禁止拷贝构造和赋值
+    SnapshotReaper(const SnapshotReaper&) = delete;
+    SnapshotReaper& operator=(const SnapshotReaper&) = delete;
+
+    /**
+     * @brief 包装快照：返回的引用全部释放后，快照交给回收线程释放
+     * 回收器必须由 std::shared_ptr 持有
+     * @param snapshot 快照（可以为空）
+     * @return 包装后的引用，指向同一个快照
+     */
+    std::shared_ptr<const MapSnapshot> adopt(std::shared_ptr<const MapSnapshot> snapshot);
+
+    /**
+     * @brief 在快照被回收线程释放后调用 callback（在回收线程中调用）
+     * 调用方在注册时必须仍持有该快照的引用；快照须经 adopt 包装，stop 之后不再通知
+     * @param snapshot 快照
+     * @param callback 释放后的回调
+     */
+    void watch(const MapSnapshot* snapshot, std::function<void()> callback);
+
+    /**
+     * @brief 释放已交来的快照，停止回收线程并丢弃未触发的通知（不能在回调中调用）
+     */
+    void stop();
+
+private:
+    /**
+     * @brief 删除器：把快照的最后一个引用交给回收器
+     */
+    struct Deleter {
+        std::weak_ptr<SnapshotReaper> reaper;
+        std::shared_ptr<const MapSnapshot> snapshot;
+
+        void operator()(const MapSnapshot*);
+    };
+
+    /**
+     * @brief 接收一个不再被引用的快照
+     */
+    void retire(std::shared_ptr<const MapSnapshot> snapshot);
+
+    /**
+     * @brief 回收线程主循环
+     */
+    void run();
+
+    std::deque<std::shared_ptr<const MapSnapshot>> retired_;
+    std::vector<std::pair<const MapSnapshot*, std::function<void()>>> watchers_;
+    std::thread thread_;    // 第一次回收时启动
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+};
+
+#endif // SNAPSHOTREAPER_H
@@ -1,6 +1,9 @@
 #ifndef STRATEGY_H
 #define STRATEGY_H
 
+#include <memory>
+#include <string>
+
 /**
  * @brief 路径规划策略枚举
  */
@@ -30,6 +33,19 @@ public:
      * @return 策略名称字符串
      */
     virtual const char* getName() const = 0;
+    
+    /**
+     * @brief 权重是否为距离和时间的线性组合 alpha * distance + beta * time
+     * 是线性组合的策略由搜索内核直接按系数内联计算，不再逐条边调用虚函数
+     * @param alpha 输出：距离的系数
+     * @param beta 输出：时间的系数
+     * @return 是否为线性组合
+     */
+    virtual bool getLinearCoefficients(double& alpha, double& beta) const {
+        (void)alpha;
+        (void)beta;
+        return false;
+    }
 };
 
 /**
@@ -44,6 +60,12 @@ public:
     const char* getName() const override {
         return "Shortest Distance";
     }
+    
+    bool getLinearCoefficients(double& alpha, double& beta) const override {
+        alpha = 1.0;
+        beta = 0.0;
+        return true;
+    }
 };
 
 /**
@@ -58,6 +80,99 @@ public:
     const char* getName() const override {
         return "Least Time";
     }
+    
+    bool getLinearCoefficients(double& alpha, double& beta) const override {
+        alpha = 0.0;
+        beta = 1.0;
+        return true;
+    }
+};
+
+/**
+ * @brief 线性组合策略：权重 = alpha * 距离 + beta * 时间（系数非负，不全为 0）
+ */
+class LinearCombinationStrategy : public Strategy {
+public:
+    LinearCombinationStrategy(const std::string& name, double alpha, double beta)
+        : name_(name), alpha_(alpha), beta_(beta) {}
+    
+    double calculateWeight(double distance, double time) const override {
+        return alpha_ * distance + beta_ * time;
+    }
+    
+    const char* getName() const override {
+        return name_.c_str();
+    }
+    
+    bool getLinearCoefficients(double& alpha, double& beta) const override {
+        alpha = alpha_;
+        beta = beta_;
+        return true;
+    }
+    
+private:
+    std::string name_;
+    double alpha_;
+    double beta_;
 };
 
+/*
+ * 边代价函数对象：搜索内核以模板参数接收，对 CSR 中第 arc 条弧求代价。
+ * 内置策略和线性组合编译为内联的数组访问，其他用户策略经 Strategy 的虚函数计算。
+ */
+
+/**
+ * @brief 单一权重数组（内置策略）
+ */
+struct ArrayCost {
+    const double* weights;
+    
+    explicit ArrayCost(const double* w) : weights(w) {}
+    double operator()(int arc) const { return weights[arc]; }
+};
+
+/**
+ * @brief 距离和时间的线性组合
+ */
+struct LinearCost {
+    const double* distances;
+    const double* times;
+    double alpha;
+    double beta;
+    
+    LinearCost(const double* d, const double* t, double a, double b)
+        : distances(d), times(t), alpha(a), beta(b) {}
+    double operator()(int arc) const { return alpha * distances[arc] + beta * times[arc]; }
+};
+
+/**
+ * @brief 任意用户策略（每条边一次虚函数调用）
+ */
+struct StrategyCost {
+    const Strategy* strategy;
+    const double* distances;
+    const double* times;
+    
+    StrategyCost(const Strategy* s, const double* d, const double* t)
+        : strategy(s), distances(d), times(t) {}
+    double operator()(int arc) const {
+        return strategy->calculateWeight(distances[arc], times[arc]);
+    }
+};
+
+/**
+ * @brief 根据策略类型创建策略对象
+ * @param strategy 策略类型
+ * @return 策略对象
+ */
+inline std::unique_ptr<Strategy> createStrategy(PathStrategy strategy) {
+    switch (strategy) {
+        case PathStrategy::LEAST_TIME:
+            return std::make_unique<LeastTimeStrategy>();
+        case PathStrategy::SHORTEST_DISTANCE:
+        default:
+            return std::make_unique<ShortestDistanceStrategy>();
+    }
+}
+
 #endif // STRATEGY_H
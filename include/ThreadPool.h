@@ -0,0 +1,61 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+
+/**
+ * @brief 固定大小的线程池
+ * 用于把一批相互独立的查询分散到多个线程。parallelFor 的调用线程也参与执行，
+ * 因此并行度为工作线程数加一；多个线程可以同时调用 parallelFor。
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 构造函数
+     * @param threadCount 并行度（含调用线程），0 表示使用硬件线程数
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief 析构函数：等待已提交的任务完成后停止工作线程
+     */
+    ~ThreadPool();
+
+    // 禁止拷贝构造和赋值
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 并行度（工作线程数加调用线程）
+     * @return 线程数
+     */
+    size_t getThreadCount() const { return workers_.size() + 1; }
+
+    /**
+     * @brief 对 [0, count) 中的每个下标调用 body，全部完成后返回
+     * 下标按需动态分配给各线程，耗时不均的任务也能保持负载均衡
+     * @param count 任务数
+     * @param body 任务函数，参数为下标
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+private:
+    /**
+     * @brief 工作线程主循环
+     */
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+};
+
+#endif // THREADPOOL_H
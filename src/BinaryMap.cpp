@@ -0,0 +1,487 @@
+#include "../include/BinaryMap.h"
+#include "../include/MappedFile.h"
+#include "../include/DataLoader.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
+#include <vector>
+
+namespace {
+    const char MAP_MAGIC[8] = {'P', 'E', 'M', 'A', 'P', 'B', 'I', 'N'};
+    const uint32_t BYTE_ORDER_MARK = 0x01020304u;
+    const uint64_t SECTION_ALIGNMENT = 64;
+    const uint32_t MAX_SECTION_COUNT = 64;
+
+    enum SectionType : uint32_t {
+        SECTION_OFFSETS = 1,
+        SECTION_TARGETS = 2,
+        SECTION_DISTANCES = 3,
+        SECTION_TIMES = 4,
+        SECTION_NODE_IDS = 5,
+        SECTION_ID_TABLE = 6,
+        SECTION_SORTED_IDS = 7,
+        SECTION_SORTED_INDICES = 8,
+        SECTION_LANDMARK_INDICES = 16,     // 附加参数：建表时图的校验和
+        SECTION_LANDMARK_DISTANCES = 17,
+        SECTION_LANDMARK_TIMES = 18,
+        SECTION_CH_RANK = 32,              // 附加参数：捷径数量；收缩层次各段按策略加 8 * 策略下标
+        SECTION_CH_UP_OFFSETS = 33,
+        SECTION_CH_UP_TARGETS = 34,
+        SECTION_CH_UP_WEIGHTS = 35,
+        SECTION_CH_UP_MIDDLES = 36
+    };
+    const uint32_t CH_SECTION_STRIDE = 8;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t fileSize;
+        uint64_t nodeCount;
+        uint64_t edgeCount;
+        int64_t idBase;
+        uint32_t sectionCount;
+        uint32_t reserved;
+        uint64_t payloadChecksum;
+        uint64_t headerChecksum;     // 覆盖文件头（本字段除外）和段表
+    };
+
+    struct SectionEntry {
+        uint32_t type;
+        uint32_t elementSize;
+        uint64_t offset;
+        uint64_t count;
+        uint64_t extra;
+    };
+
+    /**
+     * @brief 按 8 字节字计算的 FNV-1a 校验和，可以分段输入
+     */
+    class ChecksumBuilder {
+    public:
+        ChecksumBuilder() : hash_(14695981039346656037ULL), pendingBytes_(0) {}
+
+        void update(const void* data, size_t bytes) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            while (bytes > 0 && pendingBytes_ > 0) {
+                pending_[pendingBytes_++] = *p++;
+                bytes--;
+                if (pendingBytes_ == sizeof(uint64_t)) {
+                    mixWord(pending_);
+                    pendingBytes_ = 0;
+                }
+            }
+            for (; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t), p += sizeof(uint64_t)) {
+                mixWord(p);
+            }
+            if (bytes > 0) {
+                // 剩余不足一个字的字节留待下次输入（此时缓冲区一定为空）
+                std::memcpy(pending_, p, bytes);
+                pendingBytes_ = bytes;
+            }
+        }
+
+        uint64_t finish() {
+            for (size_t i = 0; i < pendingBytes_; ++i) {
+                hash_ ^= pending_[i];
+                hash_ *= 1099511628211ULL;
+            }
+            pendingBytes_ = 0;
+            return hash_;
+        }
+
+    private:
+        void mixWord(const unsigned char* p) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            hash_ ^= word;
+            hash_ *= 1099511628211ULL;
+        }
+
+        uint64_t hash_;
+        unsigned char pending_[sizeof(uint64_t)];
+        size_t pendingBytes_;
+    };
+
+    uint64_t computeHeaderChecksum(const FileHeader& header, const SectionEntry* sections) {
+        ChecksumBuilder builder;
+        builder.update(&header, offsetof(FileHeader, headerChecksum));
+        builder.update(sections, header.sectionCount * sizeof(SectionEntry));
+        return builder.finish();
+    }
+
+    // 待写入的段
+    struct OutputSection {
+        SectionEntry entry;
+        const void* data;
+    };
+
+    template <typename T>
+    void addSection(std::vector<OutputSection>& sections, uint32_t type,
+                    const T* data, size_t count, uint64_t extra = 0) {
+        OutputSection section;
+        section.entry.type = type;
+        section.entry.elementSize = sizeof(T);
+        section.entry.offset = 0;
+        section.entry.count = count;
+        section.entry.extra = extra;
+        section.data = data;
+        sections.push_back(section);
+    }
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+    /**
+     * @brief 已校验的段表，按类型查找
+     */
+    class SectionTable {
+    public:
+        SectionTable(const char* base, const SectionEntry* entries, uint32_t count)
+            : base_(base), entries_(entries), count_(count) {}
+
+        const SectionEntry* find(uint32_t type) const {
+            for (uint32_t i = 0; i < count_; ++i) {
+                if (entries_[i].type == type) {
+                    return &entries_[i];
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief 取得段数据，段不存在或元素大小、个数不符时返回空
+         */
+        template <typename T>
+        const T* get(uint32_t type, uint64_t expectedCount) const {
+            const SectionEntry* entry = find(type);
+            if (entry == nullptr || entry->elementSize != sizeof(T) || entry->count != expectedCount) {
+                return nullptr;
+            }
+            return reinterpret_cast<const T*>(base_ + entry->offset);
+        }
+
+    private:
+        const char* base_;
+        const SectionEntry* entries_;
+        uint32_t count_;
+    };
+}
+
+bool BinaryMap::isBinaryMap(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(MAP_MAGIC)];
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return std::memcmp(magic, MAP_MAGIC, sizeof(MAP_MAGIC)) == 0;
+}
+
+bool BinaryMap::save(const std::string& filename, const MapSnapshot& snapshot) {
+    const Graph& graph = snapshot.getGraph();
+    if (!graph.isFinalized()) {
+        return false;
+    }
+
+    const size_t n = graph.getNodeCount();
+    const size_t arcs = graph.targets_.size();
+
+    std::vector<OutputSection> sections;
+    addSection(sections, SECTION_OFFSETS, graph.offsets_.data(), graph.offsets_.size());
+    addSection(sections, SECTION_TARGETS, graph.targets_.data(), arcs);
+    addSection(sections, SECTION_DISTANCES, graph.distances_.data(), arcs);
+    addSection(sections, SECTION_TIMES, graph.times_.data(), arcs);
+    addSection(sections, SECTION_NODE_IDS, graph.denseToExternal_.data(), n);
+    if (!graph.idTable_.empty()) {
+        addSection(sections, SECTION_ID_TABLE, graph.idTable_.data(), graph.idTable_.size());
+    } else if (!graph.sortedIds_.empty()) {
+        addSection(sections, SECTION_SORTED_IDS, graph.sortedIds_.data(), n);
+        addSection(sections, SECTION_SORTED_INDICES, graph.sortedIndices_.data(), n);
+    }
+
+    const Landmarks* landmarks = snapshot.getLandmarks();
+    // 时间表正在重新计算或已缩放的地标表不保存（段直接指向表，加载后可以重新构建）
+    if (landmarks && landmarks->hasTable(PathStrategy::LEAST_TIME) &&
+        landmarks->getScale(PathStrategy::LEAST_TIME) == 1.0) {
+        size_t tableSize = n * static_cast<size_t>(landmarks->getLandmarkCount());
+        addSection(sections, SECTION_LANDMARK_INDICES, landmarks->landmarkIndices_.data(),
+                   landmarks->landmarkIndices_.size(), landmarks->graphChecksum_);
+        addSection(sections, SECTION_LANDMARK_DISTANCES, landmarks->distanceTable_.data(), tableSize);
+        addSection(sections, SECTION_LANDMARK_TIMES, landmarks->timeTable_.data(), tableSize);
+    }
+
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    for (PathStrategy strategy : strategies) {
+        const ContractionHierarchy* hierarchy = snapshot.getContractionHierarchy(strategy);
+        if (!hierarchy || !hierarchy->isBuilt()) {
+            continue;
+        }
+        uint32_t base = CH_SECTION_STRIDE * static_cast<uint32_t>(strategy);
+        size_t upEdges = hierarchy->upTargets_.size();
+        addSection(sections, SECTION_CH_RANK + base, hierarchy->rank_.data(), n,
+                   hierarchy->shortcutCount_);
+        addSection(sections, SECTION_CH_UP_OFFSETS + base, hierarchy->upOffsets_.data(), n + 1);
+        addSection(sections, SECTION_CH_UP_TARGETS + base, hierarchy->upTargets_.data(), upEdges);
+        addSection(sections, SECTION_CH_UP_WEIGHTS + base, hierarchy->upWeights_.data(), upEdges);
+        addSection(sections, SECTION_CH_UP_MIDDLES + base, hierarchy->upMiddles_.data(), upEdges);
+    }
+
+    // 计算各段偏移
+    std::vector<SectionEntry> entries;
+    uint64_t position = alignUp(sizeof(FileHeader) + sections.size() * sizeof(SectionEntry));
+    const uint64_t payloadStart = position;
+    for (OutputSection& section : sections) {
+        section.entry.offset = position;
+        position = alignUp(position + section.entry.count * section.entry.elementSize);
+        entries.push_back(section.entry);
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+    header.version = FILE_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.fileSize = position;
+    header.nodeCount = n;
+    header.edgeCount = graph.getEdgeCount();
+    header.idBase = graph.idBase_;
+    header.sectionCount = static_cast<uint32_t>(sections.size());
+
+    // 写入临时文件后改名：直接覆盖会改变其他进程已映射的页
+    const std::string tempFilename = filename + ".tmp";
+    std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "错误：无法写入二进制地图文件 " << tempFilename << std::endl;
+        return false;
+    }
+
+    // 先写占位的文件头和段表，负载写完后回填校验和
+    const char zeros[SECTION_ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SectionEntry));
+    file.write(zeros, payloadStart - sizeof(header) - entries.size() * sizeof(SectionEntry));
+
+    ChecksumBuilder payload;
+    uint64_t written = payloadStart;
+    for (const OutputSection& section : sections) {
+        size_t bytes = section.entry.count * section.entry.elementSize;
+        file.write(static_cast<const char*>(section.data), bytes);
+        payload.update(section.data, bytes);
+        written += bytes;
+
+        size_t padding = alignUp(written) - written;
+        file.write(zeros, padding);
+        payload.update(zeros, padding);
+        written += padding;
+    }
+
+    header.payloadChecksum = payload.finish();
+    header.headerChecksum = computeHeaderChecksum(header, entries.data());
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        std::cerr << "错误：写入二进制地图文件 " << tempFilename << " 失败" << std::endl;
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+        std::cerr << "错误：无法替换二进制地图文件 " << filename << std::endl;
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const MapSnapshot> BinaryMap::load(const std::string& filename, bool verifyChecksum) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(filename, false)) {
+        std::cerr << "错误：无法打开文件 " << filename << std::endl;
+        return nullptr;
+    }
+
+    const char* base = file->getData();
+    const size_t size = file->getSize();
+
+    // 文件头和段表
+    FileHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "错误：二进制地图文件 " << filename << " 不完整" << std::endl;
+        return nullptr;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC)) != 0 ||
+        header.version != FILE_VERSION || header.byteOrder != BYTE_ORDER_MARK) {
+        std::cerr << "错误：二进制地图文件 " << filename << " 格式或版本不受支持" << std::endl;
+        return nullptr;
+    }
+    if (header.fileSize != size || header.sectionCount > MAX_SECTION_COUNT ||
+        sizeof(header) + header.sectionCount * sizeof(SectionEntry) > size) {
+        std::cerr << "错误：二进制地图文件 " << filename << " 不完整" << std::endl;
+        return nullptr;
+    }
+    const SectionEntry* entries = reinterpret_cast<const SectionEntry*>(base + sizeof(header));
+    if (computeHeaderChecksum(header, entries) != header.headerChecksum) {
+        std::cerr << "错误：二进制地图文件 " << filename << " 文件头校验失败" << std::endl;
+        return nullptr;
+    }
+
+    uint64_t payloadStart = alignUp(sizeof(header) + header.sectionCount * sizeof(SectionEntry));
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        const SectionEntry& entry = entries[i];
+        if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset < payloadStart ||
+            entry.elementSize == 0 || entry.count > (size - entry.offset) / entry.elementSize) {
+            std::cerr << "错误：二进制地图文件 " << filename << " 段表损坏" << std::endl;
+            return nullptr;
+        }
+    }
+
+    if (verifyChecksum) {
+        ChecksumBuilder payload;
+        payload.update(base + payloadStart, size - payloadStart);
+        if (payload.finish() != header.payloadChecksum) {
+            std::cerr << "错误：二进制地图文件 " << filename << " 数据校验失败" << std::endl;
+            return nullptr;
+        }
+    }
+
+    // 图：数组直接指向映射的页
+    const SectionTable table(base, entries, header.sectionCount);
+    const uint64_t n = header.nodeCount;
+    const SectionEntry* targetsEntry = table.find(SECTION_TARGETS);
+    const uint64_t arcs = targetsEntry ? targetsEntry->count : 0;
+
+    const int* offsets = table.get<int>(SECTION_OFFSETS, n + 1);
+    const int* targets = table.get<int>(SECTION_TARGETS, arcs);
+    const double* distances = table.get<double>(SECTION_DISTANCES, arcs);
+    const double* times = table.get<double>(SECTION_TIMES, arcs);
+    const int* nodeIds = table.get<int>(SECTION_NODE_IDS, n);
+    if (!offsets || !targets || !distances || !times || (n > 0 && !nodeIds) ||
+        arcs != 2 * header.edgeCount || offsets[0] != 0 || static_cast<uint64_t>(offsets[n]) != arcs) {
+        std::cerr << "错误：二进制地图文件 " << filename << " 缺少图数据" << std::endl;
+        return nullptr;
+    }
+
+    auto graph = std::make_shared<Graph>();
+    graph->offsets_.view(offsets, n + 1);
+    graph->targets_.view(targets, arcs);
+    graph->distances_.view(distances, arcs);
+    graph->times_.view(times, arcs);
+    graph->denseToExternal_.view(nodeIds, n);
+    graph->idBase_ = static_cast<int>(header.idBase);
+    if (const SectionEntry* idTableEntry = table.find(SECTION_ID_TABLE)) {
+        const int* idTable = table.get<int>(SECTION_ID_TABLE, idTableEntry->count);
+        if (!idTable) {
+            std::cerr << "错误：二进制地图文件 " << filename << " 缺少ID映射" << std::endl;
+            return nullptr;
+        }
+        graph->idTable_.view(idTable, idTableEntry->count);
+    } else if (n > 0) {
+        const int* sortedIds = table.get<int>(SECTION_SORTED_IDS, n);
+        const int* sortedIndices = table.get<int>(SECTION_SORTED_INDICES, n);
+        if (!sortedIds || !sortedIndices) {
+            std::cerr << "错误：二进制地图文件 " << filename << " 缺少ID映射" << std::endl;
+            return nullptr;
+        }
+        graph->sortedIds_.view(sortedIds, n);
+        graph->sortedIndices_.view(sortedIndices, n);
+    }
+    graph->edgeCount_ = header.edgeCount;
+    graph->finalized_ = true;
+    graph->mapping_ = file;
+
+    // 可选：地标表
+    std::shared_ptr<Landmarks> landmarks;
+    if (const SectionEntry* indicesEntry = table.find(SECTION_LANDMARK_INDICES)) {
+        uint64_t count = indicesEntry->count;
+        const int* indices = table.get<int>(SECTION_LANDMARK_INDICES, count);
+        const double* distanceTable = table.get<double>(SECTION_LANDMARK_DISTANCES, n * count);
+        const double* timeTable = table.get<double>(SECTION_LANDMARK_TIMES, n * count);
+        if (indices && distanceTable && timeTable && count > 0) {
+            landmarks = std::make_shared<Landmarks>();
+            landmarks->landmarkIndices_.assign(indices, indices + count);
+            landmarks->landmarkCount_ = static_cast<int>(count);
+            landmarks->nodeCount_ = n;
+            landmarks->graphChecksum_ = indicesEntry->extra;
+            landmarks->distanceTable_.view(distanceTable, n * count);
+            landmarks->timeTable_.view(timeTable, n * count);
+            landmarks->mapping_ = file;
+        }
+    }
+
+    // 可选：每个策略的收缩层次
+    std::shared_ptr<ContractionHierarchy> hierarchies[2];
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    for (PathStrategy strategy : strategies) {
+        uint32_t sectionBase = CH_SECTION_STRIDE * static_cast<uint32_t>(strategy);
+        const SectionEntry* rankEntry = table.find(SECTION_CH_RANK + sectionBase);
+        const SectionEntry* upTargetsEntry = table.find(SECTION_CH_UP_TARGETS + sectionBase);
+        if (!rankEntry || !upTargetsEntry || n == 0) {
+            continue;
+        }
+        uint64_t upEdges = upTargetsEntry->count;
+        const int* rank = table.get<int>(SECTION_CH_RANK + sectionBase, n);
+        const int* upOffsets = table.get<int>(SECTION_CH_UP_OFFSETS + sectionBase, n + 1);
+        const int* upTargets = table.get<int>(SECTION_CH_UP_TARGETS + sectionBase, upEdges);
+        const double* upWeights = table.get<double>(SECTION_CH_UP_WEIGHTS + sectionBase, upEdges);
+        const int* upMiddles = table.get<int>(SECTION_CH_UP_MIDDLES + sectionBase, upEdges);
+        if (!rank || !upOffsets || !upTargets || !upWeights || !upMiddles ||
+            static_cast<uint64_t>(upOffsets[n]) != upEdges) {
+            continue;
+        }
+
+        auto hierarchy = std::make_shared<ContractionHierarchy>();
+        hierarchy->metric_ = strategy;
+        hierarchy->shortcutCount_ = rankEntry->extra;
+        hierarchy->rank_.view(rank, n);
+        hierarchy->upOffsets_.view(upOffsets, n + 1);
+        hierarchy->upTargets_.view(upTargets, upEdges);
+        hierarchy->upWeights_.view(upWeights, upEdges);
+        hierarchy->upMiddles_.view(upMiddles, upEdges);
+        hierarchy->mapping_ = file;
+        hierarchies[static_cast<int>(strategy)] = std::move(hierarchy);
+    }
+
+    return std::make_shared<MapSnapshot>(std::move(graph), std::move(landmarks),
+                                         std::move(hierarchies[0]), std::move(hierarchies[1]));
+}
+
+bool BinaryMap::convertTextMap(const std::string& textFilename, const std::string& binaryFilename,
+                               int landmarkCount, bool buildHierarchies, NodeOrder order) {
+    auto graph = std::make_shared<Graph>();
+    DataLoader loader;
+    if (!loader.loadFromFile(textFilename, *graph)) {
+        return false;
+    }
+    NodeOrdering::apply(*graph, order);
+
+    std::shared_ptr<Landmarks> landmarks;
+    if (landmarkCount > 0) {
+        landmarks = std::make_shared<Landmarks>();
+        if (!landmarks->build(*graph, landmarkCount, LandmarkSelection::AVOID)) {
+            landmarks.reset();
+        }
+    }
+
+    std::shared_ptr<ContractionHierarchy> hierarchies[2];
+    if (buildHierarchies) {
+        const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+        for (PathStrategy strategy : strategies) {
+            auto hierarchy = std::make_shared<ContractionHierarchy>();
+            if (hierarchy->build(*graph, strategy)) {
+                hierarchies[static_cast<int>(strategy)] = std::move(hierarchy);
+            }
+        }
+    }
+
+    MapSnapshot snapshot(std::move(graph), std::move(landmarks),
+                         std::move(hierarchies[0]), std::move(hierarchies[1]));
+    return save(binaryFilename, snapshot);
+}
@@ -0,0 +1,79 @@
+#include "../include/ComponentIndex.h"
+#include <algorithm>
+#include <numeric>
+#include <functional>
+
+ComponentIndex::ComponentIndex() = default;
+
+ComponentIndex::~ComponentIndex() = default;
+
+void ComponentIndex::build(const Graph& graph) {
+    const int n = static_cast<int>(graph.getNodeCount());
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    
+    labels_.assign(n, NO_COMPONENT);
+    sizes_.clear();
+    
+    // 广度优先遍历，队列复用一个数组（每个节点恰好入队一次）
+    std::vector<int> queue(n);
+    for (int start = 0; start < n; ++start) {
+        if (labels_[start] != NO_COMPONENT) {
+            continue;
+        }
+        const int component = static_cast<int>(sizes_.size());
+        int head = 0;
+        int tail = 0;
+        queue[tail++] = start;
+        labels_[start] = component;
+        while (head < tail) {
+            int u = queue[head++];
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = targets[e];
+                if (labels_[v] == NO_COMPONENT) {
+                    labels_[v] = component;
+                    queue[tail++] = v;
+                }
+            }
+        }
+        sizes_.push_back(tail);
+    }
+    
+    // 按大小降序重新编号（大小相同时保持发现顺序）
+    std::vector<int> order(sizes_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return sizes_[a] > sizes_[b];
+    });
+    std::vector<int> renumber(sizes_.size());
+    std::vector<int> sortedSizes(sizes_.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        renumber[order[i]] = static_cast<int>(i);
+        sortedSizes[i] = sizes_[order[i]];
+    }
+    for (int& label : labels_) {
+        label = renumber[label];
+    }
+    sizes_.swap(sortedSizes);
+}
+
+size_t ComponentIndex::getComponentSize(int component) const {
+    if (component < 0 || static_cast<size_t>(component) >= sizes_.size()) {
+        return 0;
+    }
+    return static_cast<size_t>(sizes_[component]);
+}
+
+ComponentStats ComponentIndex::getStats() const {
+    ComponentStats stats;
+    stats.componentCount = sizes_.size();
+    stats.largestComponentSize = sizes_.empty() ? 0 : static_cast<size_t>(sizes_.front());
+    // 大小降序，孤立点（大小为 1 的分量）在末尾
+    stats.isolatedNodeCount = static_cast<size_t>(
+        sizes_.end() - std::lower_bound(sizes_.begin(), sizes_.end(), 1, std::greater<int>()));
+    return stats;
+}
+
+size_t ComponentIndex::getMemoryUsage() const {
+    return labels_.capacity() * sizeof(int) + sizes_.capacity() * sizeof(int);
+}
@@ -0,0 +1,921 @@
+#include "../include/ContractionHierarchy.h"
+#include "../include/SearchWorkspace.h"
+#include "../include/MappedFile.h"
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace {
+    // 见证搜索最多确定的节点数；搜索不完整只会多插入捷径，不影响正确性
+    const int WITNESS_SETTLE_LIMIT = 500;
+
+    struct DynamicEdge {
+        int to;
+        double weight;
+        int middle;
+    };
+
+    struct Shortcut {
+        int from;
+        int to;
+        double weight;
+    };
+
+    /**
+     * @brief 收缩过程使用的动态图和见证搜索
+     */
+    class HierarchyBuilder {
+    public:
+        HierarchyBuilder(const Graph& graph, const double* weights)
+            : n_(graph.getNodeCount()), adj_(n_), contracted_(n_, 0), deletedNeighbors_(n_, 0),
+              witnessDist_(n_, ContractionHierarchy::INFINITE_DISTANCE) {
+            const int* offsets = graph.getOffsets();
+            const int* targets = graph.getTargets();
+            for (size_t u = 0; u < n_; ++u) {
+                for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                    // 去掉自环，平行边只保留最短的一条
+                    if (static_cast<size_t>(targets[e]) != u) {
+                        addOrImprove(static_cast<int>(u), targets[e], weights[e],
+                                     ContractionHierarchy::NO_MIDDLE);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief 按优先级依次收缩所有节点
+         * @param rank 输出的层次
+         * @param upward 输出的每个节点的向上边
+         */
+        void run(std::vector<int>& rank, std::vector<std::vector<DynamicEdge>>& upward) {
+            rank.assign(n_, 0);
+            upward.assign(n_, std::vector<DynamicEdge>());
+            priority_.assign(n_, 0);
+
+            typedef std::pair<int, int> Item;  // (优先级, 节点)
+            std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+            for (size_t v = 0; v < n_; ++v) {
+                priority_[v] = computePriority(static_cast<int>(v));
+                queue.push(Item(priority_[v], static_cast<int>(v)));
+            }
+
+            int order = 0;
+            while (!queue.empty()) {
+                Item top = queue.top();
+                queue.pop();
+                int v = top.second;
+                if (contracted_[v] || top.first != priority_[v]) {
+                    continue;
+                }
+
+                // 惰性更新：重新计算优先级，若不再是最小则放回队列
+                int current = computePriority(v);
+                if (!queue.empty() && current > queue.top().first) {
+                    priority_[v] = current;
+                    queue.push(Item(current, v));
+                    continue;
+                }
+
+                contract(v, upward[v]);
+                rank[v] = order++;
+
+                // 邻居的边差和已删除邻居数发生变化，更新其优先级
+                for (const DynamicEdge& edge : upward[v]) {
+                    int u = edge.to;
+                    deletedNeighbors_[u]++;
+                    priority_[u] = computePriority(u);
+                    queue.push(Item(priority_[u], u));
+                }
+            }
+        }
+
+    private:
+        void addOrImprove(int u, int w, double weight, int middle) {
+            for (DynamicEdge& edge : adj_[u]) {
+                if (edge.to == w) {
+                    if (weight < edge.weight) {
+                        edge.weight = weight;
+                        edge.middle = middle;
+                    }
+                    return;
+                }
+            }
+            adj_[u].push_back({w, weight, middle});
+        }
+
+        /**
+         * @brief 不经过 avoid 的有界Dijkstra，结果在 witnessDist_ 中
+         */
+        void witnessSearch(int source, int avoid, double maxDist) {
+            for (int v : touched_) {
+                witnessDist_[v] = ContractionHierarchy::INFINITE_DISTANCE;
+            }
+            touched_.clear();
+            heap_.clear();
+
+            witnessDist_[source] = 0.0;
+            touched_.push_back(source);
+            heap_.emplace_back(0.0, source);
+
+            int settled = 0;
+            while (!heap_.empty()) {
+                std::pop_heap(heap_.begin(), heap_.end());
+                HeapEntry current = heap_.back();
+                heap_.pop_back();
+                int u = current.node;
+                if (current.key > witnessDist_[u]) {
+                    continue;
+                }
+                if (current.key > maxDist || ++settled > WITNESS_SETTLE_LIMIT) {
+                    break;
+                }
+                for (const DynamicEdge& edge : adj_[u]) {
+                    int v = edge.to;
+                    if (v == avoid || contracted_[v]) {
+                        continue;
+                    }
+                    double newDist = current.key + edge.weight;
+                    if (newDist < witnessDist_[v]) {
+                        if (witnessDist_[v] == ContractionHierarchy::INFINITE_DISTANCE) {
+                            touched_.push_back(v);
+                        }
+                        witnessDist_[v] = newDist;
+                        heap_.emplace_back(newDist, v);
+                        std::push_heap(heap_.begin(), heap_.end());
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief 收缩 v 需要插入的捷径
+         */
+        void findShortcuts(int v, std::vector<Shortcut>& shortcuts) {
+            shortcuts.clear();
+            neighbors_.clear();
+            for (const DynamicEdge& edge : adj_[v]) {
+                if (!contracted_[edge.to]) {
+                    neighbors_.push_back(edge);
+                }
+            }
+
+            // 无向图：每对邻居只需从其中一端做见证搜索
+            for (size_t i = 0; i + 1 < neighbors_.size(); ++i) {
+                double maxOther = 0.0;
+                for (size_t j = i + 1; j < neighbors_.size(); ++j) {
+                    maxOther = std::max(maxOther, neighbors_[j].weight);
+                }
+                witnessSearch(neighbors_[i].to, v, neighbors_[i].weight + maxOther);
+
+                for (size_t j = i + 1; j < neighbors_.size(); ++j) {
+                    double via = neighbors_[i].weight + neighbors_[j].weight;
+                    if (witnessDist_[neighbors_[j].to] > via) {
+                        shortcuts.push_back({neighbors_[i].to, neighbors_[j].to, via});
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief 优先级：边差（捷径数 - 删除的边数）为主，已收缩邻居数用于让收缩在图上分布均匀
+         */
+        int computePriority(int v) {
+            findShortcuts(v, shortcuts_);
+            int edgeDifference = static_cast<int>(shortcuts_.size()) -
+                                 static_cast<int>(neighbors_.size());
+            return 2 * edgeDifference + deletedNeighbors_[v];
+        }
+
+        void contract(int v, std::vector<DynamicEdge>& upward) {
+            findShortcuts(v, shortcuts_);
+
+            // 此时剩余的邻居都比 v 晚收缩，它们之间的边就是 v 的向上边
+            upward = neighbors_;
+
+            for (const Shortcut& s : shortcuts_) {
+                addOrImprove(s.from, s.to, s.weight, v);
+                addOrImprove(s.to, s.from, s.weight, v);
+            }
+
+            // 从邻居的邻接表中移除 v，缩短之后的见证搜索
+            for (const DynamicEdge& edge : upward) {
+                std::vector<DynamicEdge>& list = adj_[edge.to];
+                list.erase(std::remove_if(list.begin(), list.end(),
+                                          [v](const DynamicEdge& e) { return e.to == v; }),
+                           list.end());
+            }
+
+            contracted_[v] = 1;
+            std::vector<DynamicEdge>().swap(adj_[v]);
+        }
+
+        size_t n_;
+        std::vector<std::vector<DynamicEdge>> adj_;
+        std::vector<char> contracted_;
+        std::vector<int> deletedNeighbors_;
+        std::vector<int> priority_;
+
+        // 见证搜索状态（只重置被访问过的节点）
+        std::vector<double> witnessDist_;
+        std::vector<int> touched_;
+        std::vector<HeapEntry> heap_;
+
+        // 临时缓冲区
+        std::vector<DynamicEdge> neighbors_;
+        std::vector<Shortcut> shortcuts_;
+    };
+
+    /**
+     * @brief 嵌套剖分排序（定制使用的节点顺序）
+     * 从伪外围节点出发做广度优先搜索，取包含中位节点的那一层中与下一层相连的节点作为分隔集，
+     * 分隔集排在两侧之后，两侧之间没有边，再分别递归。消去时的填充边局限在各部分内部，
+     * 路网上向上图只比原图大几倍；见证搜索得到的顺序没有这个性质，填充边会多出两个数量级
+     */
+    class NestedDissection {
+    public:
+        explicit NestedDissection(const Graph& graph)
+            : graph_(graph), member_(graph.getNodeCount(), 0), seen_(graph.getNodeCount(), 0),
+              level_(graph.getNodeCount(), 0), memberStamp_(0), seenStamp_(0), nextRank_(0) {}
+
+        /**
+         * @brief 计算所有节点的层次（分隔集的层次高于被它分开的部分）
+         */
+        std::vector<int> run() {
+            const size_t n = graph_.getNodeCount();
+            rank_.assign(n, 0);
+            nextRank_ = static_cast<int>(n);
+            std::vector<int> nodes(n);
+            for (size_t v = 0; v < n; ++v) {
+                nodes[v] = static_cast<int>(v);
+            }
+            dissect(nodes);
+            return rank_;
+        }
+
+    private:
+        void dissect(const std::vector<int>& nodes) {
+            if (nodes.size() <= 2) {
+                for (int v : nodes) {
+                    rank_[v] = --nextRank_;
+                }
+                return;
+            }
+            const int member = ++memberStamp_;
+            for (int v : nodes) {
+                member_[v] = member;
+            }
+
+            // 不连通时各连通分量相互独立
+            std::vector<int> order;
+            seenStamp_++;
+            search(nodes[0], order);
+            if (order.size() < nodes.size()) {
+                std::vector<std::vector<int>> components(1, order);
+                for (int v : nodes) {
+                    if (seen_[v] != seenStamp_) {
+                        search(v, order);
+                        components.push_back(order);
+                    }
+                }
+                for (const std::vector<int>& component : components) {
+                    dissect(component);
+                }
+                return;
+            }
+
+            // 伪外围节点：离任意节点最远的节点
+            seenStamp_++;
+            search(order.back(), order);
+            int middle = level_[order[order.size() / 2]];
+            std::vector<int> separator;
+            std::vector<int> lower;
+            std::vector<int> upper;
+            const int* offsets = graph_.getOffsets();
+            const int* targets = graph_.getTargets();
+            for (int v : order) {
+                if (level_[v] < middle) {
+                    lower.push_back(v);
+                } else if (level_[v] > middle) {
+                    upper.push_back(v);
+                } else {
+                    bool bordersUpper = false;
+                    for (int e = offsets[v]; e < offsets[v + 1] && !bordersUpper; ++e) {
+                        bordersUpper = member_[targets[e]] == member && level_[targets[e]] > middle;
+                    }
+                    (bordersUpper ? separator : lower).push_back(v);
+                }
+            }
+            if (upper.empty()) {
+                // 中位节点在最后一层：整层作为分隔集
+                separator.clear();
+                lower.clear();
+                for (int v : order) {
+                    (level_[v] < middle ? lower : separator).push_back(v);
+                }
+            }
+            for (int v : separator) {
+                rank_[v] = --nextRank_;
+            }
+            dissect(upper);
+            dissect(lower);
+        }
+
+        /**
+         * @brief 在当前节点集内从 start 广度优先搜索，输出访问顺序并记录层数
+         */
+        void search(int start, std::vector<int>& order) {
+            const int* offsets = graph_.getOffsets();
+            const int* targets = graph_.getTargets();
+            const int member = memberStamp_;
+            order.clear();
+            order.push_back(start);
+            seen_[start] = seenStamp_;
+            level_[start] = 0;
+            for (size_t head = 0; head < order.size(); ++head) {
+                int u = order[head];
+                for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                    int v = targets[e];
+                    if (member_[v] == member && seen_[v] != seenStamp_) {
+                        seen_[v] = seenStamp_;
+                        level_[v] = level_[u] + 1;
+                        order.push_back(v);
+                    }
+                }
+            }
+        }
+
+        const Graph& graph_;
+        std::vector<int> member_;   // 属于当前节点集的节点标记为 memberStamp_
+        std::vector<int> seen_;     // 当前搜索访问过的节点标记为 seenStamp_
+        std::vector<int> level_;
+        std::vector<int> rank_;
+        int memberStamp_;
+        int seenStamp_;
+        int nextRank_;
+    };
+}
+
+ContractionHierarchy::ContractionHierarchy()
+    : metric_(PathStrategy::SHORTEST_DISTANCE), shortcutCount_(0) {
+}
+
+ContractionHierarchy::~ContractionHierarchy() = default;
+
+bool ContractionHierarchy::build(const Graph& graph, PathStrategy metric) {
+    if (!graph.isFinalized()) {
+        return false;
+    }
+
+    metric_ = metric;
+    const size_t n = graph.getNodeCount();
+
+    std::vector<int> rank;
+    std::vector<std::vector<DynamicEdge>> upward;
+    {
+        HierarchyBuilder builder(graph, graph.getWeights(metric));
+        builder.run(rank, upward);
+    }
+
+    // 向上边打包为CSR
+    std::vector<int> upOffsets(n + 1, 0);
+    for (size_t v = 0; v < n; ++v) {
+        upOffsets[v + 1] = upOffsets[v] + static_cast<int>(upward[v].size());
+    }
+    std::vector<int> upTargets(static_cast<size_t>(upOffsets[n]));
+    std::vector<double> upWeights(static_cast<size_t>(upOffsets[n]));
+    std::vector<int> upMiddles(static_cast<size_t>(upOffsets[n]));
+
+    shortcutCount_ = 0;
+    for (size_t v = 0; v < n; ++v) {
+        int pos = upOffsets[v];
+        for (const DynamicEdge& edge : upward[v]) {
+            upTargets[pos] = edge.to;
+            upWeights[pos] = edge.weight;
+            upMiddles[pos] = edge.middle;
+            if (edge.middle != NO_MIDDLE) {
+                shortcutCount_++;
+            }
+            pos++;
+        }
+    }
+
+    rank_.assign(std::move(rank));
+    upOffsets_.assign(std::move(upOffsets));
+    upTargets_.assign(std::move(upTargets));
+    upWeights_.assign(std::move(upWeights));
+    upMiddles_.assign(std::move(upMiddles));
+    downOffsets_.clear();
+    downSources_.clear();
+    downEdges_.clear();
+    mapping_.reset();
+    base_.reset();
+
+    return true;
+}
+
+std::shared_ptr<ContractionHierarchy> ContractionHierarchy::customize(
+    const Graph& graph, const std::shared_ptr<const ContractionHierarchy>& previous) {
+    if (!previous || !previous->isBuilt() || !graph.isFinalized() ||
+        previous->rank_.size() != graph.getNodeCount()) {
+        return nullptr;
+    }
+
+    auto customized = std::make_shared<ContractionHierarchy>();
+    customized->metric_ = previous->metric_;
+    if (previous->isCustomizable()) {
+        customized->shareStructure(previous);
+    } else {
+        std::vector<int> rank = NestedDissection(graph).run();
+        customized->buildStructure(graph, rank.data());
+    }
+    customized->computeWeights(graph);
+    return customized;
+}
+
+std::shared_ptr<ContractionHierarchy> ContractionHierarchy::customize(
+    const Graph& graph, const std::shared_ptr<const ContractionHierarchy>& previous,
+    const std::vector<std::pair<int, int>>& changedEdges) {
+    if (!previous || !previous->isCustomizable() || !graph.isFinalized() ||
+        previous->rank_.size() != graph.getNodeCount()) {
+        return customize(graph, previous);
+    }
+
+    auto customized = std::make_shared<ContractionHierarchy>();
+    customized->metric_ = previous->metric_;
+    customized->shareStructure(previous);
+    customized->updateWeights(graph, *previous, changedEdges);
+    return customized;
+}
+
+void ContractionHierarchy::shareStructure(const std::shared_ptr<const ContractionHierarchy>& previous) {
+    // 连续多次定制时直接引用最初持有结构数组的层次，不形成引用链
+    base_ = previous->base_ ? previous->base_ : previous;
+    mapping_ = previous->mapping_;
+    rank_.view(previous->rank_.data(), previous->rank_.size());
+    upOffsets_.view(previous->upOffsets_.data(), previous->upOffsets_.size());
+    upTargets_.view(previous->upTargets_.data(), previous->upTargets_.size());
+    downOffsets_.view(previous->downOffsets_.data(), previous->downOffsets_.size());
+    downSources_.view(previous->downSources_.data(), previous->downSources_.size());
+    downEdges_.view(previous->downEdges_.data(), previous->downEdges_.size());
+}
+
+void ContractionHierarchy::buildStructure(const Graph& graph, const int* rank) {
+    const size_t n = graph.getNodeCount();
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+
+    // 按层次从低到高消去节点：v 的更高邻居两两相连。只需把 v 的邻居并入其中层次最低的
+    // 邻居 p，p 被消去时再继续向上传递，得到的边与两两相连相同
+    std::vector<std::vector<int>> up(n);
+    for (size_t u = 0; u < n; ++u) {
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            if (rank[u] < rank[targets[e]]) {
+                up[u].push_back(targets[e]);
+            }
+        }
+    }
+    std::vector<int> order(n);
+    for (size_t v = 0; v < n; ++v) {
+        order[rank[v]] = static_cast<int>(v);
+    }
+    for (int v : order) {
+        std::vector<int>& list = up[v];
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+        if (list.size() < 2) {
+            continue;
+        }
+        int parent = *std::min_element(list.begin(), list.end(),
+                                       [rank](int a, int b) { return rank[a] < rank[b]; });
+        for (int x : list) {
+            if (x != parent) {
+                up[parent].push_back(x);
+            }
+        }
+    }
+
+    // 向上图（每个节点的目标按下标排序，便于二分查找）和反向索引打包为CSR
+    std::vector<int> upOffsets(n + 1, 0);
+    std::vector<int> downOffsets(n + 1, 0);
+    for (size_t v = 0; v < n; ++v) {
+        upOffsets[v + 1] = upOffsets[v] + static_cast<int>(up[v].size());
+        for (int x : up[v]) {
+            downOffsets[x + 1]++;
+        }
+    }
+    for (size_t v = 0; v < n; ++v) {
+        downOffsets[v + 1] += downOffsets[v];
+    }
+    const size_t m = static_cast<size_t>(upOffsets[n]);
+    std::vector<int> upTargets(m);
+    std::vector<int> downSources(m);
+    std::vector<int> downEdges(m);
+    std::vector<int> cursor(downOffsets.begin(), downOffsets.end() - 1);
+    for (size_t v = 0; v < n; ++v) {
+        int pos = upOffsets[v];
+        for (int x : up[v]) {
+            upTargets[pos] = x;
+            int down = cursor[x]++;
+            downSources[down] = static_cast<int>(v);
+            downEdges[down] = pos;
+            pos++;
+        }
+        std::vector<int>().swap(up[v]);
+    }
+
+    rank_.assign(std::vector<int>(rank, rank + n));
+    upOffsets_.assign(std::move(upOffsets));
+    upTargets_.assign(std::move(upTargets));
+    downOffsets_.assign(std::move(downOffsets));
+    downSources_.assign(std::move(downSources));
+    downEdges_.assign(std::move(downEdges));
+    mapping_.reset();
+    base_.reset();
+}
+
+void ContractionHierarchy::computeWeights(const Graph& graph) {
+    const size_t n = rank_.size();
+    const size_t m = upTargets_.size();
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    const double* weights = graph.getWeights(metric_);
+
+    // 原始边取图中的权重（平行边取最小），其余的边先为无穷大
+    std::vector<double> upWeights(m, INFINITE_DISTANCE);
+    std::vector<int> upMiddles(m, NO_MIDDLE);
+    for (size_t u = 0; u < n; ++u) {
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int x = targets[e];
+            if (rank_[u] < rank_[x]) {
+                int k = findUpwardEdge(static_cast<int>(u), x);
+                upWeights[k] = std::min(upWeights[k], weights[e]);
+            }
+        }
+    }
+
+    // 自底向上：处理 v 时 v 的向上边已是最终权重（只能经过更低的节点改进），
+    // 用经过 v 的路径改进 v 的每对向上邻居之间的边
+    std::vector<int> order(n);
+    for (size_t v = 0; v < n; ++v) {
+        order[rank_[v]] = static_cast<int>(v);
+    }
+    for (int v : order) {
+        for (int i = upOffsets_[v]; i < upOffsets_[v + 1]; ++i) {
+            if (upWeights[i] == INFINITE_DISTANCE) {
+                continue;
+            }
+            for (int j = i + 1; j < upOffsets_[v + 1]; ++j) {
+                if (upWeights[j] == INFINITE_DISTANCE) {
+                    continue;
+                }
+                int k = findUpwardEdge(upTargets_[i], upTargets_[j]);
+                double via = upWeights[i] + upWeights[j];
+                if (via < upWeights[k]) {
+                    upWeights[k] = via;
+                    upMiddles[k] = v;
+                }
+            }
+        }
+    }
+
+    upWeights_.assign(std::move(upWeights));
+    upMiddles_.assign(std::move(upMiddles));
+    countShortcuts();
+}
+
+void ContractionHierarchy::updateWeights(const Graph& graph, const ContractionHierarchy& previous,
+                                         const std::vector<std::pair<int, int>>& changedEdges) {
+    const size_t n = rank_.size();
+    const size_t m = upTargets_.size();
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    const double* weights = graph.getWeights(metric_);
+    const double* before = previous.upWeights_.data();
+
+    std::vector<double> upWeights(before, before + m);
+    std::vector<int> upMiddles(previous.upMiddles_.begin(), previous.upMiddles_.end());
+    // 原来取得最小值的路径（原始边或经过中间节点的两条边）变长，需要从头计算的边
+    std::vector<char> recompute(m, 0);
+
+    // 有边需要处理的节点按层次从低到高处理：节点的向上边只依赖更低节点的向上边，
+    // 处理时这些边都已是最终权重，每个节点最多处理一次
+    typedef std::pair<int, int> Item;  // (层次, 节点)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    std::vector<char> queued(n, 0);
+    auto schedule = [&](int a, int b) {
+        int lower = rank_[a] < rank_[b] ? a : b;
+        if (!queued[lower]) {
+            queued[lower] = 1;
+            queue.push(Item(rank_[lower], lower));
+        }
+    };
+    auto baseWeight = [&](int a, int b) {
+        double best = INFINITE_DISTANCE;
+        for (int e = offsets[a]; e < offsets[a + 1]; ++e) {
+            if (targets[e] == b) {
+                best = std::min(best, weights[e]);
+            }
+        }
+        return best;
+    };
+
+    for (const std::pair<int, int>& edge : changedEdges) {
+        int k = edge.first == edge.second ? -1 : findUpwardEdge(edge.first, edge.second);
+        if (k < 0) {
+            continue;
+        }
+        double base = baseWeight(edge.first, edge.second);
+        if (base < upWeights[k]) {
+            upWeights[k] = base;
+            upMiddles[k] = NO_MIDDLE;
+        } else if (base > upWeights[k] && upMiddles[k] == NO_MIDDLE) {
+            recompute[k] = 1;
+        }
+        schedule(edge.first, edge.second);
+    }
+
+    while (!queue.empty()) {
+        int x = queue.top().second;
+        queue.pop();
+        const int begin = upOffsets_[x];
+        const int end = upOffsets_[x + 1];
+
+        // 从头计算：原始边的权重与经过每个更低公共邻居 v 的 w(v, x) + w(v, b) 取最小。
+        // 两个端点的反向索引都按 v 的下标排序，归并求交集
+        for (int k = begin; k < end; ++k) {
+            if (!recompute[k]) {
+                continue;
+            }
+            int b = upTargets_[k];
+            double best = baseWeight(x, b);
+            int middle = NO_MIDDLE;
+            int i = downOffsets_[x];
+            int j = downOffsets_[b];
+            while (i < downOffsets_[x + 1] && j < downOffsets_[b + 1]) {
+                if (downSources_[i] < downSources_[j]) {
+                    i++;
+                } else if (downSources_[j] < downSources_[i]) {
+                    j++;
+                } else {
+                    double lowerToX = upWeights[downEdges_[i]];
+                    double lowerToB = upWeights[downEdges_[j]];
+                    if (lowerToX != INFINITE_DISTANCE && lowerToB != INFINITE_DISTANCE &&
+                        lowerToX + lowerToB < best) {
+                        best = lowerToX + lowerToB;
+                        middle = downSources_[i];
+                    }
+                    i++;
+                    j++;
+                }
+            }
+            upWeights[k] = best;
+            upMiddles[k] = middle;
+        }
+
+        // 经过 x 的三角形：x 的向上边变化后，用新权重改进两端之间的边；
+        // 该边原来经过 x 取得最小值而现在变长时，改为从头计算
+        for (int i = begin; i < end; ++i) {
+            if (upWeights[i] == before[i]) {
+                continue;
+            }
+            for (int j = begin; j < end; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                int k = findUpwardEdge(upTargets_[i], upTargets_[j]);
+                double via = upWeights[i] == INFINITE_DISTANCE || upWeights[j] == INFINITE_DISTANCE
+                                 ? INFINITE_DISTANCE : upWeights[i] + upWeights[j];
+                if (via < upWeights[k]) {
+                    upWeights[k] = via;
+                    upMiddles[k] = x;
+                    schedule(upTargets_[i], upTargets_[j]);
+                } else if (via > upWeights[k] && upMiddles[k] == x) {
+                    recompute[k] = 1;
+                    schedule(upTargets_[i], upTargets_[j]);
+                }
+            }
+        }
+    }
+
+    upWeights_.assign(std::move(upWeights));
+    upMiddles_.assign(std::move(upMiddles));
+    countShortcuts();
+}
+
+void ContractionHierarchy::countShortcuts() {
+    shortcutCount_ = 0;
+    for (int middle : upMiddles_) {
+        if (middle != NO_MIDDLE) {
+            shortcutCount_++;
+        }
+    }
+}
+
+double ContractionHierarchy::query(int source, int target, std::vector<int>* path,
+                                  SearchStats* stats) const {
+    if (path) {
+        path->clear();
+    }
+    if (source == target) {
+        if (path) {
+            path->push_back(source);
+        }
+        return 0.0;
+    }
+
+    SearchWorkspace& fwd = SearchWorkspace::forThread(SearchWorkspace::FORWARD);
+    SearchWorkspace& bwd = SearchWorkspace::forThread(SearchWorkspace::BACKWARD);
+    fwd.beginSearch(rank_.size());
+    bwd.beginSearch(rank_.size());
+
+    fwd.setDistance(source, 0.0, SearchWorkspace::NO_PARENT);
+    fwd.pushHeap(0.0, source);
+    bwd.setDistance(target, 0.0, SearchWorkspace::NO_PARENT);
+    bwd.pushHeap(0.0, target);
+
+    double best = INFINITE_DISTANCE;
+    int meeting = SearchWorkspace::NO_PARENT;
+    bool forwardDone = false;
+    bool backwardDone = false;
+    SearchStats counters;
+
+    while (!forwardDone || !backwardDone) {
+        // 交替扩展两个方向；某一方向的堆顶不小于已知最短路径时该方向结束
+        bool forward;
+        if (forwardDone) {
+            forward = false;
+        } else if (backwardDone) {
+            forward = true;
+        } else if (fwd.isHeapEmpty()) {
+            forward = false;
+        } else if (bwd.isHeapEmpty()) {
+            forward = true;
+        } else {
+            forward = fwd.topHeap().key <= bwd.topHeap().key;
+        }
+        SearchWorkspace& self = forward ? fwd : bwd;
+        SearchWorkspace& other = forward ? bwd : fwd;
+
+        if (self.isHeapEmpty() || self.topHeap().key >= best) {
+            (forward ? forwardDone : backwardDone) = true;
+            continue;
+        }
+
+        HeapEntry current = self.popHeap();
+        int u = current.node;
+        if (self.isSettled(u)) {
+            SEARCH_STAT(counters.stalePops++);
+            continue;
+        }
+        self.markSettled(u);
+        SEARCH_STAT(counters.settledNodes++);
+        double d = self.getDistance(u);
+
+        if (other.isReached(u) && d + other.getDistance(u) < best) {
+            best = d + other.getDistance(u);
+            meeting = u;
+        }
+
+        // stall-on-demand：若能从更高层次的节点以更短距离到达 u，则 u 不是最短路径上的点
+        bool stalled = false;
+        for (int e = upOffsets_[u]; e < upOffsets_[u + 1]; ++e) {
+            int x = upTargets_[e];
+            if (self.isReached(x) && self.getDistance(x) + upWeights_[e] < d) {
+                stalled = true;
+                break;
+            }
+        }
+        if (stalled) {
+            continue;
+        }
+
+        for (int e = upOffsets_[u]; e < upOffsets_[u + 1]; ++e) {
+            int x = upTargets_[e];
+            double newDist = d + upWeights_[e];
+            SEARCH_STAT(counters.relaxedEdges++);
+            if (!self.isSettled(x) && newDist < self.getDistance(x)) {
+                self.setDistance(x, newDist, u);
+                self.pushHeap(newDist, x);
+                SEARCH_STAT(counters.heapPushes++);
+            }
+        }
+    }
+    if (stats) {
+        stats->add(counters);
+    }
+
+    if (meeting == SearchWorkspace::NO_PARENT) {
+        return INFINITE_DISTANCE;
+    }
+
+    if (path) {
+        // 向上图中的路径：起点 -> 相遇点 -> 终点
+        thread_local std::vector<int> upPath;
+        upPath.clear();
+        for (int node = meeting; node != SearchWorkspace::NO_PARENT; node = fwd.getParent(node)) {
+            upPath.push_back(node);
+        }
+        std::reverse(upPath.begin(), upPath.end());
+        for (int node = bwd.getParent(meeting); node != SearchWorkspace::NO_PARENT;
+             node = bwd.getParent(node)) {
+            upPath.push_back(node);
+        }
+
+        // 逐条展开捷径
+        path->push_back(upPath.front());
+        for (size_t i = 0; i + 1 < upPath.size(); ++i) {
+            unpackEdge(upPath[i], upPath[i + 1], *path);
+        }
+    }
+
+    return best;
+}
+
+void ContractionHierarchy::upwardSearch(int origin, std::vector<HeapEntry>& space) const {
+    space.clear();
+    SearchWorkspace& ws = SearchWorkspace::forThread(SearchWorkspace::FORWARD);
+    ws.beginSearch(rank_.size());
+    ws.setDistance(origin, 0.0, SearchWorkspace::NO_PARENT);
+    ws.pushHeap(0.0, origin);
+
+    while (!ws.isHeapEmpty()) {
+        int u = ws.popHeap().node;
+        if (ws.isSettled(u)) {
+            continue;
+        }
+        ws.markSettled(u);
+        double d = ws.getDistance(u);
+
+        bool stalled = false;
+        for (int e = upOffsets_[u]; e < upOffsets_[u + 1]; ++e) {
+            int x = upTargets_[e];
+            if (ws.isReached(x) && ws.getDistance(x) + upWeights_[e] < d) {
+                stalled = true;
+                break;
+            }
+        }
+        if (stalled) {
+            continue;
+        }
+        space.emplace_back(d, u);
+
+        for (int e = upOffsets_[u]; e < upOffsets_[u + 1]; ++e) {
+            int x = upTargets_[e];
+            double newDist = d + upWeights_[e];
+            if (!ws.isSettled(x) && newDist < ws.getDistance(x)) {
+                ws.setDistance(x, newDist, u);
+                ws.pushHeap(newDist, x);
+            }
+        }
+    }
+}
+
+int ContractionHierarchy::findUpwardEdge(int a, int b) const {
+    int lower = rank_[a] < rank_[b] ? a : b;
+    int higher = lower == a ? b : a;
+    if (isCustomizable()) {
+        // 可定制层次的向上边按目标下标排序
+        const int* begin = upTargets_.data() + upOffsets_[lower];
+        const int* end = upTargets_.data() + upOffsets_[lower + 1];
+        const int* it = std::lower_bound(begin, end, higher);
+        return it != end && *it == higher ? static_cast<int>(it - upTargets_.data()) : -1;
+    }
+    for (int e = upOffsets_[lower]; e < upOffsets_[lower + 1]; ++e) {
+        if (upTargets_[e] == higher) {
+            return e;
+        }
+    }
+    return -1;
+}
+
+void ContractionHierarchy::unpackEdge(int a, int b, std::vector<int>& path) const {
+    // 显式栈代替递归，避免长捷径链导致栈溢出
+    std::vector<std::pair<int, int>> stack;
+    stack.emplace_back(a, b);
+    while (!stack.empty()) {
+        std::pair<int, int> segment = stack.back();
+        stack.pop_back();
+
+        int e = findUpwardEdge(segment.first, segment.second);
+        int middle = e >= 0 ? upMiddles_[e] : NO_MIDDLE;
+        if (middle == NO_MIDDLE) {
+            path.push_back(segment.second);
+        } else {
+            // 先展开前半段（后入栈先出）
+            stack.emplace_back(middle, segment.second);
+            stack.emplace_back(segment.first, middle);
+        }
+    }
+}
+
+size_t ContractionHierarchy::getMemoryUsage() const {
+    return rank_.getMemoryUsage()
+         + upOffsets_.getMemoryUsage()
+         + upTargets_.getMemoryUsage()
+         + upWeights_.getMemoryUsage()
+         + upMiddles_.getMemoryUsage()
+         + downOffsets_.getMemoryUsage()
+         + downSources_.getMemoryUsage()
+         + downEdges_.getMemoryUsage();
+}
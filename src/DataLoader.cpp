@@ -1,17 +1,93 @@
 #include "../include/DataLoader.h"
+#include "../include/MappedFile.h"
+#include "../include/ThreadPool.h"
 #include <fstream>
-#include <sstream>
 #include <iostream>
 #include <functional>
+#include <charconv>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 
-DataLoader::DataLoader() : lastNodeCount_(0), lastEdgeCount_(0) {
+namespace {
+    // 每个解析块至少这么大，小文件不值得启动线程
+    const size_t MIN_CHUNK_BYTES = 1 << 20;
+    // 每个线程分到的块数，块多一些便于负载均衡
+    const size_t CHUNKS_PER_THREAD = 4;
+
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    inline const char* skipSpace(const char* p, const char* end) {
+        while (p != end && isSpace(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    /**
+     * @brief 读取一个以空白分隔的数值
+     * 与流输入一致：允许前导正号，行内最后一个字段之后的内容忽略；
+     * 其他字段之后必须是空白
+     * @param p 读取位置，成功时移动到数值之后
+     * @param end 行结束
+     * @param value 输出的数值
+     * @param last 是否为最后一个字段
+     * @return 是否成功
+     */
+    template <typename T>
+    bool parseNumber(const char*& p, const char* end, T& value, bool last) {
+        p = skipSpace(p, end);
+        if (p != end && *p == '+' && p + 1 != end && p[1] != '-') {
+            ++p;
+        }
+        std::from_chars_result parsed = std::from_chars(p, end, value);
+        if (parsed.ec != std::errc()) {
+            return false;
+        }
+        if (!last && parsed.ptr != end && !isSpace(*parsed.ptr)) {
+            return false;
+        }
+        p = parsed.ptr;
+        if constexpr (std::is_floating_point<T>::value) {
+            // from_chars 接受 inf / nan，文本格式中不允许
+            return std::isfinite(value);
+        }
+        return true;
+    }
+
+    // 解析结果：边或单独声明的节点，按文件顺序保存
+    struct ParsedRecord {
+        int from;
+        int to;          // 节点声明时等于 from
+        double distance;
+        double time;
+        bool isNode;
+    };
+
+    struct ParsedChunk {
+        std::vector<ParsedRecord> records;
+        std::vector<size_t> badLines;   // 块内行号（从1开始）
+        size_t lineCount = 0;
+    };
+}
+
+DataLoader::DataLoader()
+    : lastNodeCount_(0), lastEdgeCount_(0), threadCount_(0),
+      lastLoadSeconds_(0.0), lastThroughput_(0.0) {
 }
 
 DataLoader::~DataLoader() = default;
 
 bool DataLoader::loadFromFile(const std::string& filename, Graph& graph) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    auto start = std::chrono::steady_clock::now();
+    
+    MappedFile file;
+    if (!file.open(filename)) {
         std::cerr << "错误：无法打开文件 " << filename << std::endl;
         return false;
     }
@@ -20,35 +96,108 @@ bool DataLoader::loadFromFile(const std::string& filename, Graph& graph) {
     lastNodeCount_ = 0;
     lastEdgeCount_ = 0;
     
-    std::string line;
-    int lineNum = 0;
+    const char* data = file.getData();
+    const size_t size = file.getSize();
     
-    while (std::getline(file, line)) {
-        lineNum++;
-        
-        // 跳过空行和注释行
-        if (line.empty() || line[0] == '#') {
-            continue;
+    // 在换行处切块：每块从行首开始，到某一行的换行符之后结束
+    size_t threads = threadCount_ > 0 ? threadCount_
+                                      : std::max<size_t>(1, std::thread::hardware_concurrency());
+    size_t chunkCount = std::max<size_t>(1, std::min(threads * CHUNKS_PER_THREAD,
+                                                     size / MIN_CHUNK_BYTES));
+    std::vector<size_t> bounds(1, 0);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        size_t pos = std::max(bounds.back(), size / chunkCount * i);
+        const void* newline = pos < size ? std::memchr(data + pos, '\n', size - pos) : nullptr;
+        if (newline == nullptr) {
+            break;
         }
-        
-        int from, to;
-        double distance, time;
-        
-        if (parseLine(line, from, to, distance, time)) {
-            // 使用距离作为默认权重（最短距离策略）
-            graph.addEdge(from, to, distance);
-            lastEdgeCount_++;
-        } else {
-            std::cerr << "警告：第 " << lineNum << " 行格式错误，已跳过" << std::endl;
+        bounds.push_back(static_cast<size_t>(static_cast<const char*>(newline) - data) + 1);
+    }
+    bounds.push_back(size);
+    chunkCount = bounds.size() - 1;
+    
+    std::vector<ParsedChunk> chunks(chunkCount);
+    auto parseChunk = [&](size_t c) {
+        ParsedChunk& chunk = chunks[c];
+        const char* p = data + bounds[c];
+        const char* end = data + bounds[c + 1];
+        while (p != end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (lineEnd == nullptr) {
+                lineEnd = end;
+            }
+            chunk.lineCount++;
+            
+            // 跳过空行和注释行
+            if (lineEnd != p && *p != '#') {
+                ParsedRecord record;
+                if (parseLine(p, lineEnd, record.from, record.to, record.distance, record.time)) {
+                    // 跳过无效边（距离或时间为0或负数）
+                    if (record.distance > 0 && record.time > 0) {
+                        record.isNode = false;
+                        chunk.records.push_back(record);
+                    }
+                } else if (parseNodeLine(p, lineEnd, record.from)) {
+                    // 单独声明的节点（可能是孤立点）
+                    record.to = record.from;
+                    record.distance = 0.0;
+                    record.time = 0.0;
+                    record.isNode = true;
+                    chunk.records.push_back(record);
+                } else {
+                    chunk.badLines.push_back(chunk.lineCount);
+                }
+            }
+            
+            p = lineEnd == end ? end : lineEnd + 1;
         }
+    };
+    
+    if (chunkCount == 1) {
+        parseChunk(0);
+    } else {
+        ThreadPool pool(std::min(threads, chunkCount));
+        pool.parallelFor(chunkCount, parseChunk);
     }
     
+    // 按文件顺序加入图，节点下标的分配与逐行读取一致
+    size_t recordCount = 0;
+    for (const ParsedChunk& chunk : chunks) {
+        recordCount += chunk.records.size();
+    }
+    graph.reserve(recordCount / 2, recordCount);
+    
+    size_t lineBase = 0;
+    for (ParsedChunk& chunk : chunks) {
+        for (size_t line : chunk.badLines) {
+            std::cerr << "警告：第 " << lineBase + line << " 行格式错误，已跳过" << std::endl;
+        }
+        for (const ParsedRecord& record : chunk.records) {
+            if (record.isNode) {
+                graph.addNode(record.from);
+            } else {
+                // 每条边同时保存距离和时间，查询时按策略选择
+                graph.addEdge(record.from, record.to, record.distance, record.time);
+            }
+        }
+        lineBase += chunk.lineCount;
+        std::vector<ParsedRecord>().swap(chunk.records);
+    }
+    
+    // 冻结为CSR存储（重复的边以最后一行为准）
+    graph.finalize();
+    
     lastNodeCount_ = graph.getNodeCount();
-    file.close();
+    lastEdgeCount_ = graph.getEdgeCount();
+    lastLoadSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    lastThroughput_ = lastLoadSeconds_ > 0.0
+                    ? static_cast<double>(size) / (1024.0 * 1024.0) / lastLoadSeconds_ : 0.0;
     
     std::cout << "成功加载数据：" << std::endl;
     std::cout << "  节点数: " << lastNodeCount_ << std::endl;
     std::cout << "  边数: " << lastEdgeCount_ << std::endl;
+    std::cout << "  耗时: " << lastLoadSeconds_ * 1000.0 << " 毫秒（"
+              << lastThroughput_ << " MB/s，" << chunkCount << " 个解析块）" << std::endl;
     
     return true;
 }
@@ -85,7 +234,7 @@ bool DataLoader::loadFromFileWithDetails(const std::string& filename,
         int from, to;
         double distance, time;
         
-        if (parseLine(line, from, to, distance, time)) {
+        if (parseLine(line.data(), line.data() + line.size(), from, to, distance, time)) {
             // 跳过无效边（距离或时间为0或负数）
             if (distance > 0 && time > 0) {
                 // 存储距离和时间信息
@@ -97,16 +246,21 @@ bool DataLoader::loadFromFileWithDetails(const std::string& filename,
                 times[edge1] = time;
                 times[edge2] = time;
                 
-                // 使用距离作为默认权重（后续可以根据策略调整）
-                graph.addEdge(from, to, distance);
-                lastEdgeCount_++;
+                graph.addEdge(from, to, distance, time);
             }
+        } else if (parseNodeLine(line.data(), line.data() + line.size(), from)) {
+            // 单独声明的节点（可能是孤立点）
+            graph.addNode(from);
         } else {
             std::cerr << "警告：第 " << lineNum << " 行格式错误，已跳过" << std::endl;
         }
     }
     
+    // 冻结为CSR存储（重复的边以最后一行为准，与 distances/times 中的值一致）
+    graph.finalize();
+    
     lastNodeCount_ = graph.getNodeCount();
+    lastEdgeCount_ = graph.getEdgeCount();
     file.close();
     
     std::cout << "成功加载数据：" << std::endl;
@@ -116,11 +270,13 @@ bool DataLoader::loadFromFileWithDetails(const std::string& filename,
     return true;
 }
 
-bool DataLoader::parseLine(const std::string& line, int& from, int& to, 
-                          double& distance, double& time) {
-    std::istringstream iss(line);
+bool DataLoader::parseLine(const char* begin, const char* end, int& from, int& to,
+                           double& distance, double& time) {
+    const char* p = begin;
     
-    if (!(iss >> from >> to >> distance >> time)) {
+    // 四个字段之后的内容忽略
+    if (!parseNumber(p, end, from, false) || !parseNumber(p, end, to, false) ||
+        !parseNumber(p, end, distance, false) || !parseNumber(p, end, time, true)) {
         return false;
     }
     
@@ -132,6 +288,17 @@ bool DataLoader::parseLine(const std::string& line, int& from, int& to,
     return true;
 }
 
+bool DataLoader::parseNodeLine(const char* begin, const char* end, int& nodeId) {
+    const char* p = begin;
+    
+    if (!parseNumber(p, end, nodeId, false)) {
+        return false;
+    }
+    
+    // 行内只能有一个节点ID
+    return skipSpace(p, end) == end;
+}
+
 size_t DataLoader::getLoadedNodeCount() const {
     return lastNodeCount_;
 }
@@ -139,3 +306,15 @@ size_t DataLoader::getLoadedNodeCount() const {
 size_t DataLoader::getLoadedEdgeCount() const {
     return lastEdgeCount_;
 }
+
+void DataLoader::setThreadCount(size_t threadCount) {
+    threadCount_ = threadCount;
+}
+
+double DataLoader::getLastLoadSeconds() const {
+    return lastLoadSeconds_;
+}
+
+double DataLoader::getLastThroughput() const {
+    return lastThroughput_;
+}
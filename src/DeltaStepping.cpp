@@ -0,0 +1,240 @@
+#include "../include/DeltaStepping.h"
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+namespace {
+    // 节点按 2^OWNER_BLOCK_SHIFT 个一组轮流分给各线程（同一缓存行的距离只由一个线程写入）
+    const int OWNER_BLOCK_SHIFT = 6;
+    // 循环桶数组长度的上限，delta 相对最大权重过小时放大 delta
+    const size_t MAX_BUCKETS = size_t(1) << 16;
+    // 默认桶宽为平均弧权重的倍数
+    const double DEFAULT_DELTA_FACTOR = 4.0;
+    // 一轮待处理的节点少于此值时在调用线程中串行执行，避免线程池调度的开销
+    const size_t PARALLEL_THRESHOLD = 256;
+
+    struct Request {
+        int node;
+        int parent;
+        double distance;
+    };
+
+    /**
+     * @brief 每个线程负责的节点的桶和请求缓冲区
+     */
+    struct Owner {
+        std::vector<std::vector<int>> buckets;        // 循环桶数组，桶号对长度取模
+        size_t pending;                               // 各桶中的项数（含过期项）
+        std::vector<int> frontier;                    // 本轮处理的节点
+        std::vector<int> settled;                     // 当前桶中已处理过的节点，桶清空后松弛其重边
+        std::vector<int> improved;                    // 本轮距离变小的节点
+        std::vector<std::vector<Request>> outgoing;   // outgoing[o]：发给线程 o 的松弛请求
+
+        Owner() : pending(0) {}
+    };
+
+    /**
+     * @brief 有限弧权重的最大值、总和与个数
+     */
+    void weightStats(const Graph& graph, const double* weights,
+                     double& maxWeight, double& sum, size_t& count) {
+        const int n = static_cast<int>(graph.getNodeCount());
+        const int arcCount = n == 0 ? 0 : graph.getOffsets()[n];
+        maxWeight = 0.0;
+        sum = 0.0;
+        count = 0;
+        for (int e = 0; e < arcCount; ++e) {
+            double w = weights[e];
+            if (std::isfinite(w)) {
+                maxWeight = w > maxWeight ? w : maxWeight;
+                sum += w;
+                count++;
+            }
+        }
+    }
+}
+
+double DeltaStepping::suggestDelta(const Graph& graph, const double* weights) {
+    double maxWeight = 0.0;
+    double sum = 0.0;
+    size_t count = 0;
+    weightStats(graph, weights, maxWeight, sum, count);
+    if (count == 0 || sum <= 0.0) {
+        return 1.0;
+    }
+    return DEFAULT_DELTA_FACTOR * sum / static_cast<double>(count);
+}
+
+bool DeltaStepping::run(const Graph& graph, const double* weights, int source, double delta,
+                        ThreadPool* pool, ShortestPathTree& tree) {
+    auto startTime = std::chrono::steady_clock::now();
+    const int n = static_cast<int>(graph.getNodeCount());
+    if (!graph.isFinalized() || source < 0 || source >= n) {
+        return false;
+    }
+
+    double maxWeight = 0.0;
+    double sum = 0.0;
+    size_t count = 0;
+    weightStats(graph, weights, maxWeight, sum, count);
+    if (!(delta > 0.0) || !std::isfinite(delta)) {
+        delta = count == 0 || sum <= 0.0 ? 1.0 : DEFAULT_DELTA_FACTOR * sum / static_cast<double>(count);
+    }
+    if (maxWeight / delta > static_cast<double>(MAX_BUCKETS - 3)) {
+        delta = maxWeight / static_cast<double>(MAX_BUCKETS - 3);
+    }
+    // 暂定距离至多比当前桶的下界大 delta + maxWeight，循环数组覆盖这一范围即可（多留一个桶容纳舍入）
+    const size_t bucketCount = static_cast<size_t>(maxWeight / delta) + 3;
+
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    const size_t ownerCount = pool ? pool->getThreadCount() : 1;
+    std::vector<Owner> owners(ownerCount);
+    for (Owner& owner : owners) {
+        owner.buckets.resize(bucketCount);
+        owner.outgoing.resize(ownerCount);
+    }
+
+    tree.source = source;
+    tree.delta = delta;
+    tree.phases = 0;
+    tree.distances.assign(n, ShortestPathTree::UNREACHABLE);
+    tree.parents.assign(n, -1);
+    double* distances = tree.distances.data();
+    int* parents = tree.parents.data();
+    // 节点上次松弛轻边时的距离（同一距离只松弛一次）、所在桶是否已处理、距离最近一次变小的轮号
+    std::vector<double> relaxedAt(n, ShortestPathTree::UNREACHABLE);
+    std::vector<char> settled(n, 0);
+    std::vector<size_t> improvedIn(n, 0);
+
+    auto ownerOf = [ownerCount](int v) {
+        return static_cast<size_t>(v >> OWNER_BLOCK_SHIFT) % ownerCount;
+    };
+    auto bucketOf = [delta](double distance) {
+        return static_cast<uint64_t>(distance / delta);
+    };
+    auto forEachOwner = [&](size_t work, const std::function<void(size_t)>& body) {
+        if (pool && ownerCount > 1 && work >= PARALLEL_THRESHOLD) {
+            pool->parallelFor(ownerCount, body);
+        } else {
+            for (size_t o = 0; o < ownerCount; ++o) {
+                body(o);
+            }
+        }
+    };
+
+    // 为 u 的轻边或重边生成请求，只保留比当前暂定距离更小的
+    auto relax = [&](Owner& owner, int u, bool light) {
+        double du = distances[u];
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            double w = weights[e];
+            if (light ? !(w <= delta) : !(w > delta && w <= maxWeight)) {
+                continue;
+            }
+            int v = targets[e];
+            double nd = du + w;
+            if (nd < distances[v]) {
+                owner.outgoing[ownerOf(v)].push_back(Request{v, u, nd});
+            }
+        }
+    };
+
+    // 应用发给线程 o 的请求，距离变小的节点放入对应的桶
+    size_t phase = 0;
+    auto apply = [&](size_t o) {
+        Owner& owner = owners[o];
+        for (Owner& sender : owners) {
+            std::vector<Request>& requests = sender.outgoing[o];
+            for (const Request& request : requests) {
+                int v = request.node;
+                if (request.distance < distances[v]) {
+                    distances[v] = request.distance;
+                    parents[v] = request.parent;
+                    if (improvedIn[v] != phase) {
+                        improvedIn[v] = phase;
+                        owner.improved.push_back(v);
+                    }
+                } else if (request.distance == distances[v] && improvedIn[v] == phase &&
+                           request.parent < parents[v]) {
+                    parents[v] = request.parent;
+                }
+            }
+            requests.clear();
+        }
+        for (int v : owner.improved) {
+            owner.buckets[bucketOf(distances[v]) % bucketCount].push_back(v);
+            owner.pending++;
+        }
+        owner.improved.clear();
+    };
+
+    distances[source] = 0.0;
+    parents[source] = source;
+    owners[ownerOf(source)].buckets[0].push_back(source);
+    owners[ownerOf(source)].pending = 1;
+
+    for (uint64_t current = 0;; ++current) {
+        size_t pending = 0;
+        for (const Owner& owner : owners) {
+            pending += owner.pending;
+        }
+        if (pending == 0) {
+            break;
+        }
+        const size_t slot = static_cast<size_t>(current % bucketCount);
+
+        // 轻边：桶内节点可能因轻边再次进入当前桶，反复处理直到桶空
+        while (true) {
+            size_t frontierSize = 0;
+            for (const Owner& owner : owners) {
+                frontierSize += owner.buckets[slot].size();
+            }
+            if (frontierSize == 0) {
+                break;
+            }
+            phase++;
+            forEachOwner(frontierSize, [&](size_t o) {
+                Owner& owner = owners[o];
+                owner.frontier.clear();
+                owner.frontier.swap(owner.buckets[slot]);
+                owner.pending -= owner.frontier.size();
+                for (int u : owner.frontier) {
+                    // 距离已变小到其他桶的过期项，以及同一距离的重复项
+                    if (bucketOf(distances[u]) != current || relaxedAt[u] == distances[u]) {
+                        continue;
+                    }
+                    relaxedAt[u] = distances[u];
+                    if (!settled[u]) {
+                        settled[u] = 1;
+                        owner.settled.push_back(u);
+                    }
+                    relax(owner, u, true);
+                }
+            });
+            forEachOwner(frontierSize, apply);
+        }
+
+        // 重边：桶内节点的距离已确定，重边指向的节点都在后面的桶中
+        size_t settledCount = 0;
+        for (const Owner& owner : owners) {
+            settledCount += owner.settled.size();
+        }
+        if (settledCount > 0) {
+            phase++;
+            forEachOwner(settledCount, [&](size_t o) {
+                Owner& owner = owners[o];
+                for (int u : owner.settled) {
+                    relax(owner, u, false);
+                }
+                owner.settled.clear();
+            });
+            forEachOwner(settledCount, apply);
+        }
+    }
+
+    tree.phases = phase;
+    auto endTime = std::chrono::steady_clock::now();
+    tree.elapsedMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        endTime - startTime).count();
+    return true;
+}
@@ -1,7 +1,16 @@
 #include "../include/Graph.h"
+#include "../include/MappedFile.h"
 #include <algorithm>
+#include <limits>
+#include <cassert>
 
-Graph::Graph() : edgeCount_(0) {
+namespace {
+    // ID 跨度不超过节点数的该倍数时使用直接寻址数组
+    constexpr size_t ID_TABLE_SPAN_FACTOR = 4;
+    constexpr size_t ID_TABLE_SPAN_SLACK = 1024;
+}
+
+Graph::Graph() : idBase_(0), edgeCount_(0), finalized_(false) {
 }
 
 Graph::~Graph() {
@@ -9,39 +18,266 @@ Graph::~Graph() {
 }
 
 void Graph::addNode(int nodeId) {
-    if (!hasNode(nodeId)) {
-        nodes_[nodeId] = true;
-        adjacencyList_[nodeId] = std::vector<Edge>();
+    if (hasNode(nodeId)) {
+        return;
+    }
+    if (finalized_) {
+        thaw();
     }
+    internNode(nodeId);
 }
 
 void Graph::addEdge(int from, int to, double weight) {
+    addEdge(from, to, weight, weight);
+}
+
+void Graph::addEdge(int from, int to, double distance, double time) {
+    if (finalized_) {
+        thaw();
+    }
+
     // 确保两个节点都存在
-    addNode(from);
-    addNode(to);
-    
-    // 添加无向边（双向）
-    adjacencyList_[from].emplace_back(to, weight);
-    adjacencyList_[to].emplace_back(from, weight);
-    
+    int u = internNode(from);
+    int v = internNode(to);
+
+    // 添加无向边（冻结时生成双向弧）
+    pendingEdges_.push_back({u, v, distance, time});
+    pendingDegree_[u]++;
+    pendingDegree_[v]++;
+
     edgeCount_++;
 }
 
-const std::vector<Edge>& Graph::getAdjacentEdges(int nodeId) const {
-    static const std::vector<Edge> empty;
-    auto it = adjacencyList_.find(nodeId);
-    if (it != adjacencyList_.end()) {
-        return it->second;
+void Graph::reserve(size_t nodeCount, size_t edgeCount) {
+    if (finalized_) {
+        thaw();
+    }
+    pendingIds_.reserve(nodeCount);
+    pendingDegree_.reserve(nodeCount);
+    idMap_.reserve(nodeCount);
+    pendingEdges_.reserve(edgeCount);
+}
+
+int Graph::internNode(int nodeId) {
+    auto inserted = idMap_.try_emplace(nodeId, static_cast<int>(pendingIds_.size()));
+    if (inserted.second) {
+        pendingIds_.push_back(nodeId);
+        pendingDegree_.push_back(0);
+    }
+    return inserted.first->second;
+}
+
+void Graph::finalize() {
+    if (finalized_) {
+        return;
+    }
+
+    const size_t n = pendingIds_.size();
+
+    // 计数排序：先统计每个节点的度数，再前缀和得到偏移
+    std::vector<int> offsets(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i + 1] = offsets[i] + pendingDegree_[i];
     }
-    return empty;
+
+    std::vector<int> targets(static_cast<size_t>(offsets[n]));
+    std::vector<double> distances(static_cast<size_t>(offsets[n]));
+    std::vector<double> times(static_cast<size_t>(offsets[n]));
+
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (const PendingEdge& e : pendingEdges_) {
+        int pos = cursor[e.from]++;
+        targets[pos] = e.to;
+        distances[pos] = e.distance;
+        times[pos] = e.time;
+
+        pos = cursor[e.to]++;
+        targets[pos] = e.from;
+        distances[pos] = e.distance;
+        times[pos] = e.time;
+    }
+
+    // 同一对节点之间重复添加的边只保留最后一条（文件中后出现的行覆盖前面的行，
+    // 距离和时间来自同一行）。同一节点的弧按添加顺序排列，从后向前第一次遇到的目标即最后一条；
+    // 自环在端点上有两条弧，保留最后两条。两个端点上保留的弧来自同一条边
+    std::vector<int> seenBy(n, -1);
+    std::vector<char> keep(targets.size(), 0);
+    size_t removed = 0;
+    for (size_t u = 0; u < n; ++u) {
+        int selfLoopArcs = 0;
+        for (int e = offsets[u + 1] - 1; e >= offsets[u]; --e) {
+            int v = targets[e];
+            if (static_cast<size_t>(v) == u) {
+                keep[e] = selfLoopArcs < 2;
+                selfLoopArcs++;
+            } else {
+                keep[e] = seenBy[v] != static_cast<int>(u);
+                seenBy[v] = static_cast<int>(u);
+            }
+            removed += keep[e] ? 0 : 1;
+        }
+    }
+    if (removed > 0) {
+        int write = 0;
+        for (size_t u = 0; u < n; ++u) {
+            int begin = offsets[u];
+            offsets[u] = write;
+            for (int e = begin; e < offsets[u + 1]; ++e) {
+                if (keep[e]) {
+                    targets[write] = targets[e];
+                    distances[write] = distances[e];
+                    times[write] = times[e];
+                    write++;
+                }
+            }
+        }
+        offsets[n] = write;
+        targets.resize(static_cast<size_t>(write));
+        distances.resize(static_cast<size_t>(write));
+        times.resize(static_cast<size_t>(write));
+    }
+    // 每条边（包括自环）对应两条弧
+    edgeCount_ = targets.size() / 2;
+
+    offsets_.assign(std::move(offsets));
+    targets_.assign(std::move(targets));
+    distances_.assign(std::move(distances));
+    times_.assign(std::move(times));
+    denseToExternal_.assign(std::move(pendingIds_));
+
+    // 释放构建阶段数据
+    std::vector<int>().swap(pendingIds_);
+    std::vector<PendingEdge>().swap(pendingEdges_);
+    std::vector<int>().swap(pendingDegree_);
+
+    buildIdIndex();
+    finalized_ = true;
+}
+
+bool Graph::isFinalized() const {
+    return finalized_;
+}
+
+void Graph::thaw() {
+    const size_t n = denseToExternal_.size();
+
+    pendingIds_.assign(denseToExternal_.begin(), denseToExternal_.end());
+    pendingDegree_.assign(n, 0);
+    pendingEdges_.clear();
+    pendingEdges_.reserve(edgeCount_);
+
+    // 每条无向边对应两条弧，只从较小下标一端还原；自环的两条弧都在同一节点上，取一半
+    for (size_t u = 0; u < n; ++u) {
+        bool skipSelfLoop = false;
+        for (int e = offsets_[u]; e < offsets_[u + 1]; ++e) {
+            int v = targets_[e];
+            if (static_cast<size_t>(v) < u) {
+                continue;
+            }
+            if (static_cast<size_t>(v) == u) {
+                skipSelfLoop = !skipSelfLoop;
+                if (!skipSelfLoop) {
+                    continue;
+                }
+            }
+            pendingEdges_.push_back({static_cast<int>(u), v, distances_[e], times_[e]});
+            pendingDegree_[u]++;
+            pendingDegree_[v]++;
+        }
+    }
+
+    idMap_.clear();
+    idMap_.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        idMap_[pendingIds_[i]] = static_cast<int>(i);
+    }
+
+    offsets_.clear();
+    targets_.clear();
+    distances_.clear();
+    times_.clear();
+    denseToExternal_.clear();
+    idTable_.clear();
+    sortedIds_.clear();
+    sortedIndices_.clear();
+    idBase_ = 0;
+    mapping_.reset();
+    base_.reset();
+    finalized_ = false;
+}
+
+void Graph::buildIdIndex() {
+    idTable_.clear();
+    sortedIds_.clear();
+    sortedIndices_.clear();
+    idBase_ = 0;
+    std::unordered_map<int, int>().swap(idMap_);
+
+    const size_t n = denseToExternal_.size();
+    if (n == 0) {
+        return;
+    }
+
+    auto range = std::minmax_element(denseToExternal_.begin(), denseToExternal_.end());
+    int64_t span = static_cast<int64_t>(*range.second) - *range.first + 1;
+    if (static_cast<uint64_t>(span) > n * ID_TABLE_SPAN_FACTOR + ID_TABLE_SPAN_SLACK) {
+        // ID 过于稀疏：按ID排序，查找时二分
+        std::vector<int> order(n);
+        for (size_t i = 0; i < n; ++i) {
+            order[i] = static_cast<int>(i);
+        }
+        std::sort(order.begin(), order.end(), [this](int a, int b) {
+            return denseToExternal_[a] < denseToExternal_[b];
+        });
+        std::vector<int> ids(n);
+        for (size_t i = 0; i < n; ++i) {
+            ids[i] = denseToExternal_[order[i]];
+        }
+        sortedIds_.assign(std::move(ids));
+        sortedIndices_.assign(std::move(order));
+        return;
+    }
+
+    idBase_ = *range.first;
+    std::vector<int> table(static_cast<size_t>(span), INVALID_INDEX);
+    for (size_t i = 0; i < n; ++i) {
+        table[static_cast<size_t>(static_cast<int64_t>(denseToExternal_[i]) - idBase_)] =
+            static_cast<int>(i);
+    }
+    idTable_.assign(std::move(table));
+}
+
+int Graph::getIndex(int nodeId) const {
+    if (!idTable_.empty()) {
+        uint64_t offset = static_cast<uint64_t>(static_cast<int64_t>(nodeId) - idBase_);
+        return offset < idTable_.size() ? idTable_[offset] : INVALID_INDEX;
+    }
+    if (!sortedIds_.empty()) {
+        const int* it = std::lower_bound(sortedIds_.begin(), sortedIds_.end(), nodeId);
+        return it != sortedIds_.end() && *it == nodeId
+             ? sortedIndices_[static_cast<size_t>(it - sortedIds_.begin())] : INVALID_INDEX;
+    }
+    auto it = idMap_.find(nodeId);
+    return it != idMap_.end() ? it->second : INVALID_INDEX;
+}
+
+EdgeRange Graph::getAdjacentEdges(int nodeId) const {
+    assert(finalized_ && "Graph::finalize() must be called before adjacency queries");
+    int index = getIndex(nodeId);
+    if (index == INVALID_INDEX || !finalized_) {
+        return EdgeRange();
+    }
+    int begin = offsets_[index];
+    return EdgeRange(targets_.data() + begin, distances_.data() + begin, times_.data() + begin,
+                     static_cast<size_t>(offsets_[index + 1] - begin), denseToExternal_.data());
 }
 
 bool Graph::hasNode(int nodeId) const {
-    return nodes_.find(nodeId) != nodes_.end();
+    return getIndex(nodeId) != INVALID_INDEX;
 }
 
 size_t Graph::getNodeCount() const {
-    return nodes_.size();
+    return finalized_ ? denseToExternal_.size() : pendingIds_.size();
 }
 
 size_t Graph::getEdgeCount() const {
@@ -49,15 +285,138 @@ size_t Graph::getEdgeCount() const {
 }
 
 bool Graph::isIsolated(int nodeId) const {
-    if (!hasNode(nodeId)) {
+    int index = getIndex(nodeId);
+    if (index == INVALID_INDEX) {
         return false;  // 节点不存在，不算孤立点
     }
-    auto it = adjacencyList_.find(nodeId);
-    return it == adjacencyList_.end() || it->second.empty();
+    return finalized_ ? getDegreeAt(index) == 0 : pendingDegree_[index] == 0;
 }
 
 void Graph::clear() {
-    adjacencyList_.clear();
-    nodes_.clear();
+    offsets_.clear();
+    targets_.clear();
+    distances_.clear();
+    times_.clear();
+    denseToExternal_.clear();
+    idTable_.clear();
+    sortedIds_.clear();
+    sortedIndices_.clear();
+    std::unordered_map<int, int>().swap(idMap_);
+    std::vector<int>().swap(pendingIds_);
+    std::vector<PendingEdge>().swap(pendingEdges_);
+    std::vector<int>().swap(pendingDegree_);
+    mapping_.reset();
+    base_.reset();
+    idBase_ = 0;
     edgeCount_ = 0;
+    finalized_ = false;
+}
+
+uint64_t Graph::computeChecksum() const {
+    const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t hash = FNV_OFFSET;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            hash ^= p[i];
+            hash *= FNV_PRIME;
+        }
+    };
+
+    uint64_t counts[2] = {denseToExternal_.size(), edgeCount_};
+    mix(counts, sizeof(counts));
+    mix(denseToExternal_.data(), denseToExternal_.size() * sizeof(int));
+    mix(offsets_.data(), offsets_.size() * sizeof(int));
+    mix(targets_.data(), targets_.size() * sizeof(int));
+    mix(distances_.data(), distances_.size() * sizeof(double));
+    mix(times_.data(), times_.size() * sizeof(double));
+    return hash;
+}
+
+bool Graph::reorder(const std::vector<int>& order) {
+    const size_t n = denseToExternal_.size();
+    if (!finalized_ || order.size() != n) {
+        return false;
+    }
+    std::vector<int> newIndex(n, INVALID_INDEX);
+    for (size_t i = 0; i < n; ++i) {
+        int old = order[i];
+        if (old < 0 || static_cast<size_t>(old) >= n || newIndex[old] != INVALID_INDEX) {
+            return false;
+        }
+        newIndex[old] = static_cast<int>(i);
+    }
+
+    std::vector<int> offsets(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i + 1] = offsets[i] + getDegreeAt(order[i]);
+    }
+    std::vector<int> targets(targets_.size());
+    std::vector<double> distances(distances_.size());
+    std::vector<double> times(times_.size());
+    std::vector<int> ids(n);
+    for (size_t i = 0; i < n; ++i) {
+        int old = order[i];
+        int pos = offsets[i];
+        for (int e = offsets_[old]; e < offsets_[old + 1]; ++e, ++pos) {
+            targets[pos] = newIndex[targets_[e]];
+            distances[pos] = distances_[e];
+            times[pos] = times_[e];
+        }
+        ids[i] = denseToExternal_[old];
+    }
+
+    offsets_.assign(std::move(offsets));
+    targets_.assign(std::move(targets));
+    distances_.assign(std::move(distances));
+    times_.assign(std::move(times));
+    denseToExternal_.assign(std::move(ids));
+    mapping_.reset();
+    base_.reset();
+    buildIdIndex();
+    return true;
+}
+
+size_t Graph::getMemoryUsage() const {
+    size_t bytes = offsets_.getMemoryUsage()
+                 + targets_.getMemoryUsage()
+                 + distances_.getMemoryUsage()
+                 + times_.getMemoryUsage()
+                 + denseToExternal_.getMemoryUsage()
+                 + idTable_.getMemoryUsage()
+                 + sortedIds_.getMemoryUsage()
+                 + sortedIndices_.getMemoryUsage()
+                 + pendingIds_.capacity() * sizeof(int)
+                 + pendingEdges_.capacity() * sizeof(PendingEdge)
+                 + pendingDegree_.capacity() * sizeof(int);
+    // 哈希映射：每个元素一个节点（键值+next指针）加桶数组
+    bytes += idMap_.size() * (sizeof(std::pair<const int, int>) + sizeof(void*))
+           + idMap_.bucket_count() * sizeof(void*);
+    return bytes;
+}
+
+std::shared_ptr<Graph> Graph::withTimes(const std::shared_ptr<const Graph>& graph,
+                                        std::vector<double>&& times) {
+    if (!graph || !graph->finalized_ || times.size() != graph->times_.size()) {
+        return nullptr;
+    }
+
+    auto updated = std::make_shared<Graph>();
+    updated->offsets_.view(graph->offsets_.data(), graph->offsets_.size());
+    updated->targets_.view(graph->targets_.data(), graph->targets_.size());
+    updated->distances_.view(graph->distances_.data(), graph->distances_.size());
+    updated->times_.assign(std::move(times));
+    updated->denseToExternal_.view(graph->denseToExternal_.data(), graph->denseToExternal_.size());
+    updated->idTable_.view(graph->idTable_.data(), graph->idTable_.size());
+    updated->idBase_ = graph->idBase_;
+    updated->sortedIds_.view(graph->sortedIds_.data(), graph->sortedIds_.size());
+    updated->sortedIndices_.view(graph->sortedIndices_.data(), graph->sortedIndices_.size());
+    updated->edgeCount_ = graph->edgeCount_;
+    updated->finalized_ = true;
+    // 连续多次更新时直接引用最初持有数组的图，不形成引用链
+    updated->base_ = graph->base_ ? graph->base_ : graph;
+    updated->mapping_ = graph->mapping_;
+    return updated;
 }
@@ -0,0 +1,268 @@
+#include "../include/GraphGenerator.h"
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    // 道路速度等级：时间 = 距离 / 速度
+    const double SPEED_CLASSES[] = {1.0, 1.5, 2.5, 4.0};
+
+    double randomSpeed(std::mt19937_64& rng) {
+        return SPEED_CLASSES[rng() % (sizeof(SPEED_CLASSES) / sizeof(SPEED_CLASSES[0]))];
+    }
+
+    // [0, 1) 上的均匀随机数
+    double randomUnit(std::mt19937_64& rng) {
+        return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    void addRoad(Graph& graph, int from, int to, double distance, std::mt19937_64& rng) {
+        graph.addEdge(from, to, distance, distance / randomSpeed(rng));
+    }
+
+    /**
+     * @brief 写文件缓冲：数字用 std::to_chars 格式化，满 1MB 写出一次
+     */
+    class MapWriter {
+    public:
+        explicit MapWriter(std::ofstream& file) : file_(file) {
+            buffer_.reserve(BUFFER_SIZE + 128);
+        }
+
+        ~MapWriter() { flush(); }
+
+        template <typename T>
+        void write(T value) {
+            char text[32];
+            auto result = std::to_chars(text, text + sizeof(text), value);
+            buffer_.append(text, result.ptr);
+        }
+
+        void put(char c) {
+            buffer_.push_back(c);
+            if (c == '\n' && buffer_.size() >= BUFFER_SIZE) {
+                flush();
+            }
+        }
+
+        void flush() {
+            file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+
+    private:
+        static const size_t BUFFER_SIZE = 1 << 20;
+        std::ofstream& file_;
+        std::string buffer_;
+    };
+}
+
+void GraphGenerator::generateGrid(Graph& graph, int rows, int cols, uint64_t seed) {
+    graph.clear();
+    std::mt19937_64 rng(seed);
+    size_t nodeCount = static_cast<size_t>(rows) * static_cast<size_t>(cols);
+    graph.reserve(nodeCount, 2 * nodeCount);
+
+    // 先声明全部节点，稠密下标与节点ID相同
+    for (size_t id = 0; id < nodeCount; ++id) {
+        graph.addNode(static_cast<int>(id));
+    }
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int id = r * cols + c;
+            if (c + 1 < cols) {
+                addRoad(graph, id, id + 1, 1.0 + static_cast<double>(rng() % 100), rng);
+            }
+            if (r + 1 < rows) {
+                addRoad(graph, id, id + cols, 1.0 + static_cast<double>(rng() % 100), rng);
+            }
+        }
+    }
+    graph.finalize();
+}
+
+void GraphGenerator::generateRandomGeometric(Graph& graph, int nodeCount, double averageDegree,
+                                             uint64_t seed) {
+    graph.clear();
+    if (nodeCount <= 0) {
+        graph.finalize();
+        return;
+    }
+    std::mt19937_64 rng(seed);
+
+    // 区域边长随节点数增长，使节点密度（以及边长的尺度）与规模无关
+    const double side = 100.0 * std::sqrt(static_cast<double>(nodeCount));
+    const double pi = 3.14159265358979323846;
+    const double radius = std::sqrt(averageDegree / (pi * nodeCount)) * side;
+
+    std::vector<double> xs(nodeCount);
+    std::vector<double> ys(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        xs[i] = randomUnit(rng) * side;
+        ys[i] = randomUnit(rng) * side;
+    }
+
+    // 按半径大小的网格分桶，只检查相邻的 3x3 个桶
+    const int cellsPerSide = std::max(1, static_cast<int>(side / radius));
+    const double cellSize = side / cellsPerSide;
+    auto cellOf = [&](double coordinate) {
+        return std::min(cellsPerSide - 1, static_cast<int>(coordinate / cellSize));
+    };
+    std::vector<int> cellStart(static_cast<size_t>(cellsPerSide) * cellsPerSide + 1, 0);
+    std::vector<int> cellIndex(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        cellIndex[i] = cellOf(ys[i]) * cellsPerSide + cellOf(xs[i]);
+        cellStart[cellIndex[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    std::vector<int> cellNodes(nodeCount);
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < nodeCount; ++i) {
+        cellNodes[fill[cellIndex[i]]++] = i;
+    }
+
+    graph.reserve(static_cast<size_t>(nodeCount),
+                  static_cast<size_t>(nodeCount * averageDegree / 2.0));
+    for (int i = 0; i < nodeCount; ++i) {
+        graph.addNode(i);
+    }
+    const double radiusSquared = radius * radius;
+    for (int i = 0; i < nodeCount; ++i) {
+        int cx = cellOf(xs[i]);
+        int cy = cellOf(ys[i]);
+        for (int y = std::max(0, cy - 1); y <= std::min(cellsPerSide - 1, cy + 1); ++y) {
+            for (int x = std::max(0, cx - 1); x <= std::min(cellsPerSide - 1, cx + 1); ++x) {
+                int cell = y * cellsPerSide + x;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    int j = cellNodes[k];
+                    if (j <= i) {
+                        continue;
+                    }
+                    double dx = xs[i] - xs[j];
+                    double dy = ys[i] - ys[j];
+                    double squared = dx * dx + dy * dy;
+                    if (squared <= radiusSquared) {
+                        // 重合的点也保持正的边长
+                        addRoad(graph, i, j, std::max(std::sqrt(squared), 0.01), rng);
+                    }
+                }
+            }
+        }
+    }
+    graph.finalize();
+}
+
+void GraphGenerator::generateScaleFree(Graph& graph, int nodeCount, int edgesPerNode,
+                                       uint64_t seed) {
+    graph.clear();
+    std::mt19937_64 rng(seed);
+    const int m = std::max(1, edgesPerNode);
+    nodeCount = std::max(nodeCount, m + 1);
+    graph.reserve(static_cast<size_t>(nodeCount), static_cast<size_t>(nodeCount) * m);
+
+    // 每条边的两个端点各记一次，均匀抽取其中一项即按度数成比例地选取节点
+    std::vector<int> endpoints;
+    endpoints.reserve(2 * static_cast<size_t>(nodeCount) * m);
+    for (int i = 0; i <= m; ++i) {
+        graph.addNode(i);
+        for (int j = 0; j < i; ++j) {
+            addRoad(graph, j, i, 1.0 + static_cast<double>(rng() % 100), rng);
+            endpoints.push_back(i);
+            endpoints.push_back(j);
+        }
+    }
+
+    std::vector<int> chosen;
+    for (int i = m + 1; i < nodeCount; ++i) {
+        graph.addNode(i);
+        chosen.clear();
+        while (static_cast<int>(chosen.size()) < m) {
+            int target = endpoints[rng() % endpoints.size()];
+            if (std::find(chosen.begin(), chosen.end(), target) == chosen.end()) {
+                chosen.push_back(target);
+            }
+        }
+        for (int target : chosen) {
+            addRoad(graph, i, target, 1.0 + static_cast<double>(rng() % 100), rng);
+            endpoints.push_back(i);
+            endpoints.push_back(target);
+        }
+    }
+    graph.finalize();
+}
+
+std::vector<std::pair<int, int>> GraphGenerator::generateQueries(const Graph& graph, size_t count,
+                                                                 QueryWorkload workload,
+                                                                 uint64_t seed, int walkLength) {
+    std::vector<std::pair<int, int>> queries;
+    const size_t n = graph.getNodeCount();
+    if (n == 0) {
+        return queries;
+    }
+    std::mt19937_64 rng(seed);
+    queries.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int from = static_cast<int>(rng() % n);
+        int to = from;
+        if (workload == QueryWorkload::RANDOM) {
+            to = static_cast<int>(rng() % n);
+        } else {
+            for (int step = 0; step < walkLength; ++step) {
+                int degree = graph.getDegreeAt(to);
+                if (degree == 0) {
+                    break;
+                }
+                to = graph.getTargets()[graph.getOffsets()[to] + static_cast<int>(rng() % degree)];
+            }
+        }
+        queries.emplace_back(graph.getNodeId(from), graph.getNodeId(to));
+    }
+    return queries;
+}
+
+bool GraphGenerator::writeMap(const Graph& graph, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "错误：无法写入地图文件 " << filename << std::endl;
+        return false;
+    }
+
+    MapWriter writer(file);
+    const int n = static_cast<int>(graph.getNodeCount());
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    const double* distances = graph.getDistances();
+    const double* times = graph.getTimes();
+    // 先逐个声明节点（包括孤立点），加载后稠密下标的顺序与原图相同
+    for (int u = 0; u < n; ++u) {
+        writer.write(graph.getNodeId(u));
+        writer.put('\n');
+    }
+    for (int u = 0; u < n; ++u) {
+        // 每条无向边在两个端点各存一次，只从较小下标的一端写出
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            if (targets[e] <= u) {
+                continue;
+            }
+            writer.write(graph.getNodeId(u));
+            writer.put(' ');
+            writer.write(graph.getNodeId(targets[e]));
+            writer.put(' ');
+            writer.write(distances[e]);
+            writer.put(' ');
+            writer.write(times[e]);
+            writer.put('\n');
+        }
+    }
+    writer.flush();
+    if (!file) {
+        std::cerr << "错误：写入地图文件 " << filename << " 失败" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,501 @@
+#include "../include/Landmarks.h"
+#include "../include/MappedFile.h"
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace {
+    const char LANDMARK_MAGIC[8] = {'P', 'E', 'L', 'A', 'N', 'D', 'M', 'K'};
+
+    // 地标选择使用固定种子，保证同一张图得到同样的地标
+    const unsigned LANDMARK_SEED = 0x5EEDu;
+
+    typedef std::pair<double, int> QueueItem;
+
+    /**
+     * @brief 单源全图最短路径（预处理用）
+     * @param dist 输出距离，不可达为无穷大
+     * @param parent 可选，输出最短路径树的父节点
+     * @param order 可选，输出节点的确定顺序
+     */
+    void shortestPathTree(const Graph& graph, const double* weights, int source,
+                          std::vector<double>& dist, std::vector<int>* parent,
+                          std::vector<int>* order) {
+        const size_t n = graph.getNodeCount();
+        const int* offsets = graph.getOffsets();
+        const int* targets = graph.getTargets();
+
+        dist.assign(n, Landmarks::INFINITE_DISTANCE);
+        if (parent) {
+            parent->assign(n, -1);
+        }
+        if (order) {
+            order->clear();
+        }
+
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> pq;
+        dist[source] = 0.0;
+        pq.push(QueueItem(0.0, source));
+
+        while (!pq.empty()) {
+            QueueItem current = pq.top();
+            pq.pop();
+            int u = current.second;
+            if (current.first > dist[u]) {
+                continue;
+            }
+            if (order) {
+                order->push_back(u);
+            }
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = targets[e];
+                double newDist = current.first + weights[e];
+                if (newDist < dist[v]) {
+                    dist[v] = newDist;
+                    if (parent) {
+                        (*parent)[v] = u;
+                    }
+                    pq.push(QueueItem(newDist, v));
+                }
+            }
+        }
+    }
+}
+
+Landmarks::Landmarks()
+    : landmarkCount_(0), nodeCount_(0), graphChecksum_(0), selection_(LandmarkSelection::AVOID),
+      timeScale_(1.0) {
+}
+
+Landmarks::~Landmarks() = default;
+
+bool Landmarks::build(const Graph& graph, int count, LandmarkSelection selection) {
+    landmarkIndices_.clear();
+    distanceTable_.clear();
+    timeTable_.clear();
+    timeScale_ = 1.0;
+    mapping_.reset();
+    base_.reset();
+    timeBase_.reset();
+    landmarkCount_ = 0;
+    nodeCount_ = graph.getNodeCount();
+    graphChecksum_ = 0;
+    selection_ = selection;
+
+    if (!graph.isFinalized() || count <= 0) {
+        return false;
+    }
+
+    // 孤立点不适合做地标
+    size_t candidates = 0;
+    for (size_t i = 0; i < nodeCount_; ++i) {
+        if (graph.getDegreeAt(static_cast<int>(i)) > 0) {
+            candidates++;
+        }
+    }
+    if (candidates == 0) {
+        return false;
+    }
+    landmarkCount_ = static_cast<int>(std::min<size_t>(static_cast<size_t>(count), candidates));
+
+    // 选择过程中逐列填充距离表（按节点优先存放）
+    std::vector<double> distanceTable(nodeCount_ * landmarkCount_, INFINITE_DISTANCE);
+    if (selection == LandmarkSelection::FARTHEST) {
+        selectFarthest(graph, landmarkCount_, distanceTable);
+    } else {
+        selectAvoid(graph, landmarkCount_, distanceTable);
+    }
+
+    // 选出的地标可能少于请求数量（例如可选节点不足），压缩距离表
+    int selected = static_cast<int>(landmarkIndices_.size());
+    if (selected < landmarkCount_) {
+        std::vector<double> compact(nodeCount_ * selected);
+        for (size_t v = 0; v < nodeCount_; ++v) {
+            std::copy(distanceTable.begin() + v * landmarkCount_,
+                      distanceTable.begin() + v * landmarkCount_ + selected,
+                      compact.begin() + v * selected);
+        }
+        distanceTable.swap(compact);
+        landmarkCount_ = selected;
+    }
+    distanceTable_.assign(std::move(distanceTable));
+
+    std::vector<double> timeTable;
+    fillTable(graph, graph.getTimes(), timeTable);
+    timeTable_.assign(std::move(timeTable));
+    graphChecksum_ = graph.computeChecksum();
+    return landmarkCount_ > 0;
+}
+
+std::shared_ptr<Landmarks> Landmarks::withTimes(const std::shared_ptr<const Landmarks>& landmarks,
+                                                const Graph& graph) {
+    if (!landmarks || landmarks->landmarkCount_ == 0 ||
+        landmarks->nodeCount_ != graph.getNodeCount()) {
+        return nullptr;
+    }
+
+    auto updated = std::make_shared<Landmarks>();
+    updated->landmarkCount_ = landmarks->landmarkCount_;
+    updated->nodeCount_ = landmarks->nodeCount_;
+    updated->landmarkIndices_ = landmarks->landmarkIndices_;
+    updated->selection_ = landmarks->selection_;
+    updated->distanceTable_.view(landmarks->distanceTable_.data(),
+                                 landmarks->distanceTable_.size());
+    // 连续多次更新时直接引用最初持有距离表的地标表
+    updated->base_ = landmarks->base_ ? landmarks->base_ : landmarks;
+    updated->mapping_ = landmarks->mapping_;
+
+    std::vector<double> timeTable;
+    updated->fillTable(graph, graph.getTimes(), timeTable);
+    updated->timeTable_.assign(std::move(timeTable));
+    updated->graphChecksum_ = graph.computeChecksum();
+    return updated;
+}
+
+std::shared_ptr<Landmarks> Landmarks::withoutTimes(const std::shared_ptr<const Landmarks>& landmarks) {
+    if (!landmarks || landmarks->landmarkCount_ == 0) {
+        return nullptr;
+    }
+
+    auto updated = std::make_shared<Landmarks>();
+    updated->landmarkCount_ = landmarks->landmarkCount_;
+    updated->nodeCount_ = landmarks->nodeCount_;
+    updated->landmarkIndices_ = landmarks->landmarkIndices_;
+    updated->selection_ = landmarks->selection_;
+    updated->distanceTable_.view(landmarks->distanceTable_.data(),
+                                 landmarks->distanceTable_.size());
+    updated->base_ = landmarks->base_ ? landmarks->base_ : landmarks;
+    updated->mapping_ = landmarks->mapping_;
+    updated->graphChecksum_ = landmarks->graphChecksum_;
+    return updated;
+}
+
+std::shared_ptr<Landmarks> Landmarks::withTimeScale(const std::shared_ptr<const Landmarks>& landmarks,
+                                                    const Graph& graph, double factor) {
+    if (!landmarks || !landmarks->hasTable(PathStrategy::LEAST_TIME)) {
+        return nullptr;
+    }
+
+    auto updated = std::make_shared<Landmarks>();
+    updated->landmarkCount_ = landmarks->landmarkCount_;
+    updated->nodeCount_ = landmarks->nodeCount_;
+    updated->landmarkIndices_ = landmarks->landmarkIndices_;
+    updated->selection_ = landmarks->selection_;
+    updated->distanceTable_.view(landmarks->distanceTable_.data(),
+                                 landmarks->distanceTable_.size());
+    updated->timeTable_.view(landmarks->timeTable_.data(), landmarks->timeTable_.size());
+    updated->timeScale_ = landmarks->timeScale_ * std::min(1.0, std::max(0.0, factor));
+    updated->base_ = landmarks->base_ ? landmarks->base_ : landmarks;
+    updated->timeBase_ = landmarks->timeBase_ ? landmarks->timeBase_ : landmarks;
+    updated->mapping_ = landmarks->mapping_;
+    updated->graphChecksum_ = graph.computeChecksum();
+    return updated;
+}
+
+void Landmarks::selectFarthest(const Graph& graph, int count, std::vector<double>& table) {
+    const size_t n = nodeCount_;
+    const double* weights = graph.getDistances();
+
+    // minDist[v]：v 到已选地标集合的最短距离
+    std::vector<double> minDist(n, INFINITE_DISTANCE);
+    std::vector<double> dist;
+    std::vector<char> isLandmark(n, 0);
+
+    // 第一个地标取离首个非孤立点最远的节点
+    int start = 0;
+    while (graph.getDegreeAt(start) == 0) {
+        start++;
+    }
+    shortestPathTree(graph, weights, start, dist, nullptr, nullptr);
+    minDist = dist;
+
+    for (int i = 0; i < count; ++i) {
+        // 选最远的非孤立点；其他连通分量中的节点距离为无穷大，会被优先选中
+        int best = -1;
+        double bestDist = -1.0;
+        for (size_t v = 0; v < n; ++v) {
+            if (isLandmark[v] || graph.getDegreeAt(static_cast<int>(v)) == 0) {
+                continue;
+            }
+            if (minDist[v] > bestDist) {
+                bestDist = minDist[v];
+                best = static_cast<int>(v);
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        if (i == 0) {
+            // 第一个地标：重置为只以它为准
+            std::fill(minDist.begin(), minDist.end(), INFINITE_DISTANCE);
+        }
+
+        isLandmark[best] = 1;
+        landmarkIndices_.push_back(best);
+        shortestPathTree(graph, weights, best, dist, nullptr, nullptr);
+        for (size_t v = 0; v < n; ++v) {
+            table[v * count + i] = dist[v];
+            minDist[v] = std::min(minDist[v], dist[v]);
+        }
+    }
+}
+
+void Landmarks::selectAvoid(const Graph& graph, int count, std::vector<double>& table) {
+    const size_t n = nodeCount_;
+    const double* weights = graph.getDistances();
+
+    std::mt19937 rng(LANDMARK_SEED);
+    std::vector<double> rootDist;
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<int> order;
+    std::vector<double> size(n);
+    std::vector<int> bestChild(n);
+    std::vector<char> containsLandmark(n);
+    std::vector<char> isLandmark(n, 0);
+    std::vector<char> covered(n, 0);   // 所在连通分量已有地标
+
+    std::vector<int> candidates;
+    for (size_t v = 0; v < n; ++v) {
+        if (graph.getDegreeAt(static_cast<int>(v)) > 0) {
+            candidates.push_back(static_cast<int>(v));
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        // 根节点：优先从还没有地标的连通分量中随机选取
+        std::vector<int> uncovered;
+        for (int v : candidates) {
+            if (!covered[v]) {
+                uncovered.push_back(v);
+            }
+        }
+        const std::vector<int>& pool = uncovered.empty() ? candidates : uncovered;
+        int root = pool[std::uniform_int_distribution<size_t>(0, pool.size() - 1)(rng)];
+
+        shortestPathTree(graph, weights, root, rootDist, &parent, &order);
+
+        // 逆确定顺序累加子树大小：size(v) = d(r,v) - LB(r,v) + 子树之和，含地标的子树大小为0
+        const double* rootRow = table.data() + static_cast<size_t>(root) * count;
+        for (int v : order) {
+            size[v] = 0.0;
+            bestChild[v] = -1;
+            containsLandmark[v] = isLandmark[v];
+        }
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int v = *it;
+            double bound = 0.0;
+            const double* row = table.data() + static_cast<size_t>(v) * count;
+            for (int l = 0; l < i; ++l) {
+                if (row[l] != INFINITE_DISTANCE && rootRow[l] != INFINITE_DISTANCE) {
+                    bound = std::max(bound, std::abs(row[l] - rootRow[l]));
+                }
+            }
+            size[v] += rootDist[v] - bound;
+            if (containsLandmark[v]) {
+                size[v] = 0.0;
+            }
+
+            int p = parent[v];
+            if (p >= 0) {
+                if (containsLandmark[v]) {
+                    containsLandmark[p] = 1;
+                } else {
+                    size[p] += size[v];
+                }
+                if (bestChild[p] < 0 || size[v] > size[bestChild[p]]) {
+                    bestChild[p] = v;
+                }
+            }
+        }
+
+        // 从根沿最大子树走到叶子
+        int leaf = root;
+        while (bestChild[leaf] >= 0 && size[bestChild[leaf]] > 0.0) {
+            leaf = bestChild[leaf];
+        }
+
+        if (isLandmark[leaf]) {
+            // 退化情况：改用离已选地标最远的节点
+            leaf = -1;
+            double bestDist = -1.0;
+            for (int v : candidates) {
+                if (isLandmark[v]) {
+                    continue;
+                }
+                double minDist = INFINITE_DISTANCE;
+                const double* row = table.data() + static_cast<size_t>(v) * count;
+                for (int l = 0; l < i; ++l) {
+                    minDist = std::min(minDist, row[l]);
+                }
+                if (minDist > bestDist) {
+                    bestDist = minDist;
+                    leaf = v;
+                }
+            }
+            if (leaf < 0) {
+                break;
+            }
+        }
+
+        isLandmark[leaf] = 1;
+        landmarkIndices_.push_back(leaf);
+        shortestPathTree(graph, weights, leaf, dist, nullptr, nullptr);
+        for (size_t v = 0; v < n; ++v) {
+            table[v * count + i] = dist[v];
+            if (dist[v] != INFINITE_DISTANCE) {
+                covered[v] = 1;
+            }
+        }
+    }
+}
+
+void Landmarks::fillTable(const Graph& graph, const double* weights,
+                          std::vector<double>& table) const {
+    table.assign(nodeCount_ * landmarkCount_, INFINITE_DISTANCE);
+    std::vector<double> dist;
+    for (int i = 0; i < landmarkCount_; ++i) {
+        shortestPathTree(graph, weights, landmarkIndices_[i], dist, nullptr, nullptr);
+        for (size_t v = 0; v < nodeCount_; ++v) {
+            table[v * landmarkCount_ + i] = dist[v];
+        }
+    }
+}
+
+int Landmarks::selectActive(PathStrategy strategy, int source, int target,
+                            int maxActive, int* active) const {
+    const double* sourceRow = getRow(strategy, source);
+    const double* targetRow = getRow(strategy, target);
+
+    maxActive = std::min(maxActive, MAX_ACTIVE);
+    int activeCount = 0;
+    double bounds[MAX_ACTIVE];
+    for (int i = 0; i < landmarkCount_; ++i) {
+        double bound = lowerBound(targetRow, sourceRow, &i, 1);
+
+        // 插入排序维护下界最大的 maxActive 个地标
+        int pos;
+        if (activeCount < maxActive) {
+            pos = activeCount++;
+        } else if (maxActive > 0 && bound > bounds[maxActive - 1]) {
+            pos = maxActive - 1;
+        } else {
+            continue;
+        }
+        while (pos > 0 && bounds[pos - 1] < bound) {
+            bounds[pos] = bounds[pos - 1];
+            active[pos] = active[pos - 1];
+            pos--;
+        }
+        bounds[pos] = bound;
+        active[pos] = i;
+    }
+    return activeCount;
+}
+
+bool Landmarks::save(const std::string& filename) const {
+    if (landmarkCount_ == 0 || !hasTable(PathStrategy::LEAST_TIME)) {
+        return false;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "错误：无法写入地标文件 " << filename << std::endl;
+        return false;
+    }
+
+    // 地标以下标保存：加载时通过图校验和保证下标含义一致
+    uint32_t version = FILE_VERSION;
+    uint32_t count = static_cast<uint32_t>(landmarkCount_);
+    uint64_t nodeCount = nodeCount_;
+    file.write(LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(&nodeCount), sizeof(nodeCount));
+    file.write(reinterpret_cast<const char*>(&graphChecksum_), sizeof(graphChecksum_));
+    file.write(reinterpret_cast<const char*>(landmarkIndices_.data()),
+               landmarkIndices_.size() * sizeof(int));
+    file.write(reinterpret_cast<const char*>(distanceTable_.data()),
+               distanceTable_.size() * sizeof(double));
+    if (timeScale_ == 1.0) {
+        file.write(reinterpret_cast<const char*>(timeTable_.data()),
+                   timeTable_.size() * sizeof(double));
+    } else {
+        // 缩放过的时间表按缩放后的值保存，加载后仍是有效的下界
+        std::vector<double> timeTable(timeTable_.begin(), timeTable_.end());
+        for (double& time : timeTable) {
+            if (time != INFINITE_DISTANCE) {
+                time *= timeScale_;
+            }
+        }
+        file.write(reinterpret_cast<const char*>(timeTable.data()),
+                   timeTable.size() * sizeof(double));
+    }
+
+    return file.good();
+}
+
+bool Landmarks::load(const std::string& filename, const Graph& graph) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(LANDMARK_MAGIC)];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    uint64_t nodeCount = 0;
+    uint64_t checksum = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    file.read(reinterpret_cast<char*>(&nodeCount), sizeof(nodeCount));
+    file.read(reinterpret_cast<char*>(&checksum), sizeof(checksum));
+
+    if (!file || std::memcmp(magic, LANDMARK_MAGIC, sizeof(magic)) != 0 ||
+        version != FILE_VERSION) {
+        std::cerr << "警告：地标文件 " << filename << " 格式不正确，已忽略" << std::endl;
+        return false;
+    }
+    if (nodeCount != graph.getNodeCount() || checksum != graph.computeChecksum() || count == 0) {
+        std::cerr << "警告：地标文件 " << filename << " 与当前地图不匹配，已忽略" << std::endl;
+        return false;
+    }
+
+    std::vector<int> indices(count);
+    std::vector<double> distanceTable(nodeCount * count);
+    std::vector<double> timeTable(nodeCount * count);
+    file.read(reinterpret_cast<char*>(indices.data()), indices.size() * sizeof(int));
+    file.read(reinterpret_cast<char*>(distanceTable.data()), distanceTable.size() * sizeof(double));
+    file.read(reinterpret_cast<char*>(timeTable.data()), timeTable.size() * sizeof(double));
+    if (!file) {
+        std::cerr << "警告：地标文件 " << filename << " 数据不完整，已忽略" << std::endl;
+        return false;
+    }
+    for (int index : indices) {
+        if (index < 0 || static_cast<uint64_t>(index) >= nodeCount) {
+            std::cerr << "警告：地标文件 " << filename << " 数据损坏，已忽略" << std::endl;
+            return false;
+        }
+    }
+
+    landmarkCount_ = static_cast<int>(count);
+    nodeCount_ = nodeCount;
+    graphChecksum_ = checksum;
+    landmarkIndices_.swap(indices);
+    distanceTable_.assign(std::move(distanceTable));
+    timeTable_.assign(std::move(timeTable));
+    mapping_.reset();
+    base_.reset();
+    return true;
+}
+
+size_t Landmarks::getMemoryUsage() const {
+    return landmarkIndices_.capacity() * sizeof(int)
+         + distanceTable_.getMemoryUsage()
+         + timeTable_.getMemoryUsage();
+}
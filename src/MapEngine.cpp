@@ -1,135 +1,901 @@
 #include "../include/MapEngine.h"
 #include <iostream>
-#include <functional>
-#include <set>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
 
-MapEngine::MapEngine() : currentStrategy_(PathStrategy::SHORTEST_DISTANCE) {
-    pathFinder_ = std::make_unique<PathFinder>(graph_);
+namespace {
+    // PathBatch 批量查询时每块的查询数（一块由一个线程依次执行，路径写入同一个缓冲区）
+    const size_t BATCH_CHUNK_SIZE = 256;
+    // 每块路径缓冲区的块大小（节点数）
+    const size_t BATCH_ARENA_BLOCK_SIZE = 1 << 14;
 }
 
-MapEngine::~MapEngine() = default;
+MapEngine::MapEngine()
+    : reaper_(std::make_shared<SnapshotReaper>()),
+      snapshot_(reaper_->adopt(MapSnapshot::createEmpty())),
+      currentStrategy_(PathStrategy::SHORTEST_DISTANCE),
+      currentAlgorithm_(SearchAlgorithm::DIJKSTRA),
+      verifyBinaryMap_(true),
+      nodeOrder_(NodeOrder::ORIGINAL),
+      queueType_(QueueType::DARY_HEAP),
+      threadCount_(0),
+      metricsEnabled_(true),
+      lastReloadSucceeded_(false),
+      landmarkTimeFactor_(1.0),
+      customizeRequested_(false),
+      customizeRunning_(false),
+      customizeStopping_(false) {
+}
+
+MapEngine::~MapEngine() {
+    // 重载线程结束前还要更新状态，在锁外等待
+    std::thread reloadThread;
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex_);
+        reloadThread.swap(reloadThread_);
+    }
+    if (reloadThread.joinable()) {
+        reloadThread.join();
+    }
+    // 正在进行的定制完成后定制线程退出
+    {
+        std::lock_guard<std::mutex> lock(customizeMutex_);
+        customizeStopping_ = true;
+    }
+    customizeWake_.notify_all();
+    if (customizeThread_.joinable()) {
+        customizeThread_.join();
+    }
+    // 此后放下的快照（包括当前快照）在放下它的线程中释放，不再回调本对象
+    reaper_->stop();
+}
 
 bool MapEngine::loadMap(const std::string& filename) {
-    // 清空现有数据
-    graph_.clear();
-    distances_.clear();
-    times_.clear();
+    std::lock_guard<std::mutex> lock(updateMutex_);
+
+    // 加载到新快照，正在进行的查询继续使用旧快照
+    std::shared_ptr<const MapSnapshot> snapshot =
+        loadSnapshot(filename, dataLoader_, verifyBinaryMap_, nodeOrder_, queueType_);
+    if (!snapshot) {
+        // 与之前的行为一致：加载失败后地图为空（预处理数据依赖于图，一并丢弃）
+        pendingTimeHierarchy_.reset();
+        publish(MapSnapshot::createEmpty());
+        invalidateResultCache();
+        return false;
+    }
+
+    mapFilename_ = filename;
+    pendingTimeHierarchy_.reset();
+    publish(std::move(snapshot));
+    invalidateResultCache();
+    return true;
+}
+
+std::shared_ptr<const MapSnapshot> MapEngine::loadSnapshot(const std::string& filename,
+                                                           DataLoader& loader, bool verify,
+                                                           NodeOrder order, QueueType queueType) {
+    std::shared_ptr<const MapSnapshot> snapshot;
+    if (BinaryMap::isBinaryMap(filename)) {
+        // 二进制地图：映射文件，图和预处理数据直接使用映射的页
+        snapshot = BinaryMap::load(filename, verify);
+    } else {
+        // 文本地图：解析数据到新图（每条边同时带距离和时间）
+        auto graph = std::make_shared<Graph>();
+        if (loader.loadFromFile(filename, *graph)) {
+            // 可选：按遍历顺序重排稠密下标，之后的预处理和查询都使用新顺序
+            if (order != NodeOrder::ORIGINAL) {
+                auto start = std::chrono::high_resolution_clock::now();
+                double spanBefore = NodeOrdering::averageEdgeSpan(*graph);
+                NodeOrdering::apply(*graph, order);
+                auto end = std::chrono::high_resolution_clock::now();
+                std::cout << "节点重排（" << NodeOrdering::getName(order) << "）：平均边跨度 "
+                          << spanBefore << " -> " << NodeOrdering::averageEdgeSpan(*graph)
+                          << "，耗时 " << std::chrono::duration<double, std::milli>(end - start).count()
+                          << " 毫秒" << std::endl;
+            }
+            snapshot = std::make_shared<MapSnapshot>(std::move(graph), nullptr, nullptr, nullptr,
+                                                     queueType);
+        }
+    }
+    if (!snapshot) {
+        return nullptr;
+    }
+
+    if (snapshot->getQueueType() != queueType) {
+        snapshot = snapshot->withQueueType(queueType);
+    }
+
+    // 可选：二进制地图未内嵌地标表时，加载地图旁保存的地标表
+    if (!snapshot->getLandmarks()) {
+        auto landmarks = std::make_shared<Landmarks>();
+        if (landmarks->load(getLandmarkFilename(filename), snapshot->getGraph())) {
+            snapshot = snapshot->withLandmarks(std::move(landmarks));
+        }
+    }
+    return snapshot;
+}
+
+bool MapEngine::startReload(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    if (reloadStatus_.inProgress) {
+        return false;
+    }
+    // 上一个重载线程已经结束，回收后启动新线程
+    if (reloadThread_.joinable()) {
+        reloadThread_.join();
+    }
+    reloadStatus_.inProgress = true;
+    reloadThread_ = std::thread(&MapEngine::runReload, this, filename);
+    return true;
+}
+
+bool MapEngine::waitForReload() {
+    std::unique_lock<std::mutex> lock(reloadMutex_);
+    reloadFinished_.wait(lock, [this] { return !reloadStatus_.inProgress; });
+    return lastReloadSucceeded_;
+}
+
+ReloadStatus MapEngine::getReloadStatus() const {
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    return reloadStatus_;
+}
+
+void MapEngine::runReload(const std::string& filename) {
+    auto start = std::chrono::steady_clock::now();
+    bool verify = true;
+    NodeOrder order = NodeOrder::ORIGINAL;
+    QueueType queueType = QueueType::DARY_HEAP;
+    std::shared_ptr<const MapSnapshot> current;
+    bool timeHierarchyPending = false;
+    {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        verify = verifyBinaryMap_;
+        order = nodeOrder_;
+        queueType = queueType_;
+        current = getSnapshot();
+        timeHierarchyPending = pendingTimeHierarchy_ != nullptr;
+    }
+
+    // 构建期间不持有 updateMutex_：查询和其他写操作（预处理、权重更新）照常进行
+    std::shared_ptr<const MapSnapshot> snapshot;
+    try {
+        DataLoader loader;
+        snapshot = loadSnapshot(filename, loader, verify, order, queueType);
+        if (snapshot && current->getLandmarks() && !snapshot->getLandmarks()) {
+            auto landmarks = std::make_shared<Landmarks>();
+            if (landmarks->build(snapshot->getGraph(), current->getLandmarks()->getLandmarkCount(),
+                                 current->getLandmarks()->getSelection())) {
+                snapshot = snapshot->withLandmarks(std::move(landmarks));
+            } else {
+                snapshot.reset();
+            }
+        }
+        const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+        for (PathStrategy strategy : strategies) {
+            // 正在按新时间重新定制的层次也算作已有
+            bool present = current->getContractionHierarchy(strategy) ||
+                           (strategy == PathStrategy::LEAST_TIME && timeHierarchyPending);
+            if (snapshot && present && !snapshot->getContractionHierarchy(strategy)) {
+                auto hierarchy = std::make_shared<ContractionHierarchy>();
+                if (hierarchy->build(snapshot->getGraph(), strategy)) {
+                    snapshot = snapshot->withContractionHierarchy(strategy, std::move(hierarchy));
+                } else {
+                    snapshot.reset();
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "错误: 重载地图 " << filename << " 时发生异常: " << e.what() << std::endl;
+        snapshot.reset();
+    }
+    current.reset();
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const bool published = snapshot != nullptr;
+    std::shared_ptr<const MapSnapshot> old;
+    std::chrono::steady_clock::time_point publishedAt;
+    if (published) {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        // 构建期间可能切换过优先队列
+        if (snapshot->getQueueType() != queueType_) {
+            snapshot = snapshot->withQueueType(queueType_);
+        }
+        mapFilename_ = filename;
+        pendingTimeHierarchy_.reset();
+        old = snapshot_.exchange(reaper_->adopt(std::move(snapshot)));
+        publishedAt = std::chrono::steady_clock::now();
+        invalidateResultCache();
+    } else {
+        std::cerr << "错误: 无法重载地图 " << filename << "，继续使用原地图" << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex_);
+        lastReloadSucceeded_ = published;
+        if (published) {
+            const uint64_t reload = ++reloadStatus_.succeeded;
+            reloadStatus_.drainSeconds = 0.0;
+            reloadStatus_.drained = false;
+            // 旧快照已不再发布：最后一个持有者放下引用时交给回收线程释放，释放后记录排空时间。
+            // 注册时仍持有 old，回调不会错过；之后又有重载发布时不再改写新的状态
+            reaper_->watch(old.get(), [this, reload, publishedAt]() {
+                std::lock_guard<std::mutex> lock(reloadMutex_);
+                if (reloadStatus_.succeeded == reload) {
+                    reloadStatus_.drainSeconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - publishedAt).count();
+                    reloadStatus_.drained = true;
+                }
+            });
+            // 放下引用只把快照交给回收线程，回调在回收线程中执行，这里不会重入 reloadMutex_
+            old.reset();
+        } else {
+            reloadStatus_.failed++;
+        }
+        reloadStatus_.buildSeconds = buildSeconds;
+        reloadStatus_.inProgress = false;
+    }
+    reloadFinished_.notify_all();
+}
+
+bool MapEngine::saveBinaryMap(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    return BinaryMap::save(filename, *getSnapshot());
+}
+
+void MapEngine::setVerifyBinaryMap(bool verify) {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    verifyBinaryMap_ = verify;
+}
+
+void MapEngine::setNodeOrder(NodeOrder order) {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    nodeOrder_ = order;
+}
+
+NodeOrder MapEngine::getNodeOrder() const {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    return nodeOrder_;
+}
+
+bool MapEngine::buildLandmarks(int count, LandmarkSelection selection) {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+
+    auto landmarks = std::make_shared<Landmarks>();
+    if (!landmarks->build(snapshot->getGraph(), count, selection)) {
+        return false;
+    }
+
+    publish(snapshot->withLandmarks(std::move(landmarks)));
+    return true;
+}
+
+bool MapEngine::saveLandmarks(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+
+    if (!snapshot->getLandmarks()) {
+        return false;
+    }
+    return snapshot->getLandmarks()->save(
+        filename.empty() ? getLandmarkFilename(mapFilename_) : filename);
+}
+
+bool MapEngine::loadLandmarks(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+
+    auto landmarks = std::make_shared<Landmarks>();
+    if (!landmarks->load(filename.empty() ? getLandmarkFilename(mapFilename_) : filename,
+                         snapshot->getGraph())) {
+        return false;
+    }
+
+    publish(snapshot->withLandmarks(std::move(landmarks)));
+    return true;
+}
+
+bool MapEngine::hasLandmarks() const {
+    return getSnapshot()->getLandmarks() != nullptr;
+}
+
+void MapEngine::clearLandmarks() {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    publish(getSnapshot()->withLandmarks(nullptr));
+}
+
+bool MapEngine::buildContractionHierarchies() {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    for (PathStrategy strategy : strategies) {
+        auto hierarchy = std::make_shared<ContractionHierarchy>();
+        if (!hierarchy->build(snapshot->getGraph(), strategy)) {
+            return false;
+        }
+        snapshot = snapshot->withContractionHierarchy(strategy, std::move(hierarchy));
+    }
+
+    pendingTimeHierarchy_.reset();
+    publish(std::move(snapshot));
+    return true;
+}
+
+bool MapEngine::hasContractionHierarchy(PathStrategy strategy) const {
+    return getSnapshot()->getContractionHierarchy(strategy) != nullptr;
+}
+
+void MapEngine::clearContractionHierarchies() {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    snapshot = snapshot->withContractionHierarchy(PathStrategy::SHORTEST_DISTANCE, nullptr);
+    snapshot = snapshot->withContractionHierarchy(PathStrategy::LEAST_TIME, nullptr);
+    pendingTimeHierarchy_.reset();
+    publish(std::move(snapshot));
+}
+
+bool MapEngine::updateEdgeTime(int from, int to, double newTime) {
+    return applyWeightUpdates(std::vector<EdgeTimeUpdate>{{from, to, newTime}}) == 1;
+}
+
+size_t MapEngine::applyWeightUpdates(const std::vector<EdgeTimeUpdate>& updates) {
+    if (updates.empty()) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    const Graph& graph = snapshot->getGraph();
     
-    // 加载数据（带距离和时间信息）
-    bool success = dataLoader_.loadFromFileWithDetails(filename, graph_, distances_, times_);
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    const size_t arcCount = graph.getNodeCount() == 0 ? 0 : offsets[graph.getNodeCount()];
+    std::vector<double> times(graph.getTimes(), graph.getTimes() + arcCount);
     
-    if (success) {
-        // 根据当前策略重建图权重
-        rebuildGraphWeights();
-        
-        // 重新创建PathFinder（因为图已经改变）
-        pathFinder_ = std::make_unique<PathFinder>(graph_);
+    size_t applied = 0;
+    // 权重变化的边（稠密下标）
+    std::vector<std::pair<int, int>> changedEdges;
+    for (const EdgeTimeUpdate& update : updates) {
+        int u = graph.getIndex(update.from);
+        int v = graph.getIndex(update.to);
+        if (u == Graph::INVALID_INDEX || v == Graph::INVALID_INDEX ||
+            !(update.time > 0.0) || !std::isfinite(update.time)) {
+            continue;
+        }
         
-        // 设置策略
-        setStrategy(currentStrategy_);
+        // 无向边在两个端点各存一条弧，两个方向一起更新；平行边一并更新
+        bool found = false;
+        auto patch = [&](int a, int b) {
+            for (int e = offsets[a]; e < offsets[a + 1]; ++e) {
+                if (targets[e] != b) {
+                    continue;
+                }
+                found = true;
+                if (update.time != times[e]) {
+                    times[e] = update.time;
+                    if (changedEdges.empty() || changedEdges.back() != std::make_pair(u, v)) {
+                        changedEdges.emplace_back(u, v);
+                    }
+                }
+            }
+        };
+        patch(u, v);
+        patch(v, u);
+        if (found) {
+            applied++;
+        }
     }
     
-    return success;
-}
-
-void MapEngine::setStrategy(PathStrategy strategy) {
-    currentStrategy_ = strategy;
+    if (applied < updates.size()) {
+        std::cerr << "警告：" << updates.size() - applied
+                  << " 条边权重更新无效（边不存在或时间不是正数），已忽略" << std::endl;
+    }
+    if (changedEdges.empty()) {
+        return applied;
+    }
     
-    std::unique_ptr<Strategy> strategyImpl;
+    // 新旧时间之比的最小值：同一条边在一批中可能更新多次，按最终时间与原时间计算
+    const double* oldTimes = graph.getTimes();
+    double factor = 1.0;
+    for (const std::pair<int, int>& edge : changedEdges) {
+        for (int a : {edge.first, edge.second}) {
+            int b = a == edge.first ? edge.second : edge.first;
+            for (int e = offsets[a]; e < offsets[a + 1]; ++e) {
+                if (targets[e] == b) {
+                    factor = std::min(factor, times[e] / oldTimes[e]);
+                }
+            }
+        }
+    }
     
-    switch (strategy) {
-        case PathStrategy::SHORTEST_DISTANCE:
-            strategyImpl = std::make_unique<ShortestDistanceStrategy>();
-            break;
-        case PathStrategy::LEAST_TIME:
-            strategyImpl = std::make_unique<LeastTimeStrategy>();
-            break;
-        default:
-            strategyImpl = std::make_unique<ShortestDistanceStrategy>();
-            break;
+    std::shared_ptr<const Graph> updated = Graph::withTimes(snapshot->getSharedGraph(),
+                                                            std::move(times));
+    
+    // 时间只增加时，旧的时间表仍是新权重下的有效下界（A* 势函数保持可行）；
+    // 减小时把时间表的下界按最小的新旧时间之比缩放后继续使用，由后台按新时间重新计算
+    std::shared_ptr<const Landmarks> landmarks = snapshot->getSharedLandmarks();
+    if (landmarks && factor < 1.0 && landmarks->hasTable(PathStrategy::LEAST_TIME)) {
+        landmarks = Landmarks::withTimeScale(landmarks, *updated, factor);
     }
+    landmarkTimeFactor_ *= factor;
+    bool landmarksPending = landmarks && (!landmarks->hasTable(PathStrategy::LEAST_TIME) ||
+                                          landmarks->getScale(PathStrategy::LEAST_TIME) < 1.0);
     
-    // 重建图权重
-    rebuildGraphWeights();
+    // 定制得到的时间层次只重新计算受影响的向上边，与新图一起发布，不撤下；
+    // build 得到的层次先撤下，由后台按其节点顺序转换为可定制的层次
+    std::shared_ptr<const ContractionHierarchy> timeHierarchy =
+        snapshot->getSharedContractionHierarchy(PathStrategy::LEAST_TIME);
+    if (timeHierarchy && timeHierarchy->isCustomizable()) {
+        std::shared_ptr<const ContractionHierarchy> customized =
+            ContractionHierarchy::customize(*updated, timeHierarchy, changedEdges);
+        if (!customized) {
+            std::cerr << "错误：按新的通行时间定制收缩层次失败，时间策略不再使用收缩层次" << std::endl;
+        }
+        timeHierarchy = std::move(customized);
+    } else if (timeHierarchy) {
+        pendingTimeHierarchy_ = std::move(timeHierarchy);
+    }
     
-    // 重新创建PathFinder
-    pathFinder_ = std::make_unique<PathFinder>(graph_);
-    pathFinder_->setStrategy(std::move(strategyImpl));
+    publish(snapshot->withUpdatedTimes(std::move(updated), std::move(landmarks),
+                                       std::move(timeHierarchy)));
+    invalidateResultCache();
+    if (pendingTimeHierarchy_ || landmarksPending) {
+        requestCustomization();
+    }
+    return applied;
 }
 
-void MapEngine::rebuildGraphWeights() {
-    // 清空现有边
-    graph_.clear();
-    
-    // 使用集合记录已添加的边，避免重复（无向图）
-    std::set<std::pair<int, int>> addedEdges;
-    
-    // 根据当前策略重新添加边
-    for (const auto& distPair : distances_) {
-        int from = distPair.first.first;
-        int to = distPair.first.second;
-        double distance = distPair.second;
-        double time = times_[distPair.first];
-        
-        // 跳过无效边（距离或时间为0或负数）
-        if (distance <= 0 || time <= 0) {
-            continue;
+void MapEngine::waitForCustomization() {
+    std::unique_lock<std::mutex> lock(customizeMutex_);
+    customizeIdle_.wait(lock, [this] { return !customizeRequested_ && !customizeRunning_; });
+}
+
+void MapEngine::requestCustomization() {
+    std::lock_guard<std::mutex> lock(customizeMutex_);
+    customizeRequested_ = true;
+    if (!customizeThread_.joinable()) {
+        customizeThread_ = std::thread(&MapEngine::runCustomizer, this);
+    }
+    customizeWake_.notify_one();
+}
+
+void MapEngine::runCustomizer() {
+    std::unique_lock<std::mutex> lock(customizeMutex_);
+    while (true) {
+        customizeWake_.wait(lock, [this] { return customizeRequested_ || customizeStopping_; });
+        if (customizeStopping_) {
+            break;
         }
-        
-        // 创建边的键（确保from < to，避免重复）
-        std::pair<int, int> edgeKey = (from < to) ? 
-            std::make_pair(from, to) : std::make_pair(to, from);
-        
-        // 如果边已添加，跳过
-        if (addedEdges.find(edgeKey) != addedEdges.end()) {
-            continue;
+        // 一轮定制覆盖开始之前到达的所有更新，之后到达的更新再次请求
+        customizeRequested_ = false;
+        customizeRunning_ = true;
+        lock.unlock();
+        customizePending();
+        lock.lock();
+        customizeRunning_ = false;
+        customizeIdle_.notify_all();
+    }
+    customizeRunning_ = false;
+    customizeRequested_ = false;
+    customizeIdle_.notify_all();
+}
+
+void MapEngine::customizePending() {
+    std::shared_ptr<const MapSnapshot> snapshot;
+    std::shared_ptr<const ContractionHierarchy> order;
+    {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        snapshot = getSnapshot();
+        order = pendingTimeHierarchy_;
+        // 从这里开始累计时间表需要的缩放因子
+        landmarkTimeFactor_ = 1.0;
+    }
+    std::shared_ptr<const Landmarks> staleLandmarks = snapshot->getSharedLandmarks();
+    if (staleLandmarks && staleLandmarks->hasTable(PathStrategy::LEAST_TIME) &&
+        staleLandmarks->getScale(PathStrategy::LEAST_TIME) == 1.0) {
+        staleLandmarks.reset();
+    }
+    if (!order && !staleLandmarks) {
+        return;
+    }
+
+    // 定制期间不持有 updateMutex_：新的权重更新照常发布
+    const Graph& graph = snapshot->getGraph();
+    std::shared_ptr<const ContractionHierarchy> hierarchy;
+    if (order) {
+        hierarchy = ContractionHierarchy::customize(graph, order);
+    }
+    std::shared_ptr<const Landmarks> landmarks;
+    if (staleLandmarks) {
+        landmarks = Landmarks::withTimes(staleLandmarks, graph);
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    std::shared_ptr<const MapSnapshot> current = getSnapshot();
+    const Graph& currentGraph = current->getGraph();
+    // 期间时间又有更新时结果按最新的时间补齐后发布（拓扑不变）；地图被重新加载时丢弃
+    if (currentGraph.getTargets() != graph.getTargets()) {
+        return;
+    }
+    const bool timesChanged = current->getSharedGraph() != snapshot->getSharedGraph();
+    std::shared_ptr<const MapSnapshot> next = current;
+    if (order && pendingTimeHierarchy_ == order) {
+        if (hierarchy && timesChanged) {
+            // 只重新计算期间时间变化的边影响的向上边
+            std::vector<std::pair<int, int>> changedEdges;
+            const int* offsets = graph.getOffsets();
+            const int* targets = graph.getTargets();
+            const double* before = graph.getTimes();
+            const double* after = currentGraph.getTimes();
+            for (size_t u = 0; u < graph.getNodeCount(); ++u) {
+                for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                    if (static_cast<int>(u) < targets[e] && before[e] != after[e]) {
+                        changedEdges.emplace_back(static_cast<int>(u), targets[e]);
+                    }
+                }
+            }
+            hierarchy = ContractionHierarchy::customize(currentGraph, hierarchy, changedEdges);
         }
-        
-        // 根据策略计算权重
-        double weight;
-        switch (currentStrategy_) {
-            case PathStrategy::SHORTEST_DISTANCE:
-                weight = distance;
-                break;
-            case PathStrategy::LEAST_TIME:
-                weight = time;
-                break;
-            default:
-                weight = distance;
-                break;
+        if (!hierarchy) {
+            std::cerr << "错误：按新的通行时间重新定制收缩层次失败，时间策略不再使用收缩层次" << std::endl;
+        } else if (!current->getContractionHierarchy(PathStrategy::LEAST_TIME)) {
+            next = next->withContractionHierarchy(PathStrategy::LEAST_TIME, std::move(hierarchy));
         }
-        
-        // 添加边（addEdge会自动创建双向连接）
-        graph_.addEdge(from, to, weight);
-        addedEdges.insert(edgeKey);
+        pendingTimeHierarchy_.reset();
     }
+    // 期间地标表被替换（重新构建或加载）时新表已与当前时间一致；
+    // 期间时间又减小时，新表按期间累计的缩放因子缩放后仍是有效的下界
+    if (landmarks && current->getLandmarks() &&
+        current->getLandmarks()->sharesDistanceTable(*landmarks)) {
+        if (timesChanged) {
+            landmarks = Landmarks::withTimeScale(landmarks, currentGraph, landmarkTimeFactor_);
+        }
+        next = next->withLandmarks(std::move(landmarks));
+    }
+    if (next != current) {
+        publish(std::move(next));
+    }
+    // 仍缩放着的时间表（期间时间又减小）由已发出的请求在下一轮重新计算
+}
+
+std::string MapEngine::getLandmarkFilename(const std::string& mapFilename) {
+    return mapFilename + ".landmarks";
+}
+
+void MapEngine::setStrategy(PathStrategy strategy) {
+    // 只切换查询时选用的边权重，不重建图
+    currentStrategy_.store(strategy);
 }
 
-PathResult MapEngine::findPath(int from, int to) {
-    if (!pathFinder_) {
-        PathResult result;
-        result.found = false;
-        return result;
+void MapEngine::setAlgorithm(SearchAlgorithm algorithm) {
+    currentAlgorithm_.store(algorithm);
+}
+
+SearchAlgorithm MapEngine::getAlgorithm() const {
+    return currentAlgorithm_.load();
+}
+
+void MapEngine::setQueueType(QueueType type) {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    queueType_ = type;
+    publish(getSnapshot()->withQueueType(type));
+}
+
+QueueType MapEngine::getQueueType() const {
+    return getSnapshot()->getQueueType();
+}
+
+PathResult MapEngine::findPath(int from, int to) const {
+    return findPath(from, to, currentStrategy_.load());
+}
+
+PathResult MapEngine::findPath(int from, int to, PathStrategy strategy) const {
+    std::shared_ptr<PathCache> cache = resultCache_.load();
+    uint64_t generation = cache ? cache->getGeneration() : 0;
+    // 持有快照的引用直到查询结束，期间替换快照不影响本次查询
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    return cachedFindPath(cache.get(), generation, *snapshot, from, to, strategy,
+                          currentAlgorithm_.load());
+}
+
+PathResult MapEngine::findDistance(int from, int to) const {
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    PathResult result = snapshot->findDistance(from, to, currentStrategy_.load(),
+                                               currentAlgorithm_.load());
+    if (metricsEnabled_.load(std::memory_order_relaxed)) {
+        metrics_.record(result);
     }
-    
-    return pathFinder_->findPath(from, to);
+    return result;
 }
 
-const char* MapEngine::getCurrentStrategyName() const {
-    if (!pathFinder_) {
-        return "Unknown";
+PathResult MapEngine::findPath(int from, int to, const Strategy& strategy) const {
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    PathResult result = snapshot->findPath(from, to, strategy, currentAlgorithm_.load());
+    if (metricsEnabled_.load(std::memory_order_relaxed)) {
+        metrics_.record(result);
+    }
+    return result;
+}
+
+PathResult MapEngine::findPath(int from, int to, const std::string& strategyName) const {
+    std::shared_ptr<const Strategy> strategy = getRegisteredStrategy(strategyName);
+    if (!strategy) {
+        std::cerr << "错误：未注册的策略 " << strategyName << std::endl;
+        return PathResult();
+    }
+    return findPath(from, to, *strategy);
+}
+
+bool MapEngine::registerStrategy(std::shared_ptr<const Strategy> strategy) {
+    if (!strategy || strategy->getName() == nullptr || strategy->getName()[0] == '\0') {
+        std::cerr << "错误：策略为空或没有名称" << std::endl;
+        return false;
+    }
+    double alpha = 0.0;
+    double beta = 0.0;
+    if (strategy->getLinearCoefficients(alpha, beta) &&
+        !(alpha >= 0.0 && beta >= 0.0 && std::isfinite(alpha) && std::isfinite(beta) &&
+          alpha + beta > 0.0)) {
+        std::cerr << "错误：策略 " << strategy->getName()
+                  << " 的线性系数必须非负且不能都为 0" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(strategyMutex_);
+    std::string name = strategy->getName();
+    strategies_[name] = std::move(strategy);
+    return true;
+}
+
+bool MapEngine::registerLinearStrategy(const std::string& name, double distanceWeight,
+                                       double timeWeight) {
+    return registerStrategy(
+        std::make_shared<LinearCombinationStrategy>(name, distanceWeight, timeWeight));
+}
+
+bool MapEngine::unregisterStrategy(const std::string& name) {
+    std::lock_guard<std::mutex> lock(strategyMutex_);
+    return strategies_.erase(name) > 0;
+}
+
+std::shared_ptr<const Strategy> MapEngine::getRegisteredStrategy(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(strategyMutex_);
+    auto it = strategies_.find(name);
+    return it == strategies_.end() ? nullptr : it->second;
+}
+
+std::vector<PathResult> MapEngine::findPaths(const std::pair<int, int>* queries,
+                                             size_t count) const {
+    std::vector<PathResult> results(count);
+    if (count == 0) {
+        return results;
     }
-    return pathFinder_->getCurrentStrategyName();
+
+    std::shared_ptr<PathCache> cache = resultCache_.load();
+    uint64_t generation = cache ? cache->getGeneration() : 0;
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    PathStrategy strategy = currentStrategy_.load();
+    SearchAlgorithm algorithm = currentAlgorithm_.load();
+
+    // 每个查询写入自己的结果槽位，线程之间不共享可写数据
+    getThreadPool()->parallelFor(count, [&](size_t i) {
+        results[i] = cachedFindPath(cache.get(), generation, *snapshot, queries[i].first,
+                                    queries[i].second, strategy, algorithm);
+    });
+
+    return results;
+}
+
+std::vector<PathResult> MapEngine::findPaths(const std::vector<std::pair<int, int>>& queries) const {
+    return findPaths(queries.data(), queries.size());
+}
+
+void MapEngine::findPaths(const std::pair<int, int>* queries, size_t count, PathBatch& batch,
+                          bool distancesOnly) const {
+    PathStrategy strategy = currentStrategy_.load();
+    findPathsInto(count, batch, distancesOnly, [queries, strategy](size_t i) {
+        return PathQuery(queries[i].first, queries[i].second, strategy);
+    });
+}
+
+void MapEngine::findPaths(const PathQuery* queries, size_t count, PathBatch& batch,
+                          bool distancesOnly) const {
+    findPathsInto(count, batch, distancesOnly, [queries](size_t i) { return queries[i]; });
+}
+
+template <typename Query>
+void MapEngine::findPathsInto(size_t count, PathBatch& batch, bool distancesOnly,
+                              Query&& query) const {
+    batch.results_.resize(count);
+    if (count == 0) {
+        return;
+    }
+
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    SearchAlgorithm algorithm = currentAlgorithm_.load();
+    bool recordMetrics = metricsEnabled_.load(std::memory_order_relaxed);
+
+    // 连续的一段查询为一块，块内的路径依次写入该块的缓冲区，线程之间不共享可写数据
+    size_t chunkCount = (count + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+    while (batch.arenas_.size() < chunkCount) {
+        batch.arenas_.emplace_back(BATCH_ARENA_BLOCK_SIZE);
+    }
+    getThreadPool()->parallelFor(chunkCount, [&](size_t chunk) {
+        PathArena& arena = batch.arenas_[chunk];
+        arena.clear();
+        size_t end = std::min(count, (chunk + 1) * BATCH_CHUNK_SIZE);
+        for (size_t i = chunk * BATCH_CHUNK_SIZE; i < end; ++i) {
+            PathQuery item = query(i);
+            PathResult& result = batch.results_[i];
+            if (distancesOnly) {
+                result = snapshot->findDistance(item.from, item.to, item.strategy, algorithm);
+            } else {
+                result = snapshot->findPath(item.from, item.to, item.strategy, algorithm, arena);
+            }
+            if (recordMetrics) {
+                metrics_.record(result);
+            }
+        }
+    });
+}
+
+bool MapEngine::reachableWithin(int from, double budget, PathStrategy strategy,
+                                std::vector<ReachableNode>& table) const {
+    return getSnapshot()->reachableWithin(from, budget, strategy, table);
+}
+
+bool MapEngine::reachableWithin(int from, double budget, PathStrategy strategy,
+                                std::vector<int>& nodes) const {
+    return getSnapshot()->reachableWithin(from, budget, strategy, nodes);
+}
+
+bool MapEngine::shortestPathTree(int from, PathStrategy strategy, ShortestPathTree& tree,
+                                 double delta) const {
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    std::shared_ptr<ThreadPool> pool = getThreadPool();
+    return snapshot->shortestPathTree(from, strategy, delta, tree, pool.get());
+}
+
+ParetoResult MapEngine::findParetoPaths(int from, int to, size_t maxLabels) const {
+    return getSnapshot()->findParetoPaths(from, to, maxLabels);
+}
+
+std::vector<PathResult> MapEngine::findKShortestPaths(int from, int to, int k,
+                                                      PathStrategy strategy) const {
+    return getSnapshot()->findKShortestPaths(from, to, k, strategy);
+}
+
+PathResult MapEngine::cachedFindPath(PathCache* cache, uint64_t generation,
+                                     const MapSnapshot& snapshot, int from, int to,
+                                     PathStrategy strategy, SearchAlgorithm algorithm) const {
+    PathResult result;
+    auto start = std::chrono::steady_clock::now();
+    if (cache && cache->lookup(from, to, strategy, result)) {
+        // 命中的结果没有搜索，耗时为查缓存的时间
+        auto end = std::chrono::steady_clock::now();
+        result.elapsedMicroseconds =
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        result.peakQueueSize = 0;
+        result.stats = SearchStats();
+    } else {
+        result = snapshot.findPath(from, to, strategy, algorithm);
+        if (cache) {
+            cache->insert(from, to, strategy, result, generation);
+        }
+    }
+
+    if (metricsEnabled_.load(std::memory_order_relaxed)) {
+        metrics_.record(result);
+    }
+    return result;
+}
+
+void MapEngine::setMetricsEnabled(bool enabled) {
+    metricsEnabled_.store(enabled);
+}
+
+MetricsSnapshot MapEngine::getMetrics() const {
+    return metrics_.snapshot();
+}
+
+std::string MapEngine::getMetricsText() const {
+    return QueryMetrics::toPrometheus(metrics_.snapshot());
+}
+
+void MapEngine::resetMetrics() {
+    metrics_.reset();
+}
+
+void MapEngine::setResultCacheCapacity(size_t capacity) {
+    std::shared_ptr<PathCache> cache;
+    if (capacity > 0) {
+        cache = std::make_shared<PathCache>(capacity);
+    }
+    resultCache_.store(std::move(cache));
+}
+
+PathCacheStats MapEngine::getResultCacheStats() const {
+    std::shared_ptr<PathCache> cache = resultCache_.load();
+    return cache ? cache->getStats() : PathCacheStats();
+}
+
+void MapEngine::clearResultCache() {
+    invalidateResultCache();
+}
+
+void MapEngine::invalidateResultCache() {
+    std::shared_ptr<PathCache> cache = resultCache_.load();
+    if (cache) {
+        cache->invalidate();
+    }
+}
+
+DistanceMatrix MapEngine::distanceMatrix(const std::vector<int>& sources,
+                                         const std::vector<int>& targets,
+                                         PathStrategy strategy, bool distancesOnly) const {
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    std::shared_ptr<ThreadPool> pool = getThreadPool();
+    return snapshot->distanceMatrix(sources, targets, strategy, distancesOnly, pool.get());
+}
+
+void MapEngine::setThreadCount(size_t threadCount) {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    threadCount_ = threadCount;
+    // 正在使用旧线程池的批量查询持有其引用，完成后旧线程池才销毁
+    threadPool_.reset();
+}
+
+size_t MapEngine::getThreadCount() const {
+    return getThreadPool()->getThreadCount();
+}
+
+std::shared_ptr<ThreadPool> MapEngine::getThreadPool() const {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    if (!threadPool_) {
+        threadPool_ = std::make_shared<ThreadPool>(threadCount_);
+    }
+    return threadPool_;
+}
+
+std::shared_ptr<const MapSnapshot> MapEngine::getSnapshot() const {
+    return snapshot_.load();
+}
+
+void MapEngine::publish(std::shared_ptr<const MapSnapshot> snapshot) {
+    snapshot_.store(reaper_->adopt(std::move(snapshot)));
+}
+
+const char* MapEngine::getCurrentStrategyName() const {
+    // 策略名称是字符串常量，策略对象销毁后仍然有效
+    return createStrategy(currentStrategy_.load())->getName();
 }
 
 size_t MapEngine::getNodeCount() const {
-    return graph_.getNodeCount();
+    return getSnapshot()->getGraph().getNodeCount();
 }
 
 size_t MapEngine::getEdgeCount() const {
-    return graph_.getEdgeCount();
+    return getSnapshot()->getGraph().getEdgeCount();
 }
 
 bool MapEngine::isIsolated(int nodeId) const {
-    return graph_.isIsolated(nodeId);
+    return getSnapshot()->getGraph().isIsolated(nodeId);
+}
+
+int MapEngine::componentOf(int nodeId) const {
+    std::shared_ptr<const MapSnapshot> snapshot = getSnapshot();
+    int index = snapshot->getGraph().getIndex(nodeId);
+    if (index == Graph::INVALID_INDEX) {
+        return ComponentIndex::NO_COMPONENT;
+    }
+    return snapshot->getComponentIndex().getComponentAt(index);
+}
+
+size_t MapEngine::getComponentSize(int component) const {
+    return getSnapshot()->getComponentIndex().getComponentSize(component);
+}
+
+ComponentStats MapEngine::getComponentStats() const {
+    return getSnapshot()->getComponentIndex().getStats();
 }
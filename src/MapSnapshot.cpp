@@ -0,0 +1,62 @@
+#include "../include/MapSnapshot.h"
+
+MapSnapshot::MapSnapshot(std::shared_ptr<const Graph> graph,
+                         std::shared_ptr<const Landmarks> landmarks,
+                         std::shared_ptr<const ContractionHierarchy> distanceHierarchy,
+                         std::shared_ptr<const ContractionHierarchy> timeHierarchy,
+                         QueueType queueType,
+                         std::shared_ptr<const ComponentIndex> components)
+    : graph_(std::move(graph)), landmarks_(std::move(landmarks)),
+      hierarchies_{std::move(distanceHierarchy), std::move(timeHierarchy)},
+      components_(std::move(components)),
+      pathFinder_(*graph_) {
+    if (!components_) {
+        // 新图：遍历一次计算连通分量（O(n + m)）
+        auto index = std::make_shared<ComponentIndex>();
+        index->build(*graph_);
+        components_ = std::move(index);
+    }
+    pathFinder_.setComponentIndex(components_.get());
+    pathFinder_.setLandmarks(landmarks_.get());
+    pathFinder_.setContractionHierarchy(PathStrategy::SHORTEST_DISTANCE,
+                                        hierarchies_[static_cast<int>(PathStrategy::SHORTEST_DISTANCE)].get());
+    pathFinder_.setContractionHierarchy(PathStrategy::LEAST_TIME,
+                                        hierarchies_[static_cast<int>(PathStrategy::LEAST_TIME)].get());
+    pathFinder_.setQueueType(queueType);
+}
+
+MapSnapshot::~MapSnapshot() = default;
+
+std::shared_ptr<const MapSnapshot> MapSnapshot::createEmpty() {
+    auto graph = std::make_shared<Graph>();
+    graph->finalize();
+    return std::make_shared<MapSnapshot>(std::move(graph), nullptr, nullptr, nullptr);
+}
+
+std::shared_ptr<const MapSnapshot> MapSnapshot::withLandmarks(
+    std::shared_ptr<const Landmarks> landmarks) const {
+    return std::make_shared<MapSnapshot>(graph_, std::move(landmarks),
+                                         hierarchies_[0], hierarchies_[1], getQueueType(),
+                                         components_);
+}
+
+std::shared_ptr<const MapSnapshot> MapSnapshot::withContractionHierarchy(
+    PathStrategy strategy, std::shared_ptr<const ContractionHierarchy> hierarchy) const {
+    std::shared_ptr<const ContractionHierarchy> hierarchies[2] = {hierarchies_[0], hierarchies_[1]};
+    hierarchies[static_cast<int>(strategy)] = std::move(hierarchy);
+    return std::make_shared<MapSnapshot>(graph_, landmarks_, hierarchies[0], hierarchies[1],
+                                         getQueueType(), components_);
+}
+
+std::shared_ptr<const MapSnapshot> MapSnapshot::withQueueType(QueueType queueType) const {
+    return std::make_shared<MapSnapshot>(graph_, landmarks_, hierarchies_[0], hierarchies_[1],
+                                         queueType, components_);
+}
+
+std::shared_ptr<const MapSnapshot> MapSnapshot::withUpdatedTimes(
+    std::shared_ptr<const Graph> graph, std::shared_ptr<const Landmarks> landmarks,
+    std::shared_ptr<const ContractionHierarchy> timeHierarchy) const {
+    return std::make_shared<MapSnapshot>(std::move(graph), std::move(landmarks),
+                                         hierarchies_[static_cast<int>(PathStrategy::SHORTEST_DISTANCE)],
+                                         std::move(timeHierarchy), getQueueType(), components_);
+}
@@ -0,0 +1,169 @@
+#include "../include/NodeOrdering.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    // 寻找伪外围节点时最多做的广度优先遍历次数
+    const int MAX_PERIPHERAL_SWEEPS = 4;
+
+    /**
+     * @brief 从 start 出发广度优先遍历所在分量，返回最后一层中度数最小的节点
+     * @param level 各节点的层数，未访问为 -1；返回前恢复为 -1
+     * @param queue 遍历队列（复用缓冲区）
+     * @param depth 输出：最后一层的层数
+     */
+    int farthestNode(const Graph& graph, int start, std::vector<int>& level,
+                     std::vector<int>& queue, int& depth) {
+        const int* offsets = graph.getOffsets();
+        const int* targets = graph.getTargets();
+        queue.clear();
+        queue.push_back(start);
+        level[start] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = targets[e];
+                if (level[v] < 0) {
+                    level[v] = level[u] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+
+        depth = level[queue.back()];
+        int best = queue.back();
+        for (size_t i = queue.size(); i-- > 0 && level[queue[i]] == depth;) {
+            if (graph.getDegreeAt(queue[i]) < graph.getDegreeAt(best)) {
+                best = queue[i];
+            }
+        }
+        for (int v : queue) {
+            level[v] = -1;
+        }
+        return best;
+    }
+
+    /**
+     * @brief 伪外围节点（George–Liu）：反复跳到最远层，直到分量的层数不再增加
+     * 从外围出发的遍历层数多、每层窄，重排后相邻节点的下标差较小
+     */
+    int peripheralNode(const Graph& graph, int start, std::vector<int>& level,
+                       std::vector<int>& queue) {
+        int depth = 0;
+        int root = start;
+        int far = farthestNode(graph, root, level, queue, depth);
+        for (int sweep = 0; sweep < MAX_PERIPHERAL_SWEEPS; ++sweep) {
+            int farDepth = 0;
+            int next = farthestNode(graph, far, level, queue, farDepth);
+            root = far;
+            if (farDepth <= depth) {
+                break;
+            }
+            depth = farDepth;
+            far = next;
+        }
+        return root;
+    }
+}
+
+std::vector<int> NodeOrdering::computeOrder(const Graph& graph, NodeOrder order) {
+    const int n = static_cast<int>(graph.getNodeCount());
+    std::vector<int> result;
+    result.reserve(n);
+    if (order == NodeOrder::ORIGINAL) {
+        for (int i = 0; i < n; ++i) {
+            result.push_back(i);
+        }
+        return result;
+    }
+
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    std::vector<int> level(n, -1);
+    std::vector<int> queue;
+    std::vector<bool> visited(n, false);
+    std::vector<int> neighbors;
+    const bool byDegree = order == NodeOrder::RCM;
+
+    // 按下标顺序遇到未访问的节点时遍历它所在的分量，结果中各分量连续存放
+    for (int start = 0; start < n; ++start) {
+        if (visited[start]) {
+            continue;
+        }
+        int root = peripheralNode(graph, start, level, queue);
+        size_t head = result.size();
+        result.push_back(root);
+        visited[root] = true;
+        for (; head < result.size(); ++head) {
+            int u = result[head];
+            neighbors.clear();
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = targets[e];
+                if (!visited[v]) {
+                    visited[v] = true;
+                    neighbors.push_back(v);
+                }
+            }
+            if (byDegree) {
+                std::stable_sort(neighbors.begin(), neighbors.end(), [&graph](int a, int b) {
+                    return graph.getDegreeAt(a) < graph.getDegreeAt(b);
+                });
+            }
+            result.insert(result.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    if (byDegree) {
+        std::reverse(result.begin(), result.end());
+    }
+    return result;
+}
+
+bool NodeOrdering::apply(Graph& graph, NodeOrder order) {
+    if (!graph.isFinalized()) {
+        return false;
+    }
+    if (order == NodeOrder::ORIGINAL) {
+        return true;
+    }
+    return graph.reorder(computeOrder(graph, order));
+}
+
+double NodeOrdering::averageEdgeSpan(const Graph& graph) {
+    const int n = static_cast<int>(graph.getNodeCount());
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    if (n == 0 || offsets[n] == 0) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (int u = 0; u < n; ++u) {
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            total += std::abs(targets[e] - u);
+        }
+    }
+    return total / offsets[n];
+}
+
+const char* NodeOrdering::getName(NodeOrder order) {
+    switch (order) {
+        case NodeOrder::BFS:
+            return "bfs";
+        case NodeOrder::RCM:
+            return "rcm";
+        case NodeOrder::ORIGINAL:
+        default:
+            return "original";
+    }
+}
+
+bool NodeOrdering::parse(const std::string& name, NodeOrder& order) {
+    const NodeOrder all[] = {NodeOrder::ORIGINAL, NodeOrder::BFS, NodeOrder::RCM};
+    for (NodeOrder candidate : all) {
+        if (name == getName(candidate)) {
+            order = candidate;
+            return true;
+        }
+    }
+    return false;
+}
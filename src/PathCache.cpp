@@ -0,0 +1,138 @@
+#include "../include/PathCache.h"
+#include <algorithm>
+
+PathCache::PathCache(size_t capacity, size_t shardCount)
+    : capacity_(capacity), generation_(0) {
+    shardCount_ = std::max<size_t>(1, std::min(shardCount, capacity));
+    shardCapacity_ = (capacity + shardCount_ - 1) / shardCount_;
+    shards_.reset(new Shard[shardCount_]);
+    for (size_t i = 0; i < shardCount_; ++i) {
+        shards_[i].index.reserve(shardCapacity_);
+    }
+}
+
+PathCache::~PathCache() = default;
+
+size_t PathCache::KeyHash::operator()(const Key& key) const {
+    // splitmix64 的终结步骤，端点相近的键也能均匀分布
+    uint64_t x = (static_cast<uint64_t>(static_cast<uint32_t>(key.first)) << 32) ^
+                 static_cast<uint32_t>(key.second) ^
+                 (static_cast<uint64_t>(key.strategy) << 61);
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+}
+
+PathCache::Key PathCache::makeKey(int from, int to, PathStrategy strategy) {
+    Key key;
+    key.first = std::min(from, to);
+    key.second = std::max(from, to);
+    key.strategy = static_cast<int>(strategy);
+    return key;
+}
+
+PathCache::Shard& PathCache::shardOf(const Key& key) {
+    // 高位选分片，低位留给分片内的哈希表
+    return shards_[(KeyHash()(key) >> 40) % shardCount_];
+}
+
+bool PathCache::lookup(int from, int to, PathStrategy strategy, PathResult& result) {
+    if (capacity_ == 0) {
+        return false;
+    }
+    Key key = makeKey(from, to, strategy);
+    Shard& shard = shardOf(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            shard.misses++;
+            return false;
+        }
+        Entry& entry = shard.entries[it->second];
+        entry.referenced = true;
+        shard.hits++;
+        result = entry.result;
+    }
+    // 反方向的查询：在锁外反转路径
+    if (from != key.first) {
+        std::reverse(result.path.begin(), result.path.end());
+    }
+    return true;
+}
+
+void PathCache::insert(int from, int to, PathStrategy strategy, const PathResult& result,
+                       uint64_t generation) {
+    if (capacity_ == 0) {
+        return;
+    }
+    Key key = makeKey(from, to, strategy);
+    PathResult stored = result;
+    if (from != key.first) {
+        std::reverse(stored.path.begin(), stored.path.end());
+    }
+    
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // invalidate 先增加代数再逐个清空分片，在锁内检查代数即可保证旧结果不会留下
+    if (generation != generation_.load(std::memory_order_acquire)) {
+        return;
+    }
+    
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        Entry& entry = shard.entries[it->second];
+        entry.result = std::move(stored);
+        entry.referenced = true;
+        return;
+    }
+    
+    if (shard.entries.size() < shardCapacity_) {
+        shard.index.emplace(key, shard.entries.size());
+        shard.entries.push_back(Entry{key, std::move(stored), false});
+        return;
+    }
+    
+    // CLOCK：清除扫过条目的引用位，淘汰第一个引用位为 0 的条目
+    while (shard.entries[shard.hand].referenced) {
+        shard.entries[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1) % shard.entries.size();
+    }
+    Entry& victim = shard.entries[shard.hand];
+    shard.index.erase(victim.key);
+    shard.evictions++;
+    victim.key = key;
+    victim.result = std::move(stored);
+    victim.referenced = false;
+    shard.index.emplace(key, shard.hand);
+    shard.hand = (shard.hand + 1) % shard.entries.size();
+}
+
+void PathCache::invalidate() {
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.index.clear();
+        shard.hand = 0;
+    }
+}
+
+PathCacheStats PathCache::getStats() const {
+    PathCacheStats stats;
+    stats.capacity = capacity_;
+    stats.invalidations = generation_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.evictions += shard.evictions;
+        stats.size += shard.entries.size();
+    }
+    return stats;
+}
@@ -1,13 +1,16 @@
 #include "../include/PathFinder.h"
-#include <queue>
 #include <vector>
-#include <unordered_map>
-#include <limits>
 #include <algorithm>
 #include <chrono>
+#include <functional>
 
 PathFinder::PathFinder(const Graph& graph) 
-    : graph_(graph), strategy_(std::make_unique<ShortestDistanceStrategy>()) {
+    : graph_(graph), strategy_(std::make_unique<ShortestDistanceStrategy>()),
+      strategyType_(PathStrategy::SHORTEST_DISTANCE),
+      algorithm_(SearchAlgorithm::DIJKSTRA), queueType_(QueueType::DARY_HEAP),
+      landmarks_(nullptr), components_(nullptr) {
+    hierarchies_[0] = nullptr;
+    hierarchies_[1] = nullptr;
 }
 
 PathFinder::~PathFinder() = default;
@@ -18,145 +21,1267 @@ void PathFinder::setStrategy(std::unique_ptr<Strategy> strategy) {
     }
 }
 
-PathResult PathFinder::findPath(int from, int to) {
+void PathFinder::setStrategy(PathStrategy strategy) {
+    strategyType_ = strategy;
+    strategy_ = createStrategy(strategy);
+}
+
+void PathFinder::setAlgorithm(SearchAlgorithm algorithm) {
+    algorithm_ = algorithm;
+}
+
+SearchAlgorithm PathFinder::getAlgorithm() const {
+    return algorithm_;
+}
+
+void PathFinder::setQueueType(QueueType type) {
+    queueType_ = type;
+}
+
+QueueType PathFinder::getQueueType() const {
+    return queueType_;
+}
+
+void PathFinder::setLandmarks(const Landmarks* landmarks) {
+    landmarks_ = landmarks;
+}
+
+void PathFinder::setComponentIndex(const ComponentIndex* components) {
+    components_ = components;
+}
+
+void PathFinder::setContractionHierarchy(PathStrategy strategy,
+                                         const ContractionHierarchy* hierarchy) {
+    hierarchies_[static_cast<int>(strategy)] = hierarchy;
+}
+
+PathResult PathFinder::findPath(int from, int to) const {
+    return findPath(from, to, strategyType_, algorithm_);
+}
+
+PathResult PathFinder::findPath(int from, int to, PathStrategy strategy) const {
+    return findPath(from, to, strategy, algorithm_);
+}
+
+PathResult PathFinder::findPath(int from, int to, PathStrategy strategy,
+                                SearchAlgorithm algorithm) const {
+    return query(from, to, strategy, algorithm, PathMode::VECTOR, nullptr);
+}
+
+PathResult PathFinder::findPath(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm,
+                                PathArena& arena) const {
+    return query(from, to, strategy, algorithm, PathMode::ARENA, &arena);
+}
+
+PathResult PathFinder::findDistance(int from, int to, PathStrategy strategy,
+                                    SearchAlgorithm algorithm) const {
+    return query(from, to, strategy, algorithm, PathMode::DISTANCE_ONLY, nullptr);
+}
+
+PathResult PathFinder::query(int from, int to, PathStrategy strategy, SearchAlgorithm algorithm,
+                             PathMode mode, PathArena* arena) const {
     // 记录开始时间
-    auto start = std::chrono::high_resolution_clock::now();
+    auto start = std::chrono::steady_clock::now();
     
-    PathResult result = dijkstra(from, to);
+    PathResult result;
+    int source = Graph::INVALID_INDEX;
+    int target = Graph::INVALID_INDEX;
+    
+    if (prepareQuery(from, to, source, target, result, mode, arena)) {
+        switch (queueType_) {
+            case QueueType::DARY_HEAP:
+                result = search<QuaternaryHeap>(source, target, strategy, algorithm, mode, arena);
+                break;
+            case QueueType::RADIX_HEAP:
+                result = search<RadixHeap>(source, target, strategy, algorithm, mode, arena);
+                break;
+            case QueueType::BINARY_HEAP:
+            default:
+                result = search<BinaryHeap>(source, target, strategy, algorithm, mode, arena);
+                break;
+        }
+    }
     
     // 计算执行时间（微秒）
-    auto end = std::chrono::high_resolution_clock::now();
+    auto end = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     result.elapsedMicroseconds = duration.count();
     
     return result;
 }
 
-PathResult PathFinder::dijkstra(int from, int to) {
+PathResult PathFinder::findPath(int from, int to, const Strategy& strategy,
+                                SearchAlgorithm algorithm) const {
+    auto start = std::chrono::steady_clock::now();
+    
     PathResult result;
+    int source = Graph::INVALID_INDEX;
+    int target = Graph::INVALID_INDEX;
     
+    if (prepareQuery(from, to, source, target, result)) {
+        switch (queueType_) {
+            case QueueType::DARY_HEAP:
+                result = customSearch<QuaternaryHeap>(source, target, strategy, algorithm);
+                break;
+            case QueueType::RADIX_HEAP:
+                result = customSearch<RadixHeap>(source, target, strategy, algorithm);
+                break;
+            case QueueType::BINARY_HEAP:
+            default:
+                result = customSearch<BinaryHeap>(source, target, strategy, algorithm);
+                break;
+        }
+    }
+    
+    auto end = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    result.elapsedMicroseconds = duration.count();
+    
+    return result;
+}
+
+bool PathFinder::prepareQuery(int from, int to, int& source, int& target,
+                              PathResult& result, PathMode mode, PathArena* arena) const {
     // 验证节点是否存在
-    if (!graph_.hasNode(from) || !graph_.hasNode(to)) {
+    source = graph_.getIndex(from);
+    target = graph_.getIndex(to);
+    if (source == Graph::INVALID_INDEX || target == Graph::INVALID_INDEX) {
         result.found = false;
-        return result;
+        return false;
     }
     
     // 如果起点和终点相同
     if (from == to) {
-        result.path = {from};
+        if (mode != PathMode::DISTANCE_ONLY) {
+            *allocatePath(1, mode, arena, result) = from;
+        }
         result.totalWeight = 0.0;
         result.found = true;
-        return result;
+        return false;
     }
     
-    // 如果起点是孤立点
-    if (graph_.isIsolated(from)) {
+    // 如果起点或终点是孤立点
+    if (graph_.getDegreeAt(source) == 0 || graph_.getDegreeAt(target) == 0) {
         result.found = false;
-        return result;
+        return false;
     }
     
-    // 距离数组：nodeId -> 最短距离（动态添加节点）
-    std::unordered_map<int, double> dist;
-    // 父节点数组：用于重构路径
-    std::unordered_map<int, int> parent;
-    // 已访问标记
-    std::unordered_map<int, bool> visited;
+    // 如果起点和终点不在同一连通分量（不必搜索完起点所在的整个分量）
+    if (components_ && !components_->isConnectedAt(source, target)) {
+        result.found = false;
+        return false;
+    }
     
-    // 初始化起点距离为0
-    dist[from] = 0.0;
-    visited[from] = false;
+    return true;
+}
+
+template <typename Queue>
+PathResult PathFinder::search(int source, int target, PathStrategy strategy,
+                              SearchAlgorithm algorithm, PathMode mode, PathArena* arena) const {
+    ArrayCost weights(graph_.getWeights(strategy));
+    switch (algorithm) {
+        case SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA:
+            return bidirectionalDijkstra<Queue>(source, target, weights, mode, arena);
+        case SearchAlgorithm::ALT:
+            if (landmarks_ && landmarks_->hasTable(strategy)) {
+                return altSearch<Queue>(source, target, strategy, mode, arena);
+            }
+            return dijkstra<Queue>(source, target, weights, mode, arena);
+        case SearchAlgorithm::CONTRACTION_HIERARCHY: {
+            const ContractionHierarchy* hierarchy = hierarchies_[static_cast<int>(strategy)];
+            if (hierarchy && hierarchy->isBuilt()) {
+                return hierarchySearch(*hierarchy, source, target, mode, arena);
+            }
+            // 层次尚未构建或正在按新权重重新定制：使用地标表，没有时用双向搜索
+            if (landmarks_ && landmarks_->hasTable(strategy)) {
+                return altSearch<Queue>(source, target, strategy, mode, arena);
+            }
+            return bidirectionalDijkstra<Queue>(source, target, weights, mode, arena);
+        }
+        case SearchAlgorithm::DIJKSTRA:
+        default:
+            return dijkstra<Queue>(source, target, weights, mode, arena);
+    }
+}
+
+template <typename Queue>
+PathResult PathFinder::customSearch(int source, int target, const Strategy& strategy,
+                                    SearchAlgorithm algorithm) const {
+    double alpha = 0.0;
+    double beta = 0.0;
+    if (strategy.getLinearCoefficients(alpha, beta)) {
+        // 与内置策略相同的组合可以使用为其构建的地标表和收缩层次
+        if (alpha == 1.0 && beta == 0.0) {
+            return search<Queue>(source, target, PathStrategy::SHORTEST_DISTANCE, algorithm);
+        }
+        if (alpha == 0.0 && beta == 1.0) {
+            return search<Queue>(source, target, PathStrategy::LEAST_TIME, algorithm);
+        }
+        LinearCost cost(graph_.getDistances(), graph_.getTimes(), alpha, beta);
+        if (algorithm == SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA) {
+            return bidirectionalDijkstra<Queue>(source, target, cost);
+        }
+        return dijkstra<Queue>(source, target, cost);
+    }
     
-    // 最小堆（优先队列）：使用自定义比较函数
-    auto cmp = [](const HeapNode& a, const HeapNode& b) {
-        return a.distance > b.distance;  // 最小堆
-    };
-    std::priority_queue<HeapNode, std::vector<HeapNode>, decltype(cmp)> pq(cmp);
+    StrategyCost cost(&strategy, graph_.getDistances(), graph_.getTimes());
+    if (algorithm == SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA) {
+        return bidirectionalDijkstra<Queue>(source, target, cost);
+    }
+    return dijkstra<Queue>(source, target, cost);
+}
+
+template <typename Queue, typename Cost>
+PathResult PathFinder::dijkstra(int source, int target, const Cost& cost,
+                                PathMode mode, PathArena* arena) const {
+    PathResult result;
+    
+    // 线程私有工作区：距离、父节点、访问状态和堆缓冲区都在查询之间复用
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.beginSearch(graph_.getNodeCount());
+    Queue& queue = ws.getQueue<Queue>();
+    queue.reset(graph_.getNodeCount());
+    
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_PARENT);
+    queue.push(0.0, source);
     
-    pq.push(HeapNode(from, 0.0));
+    const int* offsets = graph_.getOffsets();
+    const int* targets = graph_.getTargets();
     
-    while (!pq.empty()) {
-        HeapNode current = pq.top();
-        pq.pop();
+    while (!queue.empty()) {
+        HeapEntry current = queue.pop();
         
-        int u = current.nodeId;
-        double d = current.distance;
+        int u = current.node;
+        double d = current.key;
         
-        // 如果已经访问过，跳过（处理重复节点）
-        if (visited[u]) {
+        // 如果已经确定过，跳过（惰性删除的队列中节点可能重复入队）
+        if (ws.isSettled(u)) {
+            SEARCH_STAT(result.stats.stalePops++);
             continue;
         }
         
-        visited[u] = true;
+        ws.markSettled(u);
+        SEARCH_STAT(result.stats.settledNodes++);
         
         // 如果到达目标节点
-        if (u == to) {
+        if (u == target) {
             break;
         }
         
-        // 遍历邻接边
-        const auto& edges = graph_.getAdjacentEdges(u);
-        for (const Edge& edge : edges) {
-            int v = edge.to;
-            double weight = edge.weight;
-            
-            // 如果节点v还没有被访问过，初始化其距离
-            if (dist.find(v) == dist.end()) {
-                dist[v] = std::numeric_limits<double>::max();
-                visited[v] = false;
+        // 遍历邻接边（CSR中连续存放）
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e];
+            if (ws.isSettled(v)) {
+                continue;
             }
+            SEARCH_STAT(result.stats.relaxedEdges++);
             
-            // 使用策略计算权重（这里权重已经在图中按策略计算好了）
-            // 但为了灵活性，我们仍然支持策略接口
-            double newDist = d + weight;
-            
-            if (!visited[v] && newDist < dist[v]) {
-                dist[v] = newDist;
-                parent[v] = u;
-                pq.push(HeapNode(v, newDist));
+            double newDist = d + cost(e);
+            if (newDist < ws.getDistance(v)) {
+                ws.setDistance(v, newDist, u);
+                queue.push(newDist, v);
+                SEARCH_STAT(result.stats.heapPushes++);
             }
         }
     }
+    result.peakQueueSize = queue.getPeakSize();
     
     // 检查是否找到路径
-    if (dist.find(to) == dist.end() || dist[to] == std::numeric_limits<double>::max()) {
+    if (!ws.isSettled(target)) {
         result.found = false;
         return result;
     }
     
     // 重构路径
-    result.path = reconstructPath(from, to, parent);
-    result.totalWeight = dist[to];
+    reconstructPath(source, target, ws, mode, arena, result);
+    result.totalWeight = ws.getDistance(target);
+    result.found = true;
+    
+    return result;
+}
+
+int* PathFinder::allocatePath(size_t length, PathMode mode, PathArena* arena,
+                              PathResult& result) const {
+    if (mode == PathMode::ARENA) {
+        int* data = arena->allocate(length);
+        result.span = PathSpan(data, length);
+        return data;
+    }
+    result.path.resize(length);
+    return result.path.data();
+}
+
+size_t PathFinder::pathLength(int from, int to, const SearchWorkspace& workspace) const {
+    size_t length = 1;
+    for (int current = to; current != from; current = workspace.getParent(current)) {
+        if (current == SearchWorkspace::NO_PARENT) {
+            return 0;
+        }
+        length++;
+    }
+    return length;
+}
+
+void PathFinder::writePath(int to, const SearchWorkspace& workspace, int* out, size_t length) const {
+    // 从终点回溯，从输出的末尾向前写（下标转换回外部节点ID），不需要反转
+    int current = to;
+    for (size_t i = length; i-- > 0; current = workspace.getParent(current)) {
+        out[i] = graph_.getNodeId(current);
+    }
+}
+
+void PathFinder::reconstructPath(int from, int to, const SearchWorkspace& workspace,
+                                 PathMode mode, PathArena* arena, PathResult& result) const {
+    if (mode == PathMode::DISTANCE_ONLY) {
+        return;
+    }
+    // 先测出长度，一次分配后按顺序写入
+    size_t length = pathLength(from, to, workspace);
+    if (length == 0) {
+        // 路径不完整，返回空路径
+        return;
+    }
+    writePath(to, workspace, allocatePath(length, mode, arena, result), length);
+}
+
+template <typename Queue, typename Cost>
+PathResult PathFinder::bidirectionalDijkstra(int source, int target, const Cost& cost,
+                                             PathMode mode, PathArena* arena) const {
+    PathResult result;
+    
+    // 两个方向各用一个线程私有工作区（无向图，反向搜索沿用同一邻接表）
+    SearchWorkspace& fwd = SearchWorkspace::forThread(SearchWorkspace::FORWARD);
+    SearchWorkspace& bwd = SearchWorkspace::forThread(SearchWorkspace::BACKWARD);
+    fwd.beginSearch(graph_.getNodeCount());
+    bwd.beginSearch(graph_.getNodeCount());
+    Queue& fwdQueue = fwd.getQueue<Queue>();
+    Queue& bwdQueue = bwd.getQueue<Queue>();
+    fwdQueue.reset(graph_.getNodeCount());
+    bwdQueue.reset(graph_.getNodeCount());
+    
+    fwd.setDistance(source, 0.0, SearchWorkspace::NO_PARENT);
+    fwdQueue.push(0.0, source);
+    bwd.setDistance(target, 0.0, SearchWorkspace::NO_PARENT);
+    bwdQueue.push(0.0, target);
+    
+    const int* offsets = graph_.getOffsets();
+    const int* targets = graph_.getTargets();
+    
+    // 当前已知的最短路径长度及两个方向的相遇点
+    double best = SearchWorkspace::INFINITE_DISTANCE;
+    int meeting = SearchWorkspace::NO_PARENT;
+    
+    while (!fwdQueue.empty() && !bwdQueue.empty()) {
+        // 停止条件：两侧堆顶之和不小于已知最短路径，则不可能再找到更短的路径
+        double fwdTop = fwdQueue.topKey();
+        double bwdTop = bwdQueue.topKey();
+        if (fwdTop + bwdTop >= best) {
+            break;
+        }
+        
+        // 交替扩展：每次扩展堆顶键值较小的一侧，使两个搜索区域大致平衡
+        bool forward = fwdTop <= bwdTop;
+        SearchWorkspace& self = forward ? fwd : bwd;
+        SearchWorkspace& other = forward ? bwd : fwd;
+        Queue& queue = forward ? fwdQueue : bwdQueue;
+        
+        HeapEntry current = queue.pop();
+        int u = current.node;
+        double d = current.key;
+        if (self.isSettled(u)) {
+            SEARCH_STAT(result.stats.stalePops++);
+            continue;
+        }
+        self.markSettled(u);
+        SEARCH_STAT(result.stats.settledNodes++);
+        
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e];
+            if (self.isSettled(v)) {
+                continue;
+            }
+            SEARCH_STAT(result.stats.relaxedEdges++);
+            
+            double newDist = d + cost(e);
+            if (newDist < self.getDistance(v)) {
+                self.setDistance(v, newDist, u);
+                queue.push(newDist, v);
+                SEARCH_STAT(result.stats.heapPushes++);
+            }
+            
+            // 经过边 (u, v) 连接两个方向的搜索，更新已知最短路径
+            if (other.isReached(v)) {
+                double candidate = self.getDistance(v) + other.getDistance(v);
+                if (candidate < best) {
+                    best = candidate;
+                    meeting = v;
+                }
+            }
+        }
+    }
+    
+    result.peakQueueSize = fwdQueue.getPeakSize() + bwdQueue.getPeakSize();
+    
+    if (meeting == SearchWorkspace::NO_PARENT) {
+        result.found = false;
+        return result;
+    }
+    
+    // 前半段：起点 -> 相遇点；后半段：沿反向搜索的父节点走到终点
+    if (mode != PathMode::DISTANCE_ONLY) {
+        size_t head = pathLength(source, meeting, fwd);
+        size_t tail = 0;
+        for (int node = bwd.getParent(meeting); node != SearchWorkspace::NO_PARENT;
+             node = bwd.getParent(node)) {
+            tail++;
+        }
+        int* out = allocatePath(head + tail, mode, arena, result);
+        writePath(meeting, fwd, out, head);
+        for (int node = bwd.getParent(meeting); node != SearchWorkspace::NO_PARENT;
+             node = bwd.getParent(node)) {
+            out[head++] = graph_.getNodeId(node);
+        }
+    }
+    result.totalWeight = best;
     result.found = true;
     
     return result;
 }
 
-std::vector<int> PathFinder::reconstructPath(int from, int to, 
-                                             const std::unordered_map<int, int>& parent) const {
-    std::vector<int> path;
+template <typename Queue>
+PathResult PathFinder::altSearch(int source, int target, PathStrategy strategy,
+                                 PathMode mode, PathArena* arena) const {
+    PathResult result;
     
-    if (from == to) {
-        path.push_back(from);
-        return path;
+    // 每次查询只使用对该起终点下界最大的几个地标
+    const int maxActive = 4;
+    int active[maxActive];
+    int activeCount = landmarks_->selectActive(strategy, source, target, maxActive, active);
+    const double* targetRow = landmarks_->getRow(strategy, target);
+    // 时间减小后缩放过的时间表（见 Landmarks::withTimeScale）
+    const double scale = landmarks_->getScale(strategy);
+    
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.beginSearch(graph_.getNodeCount());
+    Queue& queue = ws.getQueue<Queue>();
+    queue.reset(graph_.getNodeCount());
+    
+    // 堆的键值为 g(v) + h(v)，工作区中的距离为 g(v)；下界一致，键值出队顺序单调不减
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_PARENT);
+    queue.push(scale * Landmarks::lowerBound(targetRow, landmarks_->getRow(strategy, source),
+                                              active, activeCount), source);
+    
+    const int* offsets = graph_.getOffsets();
+    const int* targets = graph_.getTargets();
+    const double* weights = graph_.getWeights(strategy);
+    
+    while (!queue.empty()) {
+        int u = queue.pop().node;
+        if (ws.isSettled(u)) {
+            SEARCH_STAT(result.stats.stalePops++);
+            continue;
+        }
+        ws.markSettled(u);
+        SEARCH_STAT(result.stats.settledNodes++);
+        
+        if (u == target) {
+            break;
+        }
+        
+        double d = ws.getDistance(u);
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e];
+            if (ws.isSettled(v)) {
+                continue;
+            }
+            SEARCH_STAT(result.stats.relaxedEdges++);
+            
+            double newDist = d + weights[e];
+            if (newDist < ws.getDistance(v)) {
+                ws.setDistance(v, newDist, u);
+                double h = scale * Landmarks::lowerBound(targetRow, landmarks_->getRow(strategy, v),
+                                                         active, activeCount);
+                queue.push(newDist + h, v);
+                SEARCH_STAT(result.stats.heapPushes++);
+            }
+        }
     }
+    result.peakQueueSize = queue.getPeakSize();
     
-    // 从终点回溯到起点
-    int current = to;
-    while (current != from) {
-        path.push_back(current);
-        auto it = parent.find(current);
-        if (it == parent.end()) {
-            // 路径不完整，返回空路径
-            return std::vector<int>();
+    if (!ws.isSettled(target)) {
+        result.found = false;
+        return result;
+    }
+    
+    reconstructPath(source, target, ws, mode, arena, result);
+    result.totalWeight = ws.getDistance(target);
+    result.found = true;
+    
+    return result;
+}
+
+PathResult PathFinder::hierarchySearch(const ContractionHierarchy& hierarchy,
+                                       int source, int target,
+                                       PathMode mode, PathArena* arena) const {
+    PathResult result;
+    
+    // 展开捷径得到的下标路径放在线程私有缓冲区中，在查询之间复用
+    thread_local std::vector<int> indices;
+    double distance = hierarchy.query(source, target,
+                                      mode == PathMode::DISTANCE_ONLY ? nullptr : &indices,
+                                      &result.stats);
+    result.peakQueueSize =
+        SearchWorkspace::forThread(SearchWorkspace::FORWARD).getQueue<BinaryHeap>().getPeakSize() +
+        SearchWorkspace::forThread(SearchWorkspace::BACKWARD).getQueue<BinaryHeap>().getPeakSize();
+    if (distance == ContractionHierarchy::INFINITE_DISTANCE) {
+        result.found = false;
+        return result;
+    }
+    
+    if (mode != PathMode::DISTANCE_ONLY) {
+        int* out = allocatePath(indices.size(), mode, arena, result);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            out[i] = graph_.getNodeId(indices[i]);
         }
-        current = it->second;
     }
-    path.push_back(from);
+    result.totalWeight = distance;
+    result.found = true;
     
-    // 反转路径（从起点到终点）
-    std::reverse(path.begin(), path.end());
+    return result;
+}
+
+namespace {
+    /**
+     * @brief 终点搜索空间中的一项：节点、所属列、该节点到终点的距离
+     */
+    struct BucketEntry {
+        int node;
+        int column;
+        double distance;
+        
+        bool operator<(const BucketEntry& other) const {
+            return node < other.node;
+        }
+    };
     
-    return path;
+    // 有线程池时并行执行，否则在当前线程依次执行
+    void forEachIndex(ThreadPool* pool, size_t count, const std::function<void(size_t)>& body) {
+        if (pool) {
+            pool->parallelFor(count, body);
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                body(i);
+            }
+        }
+    }
+}
+
+DistanceMatrix PathFinder::distanceMatrix(const std::vector<int>& sources,
+                                          const std::vector<int>& targets,
+                                          PathStrategy strategy, bool distancesOnly,
+                                          ThreadPool* pool) const {
+    DistanceMatrix matrix;
+    matrix.rowCount = sources.size();
+    matrix.columnCount = targets.size();
+    matrix.weights.assign(matrix.rowCount * matrix.columnCount, DistanceMatrix::UNREACHABLE);
+    if (!distancesOnly) {
+        matrix.otherWeights.assign(matrix.weights.size(), DistanceMatrix::UNREACHABLE);
+    }
+    if (matrix.weights.empty()) {
+        return matrix;
+    }
+    
+    // 捷径只保存一种指标，需要另一指标时改用多目标 Dijkstra
+    const ContractionHierarchy* hierarchy = hierarchies_[static_cast<int>(strategy)];
+    if (distancesOnly && hierarchy && hierarchy->isBuilt()) {
+        hierarchyMatrix(*hierarchy, sources, targets, matrix, pool);
+        return matrix;
+    }
+    
+    switch (queueType_) {
+        case QueueType::DARY_HEAP:
+            multiTargetMatrix<QuaternaryHeap>(sources, targets, strategy, matrix, pool);
+            break;
+        case QueueType::RADIX_HEAP:
+            multiTargetMatrix<RadixHeap>(sources, targets, strategy, matrix, pool);
+            break;
+        case QueueType::BINARY_HEAP:
+        default:
+            multiTargetMatrix<BinaryHeap>(sources, targets, strategy, matrix, pool);
+            break;
+    }
+    return matrix;
+}
+
+void PathFinder::hierarchyMatrix(const ContractionHierarchy& hierarchy,
+                                 const std::vector<int>& sources,
+                                 const std::vector<int>& targets, DistanceMatrix& matrix,
+                                 ThreadPool* pool) const {
+    // 第一步：每个终点一次向上搜索，搜索空间记入桶（无向图，反向搜索与正向相同）
+    std::vector<std::vector<BucketEntry>> spaces(targets.size());
+    forEachIndex(pool, targets.size(), [&](size_t column) {
+        int index = graph_.getIndex(targets[column]);
+        if (index == Graph::INVALID_INDEX) {
+            return;
+        }
+        thread_local std::vector<HeapEntry> space;
+        hierarchy.upwardSearch(index, space);
+        spaces[column].reserve(space.size());
+        for (const HeapEntry& entry : space) {
+            spaces[column].push_back({entry.node, static_cast<int>(column), entry.key});
+        }
+    });
+    
+    // 按节点排序后连续存放，同一节点的桶可以二分查找
+    size_t total = 0;
+    for (const std::vector<BucketEntry>& space : spaces) {
+        total += space.size();
+    }
+    std::vector<BucketEntry> buckets;
+    buckets.reserve(total);
+    for (std::vector<BucketEntry>& space : spaces) {
+        buckets.insert(buckets.end(), space.begin(), space.end());
+        std::vector<BucketEntry>().swap(space);
+    }
+    std::sort(buckets.begin(), buckets.end());
+    
+    // 第二步：每个起点一次向上搜索，经过的每个节点与其桶中的终点距离相加取最小值
+    forEachIndex(pool, sources.size(), [&](size_t row) {
+        int index = graph_.getIndex(sources[row]);
+        if (index == Graph::INVALID_INDEX) {
+            return;
+        }
+        thread_local std::vector<HeapEntry> space;
+        hierarchy.upwardSearch(index, space);
+        double* rowWeights = matrix.weights.data() + row * matrix.columnCount;
+        for (const HeapEntry& entry : space) {
+            BucketEntry key = {entry.node, 0, 0.0};
+            auto range = std::equal_range(buckets.begin(), buckets.end(), key);
+            for (auto it = range.first; it != range.second; ++it) {
+                double distance = entry.key + it->distance;
+                if (distance < rowWeights[it->column]) {
+                    rowWeights[it->column] = distance;
+                }
+            }
+        }
+    });
+}
+
+template <typename Queue>
+void PathFinder::multiTargetMatrix(const std::vector<int>& sources,
+                                   const std::vector<int>& targets, PathStrategy strategy,
+                                   DistanceMatrix& matrix, ThreadPool* pool) const {
+    const size_t n = graph_.getNodeCount();
+    const double* weights = graph_.getWeights(strategy);
+    const double* otherWeights = graph_.getWeights(strategy == PathStrategy::SHORTEST_DISTANCE
+                                                       ? PathStrategy::LEAST_TIME
+                                                       : PathStrategy::SHORTEST_DISTANCE);
+    const bool withOther = !matrix.otherWeights.empty();
+    
+    // 终点按下标排序（同一节点可能出现在多列），搜索中确定一个节点时二分查找是否为终点
+    std::vector<std::pair<int, int>> targetColumns;
+    targetColumns.reserve(targets.size());
+    for (size_t column = 0; column < targets.size(); ++column) {
+        int index = graph_.getIndex(targets[column]);
+        if (index != Graph::INVALID_INDEX) {
+            targetColumns.emplace_back(index, static_cast<int>(column));
+        }
+    }
+    std::sort(targetColumns.begin(), targetColumns.end());
+    std::vector<int> distinctTargets;
+    for (size_t i = 0; i < targetColumns.size(); ++i) {
+        if (i == 0 || targetColumns[i].first != targetColumns[i - 1].first) {
+            distinctTargets.push_back(targetColumns[i].first);
+        }
+    }
+    if (distinctTargets.empty()) {
+        return;
+    }
+    
+    const int* offsets = graph_.getOffsets();
+    const int* adjacency = graph_.getTargets();
+    
+    forEachIndex(pool, sources.size(), [&](size_t row) {
+        int source = graph_.getIndex(sources[row]);
+        if (source == Graph::INVALID_INDEX) {
+            return;
+        }
+        double* rowWeights = matrix.weights.data() + row * matrix.columnCount;
+        double* rowOther = withOther ? matrix.otherWeights.data() + row * matrix.columnCount
+                                     : nullptr;
+        
+        SearchWorkspace& ws = SearchWorkspace::forThread();
+        ws.beginSearch(n);
+        Queue& queue = ws.getQueue<Queue>();
+        queue.reset(n);
+        // 沿最短路径树累计另一指标，只有被 setDistance 写过的节点才会被读取，无需清空
+        thread_local std::vector<double> otherDistance;
+        if (withOther && otherDistance.size() < n) {
+            otherDistance.resize(n);
+        }
+        
+        ws.setDistance(source, 0.0, SearchWorkspace::NO_PARENT);
+        if (withOther) {
+            otherDistance[source] = 0.0;
+        }
+        queue.push(0.0, source);
+        
+        // 只等待与起点连通的终点，其余终点保持不可达
+        size_t remaining = distinctTargets.size();
+        if (components_) {
+            remaining = 0;
+            for (int target : distinctTargets) {
+                if (components_->isConnectedAt(source, target)) {
+                    remaining++;
+                }
+            }
+        }
+        while (!queue.empty() && remaining > 0) {
+            int u = queue.pop().node;
+            if (ws.isSettled(u)) {
+                continue;
+            }
+            ws.markSettled(u);
+            double d = ws.getDistance(u);
+            
+            auto range = std::equal_range(targetColumns.begin(), targetColumns.end(),
+                                          std::make_pair(u, -1),
+                                          [](const std::pair<int, int>& a,
+                                             const std::pair<int, int>& b) {
+                                              return a.first < b.first;
+                                          });
+            if (range.first != range.second) {
+                for (auto it = range.first; it != range.second; ++it) {
+                    rowWeights[it->second] = d;
+                    if (withOther) {
+                        rowOther[it->second] = otherDistance[u];
+                    }
+                }
+                remaining--;
+            }
+            
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = adjacency[e];
+                if (ws.isSettled(v)) {
+                    continue;
+                }
+                double newDist = d + weights[e];
+                if (newDist < ws.getDistance(v)) {
+                    ws.setDistance(v, newDist, u);
+                    if (withOther) {
+                        otherDistance[v] = otherDistance[u] + otherWeights[e];
+                    }
+                    queue.push(newDist, v);
+                }
+            }
+        }
+    });
+}
+
+bool PathFinder::reachableWithin(int from, double budget, PathStrategy strategy,
+                                 std::vector<ReachableNode>& table) const {
+    table.clear();
+    return boundedSearch(from, budget, strategy,
+                         [&](int u, double cost, const SearchWorkspace& ws) {
+                             int parent = ws.getParent(u);
+                             table.emplace_back(graph_.getNodeId(u), cost,
+                                                graph_.getNodeId(parent == SearchWorkspace::NO_PARENT
+                                                                     ? u : parent));
+                         });
+}
+
+bool PathFinder::reachableWithin(int from, double budget, PathStrategy strategy,
+                                 std::vector<int>& nodes) const {
+    nodes.clear();
+    return boundedSearch(from, budget, strategy,
+                         [&](int u, double, const SearchWorkspace&) {
+                             nodes.push_back(graph_.getNodeId(u));
+                         });
+}
+
+bool PathFinder::shortestPathTree(int from, PathStrategy strategy, double delta,
+                                  ShortestPathTree& tree, ThreadPool* pool) const {
+    int source = graph_.getIndex(from);
+    if (source == Graph::INVALID_INDEX) {
+        return false;
+    }
+    return DeltaStepping::run(graph_, graph_.getWeights(strategy), source, delta, pool, tree);
+}
+
+template <typename Visit>
+bool PathFinder::boundedSearch(int from, double budget, PathStrategy strategy,
+                               Visit&& visit) const {
+    int source = graph_.getIndex(from);
+    if (source == Graph::INVALID_INDEX) {
+        return false;
+    }
+    if (!(budget >= 0.0)) {
+        return true;
+    }
+    
+    const double* weights = graph_.getWeights(strategy);
+    switch (queueType_) {
+        case QueueType::DARY_HEAP:
+            boundedDijkstra<QuaternaryHeap>(source, budget, weights, visit);
+            break;
+        case QueueType::RADIX_HEAP:
+            boundedDijkstra<RadixHeap>(source, budget, weights, visit);
+            break;
+        case QueueType::BINARY_HEAP:
+        default:
+            boundedDijkstra<BinaryHeap>(source, budget, weights, visit);
+            break;
+    }
+    return true;
+}
+
+template <typename Queue, typename Visit>
+void PathFinder::boundedDijkstra(int source, double budget, const double* weights,
+                                 Visit& visit) const {
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.beginSearch(graph_.getNodeCount());
+    Queue& queue = ws.getQueue<Queue>();
+    queue.reset(graph_.getNodeCount());
+    
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_PARENT);
+    queue.push(0.0, source);
+    
+    const int* offsets = graph_.getOffsets();
+    const int* targets = graph_.getTargets();
+    
+    while (!queue.empty()) {
+        int u = queue.pop().node;
+        if (ws.isSettled(u)) {
+            continue;
+        }
+        ws.markSettled(u);
+        double d = ws.getDistance(u);
+        visit(u, d, ws);
+        
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e];
+            if (ws.isSettled(v)) {
+                continue;
+            }
+            // 超出预算的节点不入队：队列只保存预算内的前沿，前沿全部超出预算时队列为空，搜索结束
+            double newDist = d + weights[e];
+            if (newDist <= budget && newDist < ws.getDistance(v)) {
+                ws.setDistance(v, newDist, u);
+                queue.push(newDist, v);
+            }
+        }
+    }
+}
+
+namespace {
+    /**
+     * @brief 双目标搜索的标签：到达某节点的一条部分路线
+     */
+    struct ParetoLabel {
+        double distance;
+        double time;
+        int node;
+        int parent;     // 前驱标签在标签池中的下标，起点的标签为 -1
+    };
+    
+    /**
+     * @brief 标签队列项，按 (距离, 时间) 字典序构成最小堆
+     */
+    struct LabelEntry {
+        double distance;
+        double time;
+        int label;
+        
+        bool operator<(const LabelEntry& other) const {
+            return distance > other.distance ||
+                   (distance == other.distance && time > other.time);
+        }
+    };
+    
+    /**
+     * @brief 线程私有的标签池，查询之间保留容量
+     */
+    struct ParetoPool {
+        std::vector<ParetoLabel> labels;
+        std::vector<LabelEntry> heap;
+        std::vector<int> targetLabels;  // 终点上确定的标签，按出队顺序
+    };
+}
+
+ParetoResult PathFinder::findParetoPaths(int from, int to, size_t maxLabels) const {
+    auto start = std::chrono::steady_clock::now();
+    
+    ParetoResult result;
+    PathResult check;
+    int source = Graph::INVALID_INDEX;
+    int target = Graph::INVALID_INDEX;
+    
+    if (!prepareQuery(from, to, source, target, check)) {
+        // 起点和终点相同时前沿只有一条零长度路线
+        if (check.found) {
+            ParetoRoute route;
+            route.path = check.path;
+            result.routes.push_back(route);
+        }
+    } else {
+        static thread_local ParetoPool pool;
+        std::vector<ParetoLabel>& labels = pool.labels;
+        std::vector<LabelEntry>& heap = pool.heap;
+        labels.clear();
+        heap.clear();
+        pool.targetLabels.clear();
+        
+        // 工作区的距离槽保存每个节点上已确定标签的最小时间
+        SearchWorkspace& ws = SearchWorkspace::forThread(SearchWorkspace::FORWARD);
+        ws.beginSearch(graph_.getNodeCount());
+        
+        const int* offsets = graph_.getOffsets();
+        const int* targets = graph_.getTargets();
+        const double* distances = graph_.getDistances();
+        const double* times = graph_.getTimes();
+        
+        labels.push_back({0.0, 0.0, source, -1});
+        heap.push_back({0.0, 0.0, 0});
+        
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end());
+            LabelEntry entry = heap.back();
+            heap.pop_back();
+            int u = labels[entry.label].node;
+            
+            // 距离不小于已确定的标签，时间也不更短即被支配；终点已有更快的路线同样剪掉
+            double targetTime = ws.getDistance(target);
+            if (entry.time >= ws.getDistance(u) || entry.time >= targetTime) {
+                continue;
+            }
+            ws.setDistance(u, entry.time, SearchWorkspace::NO_PARENT);
+            if (u == target) {
+                pool.targetLabels.push_back(entry.label);
+                continue;
+            }
+            
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = targets[e];
+                double newTime = entry.time + times[e];
+                if (newTime >= ws.getDistance(v) || newTime >= targetTime) {
+                    continue;
+                }
+                if (labels.size() >= maxLabels) {
+                    result.complete = false;
+                    continue;
+                }
+                double newDistance = entry.distance + distances[e];
+                labels.push_back({newDistance, newTime, v, entry.label});
+                heap.push_back({newDistance, newTime, static_cast<int>(labels.size() - 1)});
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        
+        result.labelCount = labels.size();
+        result.routes.resize(pool.targetLabels.size());
+        for (size_t i = 0; i < pool.targetLabels.size(); ++i) {
+            ParetoRoute& route = result.routes[i];
+            const ParetoLabel& last = labels[pool.targetLabels[i]];
+            route.distance = last.distance;
+            route.time = last.time;
+            for (int label = pool.targetLabels[i]; label != -1; label = labels[label].parent) {
+                route.path.push_back(graph_.getNodeId(labels[label].node));
+            }
+            std::reverse(route.path.begin(), route.path.end());
+        }
+    }
+    
+    auto end = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    result.elapsedMicroseconds = duration.count();
+    
+    return result;
+}
+
+namespace {
+    /**
+     * @brief 偏离搜索的屏蔽集合：按时间戳标记节点和弧，开始新的集合只需递增时间戳
+     */
+    class SearchMask {
+    public:
+        SearchMask() : stamp_(0) {}
+        
+        void begin(size_t nodeCount, size_t arcCount) {
+            if (nodes_.size() < nodeCount) {
+                nodes_.resize(nodeCount, 0);
+            }
+            if (arcs_.size() < arcCount) {
+                arcs_.resize(arcCount, 0);
+            }
+            if (++stamp_ == 0) {
+                std::fill(nodes_.begin(), nodes_.end(), 0);
+                std::fill(arcs_.begin(), arcs_.end(), 0);
+                stamp_ = 1;
+            }
+        }
+        
+        void blockNode(int node) { nodes_[node] = stamp_; }
+        void blockArc(int arc) { arcs_[arc] = stamp_; }
+        bool isNodeBlocked(int node) const { return nodes_[node] == stamp_; }
+        bool isArcBlocked(int arc) const { return arcs_[arc] == stamp_; }
+        
+    private:
+        std::vector<uint32_t> nodes_;
+        std::vector<uint32_t> arcs_;
+        uint32_t stamp_;
+    };
+    
+    /**
+     * @brief Yen 算法中的一条路径（稠密下标）
+     */
+    struct RoutePath {
+        std::vector<int> nodes;
+        std::vector<double> prefixCosts;    // prefixCosts[i] 为起点到 nodes[i] 的代价
+        size_t deviation;                   // 与上一条路径分叉的位置，之前的偏离点无需再搜索
+        
+        RoutePath() : deviation(0) {}
+        double cost() const { return prefixCosts.back(); }
+    };
+}
+
+std::vector<PathResult> PathFinder::findKShortestPaths(int from, int to, int k,
+                                                       PathStrategy strategy) const {
+    auto start = std::chrono::steady_clock::now();
+    
+    std::vector<PathResult> results;
+    if (k <= 0) {
+        return results;
+    }
+    
+    PathResult trivial;
+    int source = Graph::INVALID_INDEX;
+    int target = Graph::INVALID_INDEX;
+    if (!prepareQuery(from, to, source, target, trivial)) {
+        // 起点和终点相同时只有一条零长度路径
+        if (trivial.found) {
+            results.push_back(trivial);
+        }
+        return results;
+    }
+    
+    const double* weights = graph_.getWeights(strategy);
+    switch (queueType_) {
+        case QueueType::DARY_HEAP:
+            kShortestPaths<QuaternaryHeap>(source, target, k, weights, results, start);
+            break;
+        case QueueType::RADIX_HEAP:
+            kShortestPaths<RadixHeap>(source, target, k, weights, results, start);
+            break;
+        case QueueType::BINARY_HEAP:
+        default:
+            kShortestPaths<BinaryHeap>(source, target, k, weights, results, start);
+            break;
+    }
+    return results;
+}
+
+template <typename Queue>
+void PathFinder::kShortestPaths(int source, int target, int k, const double* weights,
+                                std::vector<PathResult>& results,
+                                std::chrono::steady_clock::time_point start) const {
+    const size_t n = graph_.getNodeCount();
+    const int* offsets = graph_.getOffsets();
+    const int* targets = graph_.getTargets();
+    
+    // 反向最短路径树：父节点为朝终点的下一跳，距离为到终点的最短距离（无向图，从终点搜索即可）。
+    // 起点确定后即停止，树外节点到终点的距离不小于起点的距离 radius
+    SearchWorkspace& tree = SearchWorkspace::forThread(SearchWorkspace::BACKWARD);
+    tree.beginSearch(n);
+    Queue& treeQueue = tree.getQueue<Queue>();
+    treeQueue.reset(n);
+    tree.setDistance(target, 0.0, SearchWorkspace::NO_PARENT);
+    treeQueue.push(0.0, target);
+    while (!treeQueue.empty()) {
+        int u = treeQueue.pop().node;
+        if (tree.isSettled(u)) {
+            continue;
+        }
+        tree.markSettled(u);
+        if (u == source) {
+            break;
+        }
+        double d = tree.getDistance(u);
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e];
+            double newDist = d + weights[e];
+            if (!tree.isSettled(v) && newDist < tree.getDistance(v)) {
+                tree.setDistance(v, newDist, u);
+                treeQueue.push(newDist, v);
+            }
+        }
+    }
+    if (!tree.isSettled(source)) {
+        return;
+    }
+    size_t peakQueueSize = treeQueue.getPeakSize();
+    const double radius = tree.getDistance(source);
+    auto lowerBound = [&](int v) {
+        return tree.isSettled(v) ? tree.getDistance(v) : radius;
+    };
+    
+    // 路径的前缀代价按相邻节点之间最轻的弧计算
+    auto finishPath = [&](RoutePath& path) {
+        path.prefixCosts.resize(path.nodes.size());
+        path.prefixCosts[0] = 0.0;
+        for (size_t i = 1; i < path.nodes.size(); ++i) {
+            int u = path.nodes[i - 1];
+            double best = SearchWorkspace::INFINITE_DISTANCE;
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                if (targets[e] == path.nodes[i] && weights[e] < best) {
+                    best = weights[e];
+                }
+            }
+            path.prefixCosts[i] = path.prefixCosts[i - 1] + best;
+        }
+    };
+    auto emit = [&](const RoutePath& path) {
+        PathResult result;
+        result.path.reserve(path.nodes.size());
+        for (int index : path.nodes) {
+            result.path.push_back(graph_.getNodeId(index));
+        }
+        result.totalWeight = path.cost();
+        result.found = true;
+        result.peakQueueSize = peakQueueSize;
+        auto now = std::chrono::steady_clock::now();
+        result.elapsedMicroseconds =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+        results.push_back(std::move(result));
+    };
+    
+    std::vector<RoutePath> accepted;
+    std::vector<RoutePath> candidates;
+    accepted.reserve(static_cast<size_t>(std::min(k, 64)));
+    
+    RoutePath first;
+    for (int v = source; v != SearchWorkspace::NO_PARENT; v = tree.getParent(v)) {
+        first.nodes.push_back(v);
+    }
+    finishPath(first);
+    accepted.push_back(std::move(first));
+    emit(accepted.back());
+    
+    static thread_local SearchMask mask;
+    SearchWorkspace& ws = SearchWorkspace::forThread(SearchWorkspace::FORWARD);
+    Queue& queue = ws.getQueue<Queue>();
+    
+    while (accepted.size() < static_cast<size_t>(k)) {
+        const size_t previousIndex = accepted.size() - 1;
+        for (size_t j = accepted[previousIndex].deviation;
+             j + 1 < accepted[previousIndex].nodes.size(); ++j) {
+            const std::vector<int>& previous = accepted[previousIndex].nodes;
+            int spur = previous[j];
+            
+            // 屏蔽根路径上偏离点之前的节点，以及共享该根路径的已选路径在偏离点的下一条弧
+            mask.begin(n, static_cast<size_t>(offsets[n]));
+            for (size_t i = 0; i < j; ++i) {
+                mask.blockNode(previous[i]);
+            }
+            for (const RoutePath& path : accepted) {
+                if (path.nodes.size() > j + 1 &&
+                    std::equal(previous.begin(), previous.begin() + j + 1, path.nodes.begin())) {
+                    for (int e = offsets[spur]; e < offsets[spur + 1]; ++e) {
+                        if (targets[e] == path.nodes[j + 1]) {
+                            mask.blockArc(e);
+                        }
+                    }
+                }
+            }
+            
+            RoutePath candidate;
+            // 根路径：偏离点之前的节点（j == 0 时为空）
+            candidate.nodes.reserve(previous.size());
+            candidate.nodes.insert(candidate.nodes.end(), previous.begin(), previous.begin() + j);
+            candidate.deviation = j;
+            
+            // 偏离点沿最短路径树到终点的路径未被屏蔽时就是偏离路径，不必搜索
+            int next = tree.getParent(spur);
+            bool treeUsable = tree.isSettled(spur);
+            for (int e = offsets[spur]; e < offsets[spur + 1] && treeUsable; ++e) {
+                treeUsable = !(targets[e] == next && mask.isArcBlocked(e));
+            }
+            for (int v = next; v != SearchWorkspace::NO_PARENT && treeUsable; v = tree.getParent(v)) {
+                treeUsable = !mask.isNodeBlocked(v);
+            }
+            
+            if (treeUsable) {
+                for (int v = spur; v != SearchWorkspace::NO_PARENT; v = tree.getParent(v)) {
+                    candidate.nodes.push_back(v);
+                }
+            } else {
+                // A* 偏离搜索：树上的距离是未屏蔽图中到终点的精确距离，屏蔽只会使距离变长；
+                // 树外节点取 radius。两者合起来是一致的下界
+                ws.beginSearch(n);
+                queue.reset(n);
+                ws.setDistance(spur, 0.0, SearchWorkspace::NO_PARENT);
+                queue.push(lowerBound(spur), spur);
+                while (!queue.empty()) {
+                    int u = queue.pop().node;
+                    if (ws.isSettled(u)) {
+                        continue;
+                    }
+                    ws.markSettled(u);
+                    if (u == target) {
+                        break;
+                    }
+                    double d = ws.getDistance(u);
+                    for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                        int v = targets[e];
+                        if (ws.isSettled(v) || mask.isNodeBlocked(v) || mask.isArcBlocked(e)) {
+                            continue;
+                        }
+                        double newDist = d + weights[e];
+                        if (newDist < ws.getDistance(v)) {
+                            ws.setDistance(v, newDist, u);
+                            queue.push(newDist + lowerBound(v), v);
+                        }
+                    }
+                }
+                peakQueueSize = std::max(peakQueueSize, queue.getPeakSize());
+                if (!ws.isSettled(target)) {
+                    continue;
+                }
+                size_t rootLength = candidate.nodes.size();
+                for (int v = target; v != SearchWorkspace::NO_PARENT; v = ws.getParent(v)) {
+                    candidate.nodes.push_back(v);
+                }
+                std::reverse(candidate.nodes.begin() + rootLength, candidate.nodes.end());
+            }
+            
+            bool duplicate = false;
+            for (const RoutePath& other : candidates) {
+                if (other.nodes == candidate.nodes) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (!duplicate) {
+                finishPath(candidate);
+                candidates.push_back(std::move(candidate));
+            }
+        }
+        
+        if (candidates.empty()) {
+            break;
+        }
+        size_t best = 0;
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            if (candidates[i].cost() < candidates[best].cost()) {
+                best = i;
+            }
+        }
+        accepted.push_back(std::move(candidates[best]));
+        if (best + 1 != candidates.size()) {
+            candidates[best] = std::move(candidates.back());
+        }
+        candidates.pop_back();
+        emit(accepted.back());
+    }
 }
 
 const char* PathFinder::getCurrentStrategyName() const {
@@ -0,0 +1,165 @@
+#include "../include/QueryMetrics.h"
+#include <sstream>
+#include <limits>
+
+namespace {
+    // 取值所在的桶：0 在第 0 个桶，v >= 1 在上界为不小于 v 的最小 2 的幂的桶
+    int bucketOf(uint64_t value) {
+        if (value <= 1) {
+            return static_cast<int>(value);
+        }
+        uint64_t rest = value - 1;
+#if defined(__GNUC__) || defined(__clang__)
+        int bits = 64 - __builtin_clzll(rest);
+#else
+        int bits = 0;
+        while (rest != 0) {
+            rest >>= 1;
+            bits++;
+        }
+#endif
+        return bits + 1 < QueryMetrics::BUCKET_COUNT - 1 ? bits + 1 : QueryMetrics::BUCKET_COUNT - 1;
+    }
+
+    double upperBoundOf(int bucket) {
+        if (bucket == QueryMetrics::BUCKET_COUNT - 1) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return bucket == 0 ? 0.0 : static_cast<double>(uint64_t(1) << (bucket - 1));
+    }
+
+    void writeCounter(std::ostringstream& out, const std::string& name, const char* help,
+                      uint64_t value) {
+        out << "# HELP " << name << " " << help << "\n"
+            << "# TYPE " << name << " counter\n"
+            << name << " " << value << "\n";
+    }
+
+    void writeHistogram(std::ostringstream& out, const std::string& name, const char* help,
+                        const HistogramSnapshot& histogram) {
+        out << "# HELP " << name << " " << help << "\n"
+            << "# TYPE " << name << " histogram\n";
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < histogram.counts.size(); ++i) {
+            cumulative += histogram.counts[i];
+            out << name << "_bucket{le=\"";
+            if (i + 1 == histogram.counts.size()) {
+                out << "+Inf";
+            } else {
+                out << static_cast<uint64_t>(histogram.upperBounds[i]);
+            }
+            out << "\"} " << cumulative << "\n";
+        }
+        out << name << "_sum " << histogram.sum << "\n"
+            << name << "_count " << histogram.count << "\n";
+    }
+}
+
+double HistogramSnapshot::percentile(double p) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    // 最近秩：第 ceil(p * count) 个样本所在的桶
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count) + 0.999999);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        cumulative += counts[i];
+        if (cumulative >= rank) {
+            return upperBounds[i];
+        }
+    }
+    return upperBounds.back();
+}
+
+QueryMetrics::Histogram::Histogram() {
+    reset();
+}
+
+void QueryMetrics::Histogram::record(uint64_t value) {
+    buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+HistogramSnapshot QueryMetrics::Histogram::snapshot() const {
+    HistogramSnapshot result;
+    result.counts.resize(BUCKET_COUNT);
+    result.upperBounds.resize(BUCKET_COUNT);
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        result.counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        result.upperBounds[i] = upperBoundOf(i);
+        result.count += result.counts[i];
+    }
+    result.sum = sum_.load(std::memory_order_relaxed);
+    return result;
+}
+
+void QueryMetrics::Histogram::reset() {
+    for (std::atomic<uint64_t>& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+}
+
+QueryMetrics::QueryMetrics() {
+    reset();
+}
+
+void QueryMetrics::record(const PathResult& result) {
+    queries_.fetch_add(1, std::memory_order_relaxed);
+    if (result.found) {
+        foundQueries_.fetch_add(1, std::memory_order_relaxed);
+    }
+    settledNodes_.fetch_add(result.stats.settledNodes, std::memory_order_relaxed);
+    relaxedEdges_.fetch_add(result.stats.relaxedEdges, std::memory_order_relaxed);
+    heapPushes_.fetch_add(result.stats.heapPushes, std::memory_order_relaxed);
+    stalePops_.fetch_add(result.stats.stalePops, std::memory_order_relaxed);
+    latency_.record(result.elapsedMicroseconds > 0 ?
+                    static_cast<uint64_t>(result.elapsedMicroseconds) : 0);
+    settled_.record(result.stats.settledNodes);
+}
+
+MetricsSnapshot QueryMetrics::snapshot() const {
+    MetricsSnapshot result;
+    result.queries = queries_.load(std::memory_order_relaxed);
+    result.foundQueries = foundQueries_.load(std::memory_order_relaxed);
+    result.totals.settledNodes = settledNodes_.load(std::memory_order_relaxed);
+    result.totals.relaxedEdges = relaxedEdges_.load(std::memory_order_relaxed);
+    result.totals.heapPushes = heapPushes_.load(std::memory_order_relaxed);
+    result.totals.stalePops = stalePops_.load(std::memory_order_relaxed);
+    result.latency = latency_.snapshot();
+    result.settledNodes = settled_.snapshot();
+    return result;
+}
+
+void QueryMetrics::reset() {
+    queries_.store(0, std::memory_order_relaxed);
+    foundQueries_.store(0, std::memory_order_relaxed);
+    settledNodes_.store(0, std::memory_order_relaxed);
+    relaxedEdges_.store(0, std::memory_order_relaxed);
+    heapPushes_.store(0, std::memory_order_relaxed);
+    stalePops_.store(0, std::memory_order_relaxed);
+    latency_.reset();
+    settled_.reset();
+}
+
+std::string QueryMetrics::toPrometheus(const MetricsSnapshot& snapshot, const std::string& prefix) {
+    std::ostringstream out;
+    writeCounter(out, prefix + "_queries_total", "路径查询数（含缓存命中）", snapshot.queries);
+    writeCounter(out, prefix + "_queries_found_total", "找到路径的查询数", snapshot.foundQueries);
+    writeCounter(out, prefix + "_settled_nodes_total", "搜索确定的节点数",
+                 snapshot.totals.settledNodes);
+    writeCounter(out, prefix + "_relaxed_edges_total", "搜索检查的边数",
+                 snapshot.totals.relaxedEdges);
+    writeCounter(out, prefix + "_heap_pushes_total", "优先队列入队次数",
+                 snapshot.totals.heapPushes);
+    writeCounter(out, prefix + "_stale_pops_total", "出队时被跳过的过期项数",
+                 snapshot.totals.stalePops);
+    writeHistogram(out, prefix + "_query_latency_microseconds", "查询延迟（微秒）",
+                   snapshot.latency);
+    writeHistogram(out, prefix + "_query_settled_nodes", "每次查询确定的节点数",
+                   snapshot.settledNodes);
+    return out.str();
+}
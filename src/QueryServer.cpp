@@ -0,0 +1,345 @@
+#include "../include/QueryServer.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <charconv>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // 每次从输入读取的最大字节数
+    const size_t READ_CHUNK_SIZE = 1 << 16;
+    // 在流水线中轮转的批次数（读取、搜索、输出各一批）
+    const size_t PIPELINE_DEPTH = 3;
+    // 最多报告的格式错误行数，之后只计数
+    const uint64_t MAX_REPORTED_ERRORS = 10;
+    // 文本格式中一个整数或浮点数的最大字符数（含分隔符）
+    const size_t MAX_FIELD_CHARS = 32;
+
+    /**
+     * @brief 流水线中轮转的一批查询及其结果和输出缓冲区（容量在批次之间复用）
+     */
+    struct Batch {
+        std::vector<PathQuery> queries;
+        PathBatch results;
+        std::string output;
+        bool last;
+
+        Batch() : last(false) {}
+    };
+
+    /**
+     * @brief 阶段之间传递批次的阻塞队列（批次总数固定，队列长度自然有界）
+     */
+    class Channel {
+    public:
+        void push(Batch* batch) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                items_.push_back(batch);
+            }
+            condition_.notify_one();
+        }
+
+        Batch* pop() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return !items_.empty(); });
+            Batch* batch = items_.front();
+            items_.pop_front();
+            return batch;
+        }
+
+    private:
+        std::deque<Batch*> items_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+    };
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    /**
+     * @brief 解析一行查询 "from to [distance|time]"
+     * @param blank 输出：是否为空行或注释行
+     * @return 是否为有效查询
+     */
+    bool parseLine(const char* begin, const char* end, PathStrategy defaultStrategy,
+                   PathQuery& query, bool& blank) {
+        const char* p = begin;
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        blank = p == end || *p == '#';
+        if (blank) {
+            return false;
+        }
+
+        std::from_chars_result parsed = std::from_chars(p, end, query.from);
+        if (parsed.ec != std::errc() || parsed.ptr == end || !isSpace(*parsed.ptr)) {
+            return false;
+        }
+        p = parsed.ptr;
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        parsed = std::from_chars(p, end, query.to);
+        if (parsed.ec != std::errc()) {
+            return false;
+        }
+        p = parsed.ptr;
+        if (p < end && !isSpace(*p)) {
+            return false;
+        }
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+
+        query.strategy = defaultStrategy;
+        if (p < end) {
+            const char* word = p;
+            while (p < end && !isSpace(*p)) {
+                ++p;
+            }
+            size_t length = static_cast<size_t>(p - word);
+            if (length == 8 && std::memcmp(word, "distance", 8) == 0) {
+                query.strategy = PathStrategy::SHORTEST_DISTANCE;
+            } else if (length == 4 && std::memcmp(word, "time", 4) == 0) {
+                query.strategy = PathStrategy::LEAST_TIME;
+            } else {
+                return false;
+            }
+            while (p < end && isSpace(*p)) {
+                ++p;
+            }
+        }
+        return p == end;
+    }
+
+    template <typename T>
+    char* writeValue(char* p, T value) {
+        return std::to_chars(p, p + MAX_FIELD_CHARS, value).ptr;
+    }
+
+    /**
+     * @brief 把一批结果按文本格式追加到 output
+     */
+    void formatText(const Batch& batch, bool distancesOnly, std::string& output) {
+        for (size_t i = 0; i < batch.queries.size(); ++i) {
+            const PathQuery& query = batch.queries[i];
+            const PathResult& result = batch.results[i];
+            size_t nodes = distancesOnly || !result.found ? 0 : result.span.size;
+            size_t offset = output.size();
+            output.resize(offset + (nodes + 4) * MAX_FIELD_CHARS);
+            char* p = &output[offset];
+            p = writeValue(p, query.from);
+            *p++ = ' ';
+            p = writeValue(p, query.to);
+            *p++ = ' ';
+            p = result.found ? writeValue(p, result.totalWeight) : writeValue(p, -1);
+            for (size_t j = 0; j < nodes; ++j) {
+                *p++ = ' ';
+                p = writeValue(p, result.span[j]);
+            }
+            *p++ = '\n';
+            output.resize(static_cast<size_t>(p - output.data()));
+        }
+    }
+
+    template <typename T>
+    char* writeRaw(char* p, T value) {
+        std::memcpy(p, &value, sizeof(T));
+        return p + sizeof(T);
+    }
+
+    /**
+     * @brief 把一批结果按二进制格式追加到 output
+     */
+    void formatBinary(const Batch& batch, bool distancesOnly, std::string& output) {
+        const size_t headerSize = 2 * sizeof(int32_t) + sizeof(uint8_t) + sizeof(double) +
+                                  sizeof(uint32_t);
+        for (size_t i = 0; i < batch.queries.size(); ++i) {
+            const PathQuery& query = batch.queries[i];
+            const PathResult& result = batch.results[i];
+            size_t nodes = distancesOnly || !result.found ? 0 : result.span.size;
+            size_t offset = output.size();
+            output.resize(offset + headerSize + nodes * sizeof(int32_t));
+            char* p = &output[offset];
+            p = writeRaw(p, static_cast<int32_t>(query.from));
+            p = writeRaw(p, static_cast<int32_t>(query.to));
+            p = writeRaw(p, static_cast<uint8_t>(result.found ? 1 : 0));
+            p = writeRaw(p, result.found ? result.totalWeight : -1.0);
+            p = writeRaw(p, static_cast<uint32_t>(nodes));
+            if (nodes > 0) {
+                std::memcpy(p, result.span.data, nodes * sizeof(int32_t));
+            }
+        }
+    }
+}
+
+QueryServer::QueryServer(const MapEngine& engine)
+    : engine_(engine),
+      format_(ServerFormat::TEXT),
+      batchSize_(DEFAULT_BATCH_SIZE),
+      distancesOnly_(false),
+      defaultStrategy_(PathStrategy::SHORTEST_DISTANCE) {
+}
+
+bool QueryServer::parseFormat(const std::string& name, ServerFormat& format) {
+    if (name == "text") {
+        format = ServerFormat::TEXT;
+        return true;
+    }
+    if (name == "binary") {
+        format = ServerFormat::BINARY;
+        return true;
+    }
+    return false;
+}
+
+ServerStats QueryServer::run(std::istream& in, std::ostream& out) const {
+    auto start = std::chrono::steady_clock::now();
+    ServerStats stats;
+
+    Batch batches[PIPELINE_DEPTH];
+    Channel freeBatches;
+    Channel toSearch;
+    Channel toWrite;
+    for (Batch& batch : batches) {
+        freeBatches.push(&batch);
+    }
+    std::atomic<bool> outputFailed(false);
+
+    // 读取阶段：输入暂时没有更多数据或批次已满时提交当前批次
+    std::thread reader([&]() {
+        std::streambuf* buffer = in.rdbuf();
+        std::vector<char> chunk(READ_CHUNK_SIZE);
+        std::string pending;    // 跨越两次读取的半行
+        uint64_t lineNumber = 0;
+        Batch* batch = freeBatches.pop();
+        batch->queries.clear();
+
+        auto submit = [&]() {
+            toSearch.push(batch);
+            batch = freeBatches.pop();
+            batch->queries.clear();
+        };
+        auto handleLine = [&](const char* begin, const char* end) {
+            lineNumber++;
+            PathQuery query;
+            bool blank = false;
+            if (parseLine(begin, end, defaultStrategy_, query, blank)) {
+                batch->queries.push_back(query);
+                if (batch->queries.size() >= batchSize_) {
+                    submit();
+                }
+            } else if (!blank) {
+                if (stats.errors++ < MAX_REPORTED_ERRORS) {
+                    std::cerr << "错误：第 " << lineNumber << " 行不是 \"from to [distance|time]\"，已跳过"
+                              << std::endl;
+                }
+            }
+        };
+
+        while (buffer && !outputFailed.load(std::memory_order_relaxed)) {
+            std::streamsize available = buffer->in_avail();
+            if (available <= 0) {
+                // 先把已读到的查询交给搜索阶段，再阻塞等待更多输入
+                if (!batch->queries.empty()) {
+                    submit();
+                }
+                if (std::char_traits<char>::eq_int_type(buffer->sgetc(), std::char_traits<char>::eof())) {
+                    break;
+                }
+                available = std::max<std::streamsize>(buffer->in_avail(), 1);
+            }
+            std::streamsize count = buffer->sgetn(
+                chunk.data(), std::min<std::streamsize>(available, static_cast<std::streamsize>(chunk.size())));
+            if (count <= 0) {
+                break;
+            }
+            const char* p = chunk.data();
+            const char* end = p + count;
+            while (p < end) {
+                const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (!newline) {
+                    pending.append(p, end);
+                    break;
+                }
+                if (pending.empty()) {
+                    handleLine(p, newline);
+                } else {
+                    pending.append(p, newline);
+                    handleLine(pending.data(), pending.data() + pending.size());
+                    pending.clear();
+                }
+                p = newline + 1;
+            }
+        }
+        if (!pending.empty()) {
+            handleLine(pending.data(), pending.data() + pending.size());
+        }
+        batch->last = true;
+        toSearch.push(batch);
+    });
+
+    // 输出阶段：格式化整批结果后一次写出
+    std::thread writer([&]() {
+        while (true) {
+            Batch* batch = toWrite.pop();
+            batch->output.clear();
+            if (format_ == ServerFormat::BINARY) {
+                formatBinary(*batch, distancesOnly_, batch->output);
+            } else {
+                formatText(*batch, distancesOnly_, batch->output);
+            }
+            for (size_t i = 0; i < batch->queries.size(); ++i) {
+                stats.found += batch->results[i].found ? 1 : 0;
+            }
+            stats.queries += batch->queries.size();
+            if (!outputFailed.load(std::memory_order_relaxed) && !batch->output.empty()) {
+                out.write(batch->output.data(), static_cast<std::streamsize>(batch->output.size()));
+                out.flush();
+                if (!out) {
+                    std::cerr << "错误：写出查询结果失败，停止读取" << std::endl;
+                    outputFailed.store(true, std::memory_order_relaxed);
+                }
+            }
+            bool last = batch->last;
+            batch->last = false;
+            freeBatches.push(batch);
+            if (last) {
+                break;
+            }
+        }
+    });
+
+    // 搜索阶段（调用线程）：整批交给引擎的线程池
+    while (true) {
+        Batch* batch = toSearch.pop();
+        if (!batch->queries.empty()) {
+            auto searchStart = std::chrono::steady_clock::now();
+            engine_.findPaths(batch->queries.data(), batch->queries.size(), batch->results,
+                              distancesOnly_);
+            stats.searchSeconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - searchStart).count();
+            stats.batches++;
+        } else {
+            engine_.findPaths(batch->queries.data(), 0, batch->results, distancesOnly_);
+        }
+        bool last = batch->last;
+        toWrite.push(batch);
+        if (last) {
+            break;
+        }
+    }
+
+    reader.join();
+    writer.join();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
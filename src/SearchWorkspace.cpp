@@ -0,0 +1,35 @@
+#include "../include/SearchWorkspace.h"
+
+SearchWorkspace::SearchWorkspace() : generation_(0) {
+}
+
+SearchWorkspace::~SearchWorkspace() = default;
+
+SearchWorkspace& SearchWorkspace::forThread(Slot slot) {
+    thread_local SearchWorkspace workspaces[SLOT_COUNT];
+    return workspaces[slot];
+}
+
+void SearchWorkspace::beginSearch(size_t nodeCount) {
+    if (states_.size() < nodeCount) {
+        // 新扩容的状态戳为0，小于任何有效代数
+        states_.resize(nodeCount, NodeState{INFINITE_DISTANCE, NO_PARENT, 0});
+    }
+
+    // 每次搜索占用两个代数值（已访问 / 已确定）
+    if (generation_ >= std::numeric_limits<uint32_t>::max() - 2) {
+        // 代数即将回绕，清零所有状态戳
+        for (NodeState& state : states_) {
+            state.stamp = 0;
+        }
+        generation_ = 0;
+    }
+    generation_ += 2;
+
+    binaryHeap_.reset(nodeCount);
+}
+
+size_t SearchWorkspace::getMemoryUsage() const {
+    return states_.capacity() * sizeof(NodeState) + binaryHeap_.getMemoryUsage() +
+           quaternaryHeap_.getMemoryUsage() + radixHeap_.getMemoryUsage();
+}
@@ -0,0 +1,93 @@
+#include "../include/SnapshotReaper.h"
+
+SnapshotReaper::SnapshotReaper() : stopping_(false) {
+}
+
+SnapshotReaper::~SnapshotReaper() {
+    stop();
+}
+
+std::shared_ptr<const MapSnapshot> SnapshotReaper::adopt(std::shared_ptr<const MapSnapshot> snapshot) {
+    if (!snapshot) {
+        return nullptr;
+    }
+    const MapSnapshot* raw = snapshot.get();
+    return std::shared_ptr<const MapSnapshot>(raw, Deleter{weak_from_this(), std::move(snapshot)});
+}
+
+void SnapshotReaper::Deleter::operator()(const MapSnapshot*) {
+    std::shared_ptr<SnapshotReaper> owner = reaper.lock();
+    if (owner) {
+        owner->retire(std::move(snapshot));
+    } else {
+        snapshot.reset();
+    }
+}
+
+void SnapshotReaper::watch(const MapSnapshot* snapshot, std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopping_) {
+        watchers_.emplace_back(snapshot, std::move(callback));
+    }
+}
+
+void SnapshotReaper::retire(std::shared_ptr<const MapSnapshot> snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopping_) {
+            retired_.push_back(std::move(snapshot));
+            if (!thread_.joinable()) {
+                thread_ = std::thread(&SnapshotReaper::run, this);
+            }
+        }
+    }
+    wake_.notify_one();
+    // 已停止：在当前线程中释放（snapshot 未被移走时在这里析构）
+}
+
+void SnapshotReaper::stop() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        thread.swap(thread_);
+    }
+    wake_.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    watchers_.clear();
+}
+
+void SnapshotReaper::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stopping_ || !retired_.empty(); });
+        if (retired_.empty()) {
+            return;
+        }
+        std::shared_ptr<const MapSnapshot> snapshot = std::move(retired_.front());
+        retired_.pop_front();
+        const MapSnapshot* raw = snapshot.get();
+
+        // 锁外释放：删除器可能在其他线程中同时交来快照
+        lock.unlock();
+        snapshot.reset();
+        lock.lock();
+
+        std::function<void()> callback;
+        for (size_t i = 0; i < watchers_.size(); ++i) {
+            if (watchers_[i].first == raw) {
+                callback = std::move(watchers_[i].second);
+                watchers_.erase(watchers_.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+        if (callback) {
+            lock.unlock();
+            callback();
+            lock.lock();
+        }
+    }
+}
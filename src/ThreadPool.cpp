@@ -0,0 +1,81 @@
+#include "../include/ThreadPool.h"
+#include <atomic>
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount) : stopping_(false) {
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // 调用 parallelFor 的线程也参与执行，只需再创建 threadCount - 1 个工作线程
+    workers_.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    // 各线程从共享计数器领取下一个下标
+    std::atomic<size_t> next(0);
+    auto drain = [&next, count, &body] {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            body(i);
+        }
+    };
+
+    size_t helperCount = std::min(workers_.size(), count - 1);
+    size_t pending = helperCount;
+    std::mutex doneMutex;
+    std::condition_variable done;
+
+    if (helperCount > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < helperCount; ++i) {
+            tasks_.emplace_back([&] {
+                drain();
+                std::lock_guard<std::mutex> doneLock(doneMutex);
+                if (--pending == 0) {
+                    done.notify_one();
+                }
+            });
+        }
+    }
+    condition_.notify_all();
+
+    drain();
+
+    // 任务引用了本函数栈上的状态，必须等所有辅助任务退出
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [&pending] { return pending == 0; });
+}
@@ -1,7 +1,16 @@
 #include "../include/MapEngine.h"
+#include "../include/QueryServer.h"
 #include <iostream>
+#include <fstream>
 #include <iomanip>
 #include <chrono>
+#include <cstdlib>
+#include <string>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <cstdio>
+#endif
 
 void printPathResult(const PathResult& result, int from, int to) {
     std::cout << "\n========== 路径规划结果 ==========" << std::endl;
@@ -21,6 +30,12 @@ void printPathResult(const PathResult& result, int from, int to) {
         std::cout << "总权重: " << std::fixed << std::setprecision(2) 
                   << result.totalWeight << std::endl;
         std::cout << "执行时间: " << result.elapsedMicroseconds << " 微秒" << std::endl;
+        if (SearchStats::ENABLED) {
+            std::cout << "搜索计数: 确定节点 " << result.stats.settledNodes
+                      << "，检查边 " << result.stats.relaxedEdges
+                      << "，入队 " << result.stats.heapPushes
+                      << "，过期出队 " << result.stats.stalePops << std::endl;
+        }
     } else {
         std::cout << "路径找到: 否" << std::endl;
         std::cout << "原因: 无法从节点 " << from << " 到达节点 " << to << std::endl;
@@ -28,7 +43,190 @@ void printPathResult(const PathResult& result, int from, int to) {
     std::cout << "==================================\n" << std::endl;
 }
 
+/**
+ * @brief 转换模式：path_planning_engine --convert 文本地图 二进制地图 [--landmarks N] [--ch]
+ *        [--reorder original|bfs|rcm]
+ */
+int convertMap(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "用法: " << argv[0]
+                  << " --convert <文本地图> <二进制地图> [--landmarks N] [--ch]"
+                  << " [--reorder original|bfs|rcm]" << std::endl;
+        return 1;
+    }
+    int landmarkCount = 0;
+    bool buildHierarchies = false;
+    NodeOrder order = NodeOrder::ORIGINAL;
+    for (int i = 4; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--landmarks" && i + 1 < argc) {
+            landmarkCount = std::atoi(argv[++i]);
+        } else if (option == "--ch") {
+            buildHierarchies = true;
+        } else if (option == "--reorder" && i + 1 < argc) {
+            if (!NodeOrdering::parse(argv[++i], order)) {
+                std::cerr << "错误: 未知重排方式 " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "错误: 未知参数 " << option << std::endl;
+            return 1;
+        }
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!BinaryMap::convertTextMap(argv[2], argv[3], landmarkCount, buildHierarchies, order)) {
+        std::cerr << "错误: 转换地图失败" << std::endl;
+        return 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "已生成二进制地图 " << argv[3] << "，耗时 "
+              << std::chrono::duration<double>(end - start).count() << " 秒" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief 查询服务模式：path_planning_engine --serve 地图 [--input 文件] [--output 文件]
+ *        [--format text|binary] [--no-path] [--strategy distance|time]
+ *        [--algorithm dijkstra|bidirectional|alt|ch] [--threads N] [--batch N]
+ * 地图只加载一次，之后从标准输入（或 --input 文件）读取 "from to [distance|time]" 查询直到输入结束，
+ * 结果写到标准输出（或 --output 文件）；加载信息和结束时的吞吐量统计写到标准错误
+ */
+int serveQueries(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "用法: " << argv[0]
+                  << " --serve <地图> [--input 文件] [--output 文件] [--format text|binary] [--no-path]"
+                  << " [--strategy distance|time] [--algorithm dijkstra|bidirectional|alt|ch]"
+                  << " [--threads N] [--batch N]" << std::endl;
+        return 1;
+    }
+    std::string inputFile;
+    std::string outputFile;
+    ServerFormat format = ServerFormat::TEXT;
+    bool distancesOnly = false;
+    PathStrategy strategy = PathStrategy::SHORTEST_DISTANCE;
+    SearchAlgorithm algorithm = SearchAlgorithm::DIJKSTRA;
+    size_t threadCount = 0;
+    size_t batchSize = QueryServer::DEFAULT_BATCH_SIZE;
+    for (int i = 3; i < argc; ++i) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--no-path") {
+            distancesOnly = true;
+        } else if (option == "--input" && hasValue) {
+            inputFile = argv[++i];
+        } else if (option == "--output" && hasValue) {
+            outputFile = argv[++i];
+        } else if (option == "--format" && hasValue) {
+            if (!QueryServer::parseFormat(argv[++i], format)) {
+                std::cerr << "错误: 未知输出格式 " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (option == "--strategy" && hasValue) {
+            std::string name = argv[++i];
+            if (name == "distance") {
+                strategy = PathStrategy::SHORTEST_DISTANCE;
+            } else if (name == "time") {
+                strategy = PathStrategy::LEAST_TIME;
+            } else {
+                std::cerr << "错误: 未知策略 " << name << std::endl;
+                return 1;
+            }
+        } else if (option == "--algorithm" && hasValue) {
+            std::string name = argv[++i];
+            if (name == "dijkstra") {
+                algorithm = SearchAlgorithm::DIJKSTRA;
+            } else if (name == "bidirectional") {
+                algorithm = SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA;
+            } else if (name == "alt") {
+                algorithm = SearchAlgorithm::ALT;
+            } else if (name == "ch") {
+                algorithm = SearchAlgorithm::CONTRACTION_HIERARCHY;
+            } else {
+                std::cerr << "错误: 未知搜索算法 " << name << std::endl;
+                return 1;
+            }
+        } else if (option == "--threads" && hasValue) {
+            threadCount = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (option == "--batch" && hasValue) {
+            batchSize = static_cast<size_t>(std::atoll(argv[++i]));
+        } else {
+            std::cerr << "错误: 未知参数 " << option << std::endl;
+            return 1;
+        }
+    }
+
+    // 标准输出只写查询结果，加载器的进度信息转到标准错误
+    std::ios::sync_with_stdio(false);
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    MapEngine engine;
+    engine.setThreadCount(threadCount);
+    engine.setStrategy(strategy);
+    engine.setAlgorithm(algorithm);
+    bool loaded = engine.loadMap(argv[2]);
+    if (loaded && algorithm == SearchAlgorithm::ALT && !engine.hasLandmarks()) {
+        loaded = engine.buildLandmarks();
+    }
+    if (loaded && algorithm == SearchAlgorithm::CONTRACTION_HIERARCHY &&
+        !engine.hasContractionHierarchy(strategy)) {
+        loaded = engine.buildContractionHierarchies();
+    }
+    std::cout.rdbuf(stdoutBuffer);
+    if (!loaded) {
+        std::cerr << "错误: 无法加载地图 " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cerr << "地图已加载：" << engine.getNodeCount() << " 个节点，" << engine.getEdgeCount()
+              << " 条边，" << engine.getThreadCount() << " 个搜索线程" << std::endl;
+
+    std::ifstream inputStream;
+    if (!inputFile.empty()) {
+        inputStream.open(inputFile, std::ios::binary);
+        if (!inputStream) {
+            std::cerr << "错误: 无法打开查询文件 " << inputFile << std::endl;
+            return 1;
+        }
+    }
+    std::ofstream outputStream;
+    if (!outputFile.empty()) {
+        outputStream.open(outputFile, std::ios::binary);
+        if (!outputStream) {
+            std::cerr << "错误: 无法创建结果文件 " << outputFile << std::endl;
+            return 1;
+        }
+    }
+#ifdef _WIN32
+    if (outputFile.empty() && format == ServerFormat::BINARY) {
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+
+    QueryServer server(engine);
+    server.setFormat(format);
+    server.setBatchSize(batchSize);
+    server.setDistancesOnly(distancesOnly);
+    server.setDefaultStrategy(strategy);
+    ServerStats stats = server.run(inputFile.empty() ? std::cin : inputStream,
+                                   outputFile.empty() ? std::cout : outputStream);
+
+    std::cerr << "查询服务结束：" << stats.queries << " 个查询（找到路径 " << stats.found << "），"
+              << stats.errors << " 行格式错误，" << stats.batches << " 批" << std::endl;
+    std::cerr << "总耗时 " << std::fixed << std::setprecision(3) << stats.seconds
+              << " 秒，持续吞吐量 " << std::setprecision(1) << stats.getQps()
+              << " 次/秒，搜索阶段占 "
+              << (stats.seconds > 0.0 ? 100.0 * stats.searchSeconds / stats.seconds : 0.0) << "%"
+              << std::endl;
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--convert") {
+        return convertMap(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        return serveQueries(argc, argv);
+    }
+    
     std::cout << "========================================" << std::endl;
     std::cout << "   高性能路径规划引擎 (C++)" << std::endl;
     std::cout << "   基于堆优化的Dijkstra算法" << std::endl;
@@ -52,6 +250,10 @@ int main(int argc, char* argv[]) {
     std::cout << "\n地图加载完成！" << std::endl;
     std::cout << "节点数: " << engine.getNodeCount() << std::endl;
     std::cout << "边数: " << engine.getEdgeCount() << std::endl;
+    ComponentStats components = engine.getComponentStats();
+    std::cout << "连通分量: " << components.componentCount << "（最大 "
+              << components.largestComponentSize << " 个节点，孤立点 "
+              << components.isolatedNodeCount << " 个）" << std::endl;
     
     // 测试用例1: 最短距离策略
     std::cout << "\n【测试1】最短距离策略" << std::endl;
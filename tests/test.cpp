@@ -1,9 +1,165 @@
 ﻿#include "../include/MapEngine.h"
+#include "../include/GraphGenerator.h"
+#include "../include/QueryServer.h"
 #include <iostream>
 #include <iomanip>
 #include <cassert>
 #include <vector>
 #include <chrono>
+#include <unordered_map>
+#include <queue>
+#include <limits>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+
+// 统计堆分配次数，用于验证搜索在预热后不再分配内存
+static std::atomic<size_t> g_allocationCount(0);
+
+// 替换的分配函数不能内联：否则 GCC 把内联出的 malloc 与 operator delete 中的 free 配对检查，
+// 报 -Wmismatched-new-delete
+#if defined(__GNUC__)
+#define TEST_NOINLINE __attribute__((noinline))
+#else
+#define TEST_NOINLINE
+#endif
+
+TEST_NOINLINE void* operator new(size_t size) {
+    g_allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+TEST_NOINLINE void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+TEST_NOINLINE void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+TEST_NOINLINE void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+TEST_NOINLINE void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+TEST_NOINLINE void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief 生成网格路网：rows x cols 个节点，相邻节点之间连边，权重伪随机
+ */
+void buildGridGraph(Graph& graph, int rows, int cols, unsigned seed) {
+    auto nextWeight = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return 1.0 + static_cast<double>((seed >> 16) % 100);
+    };
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int id = r * cols + c;
+            if (c + 1 < cols) {
+                double distance = nextWeight();
+                graph.addEdge(id, id + 1, distance, distance / (1.0 + (seed % 3)));
+            }
+            if (r + 1 < rows) {
+                double distance = nextWeight();
+                graph.addEdge(id, id + cols, distance, distance / (1.0 + (seed % 3)));
+            }
+        }
+    }
+    graph.finalize();
+}
+
+/**
+ * @brief 把生成网格写成地图数据文件（每条无向边一行）
+ */
+void writeGridMap(const std::string& filename, int rows, int cols, unsigned seed) {
+    Graph grid;
+    buildGridGraph(grid, rows, cols, seed);
+    std::ofstream file(filename);
+    file << std::setprecision(17);
+    for (int id = 0; id < rows * cols; ++id) {
+        for (const Edge& edge : grid.getAdjacentEdges(id)) {
+            if (edge.to > id) {
+                file << id << " " << edge.to << " " << edge.distance << " " << edge.time << "\n";
+            }
+        }
+    }
+}
+
+/**
+ * @brief 校验路径：相邻节点之间有边，且沿路径的权重之和等于 totalWeight
+ */
+bool isValidPath(const Graph& graph, const PathResult& result, PathStrategy strategy) {
+    if (!result.found || result.path.empty()) {
+        return false;
+    }
+    double total = 0.0;
+    for (size_t i = 0; i + 1 < result.path.size(); ++i) {
+        double best = std::numeric_limits<double>::infinity();
+        for (const Edge& edge : graph.getAdjacentEdges(result.path[i])) {
+            if (edge.to == result.path[i + 1] && edge.getWeight(strategy) < best) {
+                best = edge.getWeight(strategy);
+            }
+        }
+        if (best == std::numeric_limits<double>::infinity()) {
+            return false;
+        }
+        total += best;
+    }
+    return std::abs(total - result.totalWeight) < 1e-6 * (1.0 + total);
+}
+
+/**
+ * @brief 参考实现：基于哈希表和优先队列的Dijkstra（每次查询重新分配状态）
+ * @return 最短距离，不可达时为无穷大
+ */
+double referenceDijkstra(const Graph& graph, int from, int to, PathStrategy strategy) {
+    std::unordered_map<int, double> dist;
+    std::unordered_map<int, bool> visited;
+    typedef std::pair<double, int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    
+    dist[from] = 0.0;
+    pq.push(Item(0.0, from));
+    while (!pq.empty()) {
+        Item current = pq.top();
+        pq.pop();
+        if (visited[current.second]) {
+            continue;
+        }
+        visited[current.second] = true;
+        if (current.second == to) {
+            return current.first;
+        }
+        for (const Edge& edge : graph.getAdjacentEdges(current.second)) {
+            int v = edge.to;
+            double newDist = current.first + edge.getWeight(strategy);
+            auto it = dist.find(v);
+            if (it == dist.end() || newDist < it->second) {
+                dist[v] = newDist;
+                pq.push(Item(newDist, v));
+            }
+        }
+    }
+    return std::numeric_limits<double>::infinity();
+}
 
 void testBasicPathFinding() {
     std::cout << "【测试1】基本路径查找..." << std::endl;
@@ -125,9 +281,2801 @@ void testPerformance() {
     // 验证平均耗时在合理范围内（微秒级）
     assert(avgTime < 1000.0);  // 平均应该小于1毫秒
     
+    // 大规模生成图：与每次查询都重新分配哈希表的参考实现对比
+    const int rows = 300;
+    const int cols = 300;
+    Graph grid;
+    buildGridGraph(grid, rows, cols, 42u);
+    PathFinder finder(grid);
+    
+    const int queryCount = 50;
+    std::vector<std::pair<int, int>> queries;
+    unsigned seed = 7u;
+    for (int i = 0; i < queryCount; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (rows * cols));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (rows * cols));
+        queries.emplace_back(from, to);
+    }
+    
+    // 预热：首次查询为工作区分配内存
+    finder.findPath(0, rows * cols - 1);
+    
+    auto workspaceStart = std::chrono::high_resolution_clock::now();
+    std::vector<double> workspaceResults;
+    workspaceResults.reserve(queryCount);
+    for (const auto& q : queries) {
+        workspaceResults.push_back(finder.findPath(q.first, q.second).totalWeight);
+    }
+    auto workspaceEnd = std::chrono::high_resolution_clock::now();
+    
+    auto referenceStart = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; ++i) {
+        double expected = referenceDijkstra(grid, queries[i].first, queries[i].second,
+                                            PathStrategy::SHORTEST_DISTANCE);
+        assert(expected == workspaceResults[i]);
+    }
+    auto referenceEnd = std::chrono::high_resolution_clock::now();
+    
+    double workspaceAvg = std::chrono::duration<double, std::micro>(
+        workspaceEnd - workspaceStart).count() / queryCount;
+    double referenceAvg = std::chrono::duration<double, std::micro>(
+        referenceEnd - referenceStart).count() / queryCount;
+    std::cout << "生成网格 " << rows << "x" << cols << "，" << queryCount << " 次随机查询：" << std::endl;
+    std::cout << "  复用工作区: " << workspaceAvg << " 微秒/次" << std::endl;
+    std::cout << "  哈希表参考实现: " << referenceAvg << " 微秒/次（加速 "
+              << referenceAvg / workspaceAvg << " 倍）" << std::endl;
+    
+    // 预热后搜索本身不分配内存，唯一的分配是返回的路径
+    size_t allocationsBefore = g_allocationCount.load();
+    PathResult farResult = finder.findPath(0, rows * cols - 1);
+    size_t allocations = g_allocationCount.load() - allocationsBefore;
+    assert(farResult.found);
+    std::cout << "  预热后单次查询的堆分配次数: " << allocations
+              << "（路径长度 " << farResult.path.size() << "）" << std::endl;
+    assert(allocations <= 1);
+    
+    // 上面的查询已让工作区增长到位：之后每次查询最多分配路径，只求距离时完全不分配
+    allocationsBefore = g_allocationCount.load();
+    for (const auto& q : queries) {
+        PathResult result = finder.findPath(q.first, q.second);
+        assert(result.found);
+    }
+    allocations = g_allocationCount.load() - allocationsBefore;
+    assert(allocations <= queries.size());
+    allocationsBefore = g_allocationCount.load();
+    for (const auto& q : queries) {
+        assert(finder.findDistance(q.first, q.second, PathStrategy::SHORTEST_DISTANCE,
+                                   SearchAlgorithm::DIJKSTRA).found);
+    }
+    assert(g_allocationCount.load() == allocationsBefore);
+    
     std::cout << "✓ 性能测试通过" << std::endl;
 }
 
+void testCsrGraph() {
+    std::cout << "【测试8】CSR图存储..." << std::endl;
+    
+    Graph graph;
+    graph.addEdge(100, 200, 1.5);
+    graph.addEdge(200, 300, 2.5);
+    graph.addEdge(100, 300, 4.0);
+    graph.addNode(400);
+    graph.finalize();
+    
+    assert(graph.isFinalized());
+    assert(graph.getNodeCount() == 4);
+    assert(graph.getEdgeCount() == 3);
+    assert(graph.hasNode(300));
+    assert(!graph.hasNode(500));
+    assert(graph.isIsolated(400));
+    assert(!graph.isIsolated(100));
+    
+    // 外部ID与稠密下标互相转换
+    int index = graph.getIndex(200);
+    assert(index != Graph::INVALID_INDEX);
+    assert(graph.getNodeId(index) == 200);
+    assert(graph.getIndex(500) == Graph::INVALID_INDEX);
+    
+    // 邻接边按添加顺序连续存放；getAdjacentEdges 的目标为外部ID，getEdgesAt 的目标为稠密下标
+    EdgeRange edges = graph.getAdjacentEdges(100);
+    assert(edges.size() == 2);
+    assert(edges[0].to == 200 && edges[0].distance == 1.5);
+    assert(edges[1].to == 300 && edges[1].distance == 4.0);
+    assert(graph.getEdgesAt(graph.getIndex(100))[0].to == graph.getIndex(200));
+    int visited = 0;
+    for (const Edge& edge : edges) {
+        assert(edge.to == (visited++ == 0 ? 200 : 300));
+    }
+    assert(graph.getAdjacentEdges(500).empty());
+    
+    // 冻结后继续添加边会回到构建状态，再次冻结后数据完整
+    graph.addEdge(400, 400, 1.0);
+    graph.addEdge(400, 100, 3.0);
+    assert(!graph.isFinalized());
+    graph.finalize();
+    assert(graph.getEdgeCount() == 5);
+    assert(graph.getAdjacentEdges(400).size() == 3);
+    assert(graph.getAdjacentEdges(100).size() == 3);
+    assert(graph.getAdjacentEdges(200).size() == 2);
+    
+    // 稀疏ID回退到有序数组二分查找
+    Graph sparse;
+    sparse.addEdge(-1000000000, 1000000000, 1.0);
+    sparse.finalize();
+    assert(sparse.hasNode(-1000000000));
+    assert(sparse.hasNode(1000000000));
+    assert(!sparse.hasNode(0));
+    assert(sparse.getAdjacentEdges(1000000000).size() == 1);
+    
+    std::cout << "✓ CSR图存储测试通过" << std::endl;
+}
+
+void testPerQueryStrategy() {
+    std::cout << "【测试9】按查询选择策略..." << std::endl;
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    
+    engine.setStrategy(PathStrategy::SHORTEST_DISTANCE);
+    PathResult byDistance = engine.findPath(1, 5);
+    assert(byDistance.found);
+    assert(byDistance.totalWeight == 40.0);
+    
+    // 按查询指定策略，不影响默认策略
+    PathResult byTime = engine.findPath(1, 5, PathStrategy::LEAST_TIME);
+    assert(byTime.found);
+    assert(byTime.totalWeight == 23.0);
+    assert(engine.findPath(1, 5).totalWeight == 40.0);
+    
+    // 切换默认策略后结果与按查询指定一致
+    engine.setStrategy(PathStrategy::LEAST_TIME);
+    assert(engine.findPath(1, 5).totalWeight == 23.0);
+    assert(engine.findPath(5, 7).totalWeight == 6.0);
+    assert(engine.findPath(5, 7, PathStrategy::SHORTEST_DISTANCE).totalWeight == 10.0);
+    
+    // 每条边同时保存距离和时间
+    Graph graph;
+    graph.addEdge(1, 2, 10.0, 5.0);
+    graph.finalize();
+    Edge edge = graph.getAdjacentEdges(1)[0];
+    assert(edge.getWeight(PathStrategy::SHORTEST_DISTANCE) == 10.0);
+    assert(edge.getWeight(PathStrategy::LEAST_TIME) == 5.0);
+    
+    // 同一对节点（不分方向）出现在多行时以最后一行为准，距离和时间来自同一行，只算一条边
+    const std::string duplicateFile = "duplicate_edges_test.txt";
+    {
+        std::ofstream file(duplicateFile);
+        file << "1 2 10 5\n1 2 3 9\n2 3 4 4\n2 1 7 1\n3 3 2 2\n3 3 1 1\n";
+    }
+    MapEngine duplicates;
+    assert(duplicates.loadMap(duplicateFile));
+    assert(duplicates.getEdgeCount() == 3);
+    assert(duplicates.findPath(1, 2, PathStrategy::SHORTEST_DISTANCE).totalWeight == 7.0);
+    assert(duplicates.findPath(2, 1, PathStrategy::LEAST_TIME).totalWeight == 1.0);
+    assert(duplicates.findPath(1, 3, PathStrategy::SHORTEST_DISTANCE).totalWeight == 11.0);
+    const Graph& deduplicated = duplicates.getSnapshot()->getGraph();
+    assert(deduplicated.getAdjacentEdges(1).size() == 1 && deduplicated.getAdjacentEdges(2).size() == 2);
+    assert(deduplicated.getAdjacentEdges(3).size() == 3);
+    std::remove(duplicateFile.c_str());
+    
+    // 冻结后再添加：重复的边同样以最后添加的为准
+    graph.addEdge(2, 1, 4.0, 6.0);
+    graph.finalize();
+    assert(graph.getEdgeCount() == 1 && graph.getAdjacentEdges(2).size() == 1);
+    edge = graph.getAdjacentEdges(1)[0];
+    assert(edge.distance == 4.0 && edge.time == 6.0);
+    
+    std::cout << "✓ 按查询选择策略测试通过" << std::endl;
+}
+
+void testBidirectionalSearch() {
+    std::cout << "【测试10】双向Dijkstra..." << std::endl;
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    
+    // 与单向搜索在示例地图上的所有节点对比较
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    for (PathStrategy strategy : strategies) {
+        for (int from = 1; from <= 8; ++from) {
+            for (int to = 1; to <= 8; ++to) {
+                engine.setAlgorithm(SearchAlgorithm::DIJKSTRA);
+                PathResult expected = engine.findPath(from, to, strategy);
+                engine.setAlgorithm(SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA);
+                PathResult actual = engine.findPath(from, to, strategy);
+                assert(expected.found == actual.found);
+                if (expected.found) {
+                    assert(actual.totalWeight == expected.totalWeight);
+                    assert(actual.path.front() == from && actual.path.back() == to);
+                }
+            }
+        }
+    }
+    assert(engine.getAlgorithm() == SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA);
+    assert(!engine.findPath(8, 1).found);
+    assert(!engine.findPath(1, 99999).found);
+    
+    // 生成网格上随机查询，路径合法且长度与单向搜索一致
+    Graph grid;
+    buildGridGraph(grid, 120, 150, 9u);
+    PathFinder unidirectional(grid);
+    PathFinder bidirectional(grid);
+    bidirectional.setAlgorithm(SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA);
+    
+    unsigned seed = 3u;
+    double uniTime = 0.0;
+    double biTime = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (120 * 150));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (120 * 150));
+        PathStrategy strategy = (i % 2 == 0) ? PathStrategy::SHORTEST_DISTANCE
+                                             : PathStrategy::LEAST_TIME;
+        
+        PathResult expected = unidirectional.findPath(from, to, strategy);
+        PathResult actual = bidirectional.findPath(from, to, strategy);
+        assert(expected.found && actual.found);
+        assert(std::abs(actual.totalWeight - expected.totalWeight) < 1e-9);
+        assert(isValidPath(grid, actual, strategy));
+        uniTime += static_cast<double>(expected.elapsedMicroseconds);
+        biTime += static_cast<double>(actual.elapsedMicroseconds);
+    }
+    std::cout << "网格 120x150，200 次查询：单向 " << uniTime / 200 << " 微秒/次，双向 "
+              << biTime / 200 << " 微秒/次" << std::endl;
+    
+    std::cout << "✓ 双向Dijkstra测试通过" << std::endl;
+}
+
+void testAltSearch() {
+    std::cout << "【测试11】ALT地标搜索..." << std::endl;
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(!engine.hasLandmarks());
+    
+    // 没有地标表时 ALT 退化为单向Dijkstra
+    engine.setAlgorithm(SearchAlgorithm::ALT);
+    assert(engine.findPath(1, 5).totalWeight == 40.0);
+    
+    const LandmarkSelection selections[] = {LandmarkSelection::FARTHEST, LandmarkSelection::AVOID};
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    for (LandmarkSelection selection : selections) {
+        assert(engine.buildLandmarks(3, selection));
+        assert(engine.hasLandmarks());
+        for (PathStrategy strategy : strategies) {
+            for (int from = 1; from <= 8; ++from) {
+                for (int to = 1; to <= 8; ++to) {
+                    engine.setAlgorithm(SearchAlgorithm::DIJKSTRA);
+                    PathResult expected = engine.findPath(from, to, strategy);
+                    engine.setAlgorithm(SearchAlgorithm::ALT);
+                    PathResult actual = engine.findPath(from, to, strategy);
+                    assert(expected.found == actual.found);
+                    if (expected.found) {
+                        assert(std::abs(actual.totalWeight - expected.totalWeight) < 1e-9);
+                    }
+                }
+            }
+        }
+    }
+    
+    // 地标表保存、加载及与地图不匹配时拒绝加载
+    const std::string landmarkFile = "alt_test.landmarks";
+    assert(engine.saveLandmarks(landmarkFile));
+    engine.clearLandmarks();
+    assert(!engine.hasLandmarks());
+    assert(engine.loadLandmarks(landmarkFile));
+    assert(engine.findPath(1, 5, PathStrategy::LEAST_TIME).totalWeight == 23.0);
+    
+    Graph grid;
+    buildGridGraph(grid, 100, 100, 11u);
+    Landmarks gridLandmarks;
+    assert(gridLandmarks.build(grid, 8, LandmarkSelection::AVOID));
+    assert(gridLandmarks.getLandmarkCount() == 8);
+    assert(!gridLandmarks.load(landmarkFile, grid));
+    std::remove(landmarkFile.c_str());
+    
+    // 生成网格上与单向Dijkstra比较
+    PathFinder dijkstra(grid);
+    PathFinder alt(grid);
+    alt.setAlgorithm(SearchAlgorithm::ALT);
+    alt.setLandmarks(&gridLandmarks);
+    
+    unsigned seed = 5u;
+    double dijkstraTime = 0.0;
+    double altTime = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (100 * 100));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (100 * 100));
+        PathStrategy strategy = strategies[i % 2];
+        
+        PathResult expected = dijkstra.findPath(from, to, strategy);
+        PathResult actual = alt.findPath(from, to, strategy);
+        assert(actual.found);
+        assert(std::abs(actual.totalWeight - expected.totalWeight) < 1e-9);
+        assert(isValidPath(grid, actual, strategy));
+        dijkstraTime += static_cast<double>(expected.elapsedMicroseconds);
+        altTime += static_cast<double>(actual.elapsedMicroseconds);
+    }
+    std::cout << "网格 100x100，8 个地标，200 次查询：Dijkstra " << dijkstraTime / 200
+              << " 微秒/次，ALT " << altTime / 200 << " 微秒/次" << std::endl;
+    
+    std::cout << "✓ ALT地标搜索测试通过" << std::endl;
+}
+
+void testContractionHierarchy() {
+    std::cout << "【测试12】收缩层次搜索..." << std::endl;
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(!engine.hasContractionHierarchy(PathStrategy::SHORTEST_DISTANCE));
+    
+    // 没有收缩层次时退化为单向Dijkstra
+    engine.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+    assert(engine.findPath(1, 5).totalWeight == 40.0);
+    
+    assert(engine.buildContractionHierarchies());
+    assert(engine.hasContractionHierarchy(PathStrategy::SHORTEST_DISTANCE));
+    assert(engine.hasContractionHierarchy(PathStrategy::LEAST_TIME));
+    
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    for (PathStrategy strategy : strategies) {
+        for (int from = 1; from <= 8; ++from) {
+            for (int to = 1; to <= 8; ++to) {
+                engine.setAlgorithm(SearchAlgorithm::DIJKSTRA);
+                PathResult expected = engine.findPath(from, to, strategy);
+                engine.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+                PathResult actual = engine.findPath(from, to, strategy);
+                assert(expected.found == actual.found);
+                if (expected.found) {
+                    assert(std::abs(actual.totalWeight - expected.totalWeight) < 1e-9);
+                    assert(actual.path.front() == from && actual.path.back() == to);
+                }
+            }
+        }
+    }
+    
+    // 重新加载地图后层次失效
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(!engine.hasContractionHierarchy(PathStrategy::LEAST_TIME));
+    
+    // 生成网格上与单向Dijkstra比较
+    Graph grid;
+    buildGridGraph(grid, 100, 100, 13u);
+    ContractionHierarchy hierarchies[2];
+    PathFinder dijkstra(grid);
+    PathFinder ch(grid);
+    ch.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+    for (PathStrategy strategy : strategies) {
+        ContractionHierarchy& hierarchy = hierarchies[static_cast<int>(strategy)];
+        assert(hierarchy.build(grid, strategy));
+        assert(hierarchy.isBuilt());
+        ch.setContractionHierarchy(strategy, &hierarchy);
+    }
+    
+    unsigned seed = 9u;
+    double dijkstraTime = 0.0;
+    double chTime = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (100 * 100));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (100 * 100));
+        PathStrategy strategy = strategies[i % 2];
+        
+        PathResult expected = dijkstra.findPath(from, to, strategy);
+        PathResult actual = ch.findPath(from, to, strategy);
+        assert(actual.found);
+        assert(std::abs(actual.totalWeight - expected.totalWeight) < 1e-6);
+        assert(isValidPath(grid, actual, strategy));
+        dijkstraTime += static_cast<double>(expected.elapsedMicroseconds);
+        chTime += static_cast<double>(actual.elapsedMicroseconds);
+    }
+    std::cout << "网格 100x100，捷径 " << hierarchies[0].getShortcutCount()
+              << " 条，200 次查询：Dijkstra " << dijkstraTime / 200
+              << " 微秒/次，CH " << chTime / 200 << " 微秒/次" << std::endl;
+    
+    // 定制：只重新计算权重；权重变化后增量定制与完整定制、Dijkstra 的结果一致
+    auto base = std::make_shared<Graph>();
+    buildGridGraph(*base, 40, 40, 21u);
+    auto built = std::make_shared<ContractionHierarchy>();
+    assert(built->build(*base, PathStrategy::LEAST_TIME));
+    std::shared_ptr<const ContractionHierarchy> customized =
+        ContractionHierarchy::customize(*base, built);
+    assert(customized && customized->isCustomizable() && !built->isCustomizable());
+    assert(customized->getMetric() == PathStrategy::LEAST_TIME);
+    
+    const int* offsets = base->getOffsets();
+    const int* targets = base->getTargets();
+    std::vector<double> times(base->getTimes(), base->getTimes() + offsets[base->getNodeCount()]);
+    std::vector<std::pair<int, int>> changed;
+    for (int i = 0; i < 60; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int u = static_cast<int>((seed >> 8) % base->getNodeCount());
+        int v = targets[offsets[u]];
+        seed = seed * 1103515245u + 12345u;
+        double factor = 0.3 + static_cast<double>((seed >> 8) % 270) / 100.0;
+        for (int a : {u, v}) {
+            for (int e = offsets[a]; e < offsets[a + 1]; ++e) {
+                if (targets[e] == (a == u ? v : u)) {
+                    times[e] *= factor;
+                }
+            }
+        }
+        changed.emplace_back(u, v);
+    }
+    std::shared_ptr<const Graph> updated = Graph::withTimes(base, std::move(times));
+    std::shared_ptr<const ContractionHierarchy> incremental =
+        ContractionHierarchy::customize(*updated, customized, changed);
+    std::shared_ptr<const ContractionHierarchy> full =
+        ContractionHierarchy::customize(*updated, customized);
+    assert(incremental && full && incremental->isCustomizable());
+    assert(incremental->getUpwardEdgeCount() == customized->getUpwardEdgeCount());
+    PathFinder updatedDijkstra(*updated);
+    for (int i = 0; i < 100; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (40 * 40));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (40 * 40));
+        PathResult expected = updatedDijkstra.findPath(from, to, PathStrategy::LEAST_TIME);
+        for (const std::shared_ptr<const ContractionHierarchy>& hierarchy : {incremental, full}) {
+            PathFinder finder(*updated);
+            finder.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+            finder.setContractionHierarchy(PathStrategy::LEAST_TIME, hierarchy.get());
+            PathResult actual = finder.findPath(from, to, PathStrategy::LEAST_TIME);
+            assert(std::abs(actual.totalWeight - expected.totalWeight) < 1e-6);
+            assert(isValidPath(*updated, actual, PathStrategy::LEAST_TIME));
+        }
+    }
+    std::cout << "网格 40x40 定制：向上边 " << customized->getUpwardEdgeCount()
+              << " 条（收缩 " << built->getUpwardEdgeCount() << " 条）" << std::endl;
+    
+    std::cout << "✓ 收缩层次搜索测试通过" << std::endl;
+}
+
+void testConcurrentQueries() {
+    std::cout << "【测试13】并发查询与批量查询..." << std::endl;
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(engine.buildLandmarks(3));
+    assert(engine.buildContractionHierarchies());
+    
+    std::vector<std::pair<int, int>> pairs;
+    for (int from = 1; from <= 8; ++from) {
+        for (int to = 1; to <= 8; ++to) {
+            pairs.emplace_back(from, to);
+        }
+    }
+    
+    // 批量结果与逐个查询一致且顺序相同
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                          SearchAlgorithm::ALT,
+                                          SearchAlgorithm::CONTRACTION_HIERARCHY};
+    engine.setThreadCount(4);
+    assert(engine.getThreadCount() == 4);
+    for (SearchAlgorithm algorithm : algorithms) {
+        engine.setAlgorithm(algorithm);
+        std::vector<PathResult> batch = engine.findPaths(pairs);
+        assert(batch.size() == pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            PathResult single = engine.findPath(pairs[i].first, pairs[i].second);
+            assert(batch[i].found == single.found);
+            assert(batch[i].path == single.path);
+            assert(batch[i].totalWeight == single.totalWeight);
+        }
+    }
+    assert(engine.findPaths(std::vector<std::pair<int, int>>()).empty());
+    
+    // 多个线程同时查询同一个引擎，期间另一个线程反复重建预处理数据
+    engine.setAlgorithm(SearchAlgorithm::DIJKSTRA);
+    std::vector<double> expected;
+    for (const auto& q : pairs) {
+        PathResult result = engine.findPath(q.first, q.second, PathStrategy::LEAST_TIME);
+        expected.push_back(result.found ? result.totalWeight : -1.0);
+    }
+    engine.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+    
+    std::atomic<int> mismatches(0);
+    std::atomic<bool> stop(false);
+    std::thread writer([&engine, &stop] {
+        while (!stop.load()) {
+            engine.buildContractionHierarchies();
+            engine.clearContractionHierarchies();
+        }
+    });
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            for (int round = 0; round < 200; ++round) {
+                for (size_t i = 0; i < pairs.size(); ++i) {
+                    PathResult result = engine.findPath(pairs[i].first, pairs[i].second,
+                                                        PathStrategy::LEAST_TIME);
+                    if ((result.found ? result.totalWeight : -1.0) != expected[i]) {
+                        mismatches++;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    stop.store(true);
+    writer.join();
+    assert(mismatches.load() == 0);
+    
+    // 生成网格上比较单线程与多线程批量查询的吞吐量
+    const std::string gridFile = "concurrent_test_map.txt";
+    const int rows = 200;
+    const int cols = 200;
+    writeGridMap(gridFile, rows, cols, 17u);
+    MapEngine gridEngine;
+    assert(gridEngine.loadMap(gridFile));
+    std::remove(gridFile.c_str());
+    assert(gridEngine.getNodeCount() == static_cast<size_t>(rows * cols));
+    
+    std::vector<std::pair<int, int>> queries;
+    unsigned seed = 21u;
+    for (int i = 0; i < 400; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (rows * cols));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (rows * cols));
+        queries.emplace_back(from, to);
+    }
+    
+    gridEngine.setThreadCount(1);
+    auto serialStart = std::chrono::high_resolution_clock::now();
+    std::vector<PathResult> serial = gridEngine.findPaths(queries);
+    auto serialEnd = std::chrono::high_resolution_clock::now();
+    
+    gridEngine.setThreadCount(0);
+    size_t threads = gridEngine.getThreadCount();
+    auto parallelStart = std::chrono::high_resolution_clock::now();
+    std::vector<PathResult> parallel = gridEngine.findPaths(queries);
+    auto parallelEnd = std::chrono::high_resolution_clock::now();
+    
+    for (size_t i = 0; i < queries.size(); ++i) {
+        assert(serial[i].found && parallel[i].found);
+        assert(serial[i].path == parallel[i].path);
+        assert(serial[i].totalWeight == parallel[i].totalWeight);
+    }
+    double serialSeconds = std::chrono::duration<double>(serialEnd - serialStart).count();
+    double parallelSeconds = std::chrono::duration<double>(parallelEnd - parallelStart).count();
+    std::cout << "网格 " << rows << "x" << cols << "，" << queries.size() << " 次查询：1 线程 "
+              << queries.size() / serialSeconds << " 次/秒，" << threads << " 线程 "
+              << queries.size() / parallelSeconds << " 次/秒（加速 "
+              << serialSeconds / parallelSeconds << " 倍）" << std::endl;
+    
+    std::cout << "✓ 并发查询测试通过" << std::endl;
+}
+
+void testFastLoader() {
+    std::cout << "【测试14】内存映射并行加载..." << std::endl;
+    
+    // 注释、空行、格式错误行、节点声明、非正权重和 CRLF 行尾的处理与逐行读取一致
+    const std::string smallFile = "loader_test_map.txt";
+    {
+        std::ofstream file(smallFile, std::ios::binary);
+        file << "# 注释\n"
+             << "\n"
+             << "1 2 10.5 5\r\n"
+             << "+2 3 2.5e1 8 额外内容被忽略\n"
+             << "3 4 abc 1\n"
+             << "4 5 0 3\n"
+             << "5 6 -1 3\n"
+             << "   \n"
+             << "9\n"
+             << "9 x\n"
+             << "6 7 1.0 inf\n"
+             << "3 1 4 2";
+    }
+    
+    std::ostringstream warnings;
+    std::streambuf* previous = std::cerr.rdbuf(warnings.rdbuf());
+    Graph fast;
+    DataLoader loader;
+    bool loaded = loader.loadFromFile(smallFile, fast);
+    std::cerr.rdbuf(previous);
+    assert(loaded);
+    
+    assert(fast.getNodeCount() == 4);
+    assert(fast.getEdgeCount() == 3);
+    assert(fast.hasNode(9) && fast.isIsolated(9));
+    assert(!fast.hasNode(4) && !fast.hasNode(5));
+    for (const Edge& edge : fast.getAdjacentEdges(2)) {
+        if (edge.to == 3) {
+            assert(edge.distance == 25.0 && edge.time == 8.0);
+        }
+    }
+    
+    // 警告中的行号与文件行号一致
+    std::string text = warnings.str();
+    assert(text.find("第 5 行") != std::string::npos);
+    assert(text.find("第 7 行") != std::string::npos);
+    assert(text.find("第 8 行") != std::string::npos);
+    assert(text.find("第 10 行") != std::string::npos);
+    assert(text.find("第 11 行") != std::string::npos);
+    assert(text.find("第 6 行") == std::string::npos);
+    
+    // 与逐行读取的结果完全相同
+    Graph slow;
+    std::unordered_map<std::pair<int, int>, double, std::hash<std::pair<int, int>>> distances;
+    std::unordered_map<std::pair<int, int>, double, std::hash<std::pair<int, int>>> times;
+    previous = std::cerr.rdbuf(warnings.rdbuf());
+    assert(loader.loadFromFileWithDetails(smallFile, slow, distances, times));
+    std::cerr.rdbuf(previous);
+    assert(slow.computeChecksum() == fast.computeChecksum());
+    std::remove(smallFile.c_str());
+    
+    // 多块并行解析：结果与单线程相同，块边界附近的错误行号正确
+    const std::string gridFile = "loader_grid_map.txt";
+    writeGridMap(gridFile, 400, 400, 3u);
+    size_t gridLines = 0;
+    {
+        std::ifstream in(gridFile);
+        std::string line;
+        while (std::getline(in, line)) {
+            gridLines++;
+        }
+    }
+    {
+        std::ofstream file(gridFile, std::ios::app);
+        file << "bad line\n";
+    }
+    
+    Graph serial;
+    loader.setThreadCount(1);
+    assert(loader.loadFromFile(gridFile, serial));
+    double serialThroughput = loader.getLastThroughput();
+    
+    Graph parallel;
+    loader.setThreadCount(4);
+    warnings.str("");
+    previous = std::cerr.rdbuf(warnings.rdbuf());
+    assert(loader.loadFromFile(gridFile, parallel));
+    std::cerr.rdbuf(previous);
+    std::remove(gridFile.c_str());
+    
+    assert(parallel.getNodeCount() == 400u * 400u);
+    assert(parallel.getEdgeCount() == gridLines);
+    assert(parallel.computeChecksum() == serial.computeChecksum());
+    assert(warnings.str().find("第 " + std::to_string(gridLines + 1) + " 行") != std::string::npos);
+    assert(loader.getLastThroughput() > 0.0);
+    std::cout << "网格 400x400：1 线程 " << serialThroughput << " MB/s，4 线程 "
+              << loader.getLastThroughput() << " MB/s" << std::endl;
+    
+    std::cout << "✓ 内存映射并行加载测试通过" << std::endl;
+}
+
+void testBinaryMap() {
+    std::cout << "【测试15】二进制地图快照..." << std::endl;
+    
+    const std::string textFile = "binary_test_map.txt";
+    const std::string binaryFile = "binary_test_map.pmap";
+    const int rows = 200;
+    const int cols = 200;
+    writeGridMap(textFile, rows, cols, 29u);
+    
+    MapEngine source;
+    assert(source.loadMap(textFile));
+    assert(source.buildLandmarks(4));
+    assert(source.buildContractionHierarchies());
+    assert(source.saveBinaryMap(binaryFile));
+    assert(BinaryMap::isBinaryMap(binaryFile));
+    assert(!BinaryMap::isBinaryMap(textFile));
+    
+    // 二进制地图带着预处理数据加载，图直接映射到内存
+    MapEngine mapped;
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    assert(mapped.loadMap(binaryFile));
+    auto loadEnd = std::chrono::high_resolution_clock::now();
+    assert(mapped.hasLandmarks());
+    assert(mapped.hasContractionHierarchy(PathStrategy::SHORTEST_DISTANCE));
+    assert(mapped.hasContractionHierarchy(PathStrategy::LEAST_TIME));
+    assert(mapped.getNodeCount() == source.getNodeCount());
+    assert(mapped.getEdgeCount() == source.getEdgeCount());
+    assert(mapped.getSnapshot()->getGraph().isMapped());
+    assert(mapped.getSnapshot()->getGraph().computeChecksum() ==
+           source.getSnapshot()->getGraph().computeChecksum());
+    
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                          SearchAlgorithm::ALT,
+                                          SearchAlgorithm::CONTRACTION_HIERARCHY};
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    unsigned seed = 31u;
+    for (int i = 0; i < 40; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (rows * cols));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (rows * cols));
+        PathStrategy strategy = strategies[i % 2];
+        for (SearchAlgorithm algorithm : algorithms) {
+            source.setAlgorithm(algorithm);
+            mapped.setAlgorithm(algorithm);
+            PathResult expected = source.findPath(from, to, strategy);
+            PathResult actual = mapped.findPath(from, to, strategy);
+            assert(expected.found && actual.found);
+            assert(actual.path == expected.path);
+            assert(actual.totalWeight == expected.totalWeight);
+        }
+    }
+    
+    // 保存时先写临时文件再改名，已映射旧文件的快照不受影响
+    assert(mapped.saveBinaryMap(binaryFile));
+    assert(mapped.findPath(0, rows * cols - 1).found);
+    
+    std::ifstream in(binaryFile, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    
+    std::ostringstream errors;
+    std::streambuf* previous = std::cerr.rdbuf(errors.rdbuf());
+    
+    // 负载损坏：校验时加载失败，地图为空
+    const std::string corruptFile = "binary_test_corrupt.pmap";
+    {
+        std::string corrupt = bytes;
+        corrupt[corrupt.size() - 100] ^= 0x5a;
+        std::ofstream out(corruptFile, std::ios::binary);
+        out.write(corrupt.data(), static_cast<std::streamsize>(corrupt.size()));
+    }
+    MapEngine checked;
+    assert(!checked.loadMap(corruptFile));
+    assert(checked.getNodeCount() == 0);
+    
+    // 文件被截断：无论是否校验负载都拒绝加载
+    {
+        std::ofstream out(corruptFile, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    }
+    checked.setVerifyBinaryMap(false);
+    assert(!checked.loadMap(corruptFile));
+    std::cerr.rdbuf(previous);
+    assert(errors.str().find("数据校验失败") != std::string::npos);
+    assert(errors.str().find("不完整") != std::string::npos);
+    std::remove(corruptFile.c_str());
+    
+    // 稀疏ID的地图经转换后ID映射不变
+    const std::string sparseFile = "binary_test_sparse.txt";
+    {
+        std::ofstream out(sparseFile);
+        out << "5 1000000 3 1\n"
+            << "1000000 -7 4 2\n"
+            << "-7 5 10 1\n"
+            << "42\n";
+    }
+    assert(BinaryMap::convertTextMap(sparseFile, binaryFile, 2, true));
+    MapEngine sparse;
+    assert(sparse.loadMap(binaryFile));
+    assert(sparse.getNodeCount() == 4);
+    assert(sparse.isIsolated(42));
+    assert(sparse.hasLandmarks());
+    sparse.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+    PathResult result = sparse.findPath(5, -7);
+    assert(result.found && result.totalWeight == 7.0);
+    assert((result.path == std::vector<int>{5, 1000000, -7}));
+    assert(!sparse.findPath(5, 42).found);
+    assert(!sparse.findPath(5, 6).found);
+    
+    std::remove(sparseFile.c_str());
+    std::remove(textFile.c_str());
+    std::remove(binaryFile.c_str());
+    
+    std::cout << "网格 " << rows << "x" << cols << "：二进制地图 " << bytes.size() / 1024
+              << " KB，加载 " << std::chrono::duration<double, std::milli>(loadEnd - loadStart).count()
+              << " 毫秒" << std::endl;
+    
+    std::cout << "✓ 二进制地图快照测试通过" << std::endl;
+}
+
+void testGraphGenerator() {
+    std::cout << "【测试16】合成图生成器..." << std::endl;
+    
+    // 网格：节点和边数确定，连通，相同种子生成相同的图
+    Graph grid;
+    GraphGenerator::generateGrid(grid, 30, 40, 5u);
+    assert(grid.getNodeCount() == 1200);
+    assert(grid.getEdgeCount() == static_cast<size_t>(30 * 39 + 29 * 40));
+    PathFinder finder(grid);
+    assert(finder.findPath(0, 1199).found);
+    Graph sameGrid;
+    GraphGenerator::generateGrid(sameGrid, 30, 40, 5u);
+    assert(sameGrid.computeChecksum() == grid.computeChecksum());
+    Graph otherGrid;
+    GraphGenerator::generateGrid(otherGrid, 30, 40, 6u);
+    assert(otherGrid.computeChecksum() != grid.computeChecksum());
+    
+    // 随机几何图：平均度数接近期望值，边长为正
+    Graph geometric;
+    GraphGenerator::generateRandomGeometric(geometric, 5000, 6.0, 7u);
+    assert(geometric.getNodeCount() == 5000);
+    double averageDegree = 2.0 * geometric.getEdgeCount() / geometric.getNodeCount();
+    assert(averageDegree > 4.5 && averageDegree < 7.5);
+    for (size_t e = 0; e < 2 * geometric.getEdgeCount(); ++e) {
+        assert(geometric.getDistances()[e] > 0.0 && geometric.getTimes()[e] > 0.0);
+    }
+    
+    // 无标度图：边数确定，度数分布有明显的中心节点
+    Graph scaleFree;
+    GraphGenerator::generateScaleFree(scaleFree, 5000, 2, 9u);
+    assert(scaleFree.getNodeCount() == 5000);
+    assert(scaleFree.getEdgeCount() == static_cast<size_t>(3 + 2 * (5000 - 3)));
+    int maxDegree = 0;
+    for (size_t i = 0; i < scaleFree.getNodeCount(); ++i) {
+        maxDegree = std::max(maxDegree, scaleFree.getDegreeAt(static_cast<int>(i)));
+    }
+    assert(maxDegree > 20 * 4);
+    
+    // 查询负载：节点都存在，局部查询的终点在随机游走范围内
+    std::vector<std::pair<int, int>> local =
+        GraphGenerator::generateQueries(grid, 200, QueryWorkload::LOCAL, 3u, 8);
+    std::vector<std::pair<int, int>> random =
+        GraphGenerator::generateQueries(grid, 200, QueryWorkload::RANDOM, 3u);
+    assert(local.size() == 200 && random.size() == 200);
+    for (const auto& q : local) {
+        assert(grid.hasNode(q.first) && grid.hasNode(q.second));
+        int rowDelta = std::abs(q.first / 40 - q.second / 40);
+        int colDelta = std::abs(q.first % 40 - q.second % 40);
+        assert(rowDelta + colDelta <= 8);
+    }
+    
+    // 写出的文本地图重新加载后与原图完全相同
+    const std::string mapFile = "generator_test_map.txt";
+    assert(GraphGenerator::writeMap(geometric, mapFile));
+    Graph loaded;
+    DataLoader loader;
+    assert(loader.loadFromFile(mapFile, loaded));
+    std::remove(mapFile.c_str());
+    assert(loaded.computeChecksum() == geometric.computeChecksum());
+    
+    std::cout << "✓ 合成图生成器测试通过" << std::endl;
+}
+
+/**
+ * @brief 按随机键值依次出队，检查出队顺序单调且元素不丢失
+ */
+template <typename Queue>
+void checkQueueOrder(Queue& queue, unsigned seed) {
+    queue.reset(1000);
+    double last = 0.0;
+    size_t popped = 0;
+    for (int round = 0; round < 2000; ++round) {
+        seed = seed * 1103515245u + 12345u;
+        if (queue.empty() || (seed >> 16) % 3 != 0) {
+            // 键值不小于最近出队的键值（单调队列的要求）
+            int node = static_cast<int>((seed >> 8) % 1000);
+            queue.push(last + static_cast<double>((seed >> 4) % 500) / 7.0, node);
+        } else {
+            double top = queue.topKey();
+            HeapEntry entry = queue.pop();
+            assert(entry.key == top && entry.key >= last);
+            last = entry.key;
+            popped++;
+        }
+    }
+    while (!queue.empty()) {
+        HeapEntry entry = queue.pop();
+        assert(entry.key >= last);
+        last = entry.key;
+        popped++;
+    }
+    assert(popped > 0 && queue.getPeakSize() > 0);
+}
+
+void testPriorityQueues() {
+    std::cout << "【测试17】可替换的优先队列..." << std::endl;
+    
+    BinaryHeap binary;
+    QuaternaryHeap quaternary;
+    RadixHeap radix;
+    checkQueueOrder(binary, 3u);
+    checkQueueOrder(quaternary, 3u);
+    checkQueueOrder(radix, 3u);
+    
+    // 带下标的堆：同一节点只占一项，decrease-key 只接受更小的键值
+    quaternary.reset(10);
+    quaternary.push(5.0, 1);
+    quaternary.push(3.0, 2);
+    quaternary.push(1.0, 1);
+    quaternary.push(9.0, 2);
+    assert(quaternary.size() == 2 && quaternary.contains(1));
+    HeapEntry top = quaternary.pop();
+    assert(top.node == 1 && top.key == 1.0 && !quaternary.contains(1));
+    assert(quaternary.pop().key == 3.0 && quaternary.empty());
+    // 上次搜索残留的节点在 reset 后不再视为在堆中
+    quaternary.push(2.0, 7);
+    quaternary.reset(10);
+    assert(!quaternary.contains(7) && quaternary.getPeakSize() == 0);
+    
+    // 三种队列的搜索结果相同；带下标的堆队列更短
+    Graph grid;
+    buildGridGraph(grid, 80, 80, 23u);
+    Landmarks landmarks;
+    assert(landmarks.build(grid, 8, LandmarkSelection::AVOID));
+    PathFinder finder(grid);
+    finder.setLandmarks(&landmarks);
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                          SearchAlgorithm::ALT};
+    const QueueType queues[] = {QueueType::BINARY_HEAP, QueueType::DARY_HEAP, QueueType::RADIX_HEAP};
+    size_t peakSum[3] = {0, 0, 0};
+    unsigned seed = 41u;
+    for (int i = 0; i < 100; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % (80 * 80));
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % (80 * 80));
+        PathStrategy strategy = i % 2 ? PathStrategy::LEAST_TIME : PathStrategy::SHORTEST_DISTANCE;
+        double expected = referenceDijkstra(grid, from, to, strategy);
+        for (SearchAlgorithm algorithm : algorithms) {
+            for (int q = 0; q < 3; ++q) {
+                finder.setQueueType(queues[q]);
+                assert(finder.getQueueType() == queues[q]);
+                PathResult result = finder.findPath(from, to, strategy, algorithm);
+                assert(result.found);
+                assert(std::abs(result.totalWeight - expected) < 1e-6);
+                assert(isValidPath(grid, result, strategy));
+                peakSum[q] += result.peakQueueSize;
+            }
+        }
+    }
+    assert(peakSum[1] < peakSum[0]);
+    
+    // 引擎的队列设置在重新加载地图后保持
+    MapEngine engine;
+    engine.setQueueType(QueueType::RADIX_HEAP);
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(engine.getQueueType() == QueueType::RADIX_HEAP);
+    assert(engine.findPath(1, 5).totalWeight == 40.0);
+    assert(engine.buildLandmarks(2));
+    assert(engine.getQueueType() == QueueType::RADIX_HEAP);
+    
+    std::cout << "队列峰值长度之和：二叉堆 " << peakSum[0] << "，4叉堆 " << peakSum[1]
+              << "，基数堆 " << peakSum[2] << std::endl;
+    std::cout << "✓ 可替换的优先队列测试通过" << std::endl;
+}
+
+void testDistanceMatrix() {
+    std::cout << "【测试18】多对多距离矩阵..." << std::endl;
+    
+    Graph grid;
+    buildGridGraph(grid, 60, 60, 23u);
+    const int nodeCount = 60 * 60;
+    ContractionHierarchy hierarchies[2];
+    PathFinder finder(grid);
+    
+    unsigned seed = 31u;
+    std::vector<int> sources;
+    std::vector<int> targets;
+    for (int i = 0; i < 12; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        sources.push_back(static_cast<int>((seed >> 8) % nodeCount));
+    }
+    for (int i = 0; i < 15; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        targets.push_back(static_cast<int>((seed >> 8) % nodeCount));
+    }
+    // 重复的终点、与起点相同的终点和不存在的节点
+    targets.push_back(targets[0]);
+    targets.push_back(sources[3]);
+    targets.push_back(-7);
+    sources.push_back(123456);
+    
+    // 沿路径累计另一指标
+    auto otherAlongPath = [&grid](const PathResult& result, PathStrategy strategy) {
+        PathStrategy other = strategy == PathStrategy::SHORTEST_DISTANCE
+                                 ? PathStrategy::LEAST_TIME : PathStrategy::SHORTEST_DISTANCE;
+        double total = 0.0;
+        for (size_t i = 0; i + 1 < result.path.size(); ++i) {
+            for (const Edge& edge : grid.getAdjacentEdges(result.path[i])) {
+                if (edge.to == result.path[i + 1]) {
+                    total += edge.getWeight(other);
+                    break;
+                }
+            }
+        }
+        return total;
+    };
+    
+    ThreadPool pool(3);
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    for (int withHierarchy = 0; withHierarchy < 2; ++withHierarchy) {
+        if (withHierarchy) {
+            for (PathStrategy strategy : strategies) {
+                ContractionHierarchy& hierarchy = hierarchies[static_cast<int>(strategy)];
+                assert(hierarchy.build(grid, strategy));
+                finder.setContractionHierarchy(strategy, &hierarchy);
+            }
+        }
+        for (PathStrategy strategy : strategies) {
+            DistanceMatrix matrix = finder.distanceMatrix(sources, targets, strategy, true, &pool);
+            assert(matrix.rowCount == sources.size());
+            assert(matrix.columnCount == targets.size());
+            assert(matrix.weights.size() == sources.size() * targets.size());
+            assert(matrix.otherWeights.empty());
+            
+            DistanceMatrix full = finder.distanceMatrix(sources, targets, strategy, false);
+            assert(full.otherWeights.size() == full.weights.size());
+            
+            for (size_t i = 0; i < sources.size(); ++i) {
+                for (size_t j = 0; j < targets.size(); ++j) {
+                    if (!grid.hasNode(sources[i]) || !grid.hasNode(targets[j])) {
+                        assert(matrix.at(i, j) == DistanceMatrix::UNREACHABLE);
+                        assert(full.at(i, j) == DistanceMatrix::UNREACHABLE);
+                        continue;
+                    }
+                    double expected = referenceDijkstra(grid, sources[i], targets[j], strategy);
+                    assert(std::abs(matrix.at(i, j) - expected) < 1e-6);
+                    assert(std::abs(full.at(i, j) - expected) < 1e-6);
+                    
+                    // 另一指标与同一算法、同一队列找到的路径一致
+                    finder.setAlgorithm(SearchAlgorithm::DIJKSTRA);
+                    PathResult result = finder.findPath(sources[i], targets[j], strategy);
+                    double other = full.otherWeights[i * full.columnCount + j];
+                    assert(std::abs(other - otherAlongPath(result, strategy)) < 1e-6);
+                }
+            }
+            assert(matrix.at(3, targets.size() - 2) == 0.0);
+        }
+    }
+    
+    // 空输入
+    DistanceMatrix empty = finder.distanceMatrix(std::vector<int>(), targets,
+                                                 PathStrategy::SHORTEST_DISTANCE, true);
+    assert(empty.rowCount == 0 && empty.columnCount == targets.size() && empty.weights.empty());
+    
+    // 通过引擎（无收缩层次时为多目标 Dijkstra）
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    std::vector<int> ids = {1, 2, 3, 4, 5, 6, 7, 8};
+    DistanceMatrix small = engine.distanceMatrix(ids, ids, PathStrategy::SHORTEST_DISTANCE, false);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        for (size_t j = 0; j < ids.size(); ++j) {
+            PathResult result = engine.findPath(ids[i], ids[j], PathStrategy::SHORTEST_DISTANCE);
+            if (result.found) {
+                assert(std::abs(small.at(i, j) - result.totalWeight) < 1e-9);
+            } else {
+                assert(small.at(i, j) == DistanceMatrix::UNREACHABLE);
+            }
+        }
+    }
+    
+    // 矩阵与逐对查询的耗时对比（收缩层次已构建）
+    std::vector<int> many;
+    for (int i = 0; i < 50; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        many.push_back(static_cast<int>((seed >> 8) % nodeCount));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    DistanceMatrix table = finder.distanceMatrix(many, many, PathStrategy::SHORTEST_DISTANCE, true);
+    auto middle = std::chrono::high_resolution_clock::now();
+    finder.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+    for (size_t i = 0; i < many.size(); ++i) {
+        for (size_t j = 0; j < many.size(); ++j) {
+            PathResult result = finder.findPath(many[i], many[j], PathStrategy::SHORTEST_DISTANCE);
+            assert(std::abs(result.totalWeight - table.at(i, j)) < 1e-6);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "50x50 矩阵：桶式多对多 "
+              << std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count()
+              << " 微秒，逐对 CH 查询 "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count()
+              << " 微秒" << std::endl;
+    
+    std::cout << "✓ 多对多距离矩阵测试通过" << std::endl;
+}
+
+void testReachableWithin() {
+    std::cout << "【测试19】预算受限的可达范围搜索..." << std::endl;
+    
+    Graph grid;
+    buildGridGraph(grid, 30, 30, 37u);
+    const int nodeCount = 30 * 30;
+    PathFinder finder(grid);
+    const int depot = 15 * 30 + 15;
+    
+    const PathStrategy strategies[] = {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME};
+    const QueueType queueTypes[] = {QueueType::BINARY_HEAP, QueueType::DARY_HEAP,
+                                    QueueType::RADIX_HEAP};
+    std::vector<ReachableNode> table;
+    std::vector<int> nodes;
+    for (PathStrategy strategy : strategies) {
+        std::vector<double> expected(nodeCount);
+        for (int id = 0; id < nodeCount; ++id) {
+            expected[id] = referenceDijkstra(grid, depot, id, strategy);
+        }
+        const double budget = strategy == PathStrategy::SHORTEST_DISTANCE ? 400.0 : 200.0;
+        
+        for (QueueType queueType : queueTypes) {
+            finder.setQueueType(queueType);
+            assert(finder.reachableWithin(depot, budget, strategy, table));
+            assert(finder.reachableWithin(depot, budget, strategy, nodes));
+            assert(table.size() == nodes.size());
+            
+            size_t inBudget = 0;
+            for (int id = 0; id < nodeCount; ++id) {
+                if (expected[id] <= budget) {
+                    inBudget++;
+                }
+            }
+            assert(table.size() == inBudget);
+            assert(table.size() > 1 && table.size() < static_cast<size_t>(nodeCount));
+            
+            std::unordered_map<int, double> costs;
+            for (size_t i = 0; i < table.size(); ++i) {
+                const ReachableNode& entry = table[i];
+                assert(entry.node == nodes[i]);
+                assert(std::abs(entry.cost - expected[entry.node]) < 1e-9);
+                assert(i == 0 || table[i - 1].cost <= entry.cost);
+                costs[entry.node] = entry.cost;
+                
+                // 前驱先于节点确定，且代价相差一条边
+                if (entry.node == depot) {
+                    assert(entry.parent == depot && entry.cost == 0.0);
+                    continue;
+                }
+                assert(costs.count(entry.parent) == 1);
+                bool edgeFound = false;
+                for (const Edge& edge : grid.getAdjacentEdges(entry.parent)) {
+                    if (edge.to == entry.node &&
+                        std::abs(costs[entry.parent] + edge.getWeight(strategy) - entry.cost) < 1e-9) {
+                        edgeFound = true;
+                    }
+                }
+                assert(edgeFound);
+            }
+        }
+        
+        // 复用缓冲区时搜索不分配内存
+        size_t allocationsBefore = g_allocationCount.load();
+        assert(finder.reachableWithin(depot, budget, strategy, table));
+        assert(finder.reachableWithin(depot, budget, strategy, nodes));
+        assert(g_allocationCount.load() == allocationsBefore);
+    }
+    
+    // 边界情况
+    assert(finder.reachableWithin(depot, 0.0, PathStrategy::SHORTEST_DISTANCE, table));
+    assert(table.size() == 1 && table[0].node == depot);
+    assert(finder.reachableWithin(depot, -1.0, PathStrategy::SHORTEST_DISTANCE, table));
+    assert(table.empty());
+    assert(!finder.reachableWithin(-5, 100.0, PathStrategy::SHORTEST_DISTANCE, nodes));
+    assert(nodes.empty());
+    
+    // 通过引擎：孤立点只能到达自身
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(engine.reachableWithin(1, 1e9, PathStrategy::LEAST_TIME, nodes));
+    assert(std::find(nodes.begin(), nodes.end(), 5) != nodes.end());
+    assert(std::find(nodes.begin(), nodes.end(), 8) == nodes.end());
+    assert(engine.reachableWithin(8, 1e9, PathStrategy::LEAST_TIME, nodes));
+    assert(nodes.size() == 1 && nodes[0] == 8);
+    
+    std::cout << "✓ 预算受限的可达范围搜索测试通过" << std::endl;
+}
+
+void testComponentIndex() {
+    std::cout << "【测试20】连通分量索引..." << std::endl;
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(engine.componentOf(1) == 0);
+    for (int id = 2; id <= 7; ++id) {
+        assert(engine.componentOf(id) == engine.componentOf(1));
+    }
+    assert(engine.componentOf(8) == 1);
+    assert(engine.componentOf(99) == ComponentIndex::NO_COMPONENT);
+    assert(engine.getComponentSize(0) == 7);
+    assert(engine.getComponentSize(1) == 1);
+    assert(engine.getComponentSize(2) == 0);
+    ComponentStats stats = engine.getComponentStats();
+    assert(stats.componentCount == 2);
+    assert(stats.largestComponentSize == 7);
+    assert(stats.isolatedNodeCount == 1);
+    
+    // 两块互不相连的网格（大陆和岛屿）加一个孤立点
+    Graph graph;
+    buildGridGraph(graph, 80, 80, 41u);
+    const int islandBase = 100000;
+    for (int r = 0; r < 10; ++r) {
+        for (int c = 0; c < 10; ++c) {
+            int id = islandBase + r * 10 + c;
+            if (c + 1 < 10) {
+                graph.addEdge(id, id + 1, 5.0, 2.0);
+            }
+            if (r + 1 < 10) {
+                graph.addEdge(id, id + 10, 5.0, 2.0);
+            }
+        }
+    }
+    graph.addNode(-3);
+    graph.finalize();
+    
+    ComponentIndex components;
+    components.build(graph);
+    assert(components.getComponentCount() == 3);
+    assert(components.getComponentSize(0) == 80 * 80);
+    assert(components.getComponentSize(1) == 100);
+    assert(components.getComponentAt(graph.getIndex(0)) == 0);
+    assert(components.getComponentAt(graph.getIndex(islandBase + 55)) == 1);
+    assert(components.getComponentAt(graph.getIndex(-3)) == 2);
+    assert(components.getStats().isolatedNodeCount == 1);
+    
+    // 跨分量的查询不搜索即返回未找到；同一分量内结果不变
+    PathFinder plain(graph);
+    PathFinder indexed(graph);
+    indexed.setComponentIndex(&components);
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA};
+    for (SearchAlgorithm algorithm : algorithms) {
+        plain.setAlgorithm(algorithm);
+        indexed.setAlgorithm(algorithm);
+        PathResult slow = plain.findPath(0, islandBase + 55);
+        PathResult fast = indexed.findPath(0, islandBase + 55);
+        assert(!slow.found && !fast.found);
+        assert(slow.peakQueueSize > 0);
+        assert(fast.peakQueueSize == 0);
+        
+        PathResult expected = plain.findPath(0, 80 * 80 - 1);
+        PathResult actual = indexed.findPath(0, 80 * 80 - 1);
+        assert(actual.found && std::abs(actual.totalWeight - expected.totalWeight) < 1e-9);
+        assert(indexed.findPath(islandBase, islandBase + 99).found);
+    }
+    
+    // 距离矩阵只等待与起点连通的终点
+    std::vector<int> sources = {0, islandBase};
+    std::vector<int> targets = {80 * 80 - 1, islandBase + 99, -3};
+    DistanceMatrix matrix = indexed.distanceMatrix(sources, targets,
+                                                   PathStrategy::SHORTEST_DISTANCE, true);
+    assert(matrix.at(0, 0) < DistanceMatrix::UNREACHABLE);
+    assert(matrix.at(0, 1) == DistanceMatrix::UNREACHABLE);
+    assert(matrix.at(1, 0) == DistanceMatrix::UNREACHABLE);
+    assert(matrix.at(1, 1) == 5.0 * 18);
+    assert(matrix.at(0, 2) == DistanceMatrix::UNREACHABLE);
+    
+    std::cout << "✓ 连通分量索引测试通过" << std::endl;
+}
+
+void testResultCache() {
+    std::cout << "【测试21】查询结果缓存..." << std::endl;
+    
+    // 缓存本身：反向命中、CLOCK 淘汰、失效后丢弃旧代数的写入
+    PathCache cache(4, 1);
+    PathResult result;
+    result.path = {1, 2, 3};
+    result.totalWeight = 12.5;
+    result.found = true;
+    assert(!cache.lookup(1, 3, PathStrategy::SHORTEST_DISTANCE, result));
+    cache.insert(1, 3, PathStrategy::SHORTEST_DISTANCE, result, cache.getGeneration());
+    
+    PathResult cached;
+    assert(cache.lookup(1, 3, PathStrategy::SHORTEST_DISTANCE, cached));
+    assert(cached.path == result.path && cached.totalWeight == 12.5);
+    assert(cache.lookup(3, 1, PathStrategy::SHORTEST_DISTANCE, cached));
+    assert((cached.path == std::vector<int>{3, 2, 1}));
+    assert(!cache.lookup(1, 3, PathStrategy::LEAST_TIME, cached));
+    
+    for (int i = 10; i < 14; ++i) {
+        cache.insert(i, i + 1, PathStrategy::LEAST_TIME, result, cache.getGeneration());
+    }
+    PathCacheStats stats = cache.getStats();
+    assert(stats.size == 4 && stats.capacity == 4);
+    assert(stats.evictions == 1);
+    assert(stats.hits == 2 && stats.misses == 2);
+    // 被引用过的 (1, 3) 在第一轮扫描中保留
+    assert(cache.lookup(1, 3, PathStrategy::SHORTEST_DISTANCE, cached));
+    
+    uint64_t generation = cache.getGeneration();
+    cache.invalidate();
+    assert(cache.getStats().size == 0 && cache.getStats().invalidations == 1);
+    cache.insert(5, 6, PathStrategy::SHORTEST_DISTANCE, result, generation);
+    assert(!cache.lookup(5, 6, PathStrategy::SHORTEST_DISTANCE, cached));
+    
+    // 通过引擎
+    MapEngine engine;
+    assert(engine.getResultCacheStats().capacity == 0);
+    engine.setResultCacheCapacity(1000);
+    assert(engine.loadMap("data/test_data.txt"));
+    PathResult first = engine.findPath(1, 5, PathStrategy::SHORTEST_DISTANCE);
+    PathResult second = engine.findPath(1, 5, PathStrategy::SHORTEST_DISTANCE);
+    PathResult reversed = engine.findPath(5, 1, PathStrategy::SHORTEST_DISTANCE);
+    assert(first.found && second.totalWeight == first.totalWeight && second.path == first.path);
+    assert(reversed.totalWeight == first.totalWeight);
+    assert(reversed.path.front() == 5 && reversed.path.back() == 1);
+    stats = engine.getResultCacheStats();
+    assert(stats.hits == 2 && stats.misses == 1 && stats.size == 1);
+    
+    // 重新加载地图后缓存失效
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(engine.getResultCacheStats().size == 0);
+    engine.findPath(1, 5, PathStrategy::SHORTEST_DISTANCE);
+    assert(engine.getResultCacheStats().misses == 2);
+    
+    // 偏斜负载：少数热点查询占大部分请求，多线程并发，结果与不带缓存时一致
+    std::string gridFile = "test_cache_grid.txt";
+    writeGridMap(gridFile, 60, 60, 29u);
+    MapEngine plain;
+    assert(plain.loadMap(gridFile));
+    assert(engine.loadMap(gridFile));
+    engine.setResultCacheCapacity(64);
+    engine.setThreadCount(4);
+    
+    std::vector<std::pair<int, int>> queries;
+    unsigned seed = 17u;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from;
+        int to;
+        if ((seed >> 8) % 10 < 8) {
+            // 8 个热点起终点对，随机方向
+            int hot = static_cast<int>((seed >> 12) % 8);
+            from = hot * 401 % 3600;
+            to = (hot * 977 + 1800) % 3600;
+            if ((seed >> 20) & 1) {
+                std::swap(from, to);
+            }
+        } else {
+            from = static_cast<int>((seed >> 4) % 3600);
+            seed = seed * 1103515245u + 12345u;
+            to = static_cast<int>((seed >> 4) % 3600);
+        }
+        queries.emplace_back(from, to);
+    }
+    std::vector<PathResult> results = engine.findPaths(queries);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        PathResult expected = plain.findPath(queries[i].first, queries[i].second);
+        assert(results[i].found == expected.found);
+        assert(std::abs(results[i].totalWeight - expected.totalWeight) < 1e-9);
+        assert(results[i].path.front() == queries[i].first);
+        assert(results[i].path.back() == queries[i].second);
+    }
+    stats = engine.getResultCacheStats();
+    assert(stats.hits + stats.misses == queries.size());
+    assert(stats.hits >= queries.size() / 2);
+    assert(stats.evictions > 0 && stats.size <= 64 + 16);
+    std::cout << "2000 次偏斜查询：命中 " << stats.hits << "，未命中 " << stats.misses
+              << "，淘汰 " << stats.evictions << std::endl;
+    
+    engine.clearResultCache();
+    assert(engine.getResultCacheStats().size == 0);
+    engine.setResultCacheCapacity(0);
+    assert(engine.findPath(1, 2).found);
+    assert(engine.getResultCacheStats().hits == 0);
+    std::remove(gridFile.c_str());
+    
+    std::cout << "✓ 查询结果缓存测试通过" << std::endl;
+}
+
+void testLiveWeightUpdates() {
+    std::cout << "【测试22】实时边权重更新..." << std::endl;
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    engine.setResultCacheCapacity(100);
+    PathResult before = engine.findPath(1, 4, PathStrategy::LEAST_TIME);
+    assert(before.found && before.totalWeight == 14.0);
+    std::shared_ptr<const MapSnapshot> oldSnapshot = engine.getSnapshot();
+    
+    // 1-2-3-4 的时间变长后改走 1-3-4
+    assert(engine.updateEdgeTime(2, 3, 50.0));
+    PathResult after = engine.findPath(1, 4, PathStrategy::LEAST_TIME);
+    assert(after.found && after.totalWeight == 14.0);
+    assert(engine.updateEdgeTime(3, 1, 40.0));
+    after = engine.findPath(4, 1, PathStrategy::LEAST_TIME);
+    assert(after.found && after.totalWeight == 17.0);
+    assert((after.path == std::vector<int>{4, 2, 1}));
+    // 距离不变，旧快照仍然看到旧权重
+    assert(engine.findPath(1, 4, PathStrategy::SHORTEST_DISTANCE).totalWeight == 25.0);
+    assert(oldSnapshot->findPath(1, 4, PathStrategy::LEAST_TIME, SearchAlgorithm::DIJKSTRA)
+               .totalWeight == 14.0);
+    assert(engine.getResultCacheStats().invalidations == 2);
+    
+    // 无效更新
+    assert(!engine.updateEdgeTime(1, 8, 5.0));
+    assert(!engine.updateEdgeTime(1, 99, 5.0));
+    assert(!engine.updateEdgeTime(1, 2, -1.0));
+    assert(!engine.updateEdgeTime(1, 2, std::numeric_limits<double>::infinity()));
+    std::vector<EdgeTimeUpdate> mixed = {{1, 2, 6.0}, {7, 8, 1.0}, {5, 6, 3.0}};
+    assert(engine.applyWeightUpdates(mixed) == 2);
+    assert(engine.getComponentStats().componentCount == 2);
+    
+    // 网格上带地标表和收缩层次，与参考实现比较（先只增加，再有减小）
+    std::string gridFile = "test_traffic_grid.txt";
+    writeGridMap(gridFile, 50, 50, 43u);
+    assert(engine.loadMap(gridFile));
+    assert(engine.buildLandmarks(8, LandmarkSelection::AVOID));
+    assert(engine.buildContractionHierarchies());
+    const Landmarks* originalLandmarks = engine.getSnapshot()->getLandmarks();
+    const ContractionHierarchy* distanceHierarchy =
+        engine.getSnapshot()->getContractionHierarchy(PathStrategy::SHORTEST_DISTANCE);
+    
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                          SearchAlgorithm::ALT,
+                                          SearchAlgorithm::CONTRACTION_HIERARCHY};
+    unsigned seed = 47u;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 8;
+    };
+    for (int round = 0; round < 4; ++round) {
+        // 一批随机路段的时间变化：前两轮只增加，后两轮也有减小
+        std::vector<EdgeTimeUpdate> updates;
+        std::unordered_map<int, bool> used;
+        const Graph& graph = engine.getSnapshot()->getGraph();
+        while (updates.size() < 300) {
+            int id = static_cast<int>(nextRandom() % 2500);
+            int neighbor = (id % 50 + 1 < 50) ? id + 1 : id - 1;
+            // 同一条边在一批中只出现一次
+            if (used[std::min(id, neighbor)]) {
+                continue;
+            }
+            used[std::min(id, neighbor)] = true;
+            double current = 0.0;
+            for (const Edge& edge : graph.getAdjacentEdges(id)) {
+                if (edge.to == neighbor) {
+                    current = edge.time;
+                }
+            }
+            double factor = round < 2 ? 1.0 + (nextRandom() % 300) / 100.0
+                                      : 0.2 + (nextRandom() % 200) / 100.0;
+            updates.push_back({id, neighbor, current * factor});
+        }
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        assert(engine.applyWeightUpdates(updates) == updates.size());
+        auto end = std::chrono::high_resolution_clock::now();
+        // 新时间立即发布。第一批时收缩得到的时间层次撤下，在后台转换为可定制的层次，
+        // 其间的查询使用 ALT 或双向搜索；之后每批与新时间一起增量定制，不再撤下。
+        // 有减小时地标时间表先缩放后使用，后台重新计算；结果始终精确
+        std::shared_ptr<const MapSnapshot> published = engine.getSnapshot();
+        engine.waitForCustomization();
+        std::shared_ptr<const MapSnapshot> customized = engine.getSnapshot();
+        assert(&published->getGraph() == &customized->getGraph());
+        assert(round == 0 || published->getContractionHierarchy(PathStrategy::LEAST_TIME));
+        assert(customized->getContractionHierarchy(PathStrategy::LEAST_TIME)->isCustomizable());
+        
+        // 只增加时地标表保持不变，有减小时重新计算时间表；距离策略的层次始终共享
+        assert((published->getLandmarks() == originalLandmarks) == (round < 2));
+        assert((customized->getLandmarks() == originalLandmarks) == (round < 2));
+        // 后台可能在取得 published 之前就已发布重新计算的时间表
+        assert((published->getLandmarks()->getScale(PathStrategy::LEAST_TIME) < 1.0) ==
+               (round >= 2 && published != customized));
+        assert(published->getLandmarks()->sharesDistanceTable(*originalLandmarks));
+        assert(customized->getLandmarks()->getScale(PathStrategy::LEAST_TIME) == 1.0);
+        assert(customized->getLandmarks()->hasTable(PathStrategy::LEAST_TIME));
+        assert(customized->getContractionHierarchy(PathStrategy::SHORTEST_DISTANCE) ==
+               distanceHierarchy);
+        std::cout << "第 " << round + 1 << " 批 300 条更新："
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " 毫秒" << std::endl;
+        
+        for (int i = 0; i < 40; ++i) {
+            int from = static_cast<int>(nextRandom() % 2500);
+            int to = static_cast<int>(nextRandom() % 2500);
+            double expected = referenceDijkstra(customized->getGraph(), from, to,
+                                                PathStrategy::LEAST_TIME);
+            for (const std::shared_ptr<const MapSnapshot>& snapshot : {published, customized}) {
+                for (SearchAlgorithm algorithm : algorithms) {
+                    PathResult result = snapshot->findPath(from, to, PathStrategy::LEAST_TIME,
+                                                           algorithm);
+                    assert(result.found);
+                    assert(std::abs(result.totalWeight - expected) < 1e-6 * (1.0 + expected));
+                    assert(isValidPath(snapshot->getGraph(), result, PathStrategy::LEAST_TIME));
+                }
+            }
+        }
+    }
+    
+    // 同一条边在一批中更新多次：地标时间表按最终时间与原时间之比缩放，缩放后的下界仍然有效
+    {
+        std::vector<EdgeTimeUpdate> updates;
+        const Graph& graph = engine.getSnapshot()->getGraph();
+        for (int id = 0; id < 2500; id += 7) {
+            int neighbor = (id % 50 + 1 < 50) ? id + 1 : id - 1;
+            double current = 0.0;
+            for (const Edge& edge : graph.getAdjacentEdges(id)) {
+                if (edge.to == neighbor) {
+                    current = edge.time;
+                }
+            }
+            updates.push_back({id, neighbor, current * 0.5});
+            updates.push_back({neighbor, id, current * 0.25});
+        }
+        assert(engine.applyWeightUpdates(updates) == updates.size());
+        std::shared_ptr<const MapSnapshot> snapshot = engine.getSnapshot();
+        // 后台可能已经发布重新计算的时间表
+        double scale = snapshot->getLandmarks()->getScale(PathStrategy::LEAST_TIME);
+        assert(scale == 1.0 || scale <= 0.25 + 1e-12);
+        for (int i = 0; i < 100; ++i) {
+            int from = static_cast<int>(nextRandom() % 2500);
+            int to = static_cast<int>(nextRandom() % 2500);
+            PathResult expected = snapshot->findPath(from, to, PathStrategy::LEAST_TIME,
+                                                     SearchAlgorithm::DIJKSTRA);
+            PathResult result = snapshot->findPath(from, to, PathStrategy::LEAST_TIME,
+                                                   SearchAlgorithm::ALT);
+            assert(std::abs(result.totalWeight - expected.totalWeight) <
+                   1e-9 * (1.0 + expected.totalWeight));
+        }
+        engine.waitForCustomization();
+    }
+    
+    // 撤下时间层次和地标时间表的快照：CONTRACTION_HIERARCHY 退化为双向搜索，ALT 退化为 Dijkstra
+    {
+        std::shared_ptr<const MapSnapshot> snapshot = engine.getSnapshot();
+        std::shared_ptr<const MapSnapshot> degraded =
+            snapshot->withContractionHierarchy(PathStrategy::LEAST_TIME, nullptr)
+                    ->withLandmarks(Landmarks::withoutTimes(snapshot->getSharedLandmarks()));
+        assert(degraded->getLandmarks()->hasTable(PathStrategy::SHORTEST_DISTANCE));
+        assert(!degraded->getLandmarks()->hasTable(PathStrategy::LEAST_TIME));
+        PathResult expected = snapshot->findPath(7, 2400, PathStrategy::LEAST_TIME,
+                                                 SearchAlgorithm::DIJKSTRA);
+        for (SearchAlgorithm algorithm : algorithms) {
+            PathResult result = degraded->findPath(7, 2400, PathStrategy::LEAST_TIME, algorithm);
+            assert(std::abs(result.totalWeight - expected.totalWeight) < 1e-9);
+        }
+    }
+    
+    // 查询与更新并发：每个查询都在一个快照上完成，路径权重与该快照的权重一致
+    std::atomic<bool> stop(false);
+    std::atomic<int> checked(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&engine, &stop, &checked, t]() {
+            unsigned local = 100u + t;
+            while (!stop.load()) {
+                local = local * 1103515245u + 12345u;
+                int from = static_cast<int>((local >> 8) % 2500);
+                local = local * 1103515245u + 12345u;
+                int to = static_cast<int>((local >> 8) % 2500);
+                std::shared_ptr<const MapSnapshot> snapshot = engine.getSnapshot();
+                PathResult result = snapshot->findPath(from, to, PathStrategy::LEAST_TIME,
+                                                       SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA);
+                assert(isValidPath(snapshot->getGraph(), result, PathStrategy::LEAST_TIME));
+                checked++;
+            }
+        });
+    }
+    for (int batch = 0; batch < 5; ++batch) {
+        std::vector<EdgeTimeUpdate> updates;
+        for (int i = 0; i < 100; ++i) {
+            int id = static_cast<int>(nextRandom() % 2450);
+            updates.push_back({id, id + 50, 1.0 + nextRandom() % 100});
+        }
+        assert(engine.applyWeightUpdates(updates) == updates.size());
+    }
+    stop.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    assert(checked.load() > 0);
+    
+    // 持续更新：层次重新由收缩得到，第一批后在后台转换，期间的更新在发布前补齐，
+    // 更新不停止时层次也会回来，之后每个快照上的层次都与该快照的时间一致
+    assert(engine.buildContractionHierarchies());
+    stop.store(false);
+    std::atomic<int> batches(0);
+    std::thread writer([&engine, &stop, &batches]() {
+        unsigned local = 7u;
+        while (!stop.load()) {
+            std::vector<EdgeTimeUpdate> updates;
+            for (int i = 0; i < 20; ++i) {
+                local = local * 1103515245u + 12345u;
+                int id = static_cast<int>((local >> 8) % 2450);
+                local = local * 1103515245u + 12345u;
+                updates.push_back({id, id + 50, 1.0 + (local >> 8) % 100});
+            }
+            assert(engine.applyWeightUpdates(updates) == updates.size());
+            batches++;
+        }
+    });
+    while (batches.load() == 0) {
+        std::this_thread::yield();
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!engine.hasContractionHierarchy(PathStrategy::LEAST_TIME)) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    int streamed = batches.load();
+    for (int i = 0; i < 30; ++i) {
+        std::shared_ptr<const MapSnapshot> current = engine.getSnapshot();
+        assert(current->getContractionHierarchy(PathStrategy::LEAST_TIME) != nullptr);
+        int from = static_cast<int>(nextRandom() % 2500);
+        int to = static_cast<int>(nextRandom() % 2500);
+        double expected = referenceDijkstra(current->getGraph(), from, to, PathStrategy::LEAST_TIME);
+        PathResult result = current->findPath(from, to, PathStrategy::LEAST_TIME,
+                                              SearchAlgorithm::CONTRACTION_HIERARCHY);
+        assert(std::abs(result.totalWeight - expected) < 1e-6 * (1.0 + expected));
+    }
+    stop.store(true);
+    writer.join();
+    std::cout << "持续更新：第 " << streamed << " 批时层次已恢复，共 " << batches.load() << " 批"
+              << std::endl;
+    
+    // 连续几批更新之后，层次与最终的时间一致
+    engine.waitForCustomization();
+    std::shared_ptr<const MapSnapshot> snapshot = engine.getSnapshot();
+    assert(snapshot->getContractionHierarchy(PathStrategy::LEAST_TIME) != nullptr);
+    for (int i = 0; i < 20; ++i) {
+        int from = static_cast<int>(nextRandom() % 2500);
+        int to = static_cast<int>(nextRandom() % 2500);
+        double expected = referenceDijkstra(snapshot->getGraph(), from, to, PathStrategy::LEAST_TIME);
+        PathResult result = snapshot->findPath(from, to, PathStrategy::LEAST_TIME,
+                                               SearchAlgorithm::CONTRACTION_HIERARCHY);
+        assert(std::abs(result.totalWeight - expected) < 1e-6 * (1.0 + expected));
+    }
+    
+    // 等待定制时重新加载地图：过时的定制结果不会发布到新地图上
+    assert(engine.buildContractionHierarchies());
+    assert(engine.updateEdgeTime(0, 1, 1000.0));
+    assert(engine.loadMap(gridFile));
+    engine.waitForCustomization();
+    assert(!engine.hasContractionHierarchy(PathStrategy::LEAST_TIME) && !engine.hasLandmarks());
+    std::remove(gridFile.c_str());
+    
+    std::cout << "✓ 实时边权重更新测试通过" << std::endl;
+}
+
+/**
+ * @brief 不声明线性系数的自定义策略（搜索内核逐条边调用虚函数）
+ */
+class ScenicStrategy : public Strategy {
+public:
+    ScenicStrategy(double alpha, double beta) : alpha_(alpha), beta_(beta) {}
+    
+    double calculateWeight(double distance, double time) const override {
+        return alpha_ * distance + beta_ * time;
+    }
+    
+    const char* getName() const override {
+        return "Scenic";
+    }
+    
+private:
+    double alpha_;
+    double beta_;
+};
+
+/**
+ * @brief 参考实现：按策略对象计算边权重的 Dijkstra
+ */
+double referenceStrategyDijkstra(const Graph& graph, int from, int to, const Strategy& strategy) {
+    std::unordered_map<int, double> dist;
+    typedef std::pair<double, int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    dist[from] = 0.0;
+    pq.push(Item(0.0, from));
+    while (!pq.empty()) {
+        Item current = pq.top();
+        pq.pop();
+        if (current.first > dist[current.second]) {
+            continue;
+        }
+        if (current.second == to) {
+            return current.first;
+        }
+        for (const Edge& edge : graph.getAdjacentEdges(current.second)) {
+            int v = edge.to;
+            double newDist = current.first + strategy.calculateWeight(edge.distance, edge.time);
+            auto it = dist.find(v);
+            if (it == dist.end() || newDist < it->second) {
+                dist[v] = newDist;
+                pq.push(Item(newDist, v));
+            }
+        }
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+void testCustomStrategies() {
+    std::cout << "【测试23】自定义代价策略..." << std::endl;
+    
+    Graph grid;
+    buildGridGraph(grid, 80, 80, 53u);
+    PathFinder finder(grid);
+    LinearCombinationStrategy mixed("Mixed", 0.3, 2.0);
+    ScenicStrategy scenic(0.3, 2.0);
+    LinearCombinationStrategy distanceOnly("Distance", 1.0, 0.0);
+    
+    unsigned seed = 59u;
+    double inlinedTime = 0.0;
+    double virtualTime = 0.0;
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA};
+    for (int i = 0; i < 60; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 6400);
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % 6400);
+        double expected = referenceStrategyDijkstra(grid, from, to, mixed);
+        for (SearchAlgorithm algorithm : algorithms) {
+            PathResult linear = finder.findPath(from, to, mixed, algorithm);
+            PathResult generic = finder.findPath(from, to, scenic, algorithm);
+            assert(linear.found && generic.found);
+            assert(std::abs(linear.totalWeight - expected) < 1e-6 * (1.0 + expected));
+            assert(std::abs(generic.totalWeight - expected) < 1e-6 * (1.0 + expected));
+            assert(linear.path.front() == from && linear.path.back() == to);
+            inlinedTime += static_cast<double>(linear.elapsedMicroseconds);
+            virtualTime += static_cast<double>(generic.elapsedMicroseconds);
+        }
+        
+        // 与内置策略系数相同的组合走内置策略
+        PathResult builtIn = finder.findPath(from, to, PathStrategy::SHORTEST_DISTANCE,
+                                             SearchAlgorithm::DIJKSTRA);
+        PathResult same = finder.findPath(from, to, distanceOnly, SearchAlgorithm::DIJKSTRA);
+        assert(same.totalWeight == builtIn.totalWeight && same.path == builtIn.path);
+    }
+    std::cout << "120 次查询：线性组合（内联） " << inlinedTime / 120
+              << " 微秒/次，虚函数策略 " << virtualTime / 120 << " 微秒/次" << std::endl;
+    
+    // 通过引擎注册和按名称查询
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    assert(engine.registerLinearStrategy("Eco", 0.5, 1.0));
+    assert(!engine.registerLinearStrategy("Bad", -1.0, 1.0));
+    assert(!engine.registerLinearStrategy("Zero", 0.0, 0.0));
+    assert(!engine.registerStrategy(nullptr));
+    assert(engine.registerStrategy(std::make_shared<ScenicStrategy>(1.0, 1.0)));
+    assert(engine.getRegisteredStrategy("Eco") != nullptr);
+    assert(engine.getRegisteredStrategy("Bad") == nullptr);
+    
+    PathResult eco = engine.findPath(1, 4, std::string("Eco"));
+    assert(eco.found);
+    Graph small;
+    DataLoader loader;
+    assert(loader.loadFromFile("data/test_data.txt", small));
+    LinearCombinationStrategy ecoReference("Eco", 0.5, 1.0);
+    assert(std::abs(eco.totalWeight - referenceStrategyDijkstra(small, 1, 4, ecoReference)) < 1e-9);
+    PathResult scenicResult = engine.findPath(1, 5, std::string("Scenic"));
+    assert(scenicResult.found);
+    assert(std::abs(scenicResult.totalWeight -
+                    referenceStrategyDijkstra(small, 1, 5, ScenicStrategy(1.0, 1.0))) < 1e-9);
+    
+    // 未注册的策略和注销
+    assert(!engine.findPath(1, 4, std::string("Unknown")).found);
+    assert(engine.unregisterStrategy("Eco"));
+    assert(!engine.unregisterStrategy("Eco"));
+    assert(!engine.findPath(1, 4, std::string("Eco")).found);
+    
+    std::cout << "✓ 自定义代价策略测试通过" << std::endl;
+}
+
+/**
+ * @brief 参考实现：枚举所有简单路径，返回 (距离, 时间) 的 Pareto 前沿（距离递增）
+ */
+std::vector<std::pair<double, double>> referenceParetoFrontier(const Graph& graph, int from, int to) {
+    std::vector<std::pair<double, double>> all;
+    std::vector<bool> onPath(graph.getNodeCount(), false);
+    std::function<void(int, double, double)> walk = [&](int u, double distance, double time) {
+        if (u == graph.getIndex(to)) {
+            all.emplace_back(distance, time);
+            return;
+        }
+        onPath[u] = true;
+        for (int e = graph.getOffsets()[u]; e < graph.getOffsets()[u + 1]; ++e) {
+            int v = graph.getTargets()[e];
+            if (!onPath[v]) {
+                walk(v, distance + graph.getDistances()[e], time + graph.getTimes()[e]);
+            }
+        }
+        onPath[u] = false;
+    };
+    walk(graph.getIndex(from), 0.0, 0.0);
+    
+    std::sort(all.begin(), all.end());
+    std::vector<std::pair<double, double>> frontier;
+    for (const auto& point : all) {
+        if (frontier.empty() || point.second < frontier.back().second) {
+            frontier.push_back(point);
+        }
+    }
+    return frontier;
+}
+
+/**
+ * @brief 校验 Pareto 路线：路径合法、长度与时间和路径一致，前沿距离递增、时间递减
+ */
+void checkParetoRoutes(const Graph& graph, const ParetoResult& result, int from, int to) {
+    for (size_t i = 0; i < result.routes.size(); ++i) {
+        const ParetoRoute& route = result.routes[i];
+        assert(route.path.front() == from && route.path.back() == to);
+        double distance = 0.0;
+        double time = 0.0;
+        for (size_t k = 0; k + 1 < route.path.size(); ++k) {
+            int u = graph.getIndex(route.path[k]);
+            int v = graph.getIndex(route.path[k + 1]);
+            int edge = -1;
+            for (int e = graph.getOffsets()[u]; e < graph.getOffsets()[u + 1]; ++e) {
+                if (graph.getTargets()[e] == v) {
+                    edge = e;
+                    break;
+                }
+            }
+            assert(edge != -1);
+            distance += graph.getDistances()[edge];
+            time += graph.getTimes()[edge];
+        }
+        assert(std::abs(distance - route.distance) < 1e-9);
+        assert(std::abs(time - route.time) < 1e-9);
+        if (i > 0) {
+            assert(route.distance > result.routes[i - 1].distance);
+            assert(route.time < result.routes[i - 1].time);
+        }
+    }
+}
+
+void testParetoPaths() {
+    std::cout << "【测试24】双目标 Pareto 路线..." << std::endl;
+    
+    // 小网格上与枚举全部简单路径的结果比较
+    Graph small;
+    buildGridGraph(small, 4, 5, 61u);
+    PathFinder smallFinder(small);
+    const int smallPairs[][2] = {{0, 19}, {4, 15}, {2, 17}, {6, 13}};
+    for (const auto& pair : smallPairs) {
+        ParetoResult result = smallFinder.findParetoPaths(pair[0], pair[1]);
+        assert(result.complete);
+        checkParetoRoutes(small, result, pair[0], pair[1]);
+        std::vector<std::pair<double, double>> expected =
+            referenceParetoFrontier(small, pair[0], pair[1]);
+        assert(result.routes.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(std::abs(result.routes[i].distance - expected[i].first) < 1e-9);
+            assert(std::abs(result.routes[i].time - expected[i].second) < 1e-9);
+        }
+    }
+    
+    // 较大网格：前沿两端分别是最短路线和最快路线
+    Graph grid;
+    buildGridGraph(grid, 30, 30, 67u);
+    PathFinder finder(grid);
+    unsigned seed = 71u;
+    size_t totalRoutes = 0;
+    double totalTime = 0.0;
+    for (int i = 0; i < 20; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 900);
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % 900);
+        if (from == to) {
+            continue;
+        }
+        ParetoResult result = finder.findParetoPaths(from, to);
+        assert(result.complete && !result.routes.empty());
+        checkParetoRoutes(grid, result, from, to);
+        PathResult shortest = finder.findPath(from, to, PathStrategy::SHORTEST_DISTANCE);
+        PathResult fastest = finder.findPath(from, to, PathStrategy::LEAST_TIME);
+        assert(std::abs(result.routes.front().distance - shortest.totalWeight) < 1e-9);
+        assert(std::abs(result.routes.back().time - fastest.totalWeight) < 1e-9);
+        totalRoutes += result.routes.size();
+        totalTime += static_cast<double>(result.elapsedMicroseconds);
+    }
+    std::cout << "30x30 网格：平均前沿 " << totalRoutes / 20.0 << " 条路线，"
+              << totalTime / 20.0 << " 微秒/次" << std::endl;
+    
+    // 标签数上限：结果标记为不完整，已给出的路线仍然合法
+    ParetoResult capped = finder.findParetoPaths(0, 899, 50);
+    assert(!capped.complete);
+    assert(capped.labelCount <= 50);
+    checkParetoRoutes(grid, capped, 0, 899);
+    
+    // 特殊情况
+    ParetoResult same = finder.findParetoPaths(5, 5);
+    assert(same.routes.size() == 1 && same.routes[0].path == std::vector<int>{5});
+    assert(same.routes[0].distance == 0.0 && same.routes[0].time == 0.0);
+    assert(finder.findParetoPaths(0, 100000).routes.empty());
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    ParetoResult viaEngine = engine.findParetoPaths(1, 5);
+    assert(!viaEngine.routes.empty());
+    assert(std::abs(viaEngine.routes.front().distance -
+                    engine.findPath(1, 5, PathStrategy::SHORTEST_DISTANCE).totalWeight) < 1e-9);
+    assert(std::abs(viaEngine.routes.back().time -
+                    engine.findPath(1, 5, PathStrategy::LEAST_TIME).totalWeight) < 1e-9);
+    
+    std::cout << "✓ 双目标 Pareto 路线测试通过" << std::endl;
+}
+
+/**
+ * @brief 参考实现：枚举所有简单路径的代价，升序
+ */
+std::vector<double> referenceSimplePathCosts(const Graph& graph, int from, int to,
+                                             PathStrategy strategy) {
+    std::vector<double> costs;
+    std::vector<bool> onPath(graph.getNodeCount(), false);
+    const double* weights = graph.getWeights(strategy);
+    std::function<void(int, double)> walk = [&](int u, double cost) {
+        if (u == graph.getIndex(to)) {
+            costs.push_back(cost);
+            return;
+        }
+        onPath[u] = true;
+        for (int e = graph.getOffsets()[u]; e < graph.getOffsets()[u + 1]; ++e) {
+            if (!onPath[graph.getTargets()[e]]) {
+                walk(graph.getTargets()[e], cost + weights[e]);
+            }
+        }
+        onPath[u] = false;
+    };
+    walk(graph.getIndex(from), 0.0);
+    std::sort(costs.begin(), costs.end());
+    return costs;
+}
+
+/**
+ * @brief 校验 k 条路径：简单、互不相同、代价与路径一致且非降序
+ */
+void checkKShortestPaths(const Graph& graph, const std::vector<PathResult>& paths,
+                         int from, int to, PathStrategy strategy) {
+    const double* weights = graph.getWeights(strategy);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const PathResult& result = paths[i];
+        assert(result.found);
+        assert(result.path.front() == from && result.path.back() == to);
+        std::vector<int> sorted = result.path;
+        std::sort(sorted.begin(), sorted.end());
+        assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        double cost = 0.0;
+        for (size_t k = 0; k + 1 < result.path.size(); ++k) {
+            int u = graph.getIndex(result.path[k]);
+            int v = graph.getIndex(result.path[k + 1]);
+            double best = std::numeric_limits<double>::infinity();
+            for (int e = graph.getOffsets()[u]; e < graph.getOffsets()[u + 1]; ++e) {
+                if (graph.getTargets()[e] == v) {
+                    best = std::min(best, weights[e]);
+                }
+            }
+            assert(best != std::numeric_limits<double>::infinity());
+            cost += best;
+        }
+        assert(std::abs(cost - result.totalWeight) < 1e-9 * (1.0 + cost));
+        for (size_t j = 0; j < i; ++j) {
+            assert(paths[j].path != result.path);
+        }
+        if (i > 0) {
+            assert(result.totalWeight >= paths[i - 1].totalWeight - 1e-9);
+        }
+    }
+}
+
+void testKShortestPaths() {
+    std::cout << "【测试25】前 k 条最短简单路径..." << std::endl;
+    
+    // 小网格上与枚举全部简单路径的代价比较
+    Graph small;
+    buildGridGraph(small, 4, 5, 73u);
+    PathFinder smallFinder(small);
+    const int smallPairs[][2] = {{0, 19}, {3, 16}, {7, 12}};
+    const QueueType queues[] = {QueueType::BINARY_HEAP, QueueType::DARY_HEAP,
+                                QueueType::RADIX_HEAP};
+    for (const auto& pair : smallPairs) {
+        for (PathStrategy strategy : {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME}) {
+            std::vector<double> expected = referenceSimplePathCosts(small, pair[0], pair[1], strategy);
+            for (QueueType queue : queues) {
+                smallFinder.setQueueType(queue);
+                std::vector<PathResult> paths =
+                    smallFinder.findKShortestPaths(pair[0], pair[1], 12, strategy);
+                assert(paths.size() == std::min<size_t>(12, expected.size()));
+                checkKShortestPaths(small, paths, pair[0], pair[1], strategy);
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    assert(std::abs(paths[i].totalWeight - expected[i]) < 1e-9);
+                }
+            }
+        }
+    }
+    
+    // 路径不足 k 条时返回全部简单路径
+    Graph line;
+    line.addEdge(1, 2, 1.0, 1.0);
+    line.addEdge(2, 3, 1.0, 1.0);
+    line.addEdge(1, 3, 5.0, 1.0);
+    line.finalize();
+    PathFinder lineFinder(line);
+    std::vector<PathResult> all = lineFinder.findKShortestPaths(1, 3, 10,
+                                                               PathStrategy::SHORTEST_DISTANCE);
+    assert(all.size() == 2);
+    assert(all[0].path == std::vector<int>({1, 2, 3}) && all[1].path == std::vector<int>({1, 3}));
+    
+    // 较大网格：第一条与单条最短路径一致，k 增大时结果是前缀
+    Graph grid;
+    buildGridGraph(grid, 60, 60, 79u);
+    PathFinder finder(grid);
+    unsigned seed = 83u;
+    double totalTime = 0.0;
+    for (int i = 0; i < 20; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 3600);
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % 3600);
+        if (from == to) {
+            continue;
+        }
+        std::vector<PathResult> paths = finder.findKShortestPaths(from, to, 10,
+                                                                  PathStrategy::LEAST_TIME);
+        assert(paths.size() == 10);
+        checkKShortestPaths(grid, paths, from, to, PathStrategy::LEAST_TIME);
+        PathResult single = finder.findPath(from, to, PathStrategy::LEAST_TIME);
+        assert(std::abs(paths[0].totalWeight - single.totalWeight) < 1e-9);
+        std::vector<PathResult> fewer = finder.findKShortestPaths(from, to, 4,
+                                                                  PathStrategy::LEAST_TIME);
+        assert(fewer.size() == 4);
+        for (size_t k = 0; k < fewer.size(); ++k) {
+            assert(std::abs(fewer[k].totalWeight - paths[k].totalWeight) < 1e-9);
+        }
+        totalTime += static_cast<double>(paths.back().elapsedMicroseconds);
+    }
+    std::cout << "60x60 网格 k=10: " << totalTime / 20 << " 微秒/次" << std::endl;
+    
+    // 特殊情况
+    assert(finder.findKShortestPaths(0, 100000, 3, PathStrategy::LEAST_TIME).empty());
+    assert(finder.findKShortestPaths(0, 5, 0, PathStrategy::LEAST_TIME).empty());
+    std::vector<PathResult> same = finder.findKShortestPaths(7, 7, 3, PathStrategy::LEAST_TIME);
+    assert(same.size() == 1 && same[0].path == std::vector<int>{7});
+    
+    MapEngine engine;
+    assert(engine.loadMap("data/test_data.txt"));
+    std::vector<PathResult> viaEngine =
+        engine.findKShortestPaths(1, 5, 3, PathStrategy::SHORTEST_DISTANCE);
+    assert(!viaEngine.empty());
+    assert(std::abs(viaEngine[0].totalWeight -
+                    engine.findPath(1, 5, PathStrategy::SHORTEST_DISTANCE).totalWeight) < 1e-9);
+    
+    std::cout << "✓ 前 k 条最短简单路径测试通过" << std::endl;
+}
+
+/**
+ * @brief 按外部ID比较两张图：节点集合相同，每个节点的邻接边（邻居ID、距离、时间）依次相同
+ */
+bool sameGraphById(const Graph& a, const Graph& b) {
+    if (a.getNodeCount() != b.getNodeCount() || a.getEdgeCount() != b.getEdgeCount()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.getNodeCount(); ++i) {
+        int id = a.getNodeId(static_cast<int>(i));
+        EdgeRange edgesA = a.getAdjacentEdges(id);
+        EdgeRange edgesB = b.getAdjacentEdges(id);
+        if (!b.hasNode(id) || edgesA.size() != edgesB.size()) {
+            return false;
+        }
+        for (size_t k = 0; k < edgesA.size(); ++k) {
+            if (edgesA[k].to != edgesB[k].to ||
+                edgesA[k].distance != edgesB[k].distance || edgesA[k].time != edgesB[k].time) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void testNodeReordering() {
+    std::cout << "【测试26】缓存局部性节点重排..." << std::endl;
+    
+    // 随机几何图的节点按随机位置生成，原始顺序没有局部性
+    Graph original;
+    GraphGenerator::generateRandomGeometric(original, 4000, 6.0, 89u);
+    double originalSpan = NodeOrdering::averageEdgeSpan(original);
+    PathFinder originalFinder(original);
+    
+    const NodeOrder orders[] = {NodeOrder::BFS, NodeOrder::RCM};
+    for (NodeOrder order : orders) {
+        Graph reordered;
+        GraphGenerator::generateRandomGeometric(reordered, 4000, 6.0, 89u);
+        std::vector<int> permutation = NodeOrdering::computeOrder(reordered, order);
+        std::vector<int> sorted = permutation;
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            assert(sorted[i] == static_cast<int>(i));
+        }
+        assert(NodeOrdering::apply(reordered, order));
+        assert(sameGraphById(original, reordered));
+        double span = NodeOrdering::averageEdgeSpan(reordered);
+        std::cout << NodeOrdering::getName(order) << "：平均边跨度 " << originalSpan << " -> "
+                  << span << std::endl;
+        assert(span * 4 < originalSpan);
+        
+        // 查询结果按外部ID表示，与重排前一致
+        PathFinder finder(reordered);
+        unsigned seed = 97u;
+        for (int i = 0; i < 50; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            int from = static_cast<int>((seed >> 8) % 4000);
+            seed = seed * 1103515245u + 12345u;
+            int to = static_cast<int>((seed >> 8) % 4000);
+            PathResult expected = originalFinder.findPath(from, to, PathStrategy::LEAST_TIME);
+            PathResult actual = finder.findPath(from, to, PathStrategy::LEAST_TIME);
+            assert(expected.found == actual.found);
+            if (actual.found) {
+                assert(std::abs(expected.totalWeight - actual.totalWeight) < 1e-9);
+                assert(isValidPath(original, actual, PathStrategy::LEAST_TIME));
+            }
+        }
+    }
+    
+    // 无效的排列被拒绝，图保持不变
+    Graph small;
+    small.addEdge(10, 20, 1.0, 2.0);
+    small.addEdge(20, 30, 3.0, 4.0);
+    assert(!small.reorder({2, 1, 0}));
+    small.finalize();
+    assert(!small.reorder({0, 0, 1}));
+    assert(!small.reorder({0, 1}));
+    assert(small.getIndex(10) == 0 && small.getIndex(30) == 2);
+    assert(small.reorder({2, 1, 0}));
+    assert(small.getIndex(10) == 2 && small.getIndex(30) == 0);
+    assert(small.getNodeId(0) == 30);
+    
+    NodeOrder parsed = NodeOrder::ORIGINAL;
+    assert(NodeOrdering::parse("rcm", parsed) && parsed == NodeOrder::RCM);
+    assert(!NodeOrdering::parse("random", parsed));
+    
+    // 引擎加载文本地图时重排，预处理和查询透明地使用新顺序
+    const std::string mapFile = "reorder_test_map.txt";
+    assert(GraphGenerator::writeMap(original, mapFile));
+    MapEngine engine;
+    engine.setNodeOrder(NodeOrder::RCM);
+    assert(engine.getNodeOrder() == NodeOrder::RCM);
+    assert(engine.loadMap(mapFile));
+    assert(NodeOrdering::averageEdgeSpan(engine.getSnapshot()->getGraph()) * 4 < originalSpan);
+    assert(engine.buildLandmarks(4));
+    engine.buildContractionHierarchies();
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA, SearchAlgorithm::ALT,
+                                          SearchAlgorithm::CONTRACTION_HIERARCHY};
+    unsigned seed = 101u;
+    for (int i = 0; i < 30; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 4000);
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % 4000);
+        PathResult expected = originalFinder.findPath(from, to, PathStrategy::SHORTEST_DISTANCE);
+        for (SearchAlgorithm algorithm : algorithms) {
+            engine.setAlgorithm(algorithm);
+            PathResult actual = engine.findPath(from, to, PathStrategy::SHORTEST_DISTANCE);
+            assert(expected.found == actual.found);
+            if (actual.found) {
+                assert(std::abs(expected.totalWeight - actual.totalWeight) < 1e-6);
+                assert(isValidPath(original, actual, PathStrategy::SHORTEST_DISTANCE));
+            }
+        }
+    }
+    std::remove(mapFile.c_str());
+    
+    std::cout << "✓ 缓存局部性节点重排测试通过" << std::endl;
+}
+
+void testSearchMetrics() {
+    std::cout << "【测试27】搜索计数器与聚合指标..." << std::endl;
+    
+    Graph grid;
+    buildGridGraph(grid, 60, 60, 103u);
+    PathFinder finder(grid);
+    ContractionHierarchy hierarchy;
+    assert(hierarchy.build(grid, PathStrategy::SHORTEST_DISTANCE));
+    finder.setContractionHierarchy(PathStrategy::SHORTEST_DISTANCE, &hierarchy);
+    
+    // 每种算法和队列的计数器满足基本关系；双向搜索和收缩层次确定的节点更少
+    const QueueType queues[] = {QueueType::BINARY_HEAP, QueueType::DARY_HEAP,
+                                QueueType::RADIX_HEAP};
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                          SearchAlgorithm::CONTRACTION_HIERARCHY};
+    for (QueueType queue : queues) {
+        finder.setQueueType(queue);
+        uint64_t settled[3] = {0, 0, 0};
+        unsigned seed = 107u;
+        for (int i = 0; i < 30; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            int from = static_cast<int>((seed >> 8) % 3600);
+            seed = seed * 1103515245u + 12345u;
+            int to = static_cast<int>((seed >> 8) % 3600);
+            for (int a = 0; a < 3; ++a) {
+                PathResult result = finder.findPath(from, to, PathStrategy::SHORTEST_DISTANCE,
+                                                    algorithms[a]);
+                assert(result.found);
+                const SearchStats& stats = result.stats;
+                if (!SearchStats::ENABLED || from == to) {
+                    assert(stats.settledNodes == 0 && stats.relaxedEdges == 0);
+                    continue;
+                }
+                assert(stats.settledNodes > 0 && stats.settledNodes <= 2 * grid.getNodeCount());
+                assert(stats.relaxedEdges > 0 && stats.heapPushes + 2 >= stats.settledNodes);
+                assert(stats.heapPushes <= stats.relaxedEdges);
+                if (queue == QueueType::DARY_HEAP && algorithms[a] != SearchAlgorithm::CONTRACTION_HIERARCHY) {
+                    assert(stats.stalePops == 0);
+                }
+                settled[a] += stats.settledNodes;
+            }
+        }
+        if (SearchStats::ENABLED) {
+            assert(settled[1] < settled[0] && settled[2] < settled[1]);
+        }
+    }
+    
+    // 直方图的分桶和百分位
+    QueryMetrics metrics;
+    PathResult sample;
+    const int64_t latencies[] = {0, 1, 2, 3, 900, 1000000};
+    for (int64_t latency : latencies) {
+        sample.elapsedMicroseconds = latency;
+        metrics.record(sample);
+    }
+    MetricsSnapshot local = metrics.snapshot();
+    assert(local.queries == 6 && local.latency.count == 6);
+    assert(local.latency.sum == 1000906);
+    assert(local.latency.counts[0] == 1 && local.latency.counts[1] == 1 &&
+           local.latency.counts[2] == 1 && local.latency.counts[3] == 1);
+    assert(local.latency.percentile(0.5) == 2.0);
+    assert(local.latency.percentile(0.8) == 1024.0);
+    assert(local.latency.percentile(1.0) == 1048576.0);
+    metrics.reset();
+    assert(metrics.snapshot().queries == 0 && metrics.snapshot().latency.count == 0);
+    
+    // 引擎聚合：单次查询和批量查询（多线程）都被记录
+    const std::string gridFile = "metrics_test_grid.txt";
+    writeGridMap(gridFile, 40, 40, 109u);
+    MapEngine engine;
+    assert(engine.loadMap(gridFile));
+    engine.setThreadCount(4);
+    std::vector<std::pair<int, int>> queries;
+    unsigned seed = 113u;
+    for (int i = 0; i < 200; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 1600);
+        seed = seed * 1103515245u + 12345u;
+        queries.emplace_back(from, static_cast<int>((seed >> 8) % 1600));
+    }
+    uint64_t expectedSettled = 0;
+    for (size_t i = 0; i < 20; ++i) {
+        expectedSettled += engine.findPath(queries[i].first, queries[i].second).stats.settledNodes;
+    }
+    for (const PathResult& result : engine.findPaths(queries)) {
+        expectedSettled += result.stats.settledNodes;
+    }
+    engine.findPath(1, 99999);
+    MetricsSnapshot snapshot = engine.getMetrics();
+    assert(snapshot.queries == 221 && snapshot.foundQueries == 220);
+    assert(snapshot.latency.count == 221 && snapshot.settledNodes.count == 221);
+    assert(snapshot.totals.settledNodes == expectedSettled);
+    assert(snapshot.settledNodes.sum == expectedSettled);
+    
+    // Prometheus 文本：计数器、累积的桶和 +Inf 桶
+    std::string text = engine.getMetricsText();
+    assert(text.find("# TYPE path_planning_queries_total counter\npath_planning_queries_total 221\n") !=
+           std::string::npos);
+    assert(text.find("# TYPE path_planning_query_latency_microseconds histogram") != std::string::npos);
+    assert(text.find("path_planning_query_settled_nodes_bucket{le=\"+Inf\"} 221\n") != std::string::npos);
+    assert(text.find("path_planning_query_settled_nodes_count 221\n") != std::string::npos);
+    std::istringstream lines(text);
+    std::string line;
+    uint64_t previous = 0;
+    size_t bucketLines = 0;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 43, "path_planning_query_latency_microseconds_bu") == 0) {
+            uint64_t value = std::stoull(line.substr(line.rfind(' ') + 1));
+            assert(value >= previous);
+            previous = value;
+            bucketLines++;
+        }
+    }
+    assert(bucketLines == static_cast<size_t>(QueryMetrics::BUCKET_COUNT) && previous == 221);
+    
+    // 缓存命中也记为一次查询，没有搜索计数；关闭聚合后不再记录
+    engine.resetMetrics();
+    engine.setResultCacheCapacity(64);
+    engine.findPath(queries[0].first, queries[0].second);
+    PathResult hit = engine.findPath(queries[0].first, queries[0].second);
+    assert(hit.stats.settledNodes == 0);
+    assert(engine.getMetrics().queries == 2);
+    engine.setMetricsEnabled(false);
+    engine.findPath(queries[1].first, queries[1].second);
+    assert(engine.getMetrics().queries == 2);
+    std::remove(gridFile.c_str());
+    
+    std::cout << "✓ 搜索计数器与聚合指标测试通过" << std::endl;
+}
+
+/**
+ * @brief 检查最短路径树：距离与顺序 Dijkstra 相同，前驱满足 d(p) + w(p, v) == d(v) 且无环
+ */
+void checkShortestPathTree(const Graph& graph, const double* weights, const ShortestPathTree& tree,
+                           const std::vector<ReachableNode>& reference) {
+    const int n = static_cast<int>(graph.getNodeCount());
+    const int* offsets = graph.getOffsets();
+    const int* targets = graph.getTargets();
+    assert(static_cast<int>(tree.distances.size()) == n && static_cast<int>(tree.parents.size()) == n);
+    size_t reached = 0;
+    for (int v = 0; v < n; ++v) {
+        if (tree.parents[v] >= 0) {
+            reached++;
+        } else {
+            assert(tree.distances[v] == ShortestPathTree::UNREACHABLE);
+        }
+    }
+    assert(reached == reference.size());
+    for (const ReachableNode& item : reference) {
+        int v = graph.getIndex(item.node);
+        assert(tree.distances[v] == item.cost);
+        if (v == tree.source) {
+            assert(tree.parents[v] == v && tree.distances[v] == 0.0);
+            continue;
+        }
+        int p = tree.parents[v];
+        bool tight = false;
+        for (int e = offsets[p]; e < offsets[p + 1]; ++e) {
+            tight = tight || (targets[e] == v && tree.distances[p] + weights[e] == tree.distances[v]);
+        }
+        assert(tight);
+        int steps = 0;
+        for (int u = v; u != tree.source; u = tree.parents[u]) {
+            assert(++steps <= n);
+        }
+    }
+}
+
+void testDeltaStepping() {
+    std::cout << "【测试28】并行 delta-stepping 最短路径树..." << std::endl;
+    
+    // 网格加随机弦：含零权重边、轻边和重边，另有一个不连通的分量
+    Graph graph;
+    unsigned seed = 127u;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % 1000u;
+    };
+    const int rows = 60;
+    const int cols = 60;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int id = r * cols + c;
+            for (int neighbor : {c + 1 < cols ? id + 1 : -1, r + 1 < rows ? id + cols : -1}) {
+                if (neighbor < 0) {
+                    continue;
+                }
+                unsigned w = next();
+                double distance = w % 10 == 0 ? 0.0 : (w < 900 ? 1.0 + w % 50 : 200.0 + w);
+                graph.addEdge(id, neighbor, distance, 1.0 + w % 7);
+            }
+        }
+    }
+    for (int i = 0; i < 200; ++i) {
+        int a = static_cast<int>(next() * 1000u + next()) % (rows * cols);
+        int b = static_cast<int>(next() * 1000u + next()) % (rows * cols);
+        if (a != b) {
+            graph.addEdge(a, b, 1.0 + next() % 500, 1.0 + next() % 60);
+        }
+    }
+    graph.addEdge(90000, 90001, 5.0, 5.0);
+    graph.finalize();
+    
+    PathFinder finder(graph);
+    ThreadPool pool(4);
+    ShortestPathTree tree;
+    std::vector<ReachableNode> reference;
+    const double deltas[] = {0.0, 1e-6, 0.5, 3.0, 50.0, 1e9};
+    for (PathStrategy strategy : {PathStrategy::SHORTEST_DISTANCE, PathStrategy::LEAST_TIME}) {
+        const double* weights = graph.getWeights(strategy);
+        for (int from : {0, 1234, rows * cols - 1}) {
+            assert(finder.reachableWithin(from, std::numeric_limits<double>::infinity(), strategy,
+                                          reference));
+            for (double delta : deltas) {
+                for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+                    assert(finder.shortestPathTree(from, strategy, delta, tree, threads));
+                    assert(tree.source == graph.getIndex(from) && tree.delta > 0.0);
+                    assert(delta <= 0.0 || tree.delta >= delta);
+                    checkShortestPathTree(graph, weights, tree, reference);
+                }
+                // 固定线程数时前驱（含距离相同时的选择）是确定的
+                std::vector<int> parents = tree.parents;
+                assert(finder.shortestPathTree(from, strategy, delta, tree, &pool));
+                assert(tree.parents == parents);
+            }
+        }
+    }
+    
+    // 不连通分量内的起点只到达同一分量；不存在的起点返回 false
+    assert(finder.shortestPathTree(90001, PathStrategy::SHORTEST_DISTANCE, 0.0, tree, &pool));
+    assert(tree.distances[graph.getIndex(90000)] == 5.0);
+    assert(tree.parents[graph.getIndex(90000)] == graph.getIndex(90001));
+    assert(tree.parents[0] == -1 && tree.distances[0] == ShortestPathTree::UNREACHABLE);
+    assert(!finder.shortestPathTree(123456, PathStrategy::SHORTEST_DISTANCE, 0.0, tree, &pool));
+    
+    // 引擎：使用批量查询的线程池，下标属于快照的图
+    const std::string gridFile = "delta_stepping_test_grid.txt";
+    writeGridMap(gridFile, 50, 50, 131u);
+    MapEngine engine;
+    assert(engine.loadMap(gridFile));
+    engine.setThreadCount(3);
+    std::shared_ptr<const MapSnapshot> snapshot = engine.getSnapshot();
+    assert(engine.shortestPathTree(17, PathStrategy::LEAST_TIME, tree));
+    assert(snapshot->reachableWithin(17, std::numeric_limits<double>::infinity(),
+                                     PathStrategy::LEAST_TIME, reference));
+    checkShortestPathTree(snapshot->getGraph(), snapshot->getGraph().getWeights(PathStrategy::LEAST_TIME),
+                          tree, reference);
+    assert(!engine.shortestPathTree(99999, PathStrategy::LEAST_TIME, tree));
+    std::remove(gridFile.c_str());
+    
+    std::cout << "✓ 并行 delta-stepping 最短路径树测试通过" << std::endl;
+}
+
+void testPathArena() {
+    std::cout << "【测试29】路径缓冲区与只求距离的查询..." << std::endl;
+    
+    // 缓冲区：地址在 clear() 之前不变，超过块大小的路径单独占一块，clear() 后复用已有的块
+    PathArena small(8);
+    int* first = small.allocate(5);
+    int* second = small.allocate(5);
+    int* large = small.allocate(20);
+    assert(second != first + 5 && small.size() == 30);
+    for (int i = 0; i < 20; ++i) {
+        large[i] = i;
+    }
+    size_t memory = small.getMemoryUsage();
+    small.clear();
+    assert(small.size() == 0 && small.allocate(5) == first && small.allocate(5) == second);
+    assert(small.allocate(20) == large && small.getMemoryUsage() == memory);
+    
+    Graph grid;
+    buildGridGraph(grid, 50, 50, 137u);
+    Landmarks landmarks;
+    assert(landmarks.build(grid, 8, LandmarkSelection::AVOID));
+    ContractionHierarchy hierarchy;
+    assert(hierarchy.build(grid, PathStrategy::LEAST_TIME));
+    PathFinder finder(grid);
+    finder.setLandmarks(&landmarks);
+    finder.setContractionHierarchy(PathStrategy::LEAST_TIME, &hierarchy);
+    
+    // 各算法和队列：写入缓冲区的路径与 vector 路径相同，只求距离的结果与完整查询的权重相同
+    std::vector<std::pair<int, int>> queries = {{3, 3}, {0, 2499}, {7, 99999}};
+    unsigned seed = 139u;
+    for (int i = 0; i < 40; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 2500);
+        seed = seed * 1103515245u + 12345u;
+        queries.emplace_back(from, static_cast<int>((seed >> 8) % 2500));
+    }
+    const SearchAlgorithm algorithms[] = {SearchAlgorithm::DIJKSTRA,
+                                          SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA,
+                                          SearchAlgorithm::ALT,
+                                          SearchAlgorithm::CONTRACTION_HIERARCHY};
+    PathArena arena(64);
+    for (QueueType queue : {QueueType::BINARY_HEAP, QueueType::DARY_HEAP, QueueType::RADIX_HEAP}) {
+        finder.setQueueType(queue);
+        for (SearchAlgorithm algorithm : algorithms) {
+            arena.clear();
+            std::vector<PathResult> expected;
+            std::vector<PathResult> spans;
+            for (const std::pair<int, int>& query : queries) {
+                expected.push_back(finder.findPath(query.first, query.second,
+                                                   PathStrategy::LEAST_TIME, algorithm));
+                spans.push_back(finder.findPath(query.first, query.second,
+                                                PathStrategy::LEAST_TIME, algorithm, arena));
+                PathResult distance = finder.findDistance(query.first, query.second,
+                                                          PathStrategy::LEAST_TIME, algorithm);
+                assert(distance.found == expected.back().found);
+                assert(distance.totalWeight == expected.back().totalWeight);
+                assert(distance.path.empty() && distance.span.empty());
+            }
+            // 之后的查询不影响之前写入缓冲区的路径
+            for (size_t i = 0; i < queries.size(); ++i) {
+                assert(spans[i].found == expected[i].found);
+                assert(spans[i].totalWeight == expected[i].totalWeight);
+                assert(spans[i].path.empty() && spans[i].span.toVector() == expected[i].path);
+            }
+        }
+    }
+    assert(finder.findPath(3, 3, PathStrategy::LEAST_TIME, SearchAlgorithm::DIJKSTRA, arena).span.size == 1);
+    
+    // 引擎批量查询：结果与返回 vector 的批量查询相同；复用 PathBatch 时缓冲区不再增长
+    const std::string gridFile = "arena_test_grid.txt";
+    writeGridMap(gridFile, 40, 40, 149u);
+    MapEngine engine;
+    assert(engine.loadMap(gridFile));
+    engine.setThreadCount(4);
+    engine.setAlgorithm(SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA);
+    std::vector<std::pair<int, int>> batchQueries;
+    for (int i = 0; i < 1000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 1600);
+        seed = seed * 1103515245u + 12345u;
+        batchQueries.emplace_back(from, static_cast<int>((seed >> 8) % 1600));
+    }
+    batchQueries.emplace_back(5, 99999);
+    std::vector<PathResult> expected = engine.findPaths(batchQueries);
+    PathBatch batch;
+    engine.resetMetrics();
+    for (int round = 0; round < 2; ++round) {
+        size_t arenaMemory = batch.getArenaMemoryUsage();
+        engine.findPaths(batchQueries.data(), batchQueries.size(), batch);
+        assert(batch.size() == batchQueries.size());
+        assert(round == 0 || batch.getArenaMemoryUsage() == arenaMemory);
+        for (size_t i = 0; i < batchQueries.size(); ++i) {
+            assert(batch[i].found == expected[i].found);
+            assert(batch[i].totalWeight == expected[i].totalWeight);
+            assert(batch[i].path.empty() && batch[i].span.toVector() == expected[i].path);
+        }
+    }
+    engine.findPaths(batchQueries.data(), batchQueries.size(), batch, true);
+    for (size_t i = 0; i < batchQueries.size(); ++i) {
+        assert(batch[i].found == expected[i].found && batch[i].totalWeight == expected[i].totalWeight);
+        assert(batch[i].span.empty() && batch[i].path.empty());
+    }
+    PathResult distance = engine.findDistance(batchQueries[0].first, batchQueries[0].second);
+    assert(distance.totalWeight == expected[0].totalWeight && distance.path.empty());
+    assert(engine.getMetrics().queries == 3 * batchQueries.size() + 1);
+    engine.findPaths(batchQueries.data(), 0, batch);
+    assert(batch.size() == 0);
+    std::remove(gridFile.c_str());
+    
+    std::cout << "✓ 路径缓冲区与只求距离的查询测试通过" << std::endl;
+}
+
+void testQueryServer() {
+    std::cout << "【测试30】流式查询服务..." << std::endl;
+    
+    const std::string gridFile = "server_test_grid.txt";
+    writeGridMap(gridFile, 30, 30, 151u);
+    MapEngine engine;
+    assert(engine.loadMap(gridFile));
+    engine.setThreadCount(2);
+    engine.setAlgorithm(SearchAlgorithm::BIDIRECTIONAL_DIJKSTRA);
+    
+    // 查询输入：可选的策略、空行、注释、格式错误的行，最后一行没有换行符
+    std::vector<PathQuery> queries;
+    std::string input;
+    unsigned seed = 157u;
+    for (int i = 0; i < 300; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 900);
+        seed = seed * 1103515245u + 12345u;
+        int to = static_cast<int>((seed >> 8) % 900);
+        PathStrategy strategy = i % 3 == 1 ? PathStrategy::LEAST_TIME : PathStrategy::SHORTEST_DISTANCE;
+        queries.emplace_back(from, to, strategy);
+        input += std::to_string(from) + (i % 2 ? "\t" : " ") + std::to_string(to);
+        input += i % 3 == 1 ? " time" : (i % 3 == 2 ? " distance \r" : "");
+        input += "\n";
+        if (i % 50 == 0) {
+            input += "\n# 注释\n  \n1 2 fastest\n1\n1 2x\n";
+        }
+    }
+    queries.emplace_back(3, 99999, PathStrategy::SHORTEST_DISTANCE);
+    input += "3 99999";
+    
+    // 文本输出：每个查询一行，按输入顺序，与单次查询的结果相同；批大小不影响输出
+    std::string textOutput;
+    for (size_t batchSize : {size_t(1), size_t(7), QueryServer::DEFAULT_BATCH_SIZE}) {
+        QueryServer server(engine);
+        server.setBatchSize(batchSize);
+        std::istringstream in(input);
+        std::ostringstream out;
+        ServerStats stats = server.run(in, out);
+        assert(stats.queries == queries.size() && stats.errors == 3 * 6);
+        assert(batchSize != 1 || stats.batches == queries.size());
+        if (textOutput.empty()) {
+            textOutput = out.str();
+        }
+        assert(out.str() == textOutput);
+    }
+    std::istringstream lines(textOutput);
+    std::string line;
+    size_t found = 0;
+    for (const PathQuery& query : queries) {
+        assert(std::getline(lines, line));
+        std::istringstream fields(line);
+        int from = 0;
+        int to = 0;
+        double weight = 0.0;
+        fields >> from >> to >> weight;
+        std::vector<int> path((std::istream_iterator<int>(fields)), std::istream_iterator<int>());
+        PathResult expected = engine.findPath(query.from, query.to, query.strategy);
+        assert(from == query.from && to == query.to && path == expected.path);
+        assert(expected.found ? weight == expected.totalWeight : weight == -1.0);
+        found += expected.found ? 1 : 0;
+    }
+    assert(!std::getline(lines, line));
+    
+    // 二进制输出、只输出距离、默认策略
+    QueryServer server(engine);
+    server.setFormat(ServerFormat::BINARY);
+    server.setDistancesOnly(true);
+    server.setDefaultStrategy(PathStrategy::LEAST_TIME);
+    std::istringstream in(input);
+    std::ostringstream out;
+    ServerStats stats = server.run(in, out);
+    assert(stats.queries == queries.size() && stats.found == found);
+    std::string binary = out.str();
+    size_t offset = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        int32_t from = 0;
+        int32_t to = 0;
+        uint8_t ok = 0;
+        double weight = 0.0;
+        uint32_t nodes = 0;
+        std::memcpy(&from, binary.data() + offset, sizeof(from));
+        std::memcpy(&to, binary.data() + offset + 4, sizeof(to));
+        std::memcpy(&ok, binary.data() + offset + 8, sizeof(ok));
+        std::memcpy(&weight, binary.data() + offset + 9, sizeof(weight));
+        std::memcpy(&nodes, binary.data() + offset + 17, sizeof(nodes));
+        offset += 21 + nodes * sizeof(int32_t);
+        // 没有给出策略的行使用默认策略
+        PathStrategy strategy = i % 3 == 0 && i < 300 ? PathStrategy::LEAST_TIME : queries[i].strategy;
+        PathResult expected = engine.findPath(queries[i].from, queries[i].to, strategy);
+        assert(from == queries[i].from && to == queries[i].to && nodes == 0);
+        assert(ok == (expected.found ? 1 : 0));
+        assert(expected.found ? weight == expected.totalWeight : weight == -1.0);
+    }
+    assert(offset == binary.size());
+    
+    // 空输入
+    std::istringstream empty("");
+    std::ostringstream emptyOut;
+    stats = server.run(empty, emptyOut);
+    assert(stats.queries == 0 && stats.batches == 0 && emptyOut.str().empty());
+    ServerFormat format = ServerFormat::TEXT;
+    assert(QueryServer::parseFormat("binary", format) && format == ServerFormat::BINARY);
+    assert(!QueryServer::parseFormat("json", format) && format == ServerFormat::BINARY);
+    std::remove(gridFile.c_str());
+    
+    std::cout << "✓ 流式查询服务测试通过" << std::endl;
+}
+
+void testHotReload() {
+    std::cout << "【测试31】后台热重载地图..." << std::endl;
+    
+    // 无锁发布槽：并发读取总能读到某个已发布的值，且读到的值不会倒退
+    RcuSlot<const int> slot(std::make_shared<const int>(0));
+    std::atomic<bool> writing(true);
+    std::atomic<int> slotErrors(0);
+    std::vector<std::thread> slotReaders;
+    for (int t = 0; t < 3; ++t) {
+        slotReaders.emplace_back([&]() {
+            int last = 0;
+            while (writing.load()) {
+                std::shared_ptr<const int> value = slot.load();
+                if (!value || *value < last) {
+                    slotErrors++;
+                }
+                last = value ? *value : last;
+            }
+        });
+    }
+    for (int i = 1; i <= 2000; ++i) {
+        std::shared_ptr<const int> old = slot.exchange(std::make_shared<const int>(i));
+        assert(old && *old == i - 1);
+    }
+    writing = false;
+    for (std::thread& reader : slotReaders) {
+        reader.join();
+    }
+    assert(slotErrors == 0 && *slot.load() == 2000);
+    
+    // 两张地图：节点 0..399 在两张图中都存在，权重不同
+    const std::string oldFile = "reload_test_old.txt";
+    const std::string newFile = "reload_test_new.txt";
+    writeGridMap(oldFile, 20, 20, 163u);
+    writeGridMap(newFile, 30, 30, 167u);
+    std::vector<std::pair<int, int>> queries;
+    unsigned seed = 173u;
+    for (int i = 0; i < 200; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int from = static_cast<int>((seed >> 8) % 400);
+        seed = seed * 1103515245u + 12345u;
+        queries.emplace_back(from, static_cast<int>((seed >> 8) % 400));
+    }
+    MapEngine oldReference;
+    MapEngine newReference;
+    assert(oldReference.loadMap(oldFile) && newReference.loadMap(newFile));
+    std::vector<double> oldWeights;
+    std::vector<double> newWeights;
+    for (const std::pair<int, int>& query : queries) {
+        oldWeights.push_back(oldReference.findPath(query.first, query.second).totalWeight);
+        newWeights.push_back(newReference.findPath(query.first, query.second).totalWeight);
+    }
+    
+    MapEngine engine;
+    assert(engine.loadMap(oldFile));
+    assert(engine.buildLandmarks(4) && engine.buildContractionHierarchies());
+    engine.setAlgorithm(SearchAlgorithm::CONTRACTION_HIERARCHY);
+    assert(!engine.waitForReload());
+    
+    // 重载期间持续查询：每个结果都来自旧地图或新地图（收缩层次在发布前已构建），不会失败
+    std::atomic<bool> querying(true);
+    std::atomic<int> mismatches(0);
+    std::atomic<int> oldAnswers(0);
+    std::atomic<int> newAnswers(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = static_cast<size_t>(t); querying.load(); i = (i + 1) % queries.size()) {
+                PathResult result = engine.findPath(queries[i].first, queries[i].second);
+                if (result.found && std::abs(result.totalWeight - oldWeights[i]) < 1e-9) {
+                    oldAnswers++;
+                } else if (result.found && std::abs(result.totalWeight - newWeights[i]) < 1e-9) {
+                    newAnswers++;
+                } else {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    
+    // 持有旧快照的查询在重载后仍然看到旧地图；发布后的查询看到新地图及重建的预处理数据
+    std::shared_ptr<const MapSnapshot> held = engine.getSnapshot();
+    std::weak_ptr<const MapSnapshot> oldSnapshot = held;
+    assert(engine.startReload(newFile));
+    assert(!engine.startReload(newFile));
+    while (engine.getNodeCount() != 900) {
+        std::this_thread::yield();
+    }
+    assert(held->getGraph().getNodeCount() == 400);
+    PathResult heldResult = held->findPath(queries[0].first, queries[0].second,
+                                           PathStrategy::SHORTEST_DISTANCE, SearchAlgorithm::DIJKSTRA);
+    assert(std::abs(heldResult.totalWeight - oldWeights[0]) < 1e-9);
+    assert(engine.hasLandmarks() && engine.getSnapshot()->getLandmarks()->getLandmarkCount() == 4);
+    assert(engine.hasContractionHierarchy(PathStrategy::SHORTEST_DISTANCE));
+    assert(engine.hasContractionHierarchy(PathStrategy::LEAST_TIME));
+    
+    // 重载在发布后结束，不等待旧快照的持有者；旧快照在最后一个持有者放下后由回收线程释放
+    assert(engine.waitForReload());
+    ReloadStatus status = engine.getReloadStatus();
+    assert(!status.inProgress && status.succeeded == 1 && status.failed == 0 && !status.drained);
+    assert(!oldSnapshot.expired());
+    while (newAnswers.load() < 100) {
+        std::this_thread::yield();
+    }
+    held.reset();
+    while (!engine.getReloadStatus().drained) {
+        std::this_thread::yield();
+    }
+    status = engine.getReloadStatus();
+    assert(oldSnapshot.expired() && status.drainSeconds > 0.0);
+    querying = false;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    assert(mismatches == 0 && newAnswers > 0);
+    
+    // 失败的重载保留原地图
+    assert(engine.startReload("reload_test_missing.txt"));
+    assert(!engine.waitForReload());
+    status = engine.getReloadStatus();
+    assert(status.succeeded == 1 && status.failed == 1);
+    assert(engine.getNodeCount() == 900 && engine.hasContractionHierarchy(PathStrategy::LEAST_TIME));
+    PathResult result = engine.findPath(queries[1].first, queries[1].second);
+    assert(std::abs(result.totalWeight - newWeights[1]) < 1e-9);
+    
+    // 重建的地标表沿用原表的选择方法
+    {
+        MapEngine farthest;
+        assert(farthest.loadMap(oldFile) && farthest.buildLandmarks(4, LandmarkSelection::FARTHEST));
+        assert(farthest.startReload(newFile) && farthest.waitForReload());
+        std::shared_ptr<const MapSnapshot> reloaded = farthest.getSnapshot();
+        assert(reloaded->getLandmarks()->getSelection() == LandmarkSelection::FARTHEST);
+        Landmarks expected;
+        assert(expected.build(reloaded->getGraph(), 4, LandmarkSelection::FARTHEST));
+        assert(reloaded->getLandmarks()->getLandmarkIndices() == expected.getLandmarkIndices());
+    }
+    
+    // 重载回旧地图后立即销毁引擎：析构等待重载线程结束
+    {
+        MapEngine shortLived;
+        assert(shortLived.loadMap(newFile));
+        assert(shortLived.startReload(oldFile));
+    }
+    std::remove(oldFile.c_str());
+    std::remove(newFile.c_str());
+    
+    std::cout << "✓ 后台热重载地图测试通过" << std::endl;
+}
+
 int main() {
     std::cout << "========================================" << std::endl;
     std::cout << "   路径规划引擎单元测试" << std::endl;
@@ -141,6 +3089,30 @@ int main() {
         testNonExistentNode();
         testCycle();
         testPerformance();
+        testCsrGraph();
+        testPerQueryStrategy();
+        testBidirectionalSearch();
+        testAltSearch();
+        testContractionHierarchy();
+        testConcurrentQueries();
+        testFastLoader();
+        testBinaryMap();
+        testGraphGenerator();
+        testPriorityQueues();
+        testDistanceMatrix();
+        testReachableWithin();
+        testComponentIndex();
+        testResultCache();
+        testLiveWeightUpdates();
+        testCustomStrategies();
+        testParetoPaths();
+        testKShortestPaths();
+        testNodeReordering();
+        testSearchMetrics();
+        testDeltaStepping();
+        testPathArena();
+        testQueryServer();
+        testHotReload();
         
         std::cout << "\n========================================" << std::endl;
         std::cout << "所有测试通过！" << std::endl;